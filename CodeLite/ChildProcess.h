@@ -14,6 +14,12 @@
 #include <asyncprocess.h>
 #include "codelite_exports.h"
 
+/**
+ * @class ChildProcess
+ * @brief a child process with redirected stdin/stdout/stderr. On Unix, the wxEVT_ASYNC_PROCESS_OUTPUT events carry the
+ * raw bytes written to stdout (clProcessEvent::GetOutputRaw()), on Windows the output is converted to a string
+ * (clProcessEvent::GetOutput())
+ */
 class WXDLLIMPEXP_CL ChildProcess : public wxEvtHandler
 {
 #if USE_IPROCESS
@@ -0,0 +1,128 @@
+#include "CompileCommandsIndex.h"
+#include "file_logger.h"
+#include <wx/stopwatch.h>
+
+namespace
+{
+bool IsSeparator(char ch) { return ch == '/' || ch == '\\'; }
+
+/**
+ * @brief is 'arg' the source file 'file' (possibly relative to the working directory)?
+ */
+bool IsSourceFile(const std::string& arg, const std::string& file)
+{
+    if(arg == file) {
+        return true;
+    }
+    if(arg.empty() || arg[0] == '-') {
+        return false;
+    }
+    // compare the last path components
+    size_t i = arg.length();
+    size_t j = file.length();
+    while(i > 0 && j > 0 && arg[i - 1] == file[j - 1]) {
+        --i;
+        --j;
+    }
+    if(i == 0) {
+        // 'arg' is a relative path
+        return j == 0 || IsSeparator(file[j - 1]);
+    }
+    return j == 0 && IsSeparator(arg[i - 1]);
+}
+
+wxString QuoteArgument(const wxString& arg)
+{
+    bool hasSpaces = arg.find_first_of(" \t") != wxString::npos;
+    if(!hasSpaces && arg.find('"') == wxString::npos) {
+        return arg;
+    }
+    wxString quoted = arg;
+    quoted.Replace("\"", "\\\"");
+    return hasSpaces ? "\"" + quoted + "\"" : quoted;
+}
+} // namespace
+
+wxString CompileCommandsIndex::Flags::GetCommandLine() const
+{
+    wxString commandLine;
+    for(const wxString& arg : arguments) {
+        if(!commandLine.empty()) {
+            commandLine << " ";
+        }
+        commandLine << QuoteArgument(arg);
+    }
+    return commandLine;
+}
+
+CompileCommandsIndex::CompileCommandsIndex() {}
+
+CompileCommandsIndex::~CompileCommandsIndex() {}
+
+void CompileCommandsIndex::Clear()
+{
+    m_interned.clear();
+    m_flags.clear();
+    m_entriesCount = 0;
+}
+
+bool CompileCommandsIndex::Load(const wxFileName& compile_commands)
+{
+    wxStopWatch sw;
+    size_t entriesCount = m_entriesCount;
+    size_t flagsCount = m_flags.size();
+    bool ok = CompileCommandsReader::Read(compile_commands,
+                                          [this](const CompileCommandsReader::Entry& entry) { Add(entry); });
+    clDEBUG() << "Loaded" << compile_commands << ":" << (m_entriesCount - entriesCount) << "entries,"
+              << (m_flags.size() - flagsCount) << "distinct flags," << sw.Time() << "ms" << clEndl;
+    return ok;
+}
+
+CompileCommandsIndex::FlagsPtr_t CompileCommandsIndex::Add(const CompileCommandsReader::Entry& entry)
+{
+    if(entry.file.empty()) {
+        return FlagsPtr_t();
+    }
+    const std::vector<std::string>* arguments = &entry.arguments;
+    if(arguments->empty()) {
+        CompileCommandsReader::SplitCommandLine(entry.command, m_arguments);
+        arguments = &m_arguments;
+    }
+    if(arguments->empty()) {
+        return FlagsPtr_t();
+    }
+
+    // the flags are the arguments without the source file and the output file, the same flags are shared by all the
+    // files compiled with them
+    m_kept.clear();
+    m_key = entry.directory;
+    for(size_t i = 0; i < arguments->size(); ++i) {
+        const std::string& arg = arguments->at(i);
+        if(arg == "-o") {
+            ++i;
+            continue;
+        }
+        if(arg.compare(0, 3, "/Fo") == 0 || arg.compare(0, 3, "-Fo") == 0 ||
+           (!entry.output.empty() && arg == entry.output) || IsSourceFile(arg, entry.file)) {
+            continue;
+        }
+        m_kept.push_back(i);
+        m_key += '\0';
+        m_key += arg;
+    }
+
+    FlagsPtr_t& flags = m_interned[m_key];
+    if(!flags) {
+        Flags* newFlags = new Flags();
+        newFlags->directory = wxString::FromUTF8(entry.directory.c_str(), entry.directory.length());
+        newFlags->arguments.Alloc(m_kept.size());
+        for(size_t i : m_kept) {
+            const std::string& arg = arguments->at(i);
+            newFlags->arguments.Add(wxString::FromUTF8(arg.c_str(), arg.length()));
+        }
+        flags.reset(newFlags);
+        m_flags.push_back(flags);
+    }
+    ++m_entriesCount;
+    return flags;
+}
@@ -0,0 +1,69 @@
+#ifndef COMPILECOMMANDSINDEX_H
+#define COMPILECOMMANDSINDEX_H
+
+#include "CompileCommandsReader.h"
+#include "codelite_exports.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+/**
+ * @class CompileCommandsIndex
+ * @brief the distinct compilation flags of compile_commands.json files.
+ *
+ * The translation units of a project are usually compiled with the same flags: the flags are stored once (without
+ * the source file and the output file), so the callers that only need the flags (e.g. the include paths) parse each
+ * of them once instead of once per file
+ */
+class WXDLLIMPEXP_CL CompileCommandsIndex
+{
+public:
+    struct Flags {
+        wxString directory;      // the working directory
+        wxArrayString arguments; // the compiler and its options
+
+        /**
+         * @brief the arguments as a command line (quoted when needed)
+         */
+        wxString GetCommandLine() const;
+    };
+    typedef std::shared_ptr<const Flags> FlagsPtr_t;
+
+protected:
+    std::unordered_map<std::string, FlagsPtr_t> m_interned;
+    std::vector<FlagsPtr_t> m_flags;
+    size_t m_entriesCount = 0;
+    // buffers reused by Add()
+    std::vector<std::string> m_arguments;
+    std::vector<size_t> m_kept;
+    std::string m_key;
+
+public:
+    CompileCommandsIndex();
+    virtual ~CompileCommandsIndex();
+
+    /**
+     * @brief add the flags of the entries of a compile_commands.json file
+     */
+    bool Load(const wxFileName& compile_commands);
+
+    /**
+     * @brief add a compile_commands.json entry
+     * @return the flags of the entry (nullptr if the entry is not valid)
+     */
+    FlagsPtr_t Add(const CompileCommandsReader::Entry& entry);
+
+    /**
+     * @brief the distinct flags
+     */
+    const std::vector<FlagsPtr_t>& GetFlags() const { return m_flags; }
+    size_t GetEntriesCount() const { return m_entriesCount; }
+    bool IsEmpty() const { return m_flags.empty(); }
+    void Clear();
+};
+
+#endif // COMPILECOMMANDSINDEX_H
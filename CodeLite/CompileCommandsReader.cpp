@@ -0,0 +1,361 @@
+#include "CompileCommandsReader.h"
+#include "file_logger.h"
+#include <wx/filefn.h>
+
+// The file is read by chunks of this size
+#define READ_BUFFER_SIZE (256 * 1024)
+
+CompileCommandsReader::CompileCommandsReader()
+    : m_buffer(READ_BUFFER_SIZE)
+{
+}
+
+CompileCommandsReader::~CompileCommandsReader()
+{
+    if(m_fp) {
+        fclose(m_fp);
+    }
+}
+
+bool CompileCommandsReader::Fill()
+{
+    if(!m_fp) {
+        return false;
+    }
+    size_t count = fread(m_buffer.data(), 1, m_buffer.size(), m_fp);
+    m_cur = m_buffer.data();
+    m_end = m_cur + count;
+    return count > 0;
+}
+
+int CompileCommandsReader::SkipWhitespace()
+{
+    int ch = Peek();
+    while(ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+        ++m_cur;
+        ch = Peek();
+    }
+    return ch;
+}
+
+bool CompileCommandsReader::Expect(char ch)
+{
+    if(SkipWhitespace() != (unsigned char)ch) {
+        return false;
+    }
+    ++m_cur;
+    return true;
+}
+
+namespace
+{
+int HexValue(int ch)
+{
+    if(ch >= '0' && ch <= '9') {
+        return ch - '0';
+    } else if(ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    } else if(ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+void AppendUTF8(std::string& str, unsigned uc)
+{
+    if(uc < 0x80) {
+        str += (char)uc;
+    } else if(uc < 0x800) {
+        str += (char)(0xC0 | (uc >> 6));
+        str += (char)(0x80 | (uc & 0x3F));
+    } else if(uc < 0x10000) {
+        str += (char)(0xE0 | (uc >> 12));
+        str += (char)(0x80 | ((uc >> 6) & 0x3F));
+        str += (char)(0x80 | (uc & 0x3F));
+    } else {
+        str += (char)(0xF0 | (uc >> 18));
+        str += (char)(0x80 | ((uc >> 12) & 0x3F));
+        str += (char)(0x80 | ((uc >> 6) & 0x3F));
+        str += (char)(0x80 | (uc & 0x3F));
+    }
+}
+} // namespace
+
+bool CompileCommandsReader::ReadString(std::string& str)
+{
+    str.clear();
+    if(!Expect('"')) {
+        return false;
+    }
+    while(true) {
+        // copy the runs without escapes at once
+        const char* start = m_cur;
+        while(m_cur < m_end && *m_cur != '"' && *m_cur != '\\') {
+            ++m_cur;
+        }
+        str.append(start, m_cur - start);
+
+        int ch = Get();
+        if(ch == EOF) {
+            return false;
+        } else if(ch == '"') {
+            return true;
+        } else if(ch != '\\') {
+            // the chunk ended
+            str += (char)ch;
+            continue;
+        }
+
+        ch = Get();
+        switch(ch) {
+        case 'b':
+            str += '\b';
+            break;
+        case 'f':
+            str += '\f';
+            break;
+        case 'n':
+            str += '\n';
+            break;
+        case 'r':
+            str += '\r';
+            break;
+        case 't':
+            str += '\t';
+            break;
+        case 'u': {
+            unsigned uc = 0;
+            for(int i = 0; i < 4; ++i) {
+                int value = HexValue(Get());
+                if(value < 0) {
+                    return false;
+                }
+                uc = (uc << 4) | value;
+            }
+            if(uc >= 0xD800 && uc <= 0xDBFF) {
+                // surrogate pair
+                if(Get() != '\\' || Get() != 'u') {
+                    return false;
+                }
+                unsigned uc2 = 0;
+                for(int i = 0; i < 4; ++i) {
+                    int value = HexValue(Get());
+                    if(value < 0) {
+                        return false;
+                    }
+                    uc2 = (uc2 << 4) | value;
+                }
+                uc = 0x10000 | ((uc & 0x3FF) << 10) | (uc2 & 0x3FF);
+            }
+            AppendUTF8(str, uc);
+        } break;
+        case EOF:
+            return false;
+        default:
+            str += (char)ch;
+            break;
+        }
+    }
+}
+
+bool CompileCommandsReader::ReadStringArray(std::vector<std::string>& arr)
+{
+    arr.clear();
+    if(!Expect('[')) {
+        return false;
+    }
+    if(SkipWhitespace() == ']') {
+        ++m_cur;
+        return true;
+    }
+    while(true) {
+        arr.push_back(std::string());
+        if(!ReadString(arr.back())) {
+            return false;
+        }
+        int ch = SkipWhitespace();
+        ++m_cur;
+        if(ch == ']') {
+            return true;
+        } else if(ch != ',') {
+            return false;
+        }
+    }
+}
+
+bool CompileCommandsReader::SkipValue()
+{
+    int ch = SkipWhitespace();
+    if(ch == '"') {
+        return ReadString(m_key);
+    }
+    if(ch != '{' && ch != '[') {
+        // number, true, false or null
+        while(ch != EOF && ch != ',' && ch != '}' && ch != ']' && ch != ' ' && ch != '\t' && ch != '\n' &&
+              ch != '\r') {
+            ++m_cur;
+            ch = Peek();
+        }
+        return ch != EOF;
+    }
+
+    int depth = 0;
+    while(true) {
+        ch = Peek();
+        if(ch == EOF) {
+            return false;
+        } else if(ch == '"') {
+            if(!ReadString(m_key)) {
+                return false;
+            }
+            continue;
+        }
+        ++m_cur;
+        if(ch == '{' || ch == '[') {
+            ++depth;
+        } else if(ch == '}' || ch == ']') {
+            if(--depth == 0) {
+                return true;
+            }
+        }
+    }
+}
+
+bool CompileCommandsReader::ReadEntry(Entry& entry)
+{
+    entry.Clear();
+    if(!Expect('{')) {
+        return false;
+    }
+    if(SkipWhitespace() == '}') {
+        ++m_cur;
+        return true;
+    }
+    while(true) {
+        if(!ReadString(m_key) || !Expect(':')) {
+            return false;
+        }
+        bool ok;
+        if(m_key == "directory") {
+            ok = ReadString(entry.directory);
+        } else if(m_key == "file") {
+            ok = ReadString(entry.file);
+        } else if(m_key == "command") {
+            ok = ReadString(entry.command);
+        } else if(m_key == "output") {
+            ok = ReadString(entry.output);
+        } else if(m_key == "arguments") {
+            ok = ReadStringArray(entry.arguments);
+        } else {
+            ok = SkipValue();
+        }
+        if(!ok) {
+            return false;
+        }
+        int ch = SkipWhitespace();
+        ++m_cur;
+        if(ch == '}') {
+            return true;
+        } else if(ch != ',') {
+            return false;
+        }
+    }
+}
+
+bool CompileCommandsReader::Read(const wxFileName& filename, const Callback_t& callback)
+{
+    CompileCommandsReader reader;
+    reader.m_fp = wxFopen(filename.GetFullPath(), "rb");
+    if(!reader.m_fp) {
+        return false;
+    }
+
+    // skip the UTF-8 BOM
+    if(reader.Peek() == 0xEF) {
+        for(int i = 0; i < 3; ++i) {
+            reader.Get();
+        }
+    }
+
+    if(!reader.Expect('[')) {
+        clWARNING() << "Invalid compilation database:" << filename << clEndl;
+        return false;
+    }
+    if(reader.SkipWhitespace() == ']') {
+        return true;
+    }
+
+    Entry entry;
+    while(true) {
+        if(!reader.ReadEntry(entry)) {
+            clWARNING() << "Invalid compilation database:" << filename << clEndl;
+            return false;
+        }
+        callback(entry);
+
+        int ch = reader.SkipWhitespace();
+        reader.Get();
+        if(ch == ']') {
+            return true;
+        } else if(ch != ',') {
+            clWARNING() << "Invalid compilation database:" << filename << clEndl;
+            return false;
+        }
+    }
+}
+
+void CompileCommandsReader::SplitCommandLine(const std::string& command, std::vector<std::string>& arguments)
+{
+    arguments.clear();
+    std::string arg;
+    bool inArg = false;
+    char quote = 0;
+    for(size_t i = 0; i < command.length(); ++i) {
+        char ch = command[i];
+        if(quote) {
+            if(ch == quote) {
+                quote = 0;
+            } else if(ch == '\\' && quote == '"' && i + 1 < command.length() &&
+                      (command[i + 1] == '"' || command[i + 1] == '\\')) {
+                arg += command[++i];
+            } else {
+                arg += ch;
+            }
+            continue;
+        }
+
+        switch(ch) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            if(inArg) {
+                arguments.push_back(arg);
+                arg.clear();
+                inArg = false;
+            }
+            break;
+        case '"':
+        case '\'':
+            quote = ch;
+            inArg = true;
+            break;
+        case '\\':
+            inArg = true;
+            if(i + 1 < command.length() && (command[i + 1] == '"' || command[i + 1] == '\'' ||
+                                             command[i + 1] == ' ' || command[i + 1] == '\t')) {
+                arg += command[++i];
+            } else {
+                arg += ch;
+            }
+            break;
+        default:
+            inArg = true;
+            arg += ch;
+            break;
+        }
+    }
+    if(inArg) {
+        arguments.push_back(arg);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef COMPILECOMMANDSREADER_H
+#define COMPILECOMMANDSREADER_H
+
+#include "codelite_exports.h"
+#include <functional>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <wx/filename.h>
+
+/**
+ * @class CompileCommandsReader
+ * @brief read a compile_commands.json file entry by entry, without building a DOM. The file is read in chunks, only
+ * the current entry is kept in memory
+ */
+class WXDLLIMPEXP_CL CompileCommandsReader
+{
+public:
+    /**
+     * @brief a compile_commands.json entry (UTF-8). Either 'command' or 'arguments' is set
+     */
+    struct Entry {
+        std::string directory;
+        std::string file;
+        std::string command;
+        std::string output;
+        std::vector<std::string> arguments;
+
+        void Clear()
+        {
+            directory.clear();
+            file.clear();
+            command.clear();
+            output.clear();
+            arguments.clear();
+        }
+    };
+    typedef std::function<void(const Entry&)> Callback_t;
+
+protected:
+    FILE* m_fp = nullptr;
+    std::vector<char> m_buffer;
+    const char* m_cur = nullptr;
+    const char* m_end = nullptr;
+    std::string m_key;
+
+protected:
+    CompileCommandsReader();
+    ~CompileCommandsReader();
+
+    bool Fill();
+    inline int Peek()
+    {
+        if(m_cur == m_end && !Fill()) {
+            return EOF;
+        }
+        return (unsigned char)*m_cur;
+    }
+    inline int Get()
+    {
+        int ch = Peek();
+        if(ch != EOF) {
+            ++m_cur;
+        }
+        return ch;
+    }
+    int SkipWhitespace();
+    bool Expect(char ch);
+    bool ReadString(std::string& str);
+    bool ReadStringArray(std::vector<std::string>& arr);
+    bool SkipValue();
+    bool ReadEntry(Entry& entry);
+
+public:
+    /**
+     * @brief read 'filename' and call 'callback' for each entry (the entry is reused: copy what you need)
+     * @return false if the file could not be opened or is not a valid compilation database. The entries read before
+     * the error were already passed to 'callback'
+     */
+    static bool Read(const wxFileName& filename, const Callback_t& callback);
+
+    /**
+     * @brief split a command line into arguments. Quotes group the arguments, a backslash only escapes a quote or a
+     * whitespace (so the Windows paths are kept as is)
+     */
+    static void SplitCommandLine(const std::string& command, std::vector<std::string>& arguments);
+};
+
+#endif // COMPILECOMMANDSREADER_H
@@ -6,6 +6,7 @@ CxxPreProcessor::CxxPreProcessor()
     : m_options(0)
     , m_maxDepth(-1)
     , m_currentDepth(0)
+    , m_headerCache(NULL)
 {
 }
 
@@ -17,6 +18,10 @@ void CxxPreProcessor::Parse(const wxFileName& filename, size_t options)
     try {
         //CL_DEBUG("Calling CxxPreProcessor::Parse for file '%s'\n", filename.GetFullPath());
         m_options = options;
+        if(m_headerCache) {
+            m_headerCache->BeginTranslationUnit();
+            m_includePathsKey = wxJoin(m_includePaths, '\n', '\0');
+        }
         scanner = new CxxPreProcessorScanner(filename, m_options);
         // Remove the option so recursive scanner won't get it
         m_options &= ~kLexerOpt_DontCollectMacrosDefinedInThisFile;
@@ -44,6 +49,8 @@ void CxxPreProcessor::Parse(const wxFileName& filename, size_t options)
 bool
 CxxPreProcessor::ExpandInclude(const wxFileName& currentFile, const wxString& includeStatement, wxFileName& outFile)
 {
+    DoRecordInclude(includeStatement);
+
     wxString includeName = includeStatement;
     includeName.Replace("\"", "");
     includeName.Replace("<", "");
@@ -71,6 +78,11 @@ CxxPreProcessor::ExpandInclude(const wxFileName& currentFile, const wxString& in
         tmpfile << paths.Item(i) << "/" << includeName;
         wxFileName fn(tmpfile);
         tmpfile = fn.GetFullPath();
+        if(m_headerCache && !m_recorders.empty()) {
+            // the result depends on the content of every folder searched so far
+            wxString folder = fn.GetPath();
+            DoRecordFile(folder, m_headerCache->GetModificationTime(folder));
+        }
         // CL_DEBUG(" ... Checking include file: %s\n", fn.GetFullPath());
         struct stat buff;
         if((stat(tmpfile.mb_str(wxConvUTF8).data(), &buff) == 0)) {
@@ -79,7 +91,7 @@ CxxPreProcessor::ExpandInclude(const wxFileName& currentFile, const wxString& in
             if(fixedFileName.FileExists()) {
                 fixedFileName.Normalize(wxPATH_NORM_DOTS);
                 tmpfile = fixedFileName.GetFullPath();
-                m_fileMapping.insert(std::make_pair(includeStatement, tmpfile));
+                DoAddFileMapping(includeStatement, tmpfile);
                 outFile = fixedFileName;
                 return true;
             } else {
@@ -89,11 +101,187 @@ CxxPreProcessor::ExpandInclude(const wxFileName& currentFile, const wxString& in
     }
 
     // remember that we could not locate this include statement
-    m_noSuchFiles.insert(includeStatement);
-    m_fileMapping.insert(std::make_pair(includeStatement, wxString()));
+    DoAddFileMapping(includeStatement, wxString());
     return false;
 }
 
+void CxxPreProcessor::ParseInclude(const wxFileName& include)
+{
+    wxString filename = include.GetFullPath();
+    if(m_headerCache) {
+        // a header whose macros, include statements and files did not change since it was cached
+        // gives the same result
+        const CxxPreProcessorHeaderCache::EntryVec_t& entries = m_headerCache->GetEntries(filename);
+        for(size_t i = 0; i < entries.size(); ++i) {
+            if(DoIsEntryValid(*entries[i])) {
+                CxxPreProcessorHeaderCache::EntryPtr entry = entries[i];
+                m_headerCache->AddHit();
+                DoApplyEntry(*entry);
+                return;
+            }
+        }
+        m_headerCache->AddMiss();
+
+        Recorder recorder;
+        recorder.entry.reset(new CxxPreProcessorHeaderCache::Entry());
+        recorder.entry->options = m_options;
+        recorder.entry->includePaths = m_includePathsKey;
+        m_recorders.push_back(recorder);
+        DoRecordFile(filename, m_headerCache->GetModificationTime(filename));
+    }
+
+    CxxPreProcessorScanner* scanner = new CxxPreProcessorScanner(include, m_options);
+    try {
+        if(scanner && !scanner->IsNull()) {
+            scanner->Parse(this);
+        }
+    } catch(CxxLexerException& e) {
+        // catch the exception
+        CL_DEBUG("Exception caught: %s\n", e.message);
+    }
+    // make sure we always delete the scanner
+    wxDELETE(scanner);
+
+    if(m_headerCache) {
+        CxxPreProcessorHeaderCache::EntryPtr entry = m_recorders.back().entry;
+        m_recorders.pop_back();
+        m_headerCache->Insert(filename, entry);
+        DoRecordDefinedMacros(*entry);
+    }
+}
+
+const CxxPreProcessorToken* CxxPreProcessor::FindMacro(const wxString& name)
+{
+    DoRecordMacro(name);
+    CxxPreProcessorToken::Map_t::const_iterator iter = m_tokens.find(name);
+    return iter == m_tokens.end() ? NULL : &iter->second;
+}
+
+void CxxPreProcessor::DefineMacro(const CxxPreProcessorToken& macro)
+{
+    DoRecordMacro(macro.name);
+    if(m_tokens.insert(std::make_pair(macro.name, macro)).second && !m_recorders.empty()) {
+        // only the header defining the macro stores it, the headers including it share its segments
+        Recorder& recorder = m_recorders.back();
+        if(!recorder.macrosSegment) {
+            recorder.macrosSegment.reset(new std::vector<CxxPreProcessorToken>());
+            recorder.entry->definedMacros.push_back(recorder.macrosSegment);
+        }
+        recorder.macrosSegment->push_back(macro);
+    }
+}
+
+void CxxPreProcessor::DoRecordDefinedMacros(const CxxPreProcessorHeaderCache::Entry& entry)
+{
+    if(m_recorders.empty()) return;
+
+    // the macros defined by an included header come after the ones its includer defined so far
+    Recorder& recorder = m_recorders.back();
+    recorder.macrosSegment.reset();
+    recorder.entry->definedMacros.insert(
+        recorder.entry->definedMacros.end(), entry.definedMacros.begin(), entry.definedMacros.end());
+}
+
+// The Do*Record* functions remember the state of a macro / include statement / file for the headers being parsed
+// the first time they use it. A header recorder always saw what the headers it includes saw, so the loops stop at
+// the first recorder that already knows about it
+
+void CxxPreProcessor::DoRecordMacro(const wxString& name)
+{
+    for(size_t i = m_recorders.size(); i > 0; --i) {
+        Recorder& recorder = m_recorders[i - 1];
+        if(!recorder.macros.insert(name).second) break;
+
+        CxxPreProcessorHeaderCache::MacroState state;
+        state.name = name;
+        CxxPreProcessorToken::Map_t::const_iterator iter = m_tokens.find(name);
+        state.defined = (iter != m_tokens.end());
+        if(state.defined) {
+            state.value = iter->second.value;
+        }
+        recorder.entry->macros.push_back(state);
+    }
+}
+
+void CxxPreProcessor::DoRecordInclude(const wxString& includeStatement)
+{
+    for(size_t i = m_recorders.size(); i > 0; --i) {
+        Recorder& recorder = m_recorders[i - 1];
+        if(!recorder.includes.insert(includeStatement).second) break;
+        bool resolved = m_fileMapping.count(includeStatement) > 0;
+        recorder.entry->includes.push_back(std::make_pair(includeStatement, resolved));
+    }
+}
+
+void CxxPreProcessor::DoRecordFile(const wxString& filename, time_t modified)
+{
+    for(size_t i = m_recorders.size(); i > 0; --i) {
+        Recorder& recorder = m_recorders[i - 1];
+        if(!recorder.files.insert(filename).second) break;
+        recorder.entry->files.push_back(std::make_pair(filename, modified));
+    }
+}
+
+void CxxPreProcessor::DoAddFileMapping(const wxString& includeStatement, const wxString& filename)
+{
+    if(filename.IsEmpty()) {
+        m_noSuchFiles.insert(includeStatement);
+    }
+    m_fileMapping.insert(std::make_pair(includeStatement, filename));
+    for(size_t i = 0; i < m_recorders.size(); ++i) {
+        m_recorders[i].entry->fileMapping.push_back(std::make_pair(includeStatement, filename));
+    }
+}
+
+bool CxxPreProcessor::DoIsEntryValid(const CxxPreProcessorHeaderCache::Entry& entry)
+{
+    if(entry.options != m_options || entry.includePaths != m_includePathsKey) return false;
+
+    for(size_t i = 0; i < entry.macros.size(); ++i) {
+        const CxxPreProcessorHeaderCache::MacroState& state = entry.macros[i];
+        CxxPreProcessorToken::Map_t::const_iterator iter = m_tokens.find(state.name);
+        bool defined = (iter != m_tokens.end());
+        if(defined != state.defined) return false;
+        if(defined && iter->second.value != state.value) return false;
+    }
+
+    for(size_t i = 0; i < entry.includes.size(); ++i) {
+        bool resolved = m_fileMapping.count(entry.includes[i].first) > 0;
+        if(resolved != entry.includes[i].second) return false;
+    }
+
+    for(size_t i = 0; i < entry.files.size(); ++i) {
+        if(m_headerCache->GetModificationTime(entry.files[i].first) != entry.files[i].second) return false;
+    }
+    return true;
+}
+
+void CxxPreProcessor::DoApplyEntry(const CxxPreProcessorHeaderCache::Entry& entry)
+{
+    // the headers being parsed depend on whatever the cached header depends on
+    for(size_t i = 0; i < entry.macros.size(); ++i) {
+        DoRecordMacro(entry.macros[i].name);
+    }
+    for(size_t i = 0; i < entry.includes.size(); ++i) {
+        DoRecordInclude(entry.includes[i].first);
+    }
+    for(size_t i = 0; i < entry.files.size(); ++i) {
+        DoRecordFile(entry.files[i].first, entry.files[i].second);
+    }
+
+    // the entry is valid: none of its macros is defined yet (their state was recorded before they were defined)
+    for(size_t i = 0; i < entry.definedMacros.size(); ++i) {
+        const std::vector<CxxPreProcessorToken>& segment = *entry.definedMacros[i];
+        for(size_t j = 0; j < segment.size(); ++j) {
+            m_tokens.insert(std::make_pair(segment[j].name, segment[j]));
+        }
+    }
+    DoRecordDefinedMacros(entry);
+    for(size_t i = 0; i < entry.fileMapping.size(); ++i) {
+        DoAddFileMapping(entry.fileMapping[i].first, entry.fileMapping[i].second);
+    }
+}
+
 void CxxPreProcessor::AddIncludePath(const wxString& path) { m_includePaths.Add(path); }
 
 void CxxPreProcessor::AddDefinition(const wxString& def)
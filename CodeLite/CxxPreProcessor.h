@@ -28,8 +28,10 @@
 
 #include "CxxLexerAPI.h"
 #include <wx/filename.h>
+#include "CxxPreProcessorHeaderCache.h"
 #include "CxxPreProcessorScanner.h"
 #include <set>
+#include <unordered_set>
 #include "codelite_exports.h"
 
 class WXDLLIMPEXP_CL CxxPreProcessor
@@ -41,6 +43,28 @@ class WXDLLIMPEXP_CL CxxPreProcessor
     size_t m_options;
     int m_maxDepth;
     int m_currentDepth;
+    CxxPreProcessorHeaderCache* m_headerCache;
+    wxString m_includePathsKey;
+
+    // one per header being parsed while a cache is set: collects the header cache entry
+    struct Recorder {
+        CxxPreProcessorHeaderCache::EntryPtr entry;
+        // the macros defined by the header itself since its last include, shared with the entries including it
+        std::shared_ptr<std::vector<CxxPreProcessorToken> > macrosSegment;
+        std::unordered_set<wxString> macros;
+        std::unordered_set<wxString> includes;
+        std::unordered_set<wxString> files;
+    };
+    std::vector<Recorder> m_recorders;
+
+protected:
+    void DoRecordMacro(const wxString& name);
+    void DoRecordInclude(const wxString& includeStatement);
+    void DoRecordFile(const wxString& filename, time_t modified);
+    void DoRecordDefinedMacros(const CxxPreProcessorHeaderCache::Entry& entry);
+    void DoAddFileMapping(const wxString& includeStatement, const wxString& filename);
+    bool DoIsEntryValid(const CxxPreProcessorHeaderCache::Entry& entry);
+    void DoApplyEntry(const CxxPreProcessorHeaderCache::Entry& entry);
 
 public:
     CxxPreProcessor();
@@ -57,6 +81,13 @@ public:
 
     void SetOptions(size_t options) { this->m_options = options; }
     size_t GetOptions() const { return m_options; }
+
+    /**
+     * @brief use 'cache' to reuse the result of the headers parsed by previous translation units (the cache is
+     * not owned by the pre processor). Pass NULL to parse everything
+     */
+    void SetHeaderCache(CxxPreProcessorHeaderCache* cache) { this->m_headerCache = cache; }
+    CxxPreProcessorHeaderCache* GetHeaderCache() const { return m_headerCache; }
     /**
      * @brief return a command that generates a single file with all defines in it
      */
@@ -83,6 +114,21 @@ public:
      * @param outFile [output]
      */
     bool ExpandInclude(const wxFileName& currentFile, const wxString& includeStatement, wxFileName& outFile);
+
+    /**
+     * @brief parse an include file (as resolved by ExpandInclude()), or apply its cached result
+     */
+    void ParseInclude(const wxFileName& include);
+
+    /**
+     * @brief return the macro named 'name', or NULL if it is not defined
+     */
+    const CxxPreProcessorToken* FindMacro(const wxString& name);
+
+    /**
+     * @brief define a macro. A macro that is already defined is not redefined
+     */
+    void DefineMacro(const CxxPreProcessorToken& macro);
     /**
      * @brief the main entry function
      * @param filename
@@ -0,0 +1,60 @@
+#include "CxxPreProcessorHeaderCache.h"
+#include "fileutils.h"
+
+// Entries kept per header, i.e. different incoming states (most headers have one or two)
+#define MAX_ENTRIES_PER_HEADER 4
+// Once there are more entries than this, the cache starts over
+#define MAX_ENTRIES 20000
+
+CxxPreProcessorHeaderCache::CxxPreProcessorHeaderCache()
+    : m_count(0)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+CxxPreProcessorHeaderCache::~CxxPreProcessorHeaderCache() {}
+
+void CxxPreProcessorHeaderCache::Clear()
+{
+    m_entries.clear();
+    m_modificationTimes.clear();
+    m_count = 0;
+}
+
+void CxxPreProcessorHeaderCache::BeginTranslationUnit() { m_modificationTimes.clear(); }
+
+const CxxPreProcessorHeaderCache::EntryVec_t& CxxPreProcessorHeaderCache::GetEntries(const wxString& header) const
+{
+    static const EntryVec_t emptyVec;
+    std::unordered_map<wxString, EntryVec_t>::const_iterator iter = m_entries.find(header);
+    return iter == m_entries.end() ? emptyVec : iter->second;
+}
+
+void CxxPreProcessorHeaderCache::Insert(const wxString& header, EntryPtr entry)
+{
+    if(m_count >= MAX_ENTRIES) {
+        m_entries.clear();
+        m_count = 0;
+    }
+
+    EntryVec_t& entries = m_entries[header];
+    if(entries.size() >= MAX_ENTRIES_PER_HEADER) {
+        // drop the oldest entry
+        entries.erase(entries.begin());
+        --m_count;
+    }
+    entries.push_back(entry);
+    ++m_count;
+}
+
+time_t CxxPreProcessorHeaderCache::GetModificationTime(const wxString& filename)
+{
+    std::unordered_map<wxString, time_t>::iterator iter = m_modificationTimes.find(filename);
+    if(iter != m_modificationTimes.end()) {
+        return iter->second;
+    }
+    time_t modified = FileUtils::GetFileModificationTime(wxFileName(filename));
+    m_modificationTimes.insert(std::make_pair(filename, modified));
+    return modified;
+}
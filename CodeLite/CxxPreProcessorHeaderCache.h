@@ -0,0 +1,96 @@
+#ifndef CXXPREPROCESSORHEADERCACHE_H
+#define CXXPREPROCESSORHEADERCACHE_H
+
+#include "CxxLexerAPI.h"
+#include "codelite_exports.h"
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class CxxPreProcessorHeaderCache
+ * @brief remembers what CxxPreProcessor did when it parsed a header, so the next translation units including the
+ * same header can apply the result instead of parsing the header (and everything it includes) again.
+ *
+ * An entry holds the macros and the include statements the header depends on, with the state they had before the
+ * header was parsed (the first time the header or one of its includes looked them up or defined them), the files
+ * that were parsed with their modification time, and the resulting macros and include mapping. An entry can be
+ * reused when all these macros, include statements and files are still the same. The folders searched for the
+ * include statements are kept with the files: a header created in one of them (e.g. one that now shadows the
+ * header found before) changes the folder modification time. The entries are also keyed by the include paths.
+ *
+ * The macros are kept in segments shared between the entry of a header and the entries of the headers including
+ * it, so a macro is stored once however deep the header is included.
+ *
+ * This class is not thread safe: use one cache per thread
+ */
+class WXDLLIMPEXP_CL CxxPreProcessorHeaderCache
+{
+public:
+    struct MacroState {
+        wxString name;
+        bool defined;
+        wxString value;
+    };
+
+    typedef std::shared_ptr<const std::vector<CxxPreProcessorToken> > MacrosSegmentPtr;
+
+    struct Entry {
+        size_t options = 0;
+        wxString includePaths;
+        std::vector<MacroState> macros;
+        std::vector<std::pair<wxString, bool> > includes; // include statement, was it already resolved
+        std::vector<std::pair<wxString, time_t> > files;  // the files parsed and the folders searched
+        std::vector<MacrosSegmentPtr> definedMacros;      // in the order they were defined
+        std::vector<std::pair<wxString, wxString> > fileMapping; // include statement -> file (empty if not found)
+    };
+    typedef std::shared_ptr<Entry> EntryPtr;
+    typedef std::vector<EntryPtr> EntryVec_t;
+
+protected:
+    std::unordered_map<wxString, EntryVec_t> m_entries;
+    std::unordered_map<wxString, time_t> m_modificationTimes;
+    size_t m_count;
+    size_t m_hits;
+    size_t m_misses;
+
+public:
+    CxxPreProcessorHeaderCache();
+    virtual ~CxxPreProcessorHeaderCache();
+
+    /**
+     * @brief clear the cache content
+     */
+    void Clear();
+
+    /**
+     * @brief called when a new translation unit is parsed. The files modification times are read once per
+     * translation unit
+     */
+    void BeginTranslationUnit();
+
+    /**
+     * @brief return the entries cached for 'header' (can be empty)
+     */
+    const EntryVec_t& GetEntries(const wxString& header) const;
+
+    /**
+     * @brief add an entry for 'header'. Only a few entries (i.e. different incoming states) are kept per header
+     */
+    void Insert(const wxString& header, EntryPtr entry);
+
+    /**
+     * @brief return the modification time of 'filename' (see BeginTranslationUnit())
+     */
+    time_t GetModificationTime(const wxString& filename);
+
+    void AddHit() { ++m_hits; }
+    void AddMiss() { ++m_misses; }
+    size_t GetHits() const { return m_hits; }
+    size_t GetMisses() const { return m_misses; }
+    size_t GetCount() const { return m_count; }
+};
+
+#endif // CXXPREPROCESSORHEADERCACHE_H
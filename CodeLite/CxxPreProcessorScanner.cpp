@@ -68,7 +68,6 @@ void CxxPreProcessorScanner::Parse(CxxPreProcessor* pp)
 {
     CxxLexerToken token;
     bool searchingForBranch = false;
-    CxxPreProcessorToken::Map_t& ppTable = pp->GetTokens();
     while(m_scanner && ::LexerNext(m_scanner, token)) {
         // Pre Processor state
         switch(token.GetType()) {
@@ -76,17 +75,7 @@ void CxxPreProcessorScanner::Parse(CxxPreProcessor* pp)
             // we found an include statement, recurse into it
             wxFileName include;
             if(pp->ExpandInclude(m_filename, token.GetWXString(), include)) {
-                CxxPreProcessorScanner* scanner = new CxxPreProcessorScanner(include, pp->GetOptions());
-                try {
-                    if(scanner && !scanner->IsNull()) {
-                        scanner->Parse(pp);
-                    }
-                } catch(CxxLexerException& e) {
-                    // catch the exception
-                    CL_DEBUG("Exception caught: %s\n", e.message);
-                }
-                // make sure we always delete the scanner
-                wxDELETE(scanner);
+                pp->ParseInclude(include);
                 clDEBUG1() << "<== Resuming parser on file:" << m_filename << clEndl;
             }
             break;
@@ -95,7 +84,7 @@ void CxxPreProcessorScanner::Parse(CxxPreProcessor* pp)
             searchingForBranch = true;
             // read the identifier
             ReadUntilMatch(T_PP_IDENTIFIER, token);
-            if(IsTokenExists(ppTable, token)) {
+            if(IsTokenExists(pp, token)) {
                 searchingForBranch = false;
                 // condition is true
                 Parse(pp);
@@ -110,7 +99,7 @@ void CxxPreProcessorScanner::Parse(CxxPreProcessor* pp)
             searchingForBranch = true;
             // read the identifier
             ReadUntilMatch(T_PP_IDENTIFIER, token);
-            if(!IsTokenExists(ppTable, token)) {
+            if(!IsTokenExists(pp, token)) {
                 searchingForBranch = false;
                 // condition is true
                 Parse(pp);
@@ -126,7 +115,7 @@ void CxxPreProcessorScanner::Parse(CxxPreProcessor* pp)
         case T_PP_ELIF: {
             if(searchingForBranch) {
                 // We expect a condition
-                if(!CheckIf(ppTable)) {
+                if(!CheckIf(pp)) {
                     // skip until we find the next:
                     // else, elif, endif (but do not consume these tokens)
                     if(!ConsumeCurrentBranch()) return;
@@ -172,19 +161,19 @@ void CxxPreProcessorScanner::Parse(CxxPreProcessor* pp)
             // Optionally get the value
             GetRestOfPPLine(macroValue, m_options & kLexerOpt_CollectMacroValueNumbers);
 
-            CxxPreProcessorToken pp;
-            pp.name = macroName;
-            pp.value = macroValue;
+            CxxPreProcessorToken macro;
+            macro.name = macroName;
+            macro.value = macroValue;
             // mark this token for deletion when the entire TU parsing is done
-            pp.deleteOnExit = (m_options & kLexerOpt_DontCollectMacrosDefinedInThisFile);
-            ppTable.insert(std::make_pair(pp.name, pp));
+            macro.deleteOnExit = (m_options & kLexerOpt_DontCollectMacrosDefinedInThisFile);
+            pp->DefineMacro(macro);
             break;
         }
         }
     }
 }
 
-bool CxxPreProcessorScanner::CheckIfDefined(const CxxPreProcessorToken::Map_t& table)
+bool CxxPreProcessorScanner::CheckIfDefined(CxxPreProcessor* pp)
 {
     CxxLexerToken token;
     if(m_scanner && ::LexerNext(m_scanner, token)) {
@@ -193,7 +182,7 @@ bool CxxPreProcessorScanner::CheckIfDefined(const CxxPreProcessorToken::Map_t& t
         }
         switch(token.GetType()) {
         case T_PP_IDENTIFIER:
-            return table.count(token.GetWXString());
+            return pp->FindMacro(token.GetWXString()) != NULL;
         case '(':
             // ignore
             break;
@@ -220,7 +209,7 @@ struct ExpressionLocker
     ~ExpressionLocker() { wxDELETE(m_expr); }
 };
 
-bool CxxPreProcessorScanner::CheckIf(const CxxPreProcessorToken::Map_t& table)
+bool CxxPreProcessorScanner::CheckIf(CxxPreProcessor* pp)
 {
     // we currently support
     // #if IDENTIFIER
@@ -264,8 +253,8 @@ bool CxxPreProcessorScanner::CheckIf(const CxxPreProcessorToken::Map_t& table)
         }
         case T_PP_IDENTIFIER: {
             wxString identifier = token.GetWXString();
-            CxxPreProcessorToken::Map_t::const_iterator iter = table.find(identifier);
-            if(iter == table.end()) {
+            const CxxPreProcessorToken* macro = pp->FindMacro(identifier);
+            if(!macro) {
                 SET_CUR_EXPR_VALUE_RET_FALSE(0);
             } else {
                 if(cur->IsDefined()) {
@@ -273,7 +262,7 @@ bool CxxPreProcessorScanner::CheckIf(const CxxPreProcessorToken::Map_t& table)
                     // if a 'defined' statement)
                     SET_CUR_EXPR_VALUE_RET_FALSE(1);
                 } else {
-                    wxString macroValue = iter->second.value;
+                    wxString macroValue = macro->value;
                     if(macroValue.IsEmpty()) {
                         SET_CUR_EXPR_VALUE_RET_FALSE(0);
                     } else {
@@ -370,7 +359,7 @@ void CxxPreProcessorScanner::ReadUntilMatch(int type, CxxLexerToken& token)
     throw CxxLexerException(wxString() << "<<EOF>> Could not find a match for type: " << type);
 }
 
-bool CxxPreProcessorScanner::IsTokenExists(const CxxPreProcessorToken::Map_t& table, const CxxLexerToken& token)
+bool CxxPreProcessorScanner::IsTokenExists(CxxPreProcessor* pp, const CxxLexerToken& token)
 {
-    return table.count(token.GetWXString());
+    return pp->FindMacro(token.GetWXString()) != NULL;
 }
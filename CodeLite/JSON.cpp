@@ -27,14 +27,137 @@
 #include "StringUtils.h"
 #include "clFontHelper.h"
 #include "fileutils.h"
+#include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wx/ffile.h>
 #include <wx/filename.h>
 
+namespace
+{
+bool SameName(const cJSON* node, const char* name, size_t len)
+{
+    if(!node->name || node->nameLen != len) {
+        return false;
+    }
+    // the names are compared case insensitively
+    for(size_t i = 0; i < len; ++i) {
+        if(tolower((unsigned char)node->name[i]) != tolower((unsigned char)name[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+cJSON* FindChild(cJSON* parent, const char* name, size_t len)
+{
+    for(cJSON* child = parent->child; child; child = child->next) {
+        if(SameName(child, name, len)) {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+cJSON* GetChild(cJSON* parent, int pos)
+{
+    if(pos < 0 || pos >= parent->count) {
+        return nullptr;
+    }
+    // continue from the last accessed child when possible, so iterating by index is linear
+    cJSON* child = parent->child;
+    int index = 0;
+    if(parent->cachedChild && parent->cachedIndex <= pos) {
+        child = parent->cachedChild;
+        index = parent->cachedIndex;
+    }
+    for(; index < pos; ++index) {
+        child = child->next;
+    }
+    parent->cachedChild = child;
+    parent->cachedIndex = pos;
+    return child;
+}
+
+void SetNodeName(cJSON* node, const char* name, size_t len)
+{
+    node->arena->ReleaseString(node->name, node->nameLen);
+    node->name = node->arena->NewString(name, len);
+    node->nameLen = len;
+}
+
+cJSON* LinkChild(cJSON* parent, cJSON* node)
+{
+    node->next = nullptr;
+    node->prev = parent->lastChild;
+    if(parent->lastChild) {
+        parent->lastChild->next = node;
+    } else {
+        parent->child = node;
+    }
+    parent->lastChild = node;
+    ++parent->count;
+    return node;
+}
+
+/**
+ * @brief add 'item' as the last child of 'parent'. A root created on its own (e.g. by JSONItem::createObject()) is
+ * moved into the tree, any other node (i.e. a node which is already part of a tree) is copied
+ * @return the node added to 'parent'
+ */
+cJSON* AddChild(cJSON* parent, cJSON* item)
+{
+    if(item->arena != parent->arena && JSONArena::IsOwnedRoot(item)) {
+        parent->arena->Adopt(item->arena);
+    } else {
+        item = parent->arena->CopyNode(item);
+    }
+    return LinkChild(parent, item);
+}
+
+cJSON* AddChild(cJSON* parent, int type, const char* name, size_t len)
+{
+    cJSON* node = LinkChild(parent, parent->arena->NewNode(type));
+    SetNodeName(node, name, len);
+    return node;
+}
+
+void RemoveChild(cJSON* parent, cJSON* child)
+{
+    if(child->prev) {
+        child->prev->next = child->next;
+    } else {
+        parent->child = child->next;
+    }
+    if(child->next) {
+        child->next->prev = child->prev;
+    } else {
+        parent->lastChild = child->prev;
+    }
+    child->next = child->prev = nullptr;
+    --parent->count;
+    parent->cachedChild = nullptr;
+}
+} // namespace
+
 JSON::JSON(const wxString& text)
     : m_json(NULL)
 {
-    m_json = cJSON_Parse(text.mb_str(wxConvUTF8).data());
+    const wxCharBuffer cb = text.mb_str(wxConvUTF8);
+    std::string buffer(cb.data(), cb.length());
+    m_json = JSONArena::Parse(buffer);
+}
+
+JSON::JSON(const char* text, size_t len)
+    : m_json(NULL)
+{
+    m_json = JSONArena::Parse(text, len);
+}
+
+JSON::JSON(std::string&& text)
+    : m_json(NULL)
+{
+    m_json = JSONArena::Parse(text);
 }
 
 JSON::JSON(cJSON* json)
@@ -51,29 +174,32 @@ JSON::JSON(int type)
     : m_json(NULL)
 {
     if(type == cJSON_Array)
-        m_json = cJSON_CreateArray();
+        m_json = JSONArena::Create(cJSON_Array);
     else if(type == cJSON_NULL)
-        m_json = cJSON_CreateNull();
+        m_json = JSONArena::Create(cJSON_NULL);
     else
-        m_json = cJSON_CreateObject();
+        m_json = JSONArena::Create(cJSON_Object);
 }
 
 JSON::JSON(const wxFileName& filename)
     : m_json(NULL)
 {
-    wxString content;
+    std::string content;
     if(!FileUtils::ReadFileContent(filename, content)) {
         return;
     }
-    m_json = cJSON_Parse(content.mb_str(wxConvUTF8).data());
+    if(!content.empty() && wxConvUTF8.ToWChar(NULL, 0, content.c_str(), content.length()) == wxCONV_FAILED) {
+        // not UTF-8, assume the file was written with an 8 bit encoding
+        const wxCharBuffer cb = wxString::From8BitData(content.c_str(), content.length()).mb_str(wxConvUTF8);
+        content.assign(cb.data(), cb.length());
+    }
+    m_json = JSONArena::Parse(content);
 }
 
 JSON::~JSON()
 {
-    if(m_json) {
-        cJSON_Delete(m_json);
-        m_json = NULL;
-    }
+    JSONArena::Destroy(m_json);
+    m_json = NULL;
 }
 
 void JSON::save(const wxFileName& fn) const
@@ -101,11 +227,16 @@ JSONItem JSONItem::namedObject(const wxString& name) const
         return JSONItem(NULL);
     }
 
-    cJSON* obj = cJSON_GetObjectItem(m_json, name.mb_str(wxConvUTF8).data());
-    if(!obj) {
+    const wxCharBuffer cb = name.mb_str(wxConvUTF8);
+    return JSONItem(FindChild(m_json, cb.data(), cb.length()));
+}
+
+JSONItem JSONItem::namedObject(const char* name) const
+{
+    if(!m_json) {
         return JSONItem(NULL);
     }
-    return JSONItem(obj);
+    return JSONItem(FindChild(m_json, name, strlen(name)));
 }
 
 void JSON::clear()
@@ -113,13 +244,13 @@ void JSON::clear()
     int type = cJSON_Object;
     if(m_json) {
         type = m_json->type;
-        cJSON_Delete(m_json);
+        JSONArena::Destroy(m_json);
         m_json = NULL;
     }
     if(type == cJSON_Array)
-        m_json = cJSON_CreateArray();
+        m_json = JSONArena::Create(cJSON_Array);
     else
-        m_json = cJSON_CreateObject();
+        m_json = JSONArena::Create(cJSON_Object);
 }
 
 cJSON* JSON::release()
@@ -134,10 +265,7 @@ cJSON* JSON::release()
 JSONItem::JSONItem(cJSON* json)
     : m_json(json)
 {
-    if(m_json) {
-        m_name = wxString(m_json->string, wxConvUTF8);
-        m_type = m_json->type;
-    }
+    // the name and the type are read from the node when needed
 }
 
 JSONItem::JSONItem(const wxString& name, double val)
@@ -169,6 +297,24 @@ JSONItem::JSONItem(const wxString& name, bool val)
 {
 }
 
+void JSONItem::setName(const wxString& name)
+{
+    if(m_json) {
+        const wxCharBuffer cb = name.mb_str(wxConvUTF8);
+        SetNodeName(m_json, cb.data(), cb.length());
+    } else {
+        m_name = name;
+    }
+}
+
+wxString JSONItem::getName() const
+{
+    if(m_json) {
+        return m_json->name ? wxString(m_json->name, wxConvUTF8, m_json->nameLen) : wxString();
+    }
+    return m_name;
+}
+
 JSONItem JSONItem::operator[](int index) const
 {
     if(isArray()) {
@@ -188,11 +334,7 @@ JSONItem JSONItem::arrayItem(int pos) const
     if(m_json->type != cJSON_Array)
         return JSONItem(NULL);
 
-    int size = cJSON_GetArraySize(m_json);
-    if(pos >= size)
-        return JSONItem(NULL);
-
-    return JSONItem(cJSON_GetArrayItem(m_json, pos));
+    return JSONItem(GetChild(m_json, pos));
 }
 
 bool JSONItem::isNull() const
@@ -226,7 +368,7 @@ wxString JSONItem::toString(const wxString& defaultValue) const
         return defaultValue;
     }
 
-    return wxString(m_json->valuestring, wxConvUTF8);
+    return wxString(m_json->valuestring, wxConvUTF8, m_json->valueLen);
 }
 
 bool JSONItem::isBool() const
@@ -253,31 +395,31 @@ void JSONItem::append(const JSONItem& element)
         return;
     }
 
-    switch(element.getType()) {
-    case cJSON_False:
-        cJSON_AddFalseToObject(m_json, element.getName().mb_str(wxConvUTF8).data());
-        break;
+    if(element.m_json) {
+        // the node keeps its name
+        AddChild(m_json, element.m_json);
+        return;
+    }
 
+    const std::string& name = element.m_name;
+    switch(element.m_type) {
+    case cJSON_False:
     case cJSON_True:
-        cJSON_AddTrueToObject(m_json, element.getName().mb_str(wxConvUTF8).data());
-        break;
-
     case cJSON_NULL:
-        cJSON_AddNullToObject(m_json, element.getName().mb_str(wxConvUTF8).data());
+        AddChild(m_json, element.m_type, name.c_str(), name.length());
         break;
 
-    case cJSON_Number:
-        cJSON_AddNumberToObject(m_json, element.m_name.c_str(), element.m_valueNumer);
-        break;
-
-    case cJSON_String:
-        cJSON_AddStringToObject(m_json, element.m_name.c_str(), element.m_valueString.c_str());
-        break;
+    case cJSON_Number: {
+        cJSON* node = AddChild(m_json, cJSON_Number, name.c_str(), name.length());
+        node->valuedouble = element.m_valueNumer;
+        node->valueint = (int)element.m_valueNumer;
+    } break;
 
-    case cJSON_Array:
-    case cJSON_Object:
-        cJSON_AddItemToObject(m_json, element.m_name.c_str(), element.m_json);
-        break;
+    case cJSON_String: {
+        cJSON* node = AddChild(m_json, cJSON_String, name.c_str(), name.length());
+        node->valuestring = m_json->arena->NewString(element.m_valueString.c_str(), element.m_valueString.length());
+        node->valueLen = element.m_valueString.length();
+    } break;
     }
 }
 
@@ -287,40 +429,39 @@ void JSONItem::arrayAppend(const JSONItem& element)
         return;
     }
 
+    if(element.m_json) {
+        AddChild(m_json, element.m_json);
+        return;
+    }
+
     cJSON* p = NULL;
-    switch(element.getType()) {
+    switch(element.m_type) {
     case cJSON_False:
-        p = cJSON_CreateFalse();
-        break;
-
     case cJSON_True:
-        p = cJSON_CreateTrue();
-        break;
-
     case cJSON_NULL:
-        p = cJSON_CreateNull();
+        p = m_json->arena->NewNode(element.m_type);
         break;
 
     case cJSON_Number:
-        p = cJSON_CreateNumber(element.m_valueNumer);
+        p = m_json->arena->NewNode(cJSON_Number);
+        p->valuedouble = element.m_valueNumer;
+        p->valueint = (int)element.m_valueNumer;
         break;
 
     case cJSON_String:
-        p = cJSON_CreateString(element.m_valueString.c_str());
-        break;
-    case cJSON_Array:
-    case cJSON_Object:
-        p = element.m_json;
+        p = m_json->arena->NewNode(cJSON_String);
+        p->valuestring = m_json->arena->NewString(element.m_valueString.c_str(), element.m_valueString.length());
+        p->valueLen = element.m_valueString.length();
         break;
     }
     if(p) {
-        cJSON_AddItemToArray(m_json, p);
+        LinkChild(m_json, p);
     }
 }
 
 JSONItem JSONItem::createArray(const wxString& name)
 {
-    JSONItem arr(cJSON_CreateArray());
+    JSONItem arr(JSONArena::Create(cJSON_Array));
     arr.setName(name);
     arr.setType(cJSON_Array);
     return arr;
@@ -328,7 +469,7 @@ JSONItem JSONItem::createArray(const wxString& name)
 
 JSONItem JSONItem::createObject(const wxString& name)
 {
-    JSONItem obj(cJSON_CreateObject());
+    JSONItem obj(JSONArena::Create(cJSON_Object));
     obj.setName(name);
     obj.setType(cJSON_Object);
     return obj;
@@ -339,13 +480,7 @@ char* JSONItem::FormatRawString(bool formatted) const
     if(!m_json) {
         return NULL;
     }
-
-    if(formatted) {
-        return cJSON_Print(m_json);
-
-    } else {
-        return cJSON_PrintUnformatted(m_json);
-    }
+    return JSONWriter::Write(m_json, formatted);
 }
 
 wxString JSONItem::format(bool formatted) const
@@ -354,8 +489,9 @@ wxString JSONItem::format(bool formatted) const
         return wxT("");
     }
 
-    char* p = formatted ? cJSON_Print(m_json) : cJSON_PrintUnformatted(m_json);
-    wxString s(p, wxConvISO8859_1);
+    size_t len = 0;
+    char* p = JSONWriter::Write(m_json, formatted, &len);
+    wxString s(p, wxConvISO8859_1, len);
     free(p);
     return s;
 }
@@ -408,7 +544,7 @@ int JSONItem::arraySize() const
     if(m_json->type != cJSON_Array)
         return 0;
 
-    return cJSON_GetArraySize(m_json);
+    return m_json->count;
 }
 
 JSONItem& JSONItem::addProperty(const wxString& name, bool value)
@@ -465,8 +601,9 @@ wxArrayString JSONItem::toArrayString(const wxArrayString& defaultValue) const
     }
 
     wxArrayString arr;
-    for(int i = 0; i < arraySize(); i++) {
-        arr.Add(arrayItem(i).toString());
+    arr.Alloc(m_json->count);
+    for(cJSON* child = m_json->child; child; child = child->next) {
+        arr.Add(JSONItem(child).toString());
     }
     return arr;
 }
@@ -477,8 +614,16 @@ bool JSONItem::hasNamedObject(const wxString& name) const
         return false;
     }
 
-    cJSON* obj = cJSON_GetObjectItem(m_json, name.mb_str(wxConvUTF8).data());
-    return obj != NULL;
+    const wxCharBuffer cb = name.mb_str(wxConvUTF8);
+    return FindChild(m_json, cb.data(), cb.length()) != NULL;
+}
+
+bool JSONItem::hasNamedObject(const char* name) const
+{
+    if(!m_json) {
+        return false;
+    }
+    return FindChild(m_json, name, strlen(name)) != NULL;
 }
 #if wxUSE_GUI
 JSONItem& JSONItem::addProperty(const wxString& name, const wxPoint& pt)
@@ -505,7 +650,7 @@ wxPoint JSONItem::toPoint() const
         return wxDefaultPosition;
     }
 
-    wxString str = m_json->valuestring;
+    wxString str(m_json->valuestring, wxConvUTF8, m_json->valueLen);
     wxString x = str.BeforeFirst(',');
     wxString y = str.AfterFirst(',');
 
@@ -525,7 +670,7 @@ wxColour JSONItem::toColour(const wxColour& defaultColour) const
     if(m_json->type != cJSON_String) {
         return defaultColour;
     }
-    return wxColour(m_json->valuestring);
+    return wxColour(wxString(m_json->valuestring, wxConvUTF8, m_json->valueLen));
 }
 
 wxSize JSONItem::toSize() const
@@ -537,11 +682,7 @@ wxSize JSONItem::toSize() const
 
 JSONItem& JSONItem::addProperty(const wxString& name, const JSONItem& element)
 {
-    if(!m_json) {
-        return *this;
-    }
-    cJSON_AddItemToObject(m_json, name.mb_str(wxConvUTF8).data(), element.m_json);
-    return *this;
+    return addProperty(name, element.m_json);
 }
 
 void JSONItem::removeProperty(const wxString& name)
@@ -550,7 +691,12 @@ void JSONItem::removeProperty(const wxString& name)
     if(!m_json) {
         return;
     }
-    cJSON_DeleteItemFromObject(m_json, name.mb_str(wxConvUTF8).data());
+    const wxCharBuffer cb = name.mb_str(wxConvUTF8);
+    cJSON* child = FindChild(m_json, cb.data(), cb.length());
+    if(child) {
+        RemoveChild(m_json, child);
+        m_json->arena->Release(child);
+    }
 }
 #if wxUSE_GUI
 JSONItem& JSONItem::addProperty(const wxString& name, const wxStringMap_t& stringMap)
@@ -581,9 +727,10 @@ wxStringMap_t JSONItem::toStringMap() const
         return res;
     }
 
-    for(int i = 0; i < arraySize(); ++i) {
-        wxString key = arrayItem(i).namedObject("key").toString();
-        wxString val = arrayItem(i).namedObject("value").toString();
+    for(cJSON* child = m_json->child; child; child = child->next) {
+        JSONItem item(child);
+        wxString key = item.namedObject("key").toString();
+        wxString val = item.namedObject("value").toString();
         res.insert(std::make_pair(key, val));
     }
     return res;
@@ -667,8 +814,14 @@ JSONItem JSONItem::detachProperty(const wxString& name)
     if(!m_json) {
         return JSONItem(NULL);
     }
-    cJSON* j = cJSON_DetachItemFromObject(m_json, name.c_str());
-    return JSONItem(j);
+    const wxCharBuffer cb = name.mb_str(wxConvUTF8);
+    cJSON* child = FindChild(m_json, cb.data(), cb.length());
+    if(!child) {
+        return JSONItem(NULL);
+    }
+    RemoveChild(m_json, child);
+    // the detached element is owned by the caller, move it into its own arena
+    return JSONItem(m_json->arena->Detach(child));
 }
 
 wxFileName JSONItem::toFileName() const
@@ -676,7 +829,7 @@ wxFileName JSONItem::toFileName() const
     if(!m_json) {
         return wxFileName();
     }
-    return wxFileName(m_valueString);
+    return wxFileName(toString());
 }
 
 JSONItem& JSONItem::addProperty(const wxString& name, const wxFileName& filename)
@@ -700,9 +853,10 @@ JSONItem JSONItem::AddObject(const wxString& name)
 
 JSONItem& JSONItem::addProperty(const wxString& name, cJSON* pjson)
 {
-    if(!m_json) {
+    if(!m_json || !pjson) {
         return *this;
     }
-    cJSON_AddItemToObject(m_json, name.mb_str(wxConvUTF8).data(), pjson);
+    const wxCharBuffer cb = name.mb_str(wxConvUTF8);
+    SetNodeName(AddChild(m_json, pjson), cb.data(), cb.length());
     return *this;
 }
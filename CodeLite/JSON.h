@@ -32,7 +32,7 @@
 #include <wx/gdicmn.h>
 #include "codelite_exports.h"
 #include <map>
-#include "cJSON.h"
+#include "JSONNode.h"
 #if wxUSE_GUI
 #include <wx/arrstr.h>
 #include <wx/colour.h>
@@ -76,18 +76,22 @@ public:
 
     // Setters
     ////////////////////////////////////////////////
-    void setName(const wxString& m_name) { this->m_name = m_name; }
+    void setName(const wxString& name);
     void setType(int m_type) { this->m_type = m_type; }
-    int getType() const { return m_type; }
-    wxString getName() const { return m_name; }
+    int getType() const { return m_json ? m_json->type : m_type; }
+    wxString getName() const;
 
     // Readers
     ////////////////////////////////////////////////
     JSONItem namedObject(const wxString& name) const;
     bool hasNamedObject(const wxString& name) const;
+    // Lookups by UTF-8 name (e.g. a string literal), no conversion to wxString is involved
+    JSONItem namedObject(const char* name) const;
+    bool hasNamedObject(const char* name) const;
 
     JSONItem operator[](int index) const;
     JSONItem operator[](const wxString& name) const;
+    JSONItem operator[](const char* name) const { return namedObject(name); }
 
     bool toBool(bool defaultValue = false) const;
     wxString toString(const wxString& defaultValue = wxEmptyString) const;
@@ -217,6 +221,14 @@ protected:
 public:
     JSON(int type);
     JSON(const wxString& text);
+    /**
+     * @brief parse UTF-8 text. The text is neither copied nor modified, only the strings are copied into the document
+     */
+    JSON(const char* text, size_t len);
+    /**
+     * @brief parse UTF-8 text. The buffer is moved into the document, no copy is made
+     */
+    JSON(std::string&& text);
     JSON(const wxFileName& filename);
     JSON(JSONItem item);
     JSON(cJSON* json);
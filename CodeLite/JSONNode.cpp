@@ -0,0 +1,741 @@
+#include "JSONNode.h"
+#include <algorithm>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The first block of an arena, doubled for each new block up to MAX_BLOCK_SIZE
+#define MIN_BLOCK_SIZE 256
+#define MAX_BLOCK_SIZE (1024 * 1024)
+// The first block of an arena created for a single root (e.g. JSONItem::createObject()): the node and a short name
+#define ROOT_BLOCK_SIZE (sizeof(JSONNode) + 32)
+// A released string is reused for a shorter one, the rest of it is kept if at least this long
+#define MIN_FREE_STRING 8
+
+namespace
+{
+/**
+ * @brief parse a JSON text. In place: the strings are unescaped into the text itself and null terminated, the nodes
+ * point to them. Otherwise the text is left untouched and the strings are unescaped into the arena
+ */
+class JSONParser
+{
+    JSONArena* m_arena;
+    const char* m_end;
+    bool m_inPlace;
+
+public:
+    JSONParser(JSONArena* arena, const char* end, bool inPlace)
+        : m_arena(arena)
+        , m_end(end)
+        , m_inPlace(inPlace)
+    {
+    }
+
+    // the character at 'p', 0 past the end of the text
+    inline char Peek(const char* p) const { return p < m_end ? *p : 0; }
+
+    inline const char* Skip(const char* p) const
+    {
+        while(p < m_end && *p && (unsigned char)*p <= 32) {
+            ++p;
+        }
+        return p;
+    }
+
+    inline bool Match(const char* p, const char* word, size_t len) const
+    {
+        return (size_t)(m_end - p) >= len && strncmp(p, word, len) == 0;
+    }
+
+    static inline void AddChild(JSONNode* parent, JSONNode* child)
+    {
+        child->prev = parent->lastChild;
+        if(parent->lastChild) {
+            parent->lastChild->next = child;
+        } else {
+            parent->child = child;
+        }
+        parent->lastChild = child;
+        ++parent->count;
+    }
+
+    static unsigned ParseHex4(const char*& p, const char* end)
+    {
+        unsigned value = 0;
+        for(int i = 0; i < 4 && p < end; ++i) {
+            char ch = *p;
+            if(ch >= '0' && ch <= '9') {
+                value = (value << 4) | (ch - '0');
+            } else if(ch >= 'a' && ch <= 'f') {
+                value = (value << 4) | (ch - 'a' + 10);
+            } else if(ch >= 'A' && ch <= 'F') {
+                value = (value << 4) | (ch - 'A' + 10);
+            } else {
+                break;
+            }
+            ++p;
+        }
+        return value;
+    }
+
+    /**
+     * @brief parse the string starting at 'p' (which points to the opening quote)
+     * @return a pointer past the closing quote, or nullptr
+     */
+    const char* ParseString(const char* p, const char*& str, size_t& len)
+    {
+        if(Peek(p) != '"') {
+            return nullptr;
+        }
+        // find the closing quote first: the unescaped string is never longer than its text
+        const char* start = p + 1;
+        const char* close = start;
+        while(close < m_end && *close && *close != '"') {
+            if(*close == '\\' && Peek(close + 1)) {
+                ++close;
+            }
+            ++close;
+        }
+
+        const char* r = start;
+        char* w;
+        if(m_inPlace) {
+            // nothing to unescape until the first backslash
+            while(r < close && *r != '\\') {
+                ++r;
+            }
+            w = const_cast<char*>(r);
+            str = start;
+        } else {
+            w = (char*)m_arena->Allocate(close - start + 1);
+            str = w;
+        }
+        while(r < close) {
+            if(*r != '\\') {
+                *w++ = *r++;
+                continue;
+            }
+            ++r;
+            if(r == close) {
+                break;
+            }
+            switch(*r) {
+            case 'b':
+                *w++ = '\b';
+                break;
+            case 'f':
+                *w++ = '\f';
+                break;
+            case 'n':
+                *w++ = '\n';
+                break;
+            case 'r':
+                *w++ = '\r';
+                break;
+            case 't':
+                *w++ = '\t';
+                break;
+            case 'u': {
+                // transcode UTF-16 to UTF-8
+                ++r;
+                unsigned uc = ParseHex4(r, close);
+                --r;
+                if((uc >= 0xDC00 && uc <= 0xDFFF) || uc == 0) {
+                    break;
+                }
+                if(uc >= 0xD800 && uc <= 0xDBFF) {
+                    // surrogate pair
+                    if(close - r < 3 || r[1] != '\\' || r[2] != 'u') {
+                        break;
+                    }
+                    r += 3;
+                    unsigned uc2 = ParseHex4(r, close);
+                    --r;
+                    if(uc2 < 0xDC00 || uc2 > 0xDFFF) {
+                        break;
+                    }
+                    uc = 0x10000 | ((uc & 0x3FF) << 10) | (uc2 & 0x3FF);
+                }
+                if(uc < 0x80) {
+                    *w++ = (char)uc;
+                } else if(uc < 0x800) {
+                    *w++ = (char)(0xC0 | (uc >> 6));
+                    *w++ = (char)(0x80 | (uc & 0x3F));
+                } else if(uc < 0x10000) {
+                    *w++ = (char)(0xE0 | (uc >> 12));
+                    *w++ = (char)(0x80 | ((uc >> 6) & 0x3F));
+                    *w++ = (char)(0x80 | (uc & 0x3F));
+                } else {
+                    *w++ = (char)(0xF0 | (uc >> 18));
+                    *w++ = (char)(0x80 | ((uc >> 12) & 0x3F));
+                    *w++ = (char)(0x80 | ((uc >> 6) & 0x3F));
+                    *w++ = (char)(0x80 | (uc & 0x3F));
+                }
+            } break;
+            default:
+                *w++ = *r;
+                break;
+            }
+            ++r;
+        }
+        const char* next = Peek(close) == '"' ? close + 1 : close;
+        // in place, 'w' never goes past the closing quote
+        *w = 0;
+        len = w - str;
+        return next;
+    }
+
+    const char* ParseNumber(JSONNode* node, const char* num) const
+    {
+        double n = 0, sign = 1, scale = 0;
+        int subscale = 0, signsubscale = 1;
+
+        if(Peek(num) == '-') {
+            sign = -1;
+            ++num;
+        }
+        if(Peek(num) == '0') {
+            ++num;
+        }
+        if(Peek(num) >= '1' && Peek(num) <= '9') {
+            do {
+                n = (n * 10.0) + (*num++ - '0');
+            } while(Peek(num) >= '0' && Peek(num) <= '9');
+        }
+        if(Peek(num) == '.' && Peek(num + 1) >= '0' && Peek(num + 1) <= '9') {
+            ++num;
+            do {
+                n = (n * 10.0) + (*num++ - '0');
+                --scale;
+            } while(Peek(num) >= '0' && Peek(num) <= '9');
+        }
+        if(Peek(num) == 'e' || Peek(num) == 'E') {
+            ++num;
+            if(Peek(num) == '+') {
+                ++num;
+            } else if(Peek(num) == '-') {
+                signsubscale = -1;
+                ++num;
+            }
+            while(Peek(num) >= '0' && Peek(num) <= '9') {
+                subscale = (subscale * 10) + (*num++ - '0');
+            }
+        }
+        if(scale != 0 || subscale != 0) {
+            n = n * pow(10.0, (scale + subscale * signsubscale));
+        }
+        n *= sign;
+        node->type = cJSON_Number;
+        node->valuedouble = n;
+        node->valueint = (int)n;
+        return num;
+    }
+
+    const char* ParseValue(JSONNode* node, const char* p)
+    {
+        char ch = Peek(p);
+        switch(ch) {
+        case 'n':
+            if(Match(p, "null", 4)) {
+                node->type = cJSON_NULL;
+                return p + 4;
+            }
+            return nullptr;
+        case 'f':
+            if(Match(p, "false", 5)) {
+                node->type = cJSON_False;
+                return p + 5;
+            }
+            return nullptr;
+        case 't':
+            if(Match(p, "true", 4)) {
+                node->type = cJSON_True;
+                node->valueint = 1;
+                return p + 4;
+            }
+            return nullptr;
+        case '"':
+            node->type = cJSON_String;
+            return ParseString(p, node->valuestring, node->valueLen);
+        case '[':
+            return ParseArray(node, p);
+        case '{':
+            return ParseObject(node, p);
+        default:
+            if(ch == '-' || (ch >= '0' && ch <= '9')) {
+                return ParseNumber(node, p);
+            }
+            return nullptr;
+        }
+    }
+
+    const char* ParseArray(JSONNode* node, const char* p)
+    {
+        node->type = cJSON_Array;
+        p = Skip(p + 1);
+        if(Peek(p) == ']') {
+            return p + 1;
+        }
+        while(true) {
+            JSONNode* child = m_arena->NewNode(cJSON_NULL);
+            AddChild(node, child);
+            p = ParseValue(child, Skip(p));
+            if(!p) {
+                return nullptr;
+            }
+            p = Skip(p);
+            if(Peek(p) != ',') {
+                break;
+            }
+            ++p;
+        }
+        return Peek(p) == ']' ? p + 1 : nullptr;
+    }
+
+    const char* ParseObject(JSONNode* node, const char* p)
+    {
+        node->type = cJSON_Object;
+        p = Skip(p + 1);
+        if(Peek(p) == '}') {
+            return p + 1;
+        }
+        while(true) {
+            JSONNode* child = m_arena->NewNode(cJSON_NULL);
+            AddChild(node, child);
+            p = ParseString(Skip(p), child->name, child->nameLen);
+            if(!p) {
+                return nullptr;
+            }
+            p = Skip(p);
+            if(Peek(p) != ':') {
+                return nullptr;
+            }
+            p = ParseValue(child, Skip(p + 1));
+            if(!p) {
+                return nullptr;
+            }
+            p = Skip(p);
+            if(Peek(p) != ',') {
+                break;
+            }
+            ++p;
+        }
+        return Peek(p) == '}' ? p + 1 : nullptr;
+    }
+};
+} // namespace
+
+//-------------------------------------------------------------------------------
+// JSONArena
+//-------------------------------------------------------------------------------
+
+JSONArena::JSONArena(size_t blockSize)
+    : m_blockSize(blockSize)
+{
+}
+
+JSONArena::~JSONArena()
+{
+    for(JSONArena* arena : m_adopted) {
+        delete arena;
+    }
+    for(char* block : m_blocks) {
+        free(block);
+    }
+}
+
+void* JSONArena::Allocate(size_t bytes)
+{
+    // keep the allocations aligned for the nodes
+    bytes = (bytes + 7) & ~(size_t)7;
+    if(bytes > m_left) {
+        size_t blockSize = bytes > m_blockSize ? bytes : m_blockSize;
+        m_current = (char*)malloc(blockSize);
+        m_left = blockSize;
+        m_blocks.push_back(m_current);
+        if(m_blockSize < MIN_BLOCK_SIZE) {
+            m_blockSize = MIN_BLOCK_SIZE;
+        } else if(m_blockSize < MAX_BLOCK_SIZE) {
+            m_blockSize *= 2;
+        }
+    }
+    void* p = m_current;
+    m_current += bytes;
+    m_left -= bytes;
+    return p;
+}
+
+JSONNode* JSONArena::NewNode(int type)
+{
+    JSONNode* node = m_freeNodes;
+    if(node) {
+        m_freeNodes = node->next;
+    } else {
+        node = (JSONNode*)Allocate(sizeof(JSONNode));
+    }
+    memset(node, 0, sizeof(JSONNode));
+    node->type = type;
+    node->arena = this;
+    return node;
+}
+
+const char* JSONArena::NewString(const char* str, size_t len)
+{
+    char* p = nullptr;
+    std::multimap<size_t, char*>::iterator iter = m_freeStrings.lower_bound(len + 1);
+    if(iter != m_freeStrings.end()) {
+        p = iter->second;
+        size_t capacity = DoGetCapacity(p, len);
+        size_t left = iter->first - capacity;
+        m_freeStrings.erase(iter);
+        if(left >= MIN_FREE_STRING) {
+            m_freeStrings.insert(std::make_pair(left, p + capacity));
+        }
+    } else {
+        p = (char*)Allocate(len + 1);
+    }
+    if(len) {
+        memcpy(p, str, len);
+    }
+    p[len] = 0;
+    return p;
+}
+
+JSONNode* JSONArena::CopyNode(const JSONNode* node)
+{
+    JSONNode* copy = NewNode(node->type);
+    copy->valuedouble = node->valuedouble;
+    copy->valueint = node->valueint;
+    if(node->name) {
+        copy->name = NewString(node->name, node->nameLen);
+        copy->nameLen = node->nameLen;
+    }
+    if(node->valuestring) {
+        copy->valuestring = NewString(node->valuestring, node->valueLen);
+        copy->valueLen = node->valueLen;
+    }
+    for(const JSONNode* child = node->child; child; child = child->next) {
+        JSONParser::AddChild(copy, CopyNode(child));
+    }
+    return copy;
+}
+
+void JSONArena::Adopt(JSONArena* arena)
+{
+    arena->m_owner = this;
+    m_adopted.push_back(arena);
+}
+
+void JSONArena::DoDisown(JSONArena* arena)
+{
+    std::vector<JSONArena*>::iterator iter = std::find(m_adopted.begin(), m_adopted.end(), arena);
+    if(iter != m_adopted.end()) {
+        m_adopted.erase(iter);
+    }
+    arena->m_owner = nullptr;
+}
+
+void JSONArena::Release(JSONNode* node)
+{
+    if(node->arena != this) {
+        // the children of our nodes belong to this arena or are the roots of the arenas it adopted
+        JSONArena* arena = node->arena;
+        DoDisown(arena);
+        delete arena;
+        return;
+    }
+
+    JSONNode* child = node->child;
+    while(child) {
+        JSONNode* next = child->next;
+        Release(child);
+        child = next;
+    }
+    ReleaseString(node->name, node->nameLen);
+    ReleaseString(node->valuestring, node->valueLen);
+    node->next = m_freeNodes;
+    m_freeNodes = node;
+}
+
+void JSONArena::ReleaseString(const char* str, size_t len)
+{
+    if(!str) {
+        return;
+    }
+    size_t capacity = DoGetCapacity(str, len);
+    if(capacity >= MIN_FREE_STRING) {
+        m_freeStrings.insert(std::make_pair(capacity, const_cast<char*>(str)));
+    }
+}
+
+JSONNode* JSONArena::Detach(JSONNode* node)
+{
+    if(node->arena != this) {
+        // already in its own arena
+        DoDisown(node->arena);
+        return node;
+    }
+    JSONNode* copy = Copy(node);
+    Release(node);
+    return copy;
+}
+
+JSONNode* JSONArena::Create(int type)
+{
+    JSONArena* arena = new JSONArena(ROOT_BLOCK_SIZE);
+    arena->m_root = arena->NewNode(type);
+    return arena->m_root;
+}
+
+JSONNode* JSONArena::Parse(std::string& text)
+{
+    // roughly one node per 32 bytes of text
+    size_t blockSize = MIN_BLOCK_SIZE;
+    while(blockSize < MAX_BLOCK_SIZE && blockSize < text.length() * 2) {
+        blockSize *= 2;
+    }
+    JSONArena* arena = new JSONArena(blockSize);
+    arena->m_text.swap(text);
+    arena->m_root = arena->NewNode(cJSON_NULL);
+
+    // std::string is always null terminated
+    const char* p = &arena->m_text[0];
+    JSONParser parser(arena, p + arena->m_text.length(), true);
+    if(!parser.ParseValue(arena->m_root, parser.Skip(p))) {
+        delete arena;
+        return nullptr;
+    }
+    return arena->m_root;
+}
+
+JSONNode* JSONArena::Parse(const char* text, size_t len)
+{
+    // the nodes and the strings
+    size_t blockSize = MIN_BLOCK_SIZE;
+    while(blockSize < MAX_BLOCK_SIZE && blockSize < len * 3) {
+        blockSize *= 2;
+    }
+    JSONArena* arena = new JSONArena(blockSize);
+    arena->m_root = arena->NewNode(cJSON_NULL);
+
+    JSONParser parser(arena, text + len, false);
+    if(!parser.ParseValue(arena->m_root, parser.Skip(text))) {
+        delete arena;
+        return nullptr;
+    }
+    return arena->m_root;
+}
+
+JSONNode* JSONArena::Copy(const JSONNode* node)
+{
+    JSONArena* arena = new JSONArena(MIN_BLOCK_SIZE);
+    arena->m_root = arena->CopyNode(node);
+    return arena->m_root;
+}
+
+bool JSONArena::IsOwnedRoot(const JSONNode* node)
+{
+    return node && node->arena->m_root == node && !node->arena->m_owner;
+}
+
+void JSONArena::Destroy(JSONNode* root)
+{
+    if(IsOwnedRoot(root)) {
+        delete root->arena;
+    }
+}
+
+//-------------------------------------------------------------------------------
+// JSONWriter
+//-------------------------------------------------------------------------------
+
+JSONWriter::JSONWriter(bool formatted)
+    : m_formatted(formatted)
+{
+}
+
+JSONWriter::~JSONWriter() { free(m_buffer); }
+
+void JSONWriter::Reserve(size_t bytes)
+{
+    if(m_length + bytes <= m_capacity) {
+        return;
+    }
+    size_t capacity = m_capacity ? m_capacity * 2 : 256;
+    if(capacity < m_length + bytes) {
+        capacity = m_length + bytes;
+    }
+    m_buffer = (char*)realloc(m_buffer, capacity);
+    m_capacity = capacity;
+}
+
+void JSONWriter::Append(const char* str, size_t len)
+{
+    Reserve(len);
+    memcpy(m_buffer + m_length, str, len);
+    m_length += len;
+}
+
+void JSONWriter::Indent(int depth)
+{
+    if(depth <= 0) {
+        return;
+    }
+    Reserve(depth);
+    memset(m_buffer + m_length, ' ', depth);
+    m_length += depth;
+}
+
+void JSONWriter::WriteString(const char* str, size_t len)
+{
+    if(!str) {
+        str = "";
+        len = 0;
+    }
+    Reserve(len + 2);
+    Append('"');
+    const char* run = str;
+    const char* end = str + len;
+    for(const char* p = str; p < end; ++p) {
+        unsigned char ch = *p;
+        if(ch > 31 && ch != '"' && ch != '\\') {
+            continue;
+        }
+        Append(run, p - run);
+        run = p + 1;
+        Append('\\');
+        switch(ch) {
+        case '\\':
+        case '"':
+            Append((char)ch);
+            break;
+        case '\b':
+            Append('b');
+            break;
+        case '\f':
+            Append('f');
+            break;
+        case '\n':
+            Append('n');
+            break;
+        case '\r':
+            Append('r');
+            break;
+        case '\t':
+            Append('t');
+            break;
+        default: {
+            char escaped[8];
+            int count = snprintf(escaped, sizeof(escaped), "u%04x", ch);
+            Append(escaped, count);
+        } break;
+        }
+    }
+    Append(run, end - run);
+    Append('"');
+}
+
+void JSONWriter::WriteNumber(const JSONNode* node)
+{
+    // "%.0f" of DBL_MAX is 309 digits long
+    char str[DBL_MAX_10_EXP + 32];
+    int count;
+    double d = node->valuedouble;
+    if(fabs(((double)node->valueint) - d) <= DBL_EPSILON && d <= INT_MAX && d >= INT_MIN) {
+        count = snprintf(str, sizeof(str), "%d", node->valueint);
+    } else if(fabs(floor(d) - d) <= DBL_EPSILON) {
+        count = snprintf(str, sizeof(str), "%.0f", d);
+    } else if(fabs(d) < 1.0e-6 || fabs(d) > 1.0e9) {
+        count = snprintf(str, sizeof(str), "%e", d);
+    } else {
+        count = snprintf(str, sizeof(str), "%f", d);
+    }
+    if(count > 0) {
+        Append(str, count);
+    }
+}
+
+void JSONWriter::WriteValue(const JSONNode* node, int depth)
+{
+    switch(node->type) {
+    case cJSON_NULL:
+        Append("null", 4);
+        break;
+    case cJSON_False:
+        Append("false", 5);
+        break;
+    case cJSON_True:
+        Append("true", 4);
+        break;
+    case cJSON_Number:
+        WriteNumber(node);
+        break;
+    case cJSON_String:
+        WriteString(node->valuestring, node->valueLen);
+        break;
+    case cJSON_Array:
+        Append('[');
+        for(const JSONNode* child = node->child; child; child = child->next) {
+            WriteValue(child, depth + 1);
+            if(child->next) {
+                Append(',');
+                if(m_formatted) {
+                    Append(' ');
+                }
+            }
+        }
+        Append(']');
+        break;
+    case cJSON_Object:
+        ++depth;
+        Append('{');
+        if(m_formatted) {
+            Append('\n');
+        }
+        for(const JSONNode* child = node->child; child; child = child->next) {
+            if(m_formatted) {
+                Indent(depth);
+            }
+            WriteString(child->name, child->nameLen);
+            Append(':');
+            if(m_formatted) {
+                Append(' ');
+            }
+            WriteValue(child, depth);
+            if(child->next) {
+                Append(',');
+            }
+            if(m_formatted) {
+                Append('\n');
+            }
+        }
+        if(m_formatted) {
+            Indent(depth - 1);
+        }
+        Append('}');
+        break;
+    default:
+        break;
+    }
+}
+
+char* JSONWriter::Write(const JSONNode* node, bool formatted, size_t* length)
+{
+    if(!node) {
+        return nullptr;
+    }
+    JSONWriter writer(formatted);
+    writer.WriteValue(node, 0);
+    writer.Append('\0');
+
+    char* buffer = writer.m_buffer;
+    if(length) {
+        *length = writer.m_length - 1;
+    }
+    writer.m_buffer = nullptr;
+    return buffer;
+}
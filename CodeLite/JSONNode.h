@@ -0,0 +1,202 @@
+#ifndef JSONNODE_H
+#define JSONNODE_H
+
+#include "codelite_exports.h"
+#include <map>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// The node types. The names are the ones of cJSON (the library previously used by JSON/JSONItem), so the code using
+// them keeps compiling
+#define cJSON_False 0
+#define cJSON_True 1
+#define cJSON_NULL 2
+#define cJSON_Number 3
+#define cJSON_String 4
+#define cJSON_Array 5
+#define cJSON_Object 6
+
+class JSONArena;
+
+/**
+ * @brief a JSON value. Nodes are allocated from a JSONArena: the arena releases all its nodes at once, the nodes (and
+ * strings) of a subtree removed from the tree are reused by the arena. The strings are null terminated and either
+ * point into the parsed text (they are unescaped in place) or were copied into the arena
+ */
+struct JSONNode {
+    JSONNode* next;
+    JSONNode* prev;
+    JSONNode* child;
+    JSONNode* lastChild;
+    JSONArena* arena;
+    const char* name;        // the property name (nullptr when not set)
+    const char* valuestring; // cJSON_String only
+    size_t nameLen;
+    size_t valueLen;
+    double valuedouble;
+    int valueint;
+    int type;
+    int count; // number of children
+    // the last child accessed by index, so iterating an array by index is not quadratic
+    JSONNode* cachedChild;
+    int cachedIndex;
+};
+
+// The type exposed by JSON/JSONItem
+typedef JSONNode cJSON;
+
+/**
+ * @class JSONArena
+ * @brief owns the nodes (and strings) of a JSON tree. The node returned by Create(), Parse() or Copy() is the root of
+ * a new arena: deleting it with Destroy() releases the whole tree. When a root is added to another tree, its arena is
+ * adopted by the arena of that tree. A subtree removed from the tree is given back with Release(): an adopted arena is
+ * deleted, the other nodes and strings go to free lists used by the next allocations, so a long lived document
+ * (e.g. a configuration file whose entries are replaced over and over) does not grow
+ */
+class WXDLLIMPEXP_CL JSONArena
+{
+    std::vector<char*> m_blocks;
+    char* m_current = nullptr;
+    size_t m_left = 0;
+    size_t m_blockSize;
+    std::string m_text; // the parsed text
+    std::vector<JSONArena*> m_adopted;
+    JSONNode* m_root = nullptr;
+    JSONArena* m_owner = nullptr;
+    JSONNode* m_freeNodes = nullptr;            // linked by 'next'
+    std::multimap<size_t, char*> m_freeStrings; // by capacity (including the terminating null)
+
+    /**
+     * @brief remove the adopted 'arena' from the arenas owned by this one
+     */
+    void DoDisown(JSONArena* arena);
+
+    /**
+     * @brief the strings allocated from the blocks take a multiple of 8 bytes, the ones in the parsed text their
+     * exact length
+     */
+    size_t DoGetCapacity(const char* str, size_t len) const
+    {
+        if(str >= m_text.c_str() && str < m_text.c_str() + m_text.length()) {
+            return len + 1;
+        }
+        return (len + 8) & ~(size_t)7;
+    }
+
+protected:
+    JSONArena(size_t blockSize);
+
+public:
+    ~JSONArena();
+
+    /**
+     * @brief create a root node of the given type
+     */
+    static JSONNode* Create(int type);
+
+    /**
+     * @brief parse UTF-8 text. The text is swapped into the arena (i.e. 'text' is empty on return) and parsed in
+     * place
+     * @return the root node, or nullptr if the text is not a valid JSON value
+     */
+    static JSONNode* Parse(std::string& text);
+
+    /**
+     * @brief parse 'len' bytes of UTF-8 text (not necessarily null terminated). The text is not copied nor modified:
+     * only the strings are copied (unescaped) into the arena
+     * @return the root node, or nullptr if the text is not a valid JSON value
+     */
+    static JSONNode* Parse(const char* text, size_t len);
+
+    /**
+     * @brief deep copy 'node' into a new arena
+     */
+    static JSONNode* Copy(const JSONNode* node);
+
+    /**
+     * @brief delete the arena of 'root'. Nothing is done if 'root' is not the root of its arena, or if its arena was
+     * adopted by another one
+     */
+    static void Destroy(JSONNode* root);
+
+    /**
+     * @brief return true if 'node' is the root of an arena which is not part of another tree
+     */
+    static bool IsOwnedRoot(const JSONNode* node);
+
+    void* Allocate(size_t bytes);
+    JSONNode* NewNode(int type);
+    /**
+     * @brief copy 'len' bytes of 'str' into the arena and null terminate them
+     */
+    const char* NewString(const char* str, size_t len);
+    /**
+     * @brief deep copy 'node' into this arena
+     */
+    JSONNode* CopyNode(const JSONNode* node);
+    /**
+     * @brief take the ownership of 'arena'
+     */
+    void Adopt(JSONArena* arena);
+
+    /**
+     * @brief give back the memory of 'node' and its children. 'node' was removed from a tree and its parent belongs
+     * to this arena
+     */
+    void Release(JSONNode* node);
+
+    /**
+     * @brief give back the memory of a string allocated by this arena (or pointing into its parsed text)
+     */
+    void ReleaseString(const char* str, size_t len);
+
+    /**
+     * @brief move 'node', removed from a tree whose parent belongs to this arena, into its own arena
+     * @return the root of the new arena
+     */
+    JSONNode* Detach(JSONNode* node);
+
+    JSONNode* GetRoot() const { return m_root; }
+    JSONArena* GetOwner() const { return m_owner; }
+};
+
+/**
+ * @class JSONWriter
+ * @brief serialise a JSON tree into a single growing buffer. The output is the same as the one of cJSON: compact, or
+ * formatted with one space of indentation per level and arrays written on a single line
+ */
+class WXDLLIMPEXP_CL JSONWriter
+{
+    char* m_buffer = nullptr;
+    size_t m_length = 0;
+    size_t m_capacity = 0;
+    bool m_formatted;
+
+protected:
+    JSONWriter(bool formatted);
+    ~JSONWriter();
+
+    void Reserve(size_t bytes);
+    inline void Append(char ch)
+    {
+        if(m_length + 1 > m_capacity) {
+            Reserve(1);
+        }
+        m_buffer[m_length++] = ch;
+    }
+    void Append(const char* str, size_t len);
+    void Indent(int depth);
+    void WriteString(const char* str, size_t len);
+    void WriteNumber(const JSONNode* node);
+    void WriteValue(const JSONNode* node, int depth);
+
+public:
+    /**
+     * @brief return the text of 'node' (null terminated), allocated with malloc(): the caller should free() it
+     * @param length if not null, set to the length of the text
+     */
+    static char* Write(const JSONNode* node, bool formatted, size_t* length = nullptr);
+};
+
+#endif // JSONNODE_H
@@ -0,0 +1,21 @@
+#ifndef CANCELREQUESTNOTIFICATION_HPP
+#define CANCELREQUESTNOTIFICATION_HPP
+
+#include "LSP/Notification.h"
+
+namespace LSP
+{
+
+/**
+ * @brief $/cancelRequest: tell the server that the reply for the request 'id' is no longer needed
+ */
+class WXDLLIMPEXP_CL CancelRequestNotification : public Notification
+{
+public:
+    CancelRequestNotification(int id);
+    virtual ~CancelRequestNotification();
+};
+
+} // namespace LSP
+
+#endif // CANCELREQUESTNOTIFICATION_HPP
@@ -61,5 +61,6 @@ bool LSP::CompletionRequest::IsValidAt(const wxFileName& filename, size_t line,
     const wxFileName& fn = m_params->As<CompletionParams>()->GetTextDocument().GetFilename();
     size_t calledLine = m_params->As<CompletionParams>()->GetPosition().GetLine();
     size_t calledColumn = m_params->As<CompletionParams>()->GetPosition().GetCharacter();
-    return (fn == filename) && (calledLine == line) && (calledColumn == col);
+    // the reply is still useful if the user kept typing on the same line
+    return (fn == filename) && (calledLine == line) && (col >= calledColumn);
 }
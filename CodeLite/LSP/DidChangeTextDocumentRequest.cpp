@@ -18,4 +18,17 @@ LSP::DidChangeTextDocumentRequest::DidChangeTextDocumentRequest(const wxFileName
     m_params->As<DidChangeTextDocumentParams>()->SetContentChanges({ changeEvent });
 }
 
+LSP::DidChangeTextDocumentRequest::DidChangeTextDocumentRequest(
+    const wxFileName& filename, const std::vector<TextDocumentContentChangeEvent>& changes)
+{
+    SetMethod("textDocument/didChange");
+    m_params.reset(new DidChangeTextDocumentParams());
+
+    VersionedTextDocumentIdentifier id;
+    id.SetVersion(++counter);
+    id.SetFilename(filename);
+    m_params->As<DidChangeTextDocumentParams>()->SetTextDocument(id);
+    m_params->As<DidChangeTextDocumentParams>()->SetContentChanges(changes);
+}
+
 LSP::DidChangeTextDocumentRequest::~DidChangeTextDocumentRequest() {}
@@ -1,8 +1,10 @@
 #ifndef DIDCHANGE_TEXTDOCUMENTREQUEST_H
 #define DIDCHANGE_TEXTDOCUMENTREQUEST_H
 
+#include <vector>
 #include <wx/filename.h>
 #include "LSP/Notification.h"
+#include "LSP/basic_types.h"
 
 namespace LSP
 {
@@ -10,7 +12,14 @@ namespace LSP
 class WXDLLIMPEXP_CL DidChangeTextDocumentRequest : public LSP::Notification
 {
 public:
+    /**
+     * @brief full sync: send the whole document content
+     */
     DidChangeTextDocumentRequest(const wxFileName& filename, const std::string& fileContent);
+    /**
+     * @brief incremental sync: send the changes done since the previous notification, in the order they were made
+     */
+    DidChangeTextDocumentRequest(const wxFileName& filename, const std::vector<TextDocumentContentChangeEvent>& changes);
     virtual ~DidChangeTextDocumentRequest();
 };
 
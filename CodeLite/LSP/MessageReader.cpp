@@ -0,0 +1,190 @@
+#include "MessageReader.h"
+#include "file_logger.h"
+#include <algorithm>
+#include <ctype.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY (64 * 1024)
+#define HEADER_CONTENT_LENGTH "content-length:"
+#define NO_POSITION ((size_t)-1)
+
+LSP::MessageReader::MessageReader()
+    : m_terminatorPos(NO_POSITION)
+{
+}
+
+LSP::MessageReader::~MessageReader() {}
+
+void LSP::MessageReader::Clear()
+{
+    m_head = 0;
+    m_size = 0;
+    m_scanned = 0;
+    m_headersLength = 0;
+    m_contentLength = 0;
+    m_terminatorPos = NO_POSITION;
+}
+
+void LSP::MessageReader::RestoreTerminator()
+{
+    if(m_terminatorPos != NO_POSITION) {
+        m_buffer[m_terminatorPos] = m_savedByte;
+        m_terminatorPos = NO_POSITION;
+    }
+}
+
+void LSP::MessageReader::Consume(size_t bytes)
+{
+    m_head = (m_head + bytes) & (m_capacity - 1);
+    m_size -= bytes;
+}
+
+void LSP::MessageReader::Reserve(size_t bytes)
+{
+    // Grow the buffer if needed. The new buffer is also used to make the unread bytes contiguous (i.e. starting at 0)
+    size_t capacity = m_capacity ? m_capacity : INITIAL_CAPACITY;
+    while(capacity < bytes) {
+        capacity *= 2;
+    }
+    if(capacity == m_capacity && (m_head + m_size) <= m_capacity && bytes <= m_capacity) {
+        // nothing to do
+        return;
+    }
+
+    std::vector<char> buffer(capacity + 1);
+    size_t first = m_size;
+    if(m_capacity && (m_head + m_size) > m_capacity) {
+        first = m_capacity - m_head;
+    }
+    if(first) {
+        memcpy(buffer.data(), m_buffer.data() + m_head, first);
+    }
+    if(first < m_size) {
+        memcpy(buffer.data() + first, m_buffer.data(), m_size - first);
+    }
+    m_buffer.swap(buffer);
+    m_capacity = capacity;
+    m_head = 0;
+}
+
+void LSP::MessageReader::Append(const char* data, size_t len)
+{
+    RestoreTerminator();
+    if(len == 0) {
+        return;
+    }
+    if(m_size + len > m_capacity) {
+        Reserve(m_size + len);
+    }
+
+    // Copy the data at the tail, in two parts if it wraps around the end of the buffer
+    size_t tail = (m_head + m_size) & (m_capacity - 1);
+    size_t first = std::min(len, m_capacity - tail);
+    memcpy(m_buffer.data() + tail, data, first);
+    if(first < len) {
+        memcpy(m_buffer.data(), data + first, len - first);
+    }
+    m_size += len;
+}
+
+bool LSP::MessageReader::ReadHeaders()
+{
+    // Find the "\r\n\r\n" separator, without scanning the same bytes twice
+    size_t end = NO_POSITION;
+    for(size_t i = m_scanned; i + 3 < m_size; ++i) {
+        if(At(i) == '\r' && At(i + 1) == '\n' && At(i + 2) == '\r' && At(i + 3) == '\n') {
+            end = i;
+            break;
+        }
+    }
+    if(end == NO_POSITION) {
+        m_scanned = m_size > 3 ? m_size - 3 : 0;
+        return false;
+    }
+
+    // Parse the header lines, we only care about the Content-Length
+    bool found = false;
+    size_t contentLength = 0;
+    size_t lineStart = 0;
+    while(lineStart < end) {
+        size_t lineEnd = lineStart;
+        while(lineEnd < end && At(lineEnd) != '\n') {
+            ++lineEnd;
+        }
+
+        const size_t nameLen = sizeof(HEADER_CONTENT_LENGTH) - 1;
+        size_t pos = lineStart;
+        while(pos < lineEnd && (At(pos) == ' ' || At(pos) == '\r')) {
+            ++pos;
+        }
+        if((lineEnd - pos) > nameLen) {
+            bool match = true;
+            for(size_t i = 0; match && i < nameLen; ++i) {
+                match = (::tolower((unsigned char)At(pos + i)) == HEADER_CONTENT_LENGTH[i]);
+            }
+            if(match) {
+                pos += nameLen;
+                while(pos < lineEnd && At(pos) == ' ') {
+                    ++pos;
+                }
+                contentLength = 0;
+                while(pos < lineEnd && At(pos) >= '0' && At(pos) <= '9') {
+                    contentLength = (contentLength * 10) + (At(pos) - '0');
+                    ++pos;
+                }
+                found = true;
+            }
+        }
+        lineStart = lineEnd + 1;
+    }
+
+    m_scanned = 0;
+    if(!found) {
+        // Can't tell where this message ends: drop its headers and hope for the best
+        clWARNING() << "LSP: received a message without Content-Length header, ignoring it" << clEndl;
+        Consume(end + 4);
+        return false;
+    }
+    m_headersLength = end + 4;
+    m_contentLength = contentLength;
+    return true;
+}
+
+bool LSP::MessageReader::Next(const char*& data, size_t& len)
+{
+    RestoreTerminator();
+    while(m_headersLength == 0) {
+        size_t sizeBefore = m_size;
+        if(ReadHeaders()) {
+            break;
+        }
+        if(m_size == sizeBefore) {
+            // incomplete headers
+            return false;
+        }
+    }
+
+    if(m_size < (m_headersLength + m_contentLength)) {
+        // incomplete message
+        return false;
+    }
+
+    Consume(m_headersLength);
+    if((m_head + m_contentLength) > m_capacity) {
+        // the content wraps around the end of the buffer, make it contiguous
+        Reserve(m_capacity);
+    }
+
+    // Null terminate the content. The terminator either uses the extra byte at the end of the buffer or overwrites
+    // the first byte of the next message, which is restored on the next call
+    m_terminatorPos = m_head + m_contentLength;
+    m_savedByte = m_buffer[m_terminatorPos];
+    m_buffer[m_terminatorPos] = 0;
+
+    data = m_buffer.data() + m_head;
+    len = m_contentLength;
+    Consume(m_contentLength);
+    m_headersLength = 0;
+    m_contentLength = 0;
+    return true;
+}
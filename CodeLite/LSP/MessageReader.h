@@ -0,0 +1,64 @@
+#ifndef LSP_MESSAGEREADER_H
+#define LSP_MESSAGEREADER_H
+
+#include "codelite_exports.h"
+#include <stddef.h>
+#include <vector>
+
+namespace LSP
+{
+
+/**
+ * @class MessageReader
+ * @brief collects the bytes received from a language server in a ring buffer and splits them into JSON-RPC
+ * messages using their "Content-Length" header. The messages are never converted: they are returned as UTF-8 spans of
+ * the buffer
+ */
+class WXDLLIMPEXP_CL MessageReader
+{
+    std::vector<char> m_buffer; // capacity + 1 bytes, the last one is used to terminate a message ending there
+    size_t m_capacity = 0;      // always a power of 2
+    size_t m_head = 0;          // position of the first unread byte
+    size_t m_size = 0;          // number of unread bytes
+    size_t m_scanned = 0;       // bytes already searched for the end of the headers
+    size_t m_headersLength = 0; // once the headers of the current message were read, their length
+    size_t m_contentLength = 0;
+    size_t m_terminatorPos;     // where the returned message was null terminated
+    char m_savedByte = 0;       // the byte overwritten by the terminator
+
+protected:
+    inline char At(size_t offset) const { return m_buffer[(m_head + offset) & (m_capacity - 1)]; }
+    void Consume(size_t bytes);
+    void Reserve(size_t bytes);
+    void RestoreTerminator();
+    bool ReadHeaders();
+
+public:
+    MessageReader();
+    virtual ~MessageReader();
+
+    /**
+     * @brief add bytes received from the server
+     */
+    void Append(const char* data, size_t len);
+
+    /**
+     * @brief if a complete message was received, remove it from the buffer and return its content (without the
+     * headers). The content is null terminated and remains valid until the next call to Append(), Next() or Clear()
+     */
+    bool Next(const char*& data, size_t& len);
+
+    /**
+     * @brief discard all the received bytes
+     */
+    void Clear();
+
+    /**
+     * @brief number of bytes received which are not part of a returned message yet
+     */
+    size_t GetSize() const { return m_size; }
+};
+
+} // namespace LSP
+
+#endif // LSP_MESSAGEREADER_H
@@ -9,6 +9,12 @@ LSP::ResponseError::ResponseError(const wxString& message, IPathConverter::Ptr_t
     FromJSON(json.toElement(), m_pathConverter);
 }
 
+LSP::ResponseError::ResponseError(const JSONItem& json, IPathConverter::Ptr_t pathConverter)
+    : m_pathConverter(pathConverter)
+{
+    FromJSON(json, m_pathConverter);
+}
+
 LSP::ResponseError::~ResponseError() {}
 
 void LSP::ResponseError::FromJSON(const JSONItem& json, IPathConverter::Ptr_t pathConverter)
@@ -31,6 +31,7 @@ public:
 
 public:
     ResponseError(const wxString& message, IPathConverter::Ptr_t pathConverter);
+    ResponseError(const JSONItem& json, IPathConverter::Ptr_t pathConverter);
     ResponseError();
     virtual ~ResponseError();
     void FromJSON(const JSONItem& json, IPathConverter::Ptr_t pathConverter);
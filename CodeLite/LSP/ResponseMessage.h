@@ -13,17 +13,13 @@ class WXDLLIMPEXP_CL ResponseMessage : public LSP::Message
 {
     int m_id = wxNOT_FOUND;
     wxSharedPtr<JSON> m_json;
-    wxString m_jsonMessage;
     IPathConverter::Ptr_t m_pathConverter;
 
-protected:
+public:
     /**
-     * @brief read headers from buffer. Return the number of bytes consumed
+     * @brief parse a message content (UTF-8, without the headers) as returned by LSP::MessageReader
      */
-    int ReadHeaders(const wxString& message, wxStringMap_t& headers);
-
-public:
-    ResponseMessage(wxString& message, IPathConverter::Ptr_t pathConverter);
+    ResponseMessage(const char* content, size_t len, IPathConverter::Ptr_t pathConverter);
     virtual ~ResponseMessage();
     virtual JSONItem ToJSON(const wxString& name, IPathConverter::Ptr_t pathConverter) const;
     virtual void FromJSON(const JSONItem& json, IPathConverter::Ptr_t pathConverter);
@@ -34,7 +30,7 @@ public:
         this->m_id = id;
         return *this;
     }
-    const wxString& GetMessageString() const { return m_jsonMessage; }
+    JSONItem GetJSON() const { return m_json ? m_json->toElement() : JSONItem(nullptr); }
     int GetId() const { return m_id; }
     bool IsOk() const { return m_json && m_json->isOk(); }
     bool Has(const wxString& property) const;
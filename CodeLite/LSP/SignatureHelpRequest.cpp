@@ -29,5 +29,6 @@ void LSP::SignatureHelpRequest::OnResponse(const LSP::ResponseMessage& response,
 
 bool LSP::SignatureHelpRequest::IsValidAt(const wxFileName& filename, size_t line, size_t col) const
 {
-    return (m_filename == filename) && (m_line == line) && (m_column == col);
+    // the reply is still useful if the user kept typing the arguments on the same line
+    return (m_filename == filename) && (m_line == line) && (col >= m_column);
 }
@@ -39,12 +39,81 @@ enum eSymbolKind {
     kSK_TypeParameter = 26,
 };
 
+//===----------------------------------------------------------------------------------
+// Position
+//===----------------------------------------------------------------------------------
+class WXDLLIMPEXP_CL Position : public Serializable
+{
+    int m_line = wxNOT_FOUND;
+    int m_character = wxNOT_FOUND;
+
+public:
+    virtual void FromJSON(const JSONItem& json, IPathConverter::Ptr_t pathConverter);
+    virtual JSONItem ToJSON(const wxString& name, IPathConverter::Ptr_t pathConverter) const;
+
+    Position(int line, int col)
+        : m_line(line)
+        , m_character(col)
+    {
+    }
+    Position() {}
+    virtual ~Position() {}
+    Position& SetCharacter(int character)
+    {
+        this->m_character = character;
+        return *this;
+    }
+    Position& SetLine(int line)
+    {
+        this->m_line = line;
+        return *this;
+    }
+    int GetCharacter() const { return m_character; }
+    int GetLine() const { return m_line; }
+    bool IsOk() const { return m_line != wxNOT_FOUND && m_character != wxNOT_FOUND; }
+};
+
+//===----------------------------------------------------------------------------------
+// Range
+//===----------------------------------------------------------------------------------
+class WXDLLIMPEXP_CL Range : public Serializable
+{
+    Position m_start;
+    Position m_end;
+
+public:
+    virtual void FromJSON(const JSONItem& json, IPathConverter::Ptr_t pathConverter);
+    virtual JSONItem ToJSON(const wxString& name, IPathConverter::Ptr_t pathConverter) const;
+
+    Range(const Position& start, const Position& end)
+        : m_start(start)
+        , m_end(end)
+    {
+    }
+    Range() {}
+    virtual ~Range() {}
+    Range& SetEnd(const Position& end)
+    {
+        this->m_end = end;
+        return *this;
+    }
+    Range& SetStart(const Position& start)
+    {
+        this->m_start = start;
+        return *this;
+    }
+    const Position& GetEnd() const { return m_end; }
+    const Position& GetStart() const { return m_start; }
+    bool IsOk() const { return m_start.IsOk() && m_end.IsOk(); }
+};
+
 //===----------------------------------------------------------------------------------
 // TextDocumentContentChangeEvent
 //===----------------------------------------------------------------------------------
 class WXDLLIMPEXP_CL TextDocumentContentChangeEvent : public Serializable
 {
     std::string m_text;
+    Range m_range; // when not set, 'm_text' is the whole document content
 
 public:
     virtual JSONItem ToJSON(const wxString& name, IPathConverter::Ptr_t pathConverter) const;
@@ -58,6 +127,12 @@ public:
     virtual ~TextDocumentContentChangeEvent() {}
     TextDocumentContentChangeEvent& SetText(const std::string& text);
     const std::string& GetText() const { return m_text; }
+    TextDocumentContentChangeEvent& SetRange(const Range& range)
+    {
+        this->m_range = range;
+        return *this;
+    }
+    const Range& GetRange() const { return m_range; }
 };
 
 //===----------------------------------------------------------------------------------
@@ -110,74 +185,6 @@ public:
     int GetVersion() const { return m_version; }
 };
 
-//===----------------------------------------------------------------------------------
-// Position
-//===----------------------------------------------------------------------------------
-class WXDLLIMPEXP_CL Position : public Serializable
-{
-    int m_line = wxNOT_FOUND;
-    int m_character = wxNOT_FOUND;
-
-public:
-    virtual void FromJSON(const JSONItem& json, IPathConverter::Ptr_t pathConverter);
-    virtual JSONItem ToJSON(const wxString& name, IPathConverter::Ptr_t pathConverter) const;
-
-    Position(int line, int col)
-        : m_line(line)
-        , m_character(col)
-    {
-    }
-    Position() {}
-    virtual ~Position() {}
-    Position& SetCharacter(int character)
-    {
-        this->m_character = character;
-        return *this;
-    }
-    Position& SetLine(int line)
-    {
-        this->m_line = line;
-        return *this;
-    }
-    int GetCharacter() const { return m_character; }
-    int GetLine() const { return m_line; }
-    bool IsOk() const { return m_line != wxNOT_FOUND && m_character != wxNOT_FOUND; }
-};
-
-//===----------------------------------------------------------------------------------
-// Range
-//===----------------------------------------------------------------------------------
-class WXDLLIMPEXP_CL Range : public Serializable
-{
-    Position m_start;
-    Position m_end;
-
-public:
-    virtual void FromJSON(const JSONItem& json, IPathConverter::Ptr_t pathConverter);
-    virtual JSONItem ToJSON(const wxString& name, IPathConverter::Ptr_t pathConverter) const;
-
-    Range(const Position& start, const Position& end)
-        : m_start(start)
-        , m_end(end)
-    {
-    }
-    Range() {}
-    virtual ~Range() {}
-    Range& SetEnd(const Position& end)
-    {
-        this->m_end = end;
-        return *this;
-    }
-    Range& SetStart(const Position& start)
-    {
-        this->m_start = start;
-        return *this;
-    }
-    const Position& GetEnd() const { return m_end; }
-    const Position& GetStart() const { return m_start; }
-    bool IsOk() const { return m_start.IsOk() && m_end.IsOk(); }
-};
-
 //===----------------------------------------------------------------------------------
 // TextEdit
 //===----------------------------------------------------------------------------------
@@ -11,33 +11,14 @@ PHPDocComment::PHPDocComment(PHPSourceFile& sourceFile, const wxString& comment)
     : m_sourceFile(sourceFile)
     , m_comment(comment)
 {
-    static std::unordered_set<wxString> nativeTypes;
-    if(nativeTypes.empty()) {
-        // List taken from https://www.php.net/manual/en/language.types.intro.php
-        // Native types
-        nativeTypes.insert("bool");
-        nativeTypes.insert("int");
-        nativeTypes.insert("float");
-        nativeTypes.insert("string");
-        nativeTypes.insert("array");
-        nativeTypes.insert("object");
-        nativeTypes.insert("iterable");
-        nativeTypes.insert("callable");
-        nativeTypes.insert("null");
-        nativeTypes.insert("mixed");
-        nativeTypes.insert("void");
-        // Types that are common in documentation
-        nativeTypes.insert("boolean");
-        nativeTypes.insert("integer");
-        nativeTypes.insert("double");
-        nativeTypes.insert("real");
-        nativeTypes.insert("binery");
-        nativeTypes.insert("resource");
-        nativeTypes.insert("number");
-        nativeTypes.insert("callback");
-    }
-
-    static wxRegEx reReturnStatement(wxT("@(return)[ \t]+(\??"")([\\a-zA-Z_]{1}[\\|\\a-zA-Z0-9_]*)"));
+    // List taken from https://www.php.net/manual/en/language.types.intro.php
+    static const std::unordered_set<wxString> nativeTypes = {
+        "bool", "int", "float", "string", "array", "object", "iterable", "callable", "null", "mixed", "void",
+        "boolean", "integer", "double", "real", "binery", "resource", "number", "callback"
+    };
+
+    // wxRegEx keeps the last match: one instance per thread
+    static thread_local wxRegEx reReturnStatement(wxT("@(return)[ \t]+(\??"")([\\a-zA-Z_]{1}[\\|\\a-zA-Z0-9_]*)"));
     if(reReturnStatement.IsValid() && reReturnStatement.Matches(m_comment)) {
         wxString returnNullable = reReturnStatement.GetMatch(m_comment, 2);
         wxString returnValue = reReturnStatement.GetMatch(m_comment, 3);
@@ -0,0 +1,254 @@
+#include "PHPEntityGraph.h"
+#include "PHPEntityClass.h"
+#include "PHPEntityFunction.h"
+#include "PHPEntityFunctionAlias.h"
+#include "PHPEntityNamespace.h"
+#include "PHPEntityVariable.h"
+#include "PHPLookupTable.h"
+
+namespace
+{
+bool ContainsFile(const PHPEntityBase::List_t& entities, const wxString& filename)
+{
+    for(const PHPEntityBase::Ptr_t& entity : entities) {
+        if(entity->GetFilename().GetFullPath() == filename) { return true; }
+    }
+    return false;
+}
+
+bool ContainsFile(const PHPEntityGraph::Members& members, const wxString& filename)
+{
+    if(ContainsFile(members.scopes, filename) || ContainsFile(members.functions, filename) ||
+       ContainsFile(members.aliases, filename) || ContainsFile(members.variables, filename)) {
+        return true;
+    }
+    for(const PHPDocVar::Map_t::value_type& vt : members.docs) {
+        if(vt.second->GetFilename().GetFullPath() == filename) { return true; }
+    }
+    return false;
+}
+
+template <typename T>
+void LoadEntities(wxSQLite3Database& db, const wxString& tableName, wxLongLong scopeId, PHPEntityBase::List_t& entities)
+{
+    wxString sql;
+    sql << "SELECT * from " << tableName << " WHERE SCOPE_ID=" << scopeId << " ORDER BY ID";
+    wxSQLite3Statement st = db.PrepareStatement(sql);
+    wxSQLite3ResultSet res = st.ExecuteQuery();
+    while(res.NextRow()) {
+        PHPEntityBase::Ptr_t entity(new T());
+        entity->FromResultSet(res);
+        entities.push_back(entity);
+    }
+}
+} // namespace
+
+PHPEntityGraph::PHPEntityGraph() {}
+
+PHPEntityGraph::~PHPEntityGraph() {}
+
+PHPEntityBase::Ptr_t PHPEntityGraph::Clone(PHPEntityBase::Ptr_t entity)
+{
+    if(!entity) { return entity; }
+    if(entity->Is(kEntityTypeClass)) {
+        return PHPEntityBase::Ptr_t(new PHPEntityClass(*entity->Cast<PHPEntityClass>()));
+    } else if(entity->Is(kEntityTypeNamespace)) {
+        return PHPEntityBase::Ptr_t(new PHPEntityNamespace(*entity->Cast<PHPEntityNamespace>()));
+    } else if(entity->Is(kEntityTypeFunction)) {
+        return PHPEntityBase::Ptr_t(new PHPEntityFunction(*entity->Cast<PHPEntityFunction>()));
+    } else if(entity->Is(kEntityTypeFunctionAlias)) {
+        return PHPEntityBase::Ptr_t(new PHPEntityFunctionAlias(*entity->Cast<PHPEntityFunctionAlias>()));
+    } else if(entity->Is(kEntityTypeVariable)) {
+        return PHPEntityBase::Ptr_t(new PHPEntityVariable(*entity->Cast<PHPEntityVariable>()));
+    }
+    return PHPEntityBase::Ptr_t(NULL);
+}
+
+void PHPEntityGraph::Clear()
+{
+    m_loaded = false;
+    m_scopes.clear();
+    m_scopeParents.clear();
+    m_scopesByName.clear();
+    m_scopesByFile.clear();
+    m_inheritance.clear();
+    m_members.clear();
+}
+
+void PHPEntityGraph::Load(wxSQLite3Database& db)
+{
+    Clear();
+    wxSQLite3Statement st = db.PrepareStatement("SELECT * from SCOPE_TABLE");
+    wxSQLite3ResultSet res = st.ExecuteQuery();
+    while(res.NextRow()) {
+        AddScope(res);
+    }
+    m_loaded = true;
+}
+
+void PHPEntityGraph::AddScope(wxSQLite3ResultSet& res)
+{
+    PHPEntityBase::Ptr_t scope;
+    if(res.GetInt("SCOPE_TYPE", 1) == kPhpScopeTypeNamespace) {
+        scope.Reset(new PHPEntityNamespace());
+    } else {
+        scope.Reset(new PHPEntityClass());
+    }
+    scope->FromResultSet(res);
+
+    long long id = scope->GetDbId().GetValue();
+    long long parentId = res.GetInt64("SCOPE_ID").GetValue();
+    RemoveScope(id);
+
+    // FULLNAME is unique: a class that was moved to another file replaced the row of its previous definition
+    PHPEntityBase::Ptr_t previous = GetScope(scope->GetFullName());
+    if(previous) { RemoveScope(previous->GetDbId().GetValue()); }
+
+    m_scopes.insert(std::make_pair(id, scope));
+    m_scopeParents.insert(std::make_pair(id, parentId));
+    m_scopesByName[scope->GetFullName()] = scope;
+    m_members.erase(parentId);
+    m_scopesByFile[res.GetString("FILE_NAME")].push_back(id);
+}
+
+void PHPEntityGraph::RemoveScope(long long id)
+{
+    std::unordered_map<long long, PHPEntityBase::Ptr_t>::iterator iter = m_scopes.find(id);
+    if(iter == m_scopes.end()) { return; }
+
+    std::unordered_map<wxString, PHPEntityBase::Ptr_t>::iterator nameIter =
+        m_scopesByName.find(iter->second->GetFullName());
+    if(nameIter != m_scopesByName.end() && nameIter->second == iter->second) { m_scopesByName.erase(nameIter); }
+    m_scopes.erase(iter);
+    m_members.erase(id);
+
+    std::unordered_map<long long, long long>::iterator parentIter = m_scopeParents.find(id);
+    if(parentIter != m_scopeParents.end()) {
+        m_members.erase(parentIter->second);
+        m_scopeParents.erase(parentIter);
+    }
+}
+
+PHPEntityBase::Ptr_t PHPEntityGraph::GetScope(wxLongLong id) const
+{
+    std::unordered_map<long long, PHPEntityBase::Ptr_t>::const_iterator iter = m_scopes.find(id.GetValue());
+    return iter == m_scopes.end() ? PHPEntityBase::Ptr_t(NULL) : iter->second;
+}
+
+PHPEntityBase::Ptr_t PHPEntityGraph::GetScope(const wxString& fullname) const
+{
+    std::unordered_map<wxString, PHPEntityBase::Ptr_t>::const_iterator iter = m_scopesByName.find(fullname);
+    return iter == m_scopesByName.end() ? PHPEntityBase::Ptr_t(NULL) : iter->second;
+}
+
+const std::vector<wxLongLong>& PHPEntityGraph::GetInheritance(wxLongLong classId)
+{
+    std::unordered_map<long long, std::vector<wxLongLong> >::iterator iter = m_inheritance.find(classId.GetValue());
+    if(iter != m_inheritance.end()) { return iter->second; }
+
+    std::vector<wxLongLong>& parents = m_inheritance[classId.GetValue()];
+    PHPEntityBase::Ptr_t cls = GetScope(classId);
+    if(cls && cls->Is(kEntityTypeClass)) {
+        wxArrayString parentsArr = cls->Cast<PHPEntityClass>()->GetInheritanceArray();
+        for(size_t i = 0; i < parentsArr.GetCount(); ++i) {
+            PHPEntityBase::Ptr_t parent = GetScope(parentsArr.Item(i));
+            if(parent && parent->Is(kEntityTypeClass)) { parents.push_back(parent->GetDbId()); }
+        }
+    }
+    return parents;
+}
+
+const PHPEntityGraph::Members& PHPEntityGraph::GetMembers(wxSQLite3Database& db, wxLongLong scopeId)
+{
+    std::unordered_map<long long, Members>::iterator iter = m_members.find(scopeId.GetValue());
+    if(iter != m_members.end()) { return iter->second; }
+
+    // Load everything before caching it, a failure leaves nothing behind
+    Members members;
+    {
+        wxString sql;
+        sql << "SELECT ID from SCOPE_TABLE WHERE SCOPE_ID=" << scopeId << " ORDER BY ID";
+        wxSQLite3Statement st = db.PrepareStatement(sql);
+        wxSQLite3ResultSet res = st.ExecuteQuery();
+        while(res.NextRow()) {
+            PHPEntityBase::Ptr_t scope = GetScope(res.GetInt64(0));
+            if(scope) { members.scopes.push_back(scope); }
+        }
+    }
+    LoadEntities<PHPEntityFunction>(db, "FUNCTION_TABLE", scopeId, members.functions);
+    LoadEntities<PHPEntityFunctionAlias>(db, "FUNCTION_ALIAS_TABLE", scopeId, members.aliases);
+    LoadEntities<PHPEntityVariable>(db, "VARIABLES_TABLE", scopeId, members.variables);
+    {
+        wxString sql;
+        sql << "SELECT * from PHPDOC_VAR_TABLE WHERE SCOPE_ID=" << scopeId << " ORDER BY ID";
+        wxSQLite3Statement st = db.PrepareStatement(sql);
+        wxSQLite3ResultSet res = st.ExecuteQuery();
+        while(res.NextRow()) {
+            PHPDocVar::Ptr_t var(new PHPDocVar());
+            var->FromResultSet(res);
+            members.docs.insert(std::make_pair(var->GetName(), var));
+        }
+    }
+
+    Members& cached = m_members[scopeId.GetValue()];
+    std::swap(cached, members);
+    return cached;
+}
+
+void PHPEntityGraph::CollectScopeIds(wxSQLite3Database& db, const wxString& sql, const wxString& filename,
+                                     std::vector<long long>& ids)
+{
+    wxSQLite3Statement st = db.PrepareStatement(sql);
+    st.Bind(st.GetParamIndex(":FILE_NAME"), filename);
+    wxSQLite3ResultSet res = st.ExecuteQuery();
+    while(res.NextRow()) {
+        ids.push_back(res.GetInt64(0).GetValue());
+    }
+}
+
+void PHPEntityGraph::UpdateFile(wxSQLite3Database& db, const wxFileName& filename)
+{
+    if(!m_loaded) { return; }
+    wxString path = filename.GetFullPath();
+
+    // Drop the cached members that came from this file
+    for(std::unordered_map<long long, Members>::iterator iter = m_members.begin(); iter != m_members.end();) {
+        if(ContainsFile(iter->second, path)) {
+            iter = m_members.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    // Replace the scopes of this file with the ones now in the database
+    std::unordered_map<wxString, std::vector<long long> >::iterator fileIter = m_scopesByFile.find(path);
+    if(fileIter != m_scopesByFile.end()) {
+        std::vector<long long> ids;
+        ids.swap(fileIter->second);
+        m_scopesByFile.erase(fileIter);
+        for(long long id : ids) {
+            RemoveScope(id);
+        }
+    }
+    {
+        wxSQLite3Statement st = db.PrepareStatement("SELECT * from SCOPE_TABLE WHERE FILE_NAME=:FILE_NAME");
+        st.Bind(st.GetParamIndex(":FILE_NAME"), path);
+        wxSQLite3ResultSet res = st.ExecuteQuery();
+        while(res.NextRow()) {
+            AddScope(res);
+        }
+    }
+
+    // The file may have added members to scopes that did not have members from it before
+    std::vector<long long> ids;
+    CollectScopeIds(db, "SELECT DISTINCT SCOPE_ID from FUNCTION_TABLE WHERE FILE_NAME=:FILE_NAME", path, ids);
+    CollectScopeIds(db, "SELECT DISTINCT SCOPE_ID from FUNCTION_ALIAS_TABLE WHERE FILE_NAME=:FILE_NAME", path, ids);
+    CollectScopeIds(db, "SELECT DISTINCT SCOPE_ID from VARIABLES_TABLE WHERE FILE_NAME=:FILE_NAME", path, ids);
+    CollectScopeIds(db, "SELECT DISTINCT SCOPE_ID from PHPDOC_VAR_TABLE WHERE FILE_NAME=:FILE_NAME", path, ids);
+    for(long long id : ids) {
+        m_members.erase(id);
+    }
+
+    // The inheritance edges are resolved by name: a class of this file may be the parent of any class
+    m_inheritance.clear();
+}
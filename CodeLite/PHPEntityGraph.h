@@ -0,0 +1,88 @@
+#ifndef PHPENTITYGRAPH_H
+#define PHPENTITYGRAPH_H
+
+#include "PHPDocVar.h"
+#include "PHPEntityBase.h"
+#include "codelite_exports.h"
+#include "wx/wxsqlite3.h"
+#include <unordered_map>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/string.h>
+#include <wxStringHash.h>
+
+/**
+ * @class PHPEntityGraph
+ * @brief a resident copy of the PHP symbols database used by the lookups: all the scopes (classes and namespaces)
+ * with their inheritance edges, and the members of the scopes that were looked up (loaded on demand, once).
+ *
+ * The entities kept here are prototypes: use Clone() before handing them to code that may modify them
+ */
+class WXDLLIMPEXP_CL PHPEntityGraph
+{
+public:
+    struct Members {
+        PHPEntityBase::List_t scopes; // child classes and namespaces
+        PHPEntityBase::List_t functions;
+        PHPEntityBase::List_t aliases;
+        PHPEntityBase::List_t variables;
+        PHPDocVar::Map_t docs; // @var comments, by name
+    };
+
+protected:
+    bool m_loaded = false;
+    std::unordered_map<long long, PHPEntityBase::Ptr_t> m_scopes;
+    std::unordered_map<long long, long long> m_scopeParents; // scope ID -> the ID of the scope containing it
+    std::unordered_map<wxString, PHPEntityBase::Ptr_t> m_scopesByName;
+    std::unordered_map<wxString, std::vector<long long> > m_scopesByFile;
+    std::unordered_map<long long, std::vector<wxLongLong> > m_inheritance; // class ID -> parents IDs
+    std::unordered_map<long long, Members> m_members;
+
+protected:
+    void AddScope(wxSQLite3ResultSet& res);
+    void RemoveScope(long long id);
+    void CollectScopeIds(wxSQLite3Database& db, const wxString& sql, const wxString& filename,
+                         std::vector<long long>& ids);
+
+public:
+    PHPEntityGraph();
+    virtual ~PHPEntityGraph();
+
+    /**
+     * @brief return a copy of 'entity' that the caller may modify
+     */
+    static PHPEntityBase::Ptr_t Clone(PHPEntityBase::Ptr_t entity);
+
+    bool IsLoaded() const { return m_loaded; }
+    void Clear();
+
+    /**
+     * @brief load the scopes table. Throws wxSQLite3Exception
+     */
+    void Load(wxSQLite3Database& db);
+
+    /**
+     * @brief return the scope with a given ID / fullname, null if it does not exist
+     */
+    PHPEntityBase::Ptr_t GetScope(wxLongLong id) const;
+    PHPEntityBase::Ptr_t GetScope(const wxString& fullname) const;
+
+    /**
+     * @brief the IDs of the classes a class extends, implements or uses (as traits)
+     */
+    const std::vector<wxLongLong>& GetInheritance(wxLongLong classId);
+
+    /**
+     * @brief the members of a scope, ordered by their database ID. Loaded from the database on the first call.
+     * Throws wxSQLite3Exception
+     */
+    const Members& GetMembers(wxSQLite3Database& db, wxLongLong scopeId);
+
+    /**
+     * @brief 'filename' was re-parsed: replace its scopes and drop the cached members that it changed.
+     * Throws wxSQLite3Exception
+     */
+    void UpdateFile(wxSQLite3Database& db, const wxFileName& filename);
+};
+
+#endif // PHPENTITYGRAPH_H
@@ -9,6 +9,9 @@
 #include "fileextmanager.h"
 #include "fileutils.h"
 #include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <thread>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/stopwatch.h>
@@ -18,9 +21,19 @@
 wxDEFINE_EVENT(wxPHP_PARSE_STARTED, clParseEvent);
 wxDEFINE_EVENT(wxPHP_PARSE_ENDED, clParseEvent);
 wxDEFINE_EVENT(wxPHP_PARSE_PROGRESS, clParseEvent);
+wxDEFINE_EVENT(wxPHP_FILE_PARSED, clParseEvent);
 
 static wxString PHP_SCHEMA_VERSION = "9.3.0.1";
 
+// Number of parsed files waiting to be stored, per parser thread
+#define PARALLEL_PARSE_WINDOW_PER_WORKER 16
+
+// Commit the stored symbols every that many files
+#define PARALLEL_PARSE_COMMIT_INTERVAL 5000
+
+// Send a progress event at most that often (ms)
+#define PARALLEL_PARSE_PROGRESS_INTERVAL 100
+
 //------------------------------------------------
 // Metadata table
 //------------------------------------------------
@@ -159,6 +172,37 @@ const static wxString CREATE_FILES_TABLE_SQL =
 const static wxString CREATE_FILES_TABLE_SQL_IDX1 =
     "CREATE UNIQUE INDEX IF NOT EXISTS FILES_TABLE_IDX_1 ON FILES_TABLE(FILE_NAME)";
 
+namespace
+{
+bool IsScopeOfType(PHPEntityBase::Ptr_t scope, ePhpScopeType scopeType)
+{
+    switch(scopeType) {
+    case kPhpScopeTypeNamespace:
+        return scope->Is(kEntityTypeNamespace);
+    case kPhpScopeTypeClass:
+        return scope->Is(kEntityTypeClass);
+    default:
+        return true;
+    }
+}
+
+// Compare the way the SQLite LIKE operator does: the case of the ASCII letters is ignored
+wxUniChar::value_type ToLowerASCII(wxUniChar ch)
+{
+    wxUniChar::value_type value = ch.GetValue();
+    return (value >= 'A' && value <= 'Z') ? value - 'A' + 'a' : value;
+}
+
+bool MatchesNoCaseAt(const wxString& str, size_t pos, const wxString& part)
+{
+    if(pos + part.length() > str.length()) return false;
+    for(size_t i = 0; i < part.length(); ++i) {
+        if(ToLowerASCII(str[pos + i]) != ToLowerASCII(part[i])) return false;
+    }
+    return true;
+}
+} // namespace
+
 PHPLookupTable::PHPLookupTable()
     : m_sizeLimit(50)
 {
@@ -386,6 +430,7 @@ void PHPLookupTable::UpdateSourceFile(PHPSourceFile& source, bool autoCommit)
         }
 
         if(autoCommit) m_db.Commit();
+        UpdateSymbolsCache(source.GetFilename());
 
     } catch(wxSQLite3Exception& e) {
         if(autoCommit) m_db.Rollback();
@@ -398,31 +443,17 @@ PHPEntityBase::Ptr_t PHPLookupTable::DoFindMemberOf(wxLongLong parentDbId, const
 {
     // Find members of of parentDbID
     try {
+        const PHPEntityGraph::Members& members = GetGraph().GetMembers(m_db, parentDbId);
         PHPEntityBase::List_t matches;
-        {
-            wxString sql;
-            sql << "SELECT * from FUNCTION_TABLE WHERE SCOPE_ID=" << parentDbId << " AND NAME='" << exactName << "'";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityFunction());
-                match->FromResultSet(res);
-                matches.push_back(match);
-            }
+        for(const PHPEntityBase::Ptr_t& func : members.functions) {
+            if(func->GetShortName() == exactName) { matches.push_back(PHPEntityGraph::Clone(func)); }
         }
 
         if(matches.empty()) {
             // Search functions alias table
-            wxString sql;
-            sql << "SELECT * from FUNCTION_ALIAS_TABLE WHERE SCOPE_ID=" << parentDbId << " AND NAME='" << exactName
-                << "'";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityFunctionAlias());
-                match->FromResultSet(res);
+            for(const PHPEntityBase::Ptr_t& alias : members.aliases) {
+                if(alias->GetShortName() != exactName) continue;
+                PHPEntityBase::Ptr_t match = PHPEntityGraph::Clone(alias);
                 PHPEntityBase::Ptr_t pFunc = FindFunction(match->Cast<PHPEntityFunctionAlias>()->GetRealname());
                 if(pFunc) {
                     match->Cast<PHPEntityFunctionAlias>()->SetFunc(pFunc);
@@ -432,28 +463,14 @@ PHPEntityBase::Ptr_t PHPLookupTable::DoFindMemberOf(wxLongLong parentDbId, const
         }
 
         if(matches.empty() && parentIsNamespace) {
-            // search the scope table as well
-            wxString sql;
-            sql << "SELECT * from SCOPE_TABLE WHERE SCOPE_ID=" << parentDbId << " AND NAME='" << exactName << "'";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while(res.NextRow()) {
-                ePhpScopeType st = kPhpScopeTypeAny;
-                st =
-                    res.GetInt("SCOPE_TYPE", 1) == kPhpScopeTypeNamespace ? kPhpScopeTypeNamespace : kPhpScopeTypeClass;
-
-                PHPEntityBase::Ptr_t match = NewEntity("SCOPE_TABLE", st);
-                if(match) {
-                    match->FromResultSet(res);
-                    matches.push_back(match);
-                }
+            // search the scopes as well
+            for(const PHPEntityBase::Ptr_t& scope : members.scopes) {
+                if(scope->GetShortName() == exactName) { matches.push_back(PHPEntityGraph::Clone(scope)); }
             }
         }
 
         if(matches.empty()) {
             // Could not find a match in the function table, check the variable table
-            wxString sql;
             wxString nameWDollar, namwWODollar;
             nameWDollar = exactName;
             if(exactName.StartsWith("$")) {
@@ -463,15 +480,9 @@ PHPEntityBase::Ptr_t PHPLookupTable::DoFindMemberOf(wxLongLong parentDbId, const
                 nameWDollar.Prepend("$");
             }
 
-            sql << "SELECT * from VARIABLES_TABLE WHERE SCOPE_ID=" << parentDbId << " AND NAME IN ('" << nameWDollar
-                << "', '" << namwWODollar << "')";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityVariable());
-                match->FromResultSet(res);
-                matches.push_back(match);
+            for(const PHPEntityBase::Ptr_t& var : members.variables) {
+                const wxString& name = var->GetShortName();
+                if(name == nameWDollar || name == namwWODollar) { matches.push_back(PHPEntityGraph::Clone(var)); }
             }
 
             // Fix variables type using the PHPDOC_VAR_TABLE content for this class
@@ -504,12 +515,16 @@ void PHPLookupTable::DoGetInheritanceParentIDs(PHPEntityBase::Ptr_t cls, std::ve
     if(!excludeSelf) { parents.push_back(cls->GetDbId()); }
 
     parentsVisited.insert(cls->GetDbId());
-    wxArrayString parentsArr = cls->Cast<PHPEntityClass>()->GetInheritanceArray();
-    for(size_t i = 0; i < parentsArr.GetCount(); ++i) {
-        PHPEntityBase::Ptr_t parent = FindClass(parentsArr.Item(i));
-        if(parent && !parentsVisited.count(parent->GetDbId())) {
-            DoGetInheritanceParentIDs(parent, parents, parentsVisited, false);
+    try {
+        PHPEntityGraph& graph = GetGraph();
+        const std::vector<wxLongLong>& parentIds = graph.GetInheritance(cls->GetDbId());
+        for(size_t i = 0; i < parentIds.size(); ++i) {
+            if(!parentsVisited.count(parentIds[i])) {
+                DoGetInheritanceParentIDs(graph.GetScope(parentIds[i]), parents, parentsVisited, false);
+            }
         }
+    } catch(wxSQLite3Exception& e) {
+        CL_WARNING("PHPLookupTable::DoGetInheritanceParentIDs: %s", e.GetMessage());
     }
 }
 
@@ -517,35 +532,8 @@ PHPEntityBase::Ptr_t PHPLookupTable::DoFindScope(const wxString& fullname, ePhpS
 {
     // locate the scope
     try {
-        wxString sql;
-
-        // limit by 2 for performance reason
-        // we will return NULL incase the number of matches is greater than 1...
-        sql << "SELECT * from SCOPE_TABLE WHERE FULLNAME='" << fullname << "'";
-        if(scopeType != kPhpScopeTypeAny) { sql << " AND SCOPE_TYPE = " << static_cast<int>(scopeType); }
-        sql << " LIMIT 2 ";
-
-        wxSQLite3Statement st = m_db.PrepareStatement(sql);
-        wxSQLite3ResultSet res = st.ExecuteQuery();
-        PHPEntityBase::Ptr_t match(NULL);
-
-        while(res.NextRow()) {
-            if(match) {
-                // only one match
-                return PHPEntityBase::Ptr_t(NULL);
-            }
-
-            int scopeType = res.GetInt("SCOPE_TYPE", 1);
-            if(scopeType == 0) {
-                // namespace
-                match.Reset(new PHPEntityNamespace());
-            } else {
-                // class
-                match.Reset(new PHPEntityClass());
-            }
-            match->FromResultSet(res);
-        }
-        return match;
+        PHPEntityBase::Ptr_t match = GetGraph().GetScope(fullname);
+        if(match && IsScopeOfType(match, scopeType)) { return PHPEntityGraph::Clone(match); }
 
     } catch(wxSQLite3Exception& e) {
         CL_WARNING("PHPLookupTable::FindScope: %s", e.GetMessage());
@@ -562,30 +550,9 @@ PHPEntityBase::Ptr_t PHPLookupTable::DoFindScope(wxLongLong id, ePhpScopeType sc
 {
     // locate the scope
     try {
-        wxString sql;
-
-        // limit by 2 for performance reason
-        // we will return NULL incase the number of matches is greater than 1...
-        sql << "SELECT * from SCOPE_TABLE WHERE ID=" << id;
-        if(scopeType != kPhpScopeTypeAny) { sql << " AND SCOPE_TYPE = " << static_cast<int>(scopeType); }
-        sql << " LIMIT 1";
+        PHPEntityBase::Ptr_t match = GetGraph().GetScope(id);
+        if(match && IsScopeOfType(match, scopeType)) { return PHPEntityGraph::Clone(match); }
 
-        wxSQLite3Statement st = m_db.PrepareStatement(sql);
-        wxSQLite3ResultSet res = st.ExecuteQuery();
-
-        if(res.NextRow()) {
-            PHPEntityBase::Ptr_t match(NULL);
-            int scopeType = res.GetInt("SCOPE_TYPE", 1);
-            if(scopeType == kPhpScopeTypeNamespace) {
-                // namespace
-                match.Reset(new PHPEntityNamespace());
-            } else {
-                // class
-                match.Reset(new PHPEntityClass());
-            }
-            match->FromResultSet(res);
-            return match;
-        }
     } catch(wxSQLite3Exception& e) {
         CL_WARNING("PHPLookupTable::DoFindScope: %s", e.GetMessage());
     }
@@ -683,6 +650,26 @@ void PHPLookupTable::DoAddNameFilter(wxString& sql, const wxString& nameHint, si
     }
 }
 
+bool PHPLookupTable::DoMatchName(const wxString& name, const wxString& nameHint, size_t flags) const
+{
+    // The in-memory version of DoAddNameFilter(), 'nameHint' is already trimmed
+    if(nameHint.IsEmpty()) { return true; }
+
+    if(flags & kLookupFlags_ExactMatch) {
+        return name == nameHint;
+
+    } else if(flags & kLookupFlags_Contains) {
+        for(size_t pos = 0; pos + nameHint.length() <= name.length(); ++pos) {
+            if(MatchesNoCaseAt(name, pos, nameHint)) { return true; }
+        }
+        return false;
+
+    } else if(flags & kLookupFlags_StartsWith) {
+        return MatchesNoCaseAt(name, 0, nameHint);
+    }
+    return true;
+}
+
 void PHPLookupTable::LoadAllByFilter(PHPEntityBase::List_t& matches, const wxString& nameHint, eLookupFlags flags)
 {
     try {
@@ -804,7 +791,11 @@ void PHPLookupTable::DeleteFileEntries(const wxFileName& filename, bool autoComm
             st.ExecuteUpdate();
         }
 
-        if(autoCommit) m_db.Commit();
+        if(autoCommit) {
+            // else, the caller is updating the file
+            m_db.Commit();
+            UpdateSymbolsCache(filename);
+        }
     } catch(wxSQLite3Exception& e) {
         if(autoCommit) m_db.Rollback();
         CL_WARNING("PHPLookupTable::DeleteFileEntries: %s", e.GetMessage());
@@ -817,6 +808,7 @@ void PHPLookupTable::Close()
         if(m_db.IsOpen()) { m_db.Close(); }
         m_filename.Clear();
         m_allClasses.clear();
+        m_graph.Clear();
 
     } catch(wxSQLite3Exception& e) {
         CL_WARNING("PHPLookupTable::Close: %s", e.GetMessage());
@@ -830,100 +822,69 @@ void PHPLookupTable::DoFindChildren(PHPEntityBase::List_t& matches, wxLongLong p
 {
     // Find members of of parentDbID
     try {
+        const PHPEntityGraph::Members& members = GetGraph().GetMembers(m_db, parentId);
+        wxString name = nameHint;
+        name.Trim().Trim(false);
+
+        // Copy the entities matching the name, at most m_sizeLimit of them
+        PHPEntityBase::List_t candidates;
+        auto filterByName = [&](const PHPEntityBase::List_t& entities) -> const PHPEntityBase::List_t& {
+            candidates.clear();
+            for(const PHPEntityBase::Ptr_t& entity : entities) {
+                if(candidates.size() == m_sizeLimit) break;
+                if(entity->Is(kEntityTypeNamespace) || !DoMatchName(entity->GetShortName(), name, flags)) continue;
+                candidates.push_back(PHPEntityGraph::Clone(entity));
+            }
+            return candidates;
+        };
+
         // Load classes
         if(!(flags & kLookupFlags_FunctionsAndConstsOnly)) {
-            wxString sql;
-            sql << "SELECT * from SCOPE_TABLE WHERE SCOPE_ID=" << parentId << " AND SCOPE_TYPE = 1 AND ";
-            DoAddNameFilter(sql, nameHint, flags);
-            DoAddLimit(sql);
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityClass());
-                match->FromResultSet(res);
-                matches.push_back(match);
-            }
+            const PHPEntityBase::List_t& classes = filterByName(members.scopes);
+            matches.insert(matches.end(), classes.begin(), classes.end());
         }
 
-        {
-            // load functions
-            wxString sql;
-            sql << "SELECT * from FUNCTION_TABLE WHERE SCOPE_ID=" << parentId << " AND ";
-            DoAddNameFilter(sql, nameHint, flags);
-            DoAddLimit(sql);
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityFunction());
-                match->FromResultSet(res);
-                bool isStaticFunction = match->HasFlag(kFunc_Static);
-                if(isStaticFunction) {
-                    // always return static functions
-                    matches.push_back(match);
+        // load functions
+        for(PHPEntityBase::Ptr_t match : filterByName(members.functions)) {
+            bool isStaticFunction = match->HasFlag(kFunc_Static);
+            if(isStaticFunction) {
+                // always return static functions
+                matches.push_back(match);
 
-                } else {
-                    // Non static function.
-                    if(!(flags & kLookupFlags_Static)) { matches.push_back(match); }
-                }
+            } else {
+                // Non static function.
+                if(!(flags & kLookupFlags_Static)) { matches.push_back(match); }
             }
         }
 
-        {
-            // load function aliases
-            wxString sql;
-            sql << "SELECT * from FUNCTION_ALIAS_TABLE WHERE SCOPE_ID=" << parentId << " AND ";
-            DoAddNameFilter(sql, nameHint, flags);
-            DoAddLimit(sql);
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityFunctionAlias());
-                match->FromResultSet(res);
-                const wxString& realFuncName = match->Cast<PHPEntityFunctionAlias>()->GetRealname();
-                // Load the function pointed by this reference
-                PHPEntityBase::Ptr_t pFunc = FindFunction(realFuncName);
-                if(pFunc) {
-                    // Keep the reference to the real function
-                    match->Cast<PHPEntityFunctionAlias>()->SetFunc(pFunc);
-                    matches.push_back(match);
-                }
+        // load function aliases
+        for(PHPEntityBase::Ptr_t match : filterByName(members.aliases)) {
+            const wxString& realFuncName = match->Cast<PHPEntityFunctionAlias>()->GetRealname();
+            // Load the function pointed by this reference
+            PHPEntityBase::Ptr_t pFunc = FindFunction(realFuncName);
+            if(pFunc) {
+                // Keep the reference to the real function
+                match->Cast<PHPEntityFunctionAlias>()->SetFunc(pFunc);
+                matches.push_back(match);
             }
         }
 
-        {
-            // Add members from the variables table
-            wxString sql;
-            sql << "SELECT * from VARIABLES_TABLE WHERE SCOPE_ID=" << parentId << " AND ";
-            DoAddNameFilter(sql, nameHint, flags);
-            DoAddLimit(sql);
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityVariable());
-                match->FromResultSet(res);
-
-                if(flags & kLookupFlags_FunctionsAndConstsOnly) {
-                    // Filter non consts from the list
-                    if(!match->Cast<PHPEntityVariable>()->IsConst() && !match->Cast<PHPEntityVariable>()->IsDefine()) {
-                        continue;
-                    }
+        // Add members from the variables table
+        for(PHPEntityBase::Ptr_t match : filterByName(members.variables)) {
+            if(flags & kLookupFlags_FunctionsAndConstsOnly) {
+                // Filter non consts from the list
+                if(!match->Cast<PHPEntityVariable>()->IsConst() && !match->Cast<PHPEntityVariable>()->IsDefine()) {
+                    continue;
                 }
-
-                bool isConst = match->Cast<PHPEntityVariable>()->IsConst();
-                bool isStatic = match->Cast<PHPEntityVariable>()->IsStatic();
-                bool bAddIt = ((isStatic || isConst) && CollectingStatics(flags)) ||
-                              (!isStatic && !isConst && !CollectingStatics(flags));
-                if(bAddIt) { matches.push_back(match); }
             }
-            DoFixVarsDocComment(matches, parentId);
+
+            bool isConst = match->Cast<PHPEntityVariable>()->IsConst();
+            bool isStatic = match->Cast<PHPEntityVariable>()->IsStatic();
+            bool bAddIt = ((isStatic || isConst) && CollectingStatics(flags)) ||
+                          (!isStatic && !isConst && !CollectingStatics(flags));
+            if(bAddIt) { matches.push_back(match); }
         }
+        DoFixVarsDocComment(matches, parentId);
 
     } catch(wxSQLite3Exception& e) {
         CL_WARNING("PHPLookupTable::FindChildren: %s", e.GetMessage());
@@ -998,12 +959,36 @@ void PHPLookupTable::ClearAll(bool autoCommit)
         }
 
         if(autoCommit) m_db.Commit();
+        m_graph.Clear();
     } catch(wxSQLite3Exception& e) {
         if(autoCommit) m_db.Rollback();
         CL_WARNING("PHPLookupTable::ClearAll: %s", e.GetMessage());
     }
 }
 
+void PHPLookupTable::ResetSymbolsCache() { m_graph.Clear(); }
+
+void PHPLookupTable::UpdateSymbolsCache(const wxFileName& filename)
+{
+    if(!m_graph.IsLoaded()) return;
+    try {
+        m_graph.UpdateFile(m_db, filename);
+    } catch(wxSQLite3Exception& e) {
+        CL_WARNING("PHPLookupTable::UpdateSymbolsCache: %s", e.GetMessage());
+        m_graph.Clear();
+    }
+}
+
+PHPEntityGraph& PHPLookupTable::GetGraph()
+{
+    if(!m_graph.IsLoaded()) {
+        wxStopWatch sw;
+        m_graph.Load(m_db);
+        clDEBUG() << "PHPLookupTable: symbols loaded into memory in" << sw.Time() << "ms" << clEndl;
+    }
+    return m_graph;
+}
+
 PHPEntityBase::Ptr_t PHPLookupTable::FindFunction(const wxString& fullname)
 {
     // locate the scope
@@ -1053,16 +1038,13 @@ PHPEntityBase::Ptr_t PHPLookupTable::CreateNamespaceForDefine(PHPEntityBase::Ptr
     wxString nameSpaceName, shortName;
     DoSplitFullname(define->GetFullName(), nameSpaceName, shortName);
 
-    PHPEntityBase::Ptr_t pNamespace = DoFindScope(nameSpaceName, kPhpScopeTypeNamespace);
-    if(!pNamespace) {
-        // Create it
-        pNamespace.Reset(new PHPEntityNamespace());
-        pNamespace->SetFullName(nameSpaceName);
-        pNamespace->SetShortName(nameSpaceName.AfterLast('\\'));
-        pNamespace->SetFilename(define->GetFilename());
-        pNamespace->SetLine(define->GetLine());
-        pNamespace->Store(this);
-    }
+    // Store() picks the database ID of the namespace if it already exists
+    PHPEntityBase::Ptr_t pNamespace(new PHPEntityNamespace());
+    pNamespace->SetFullName(nameSpaceName);
+    pNamespace->SetShortName(nameSpaceName.AfterLast('\\'));
+    pNamespace->SetFilename(define->GetFilename());
+    pNamespace->SetLine(define->GetLine());
+    pNamespace->Store(this);
     return pNamespace;
 }
 
@@ -1269,25 +1251,15 @@ PHPEntityBase::List_t PHPLookupTable::FindSymbol(const wxString& name)
 
 void PHPLookupTable::DoFixVarsDocComment(PHPEntityBase::List_t& matches, wxLongLong parentId)
 {
-    // Load all PHPDocVar belonged to this class
-    PHPDocVar::Map_t docs;
-    wxString sql;
-    sql << "SELECT * from PHPDOC_VAR_TABLE WHERE SCOPE_ID=" << parentId;
-    DoAddLimit(sql);
-    wxSQLite3Statement st = m_db.PrepareStatement(sql);
-    wxSQLite3ResultSet res = st.ExecuteQuery();
-
-    while(res.NextRow()) {
-        PHPDocVar::Ptr_t var(new PHPDocVar());
-        var->FromResultSet(res);
-        docs.insert(std::make_pair(var->GetName(), var));
-    }
+    // The PHPDocVar belonged to this class
+    const PHPDocVar::Map_t& docs = GetGraph().GetMembers(m_db, parentId).docs;
 
     // Let the PHPDOC table content override the matches' type
     std::for_each(matches.begin(), matches.end(), [&](PHPEntityBase::Ptr_t match) {
         if(match->Is(kEntityTypeVariable)) {
-            if(docs.count(match->GetShortName())) {
-                PHPDocVar::Ptr_t docvar = docs.find(match->GetShortName())->second;
+            PHPDocVar::Map_t::const_iterator iter = docs.find(match->GetShortName());
+            if(iter != docs.end()) {
+                PHPDocVar::Ptr_t docvar = iter->second;
                 if(!docvar->GetType().IsEmpty()) { match->Cast<PHPEntityVariable>()->SetTypeHint(docvar->GetType()); }
             }
         }
@@ -1296,16 +1268,24 @@ void PHPLookupTable::DoFixVarsDocComment(PHPEntityBase::List_t& matches, wxLongL
 
 void PHPLookupTable::UpdateClassCache(const wxString& classname)
 {
+    std::lock_guard<std::mutex> locker(m_allClassesLock);
     if(m_allClasses.count(classname) == 0) { m_allClasses.insert(classname); }
 }
 
-bool PHPLookupTable::ClassExists(const wxString& classname) const { return m_allClasses.count(classname) != 0; }
+bool PHPLookupTable::ClassExists(const wxString& classname) const
+{
+    std::lock_guard<std::mutex> locker(m_allClassesLock);
+    return m_allClasses.count(classname) != 0;
+}
 
 void PHPLookupTable::RebuildClassCache()
 {
     // locate the scope
     clDEBUG() << "Rebuilding PHP class cache..." << clEndl;
-    m_allClasses.clear();
+    {
+        std::lock_guard<std::mutex> locker(m_allClassesLock);
+        m_allClasses.clear();
+    }
     size_t count = 0;
     try {
         wxString sql;
@@ -1424,3 +1404,164 @@ void PHPLookupTable::ParseFolder(const wxString& folder, const wxString& filemas
         }
     });
 }
+
+void PHPLookupTable::RecreateSymbolsDatabaseInParallel(const wxArrayString& files, eUpdateMode updateMode,
+                                                       const std::function<bool()>& pFuncGoingDown,
+                                                       bool parseFuncBodies, size_t workersCount)
+{
+    {
+        clParseEvent event(wxPHP_PARSE_STARTED);
+        event.SetTotalFiles(files.GetCount());
+        event.SetCurfileIndex(0);
+        EventNotifier::Get()->AddPendingEvent(event);
+    }
+
+    wxStopWatch sw;
+    {
+        // clear the cache
+        std::lock_guard<std::mutex> locker(m_allClassesLock);
+        m_allClasses.clear();
+    }
+
+    // Collect the files that need to be parsed. The database is accessed from this thread only
+    std::vector<wxFileName> filesToParse;
+    filesToParse.reserve(files.GetCount());
+    for(size_t i = 0; i < files.GetCount(); ++i) {
+        wxFileName fnFile(files.Item(i));
+        if(!fnFile.Exists() || FileExtManager::GetType(fnFile.GetFullName()) != FileExtManager::TypePhp) {
+            continue;
+        }
+        if(updateMode == kUpdateMode_Fast) {
+            time_t lastModifiedOnDisk = fnFile.GetModificationTime().GetTicks();
+            wxLongLong lastModifiedInDB = GetFileLastParsedTimestamp(fnFile);
+            if(lastModifiedOnDisk <= lastModifiedInDB.ToLong()) { continue; }
+        }
+        filesToParse.push_back(fnFile);
+    }
+    const size_t skippedCount = files.GetCount() - filesToParse.size();
+
+    struct ParsedFile {
+        bool done = false;
+        std::unique_ptr<PHPSourceFile> source; // null if the file could not be read
+    };
+
+    workersCount = std::max((size_t)1, std::min(workersCount, filesToParse.size()));
+    const size_t window = workersCount * PARALLEL_PARSE_WINDOW_PER_WORKER;
+    std::vector<ParsedFile> parsedFiles(filesToParse.size());
+    std::mutex lock;
+    std::condition_variable cv;
+    size_t nextFile = 0;
+    size_t storedFiles = 0;
+    bool abort = false;
+
+    // The parser threads take the files in order, and never run more than 'window' files ahead of this thread. They
+    // don't read the class cache (this thread fills it while they parse): the type hints which depend on it are
+    // resolved by this thread just before the file is stored, with the classes of the files stored before it, like a
+    // serial parse
+    std::vector<std::thread> workers;
+    for(size_t w = 0; w < workersCount && !filesToParse.empty(); ++w) {
+        workers.push_back(std::thread([&]() {
+            while(true) {
+                size_t index;
+                {
+                    std::unique_lock<std::mutex> locker(lock);
+                    cv.wait(locker, [&]() {
+                        return abort || nextFile >= filesToParse.size() || nextFile < storedFiles + window;
+                    });
+                    if(abort || nextFile >= filesToParse.size()) { return; }
+                    index = nextFile++;
+                }
+
+                std::unique_ptr<PHPSourceFile> source;
+                const wxFileName& fnSourceFile = filesToParse[index];
+                wxString content;
+                if(FileUtils::ReadFileContent(fnSourceFile, content, wxConvISO8859_1)) {
+                    source.reset(new PHPSourceFile(content, this));
+                    source->SetFilename(fnSourceFile);
+                    source->SetParseFunctionBody(parseFuncBodies);
+                    source->SetDelayClassLookups(true);
+                    source->Parse();
+                } else {
+                    clWARNING() << "PHP: Failed to read file:" << fnSourceFile << "for parsing" << clEndl;
+                }
+
+                {
+                    std::lock_guard<std::mutex> locker(lock);
+                    parsedFiles[index].source.swap(source);
+                    parsedFiles[index].done = true;
+                }
+                cv.notify_all();
+            }
+        }));
+    }
+
+    // Store the parsed files as they become available
+    wxStopWatch progressTimer;
+    size_t i = 0;
+    try {
+        m_db.Begin();
+        for(; i < filesToParse.size(); ++i) {
+            if(pFuncGoingDown()) { break; }
+
+            std::unique_ptr<PHPSourceFile> source;
+            {
+                std::unique_lock<std::mutex> locker(lock);
+                cv.wait(locker, [&]() { return parsedFiles[i].done; });
+                source.swap(parsedFiles[i].source);
+                storedFiles = i + 1;
+            }
+            cv.notify_all();
+
+            if(source) {
+                source->ResolveClassLookups();
+                UpdateSourceFile(*source, false);
+            }
+            if((i + 1) % PARALLEL_PARSE_COMMIT_INTERVAL == 0) {
+                m_db.Commit();
+                m_db.Begin();
+            }
+
+            if(progressTimer.Time() >= PARALLEL_PARSE_PROGRESS_INTERVAL) {
+                progressTimer.Start();
+                long elapsedMs = sw.Time();
+                clParseEvent event(wxPHP_PARSE_PROGRESS);
+                event.SetTotalFiles(files.GetCount());
+                event.SetCurfileIndex(skippedCount + i + 1);
+                event.SetFilesPerSecond(elapsedMs ? ((i + 1) * 1000) / elapsedMs : 0);
+                event.SetFileName(filesToParse[i].GetFullPath());
+                EventNotifier::Get()->AddPendingEvent(event);
+            }
+        }
+        m_db.Commit();
+
+    } catch(wxSQLite3Exception& e) {
+        try {
+            m_db.Rollback();
+
+        } catch(...) {
+        }
+        clWARNING() << "PHPLookupTable::RecreateSymbolsDatabaseInParallel:" << e.GetMessage() << clEndl;
+    }
+
+    // Stop the parser threads
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        abort = true;
+    }
+    cv.notify_all();
+    for(std::thread& worker : workers) {
+        worker.join();
+    }
+
+    long elapsedMs = sw.Time();
+    clDEBUG() << "PHP: parsed" << i << "files (out of" << files.GetCount() << ") in" << elapsedMs
+              << "milliseconds using" << workersCount << "threads" << clEndl;
+
+    {
+        // always make sure that the end event is sent
+        clParseEvent event(wxPHP_PARSE_ENDED);
+        event.SetTotalFiles(files.GetCount());
+        event.SetCurfileIndex(files.GetCount());
+        EventNotifier::Get()->AddPendingEvent(event);
+    }
+}
@@ -27,6 +27,7 @@
 #define PHPLOOKUPTABLE_H
 
 #include "PHPEntityBase.h"
+#include "PHPEntityGraph.h"
 #include "PHPSourceFile.h"
 #include "cl_command_event.h"
 #include "codelite_exports.h"
@@ -36,6 +37,8 @@
 #include "fileutils.h"
 #include "smart_ptr.h"
 #include "wx/wxsqlite3.h"
+#include <functional>
+#include <mutex>
 #include <set>
 #include <unordered_set>
 #include <vector>
@@ -47,6 +50,7 @@
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxPHP_PARSE_STARTED, clParseEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxPHP_PARSE_ENDED, clParseEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxPHP_PARSE_PROGRESS, clParseEvent);
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxPHP_FILE_PARSED, clParseEvent);
 
 enum ePhpScopeType {
     kPhpScopeTypeAny = -1,
@@ -65,6 +69,8 @@ class WXDLLIMPEXP_CL PHPLookupTable
     wxFileName m_filename;
     size_t m_sizeLimit;
     std::unordered_set<wxString> m_allClasses;
+    mutable std::mutex m_allClassesLock; // the parser threads read m_allClasses while the symbols are stored
+    PHPEntityGraph m_graph;
 
 public:
     enum eLookupFlags {
@@ -94,6 +100,12 @@ public:
 private:
     void EnsureIntegrity(const wxFileName& filename);
     void DoAddNameFilter(wxString& sql, const wxString& nameHint, size_t flags);
+    bool DoMatchName(const wxString& name, const wxString& nameHint, size_t flags) const;
+
+    /**
+     * @brief the entity graph used by the lookups, loaded on first use. Throws wxSQLite3Exception
+     */
+    PHPEntityGraph& GetGraph();
 
     void CreateSchema();
     PHPEntityBase::Ptr_t DoFindMemberOf(wxLongLong parentDbId, const wxString& exactName,
@@ -222,6 +234,17 @@ public:
      */
     void ClearAll(bool autoCommit = true);
 
+    /**
+     * @brief drop the in-memory symbols, they are reloaded from the database by the next lookup.
+     * Call this when the database was rebuilt by another PHPLookupTable instance
+     */
+    void ResetSymbolsCache();
+
+    /**
+     * @brief 'filename' was re-parsed by another PHPLookupTable instance: refresh its in-memory symbols
+     */
+    void UpdateSymbolsCache(const wxFileName& filename);
+
     /**
      * @brief find a scope symbol (class or namespace) by its fullname
      */
@@ -287,6 +310,14 @@ public:
     template <typename GoindDownFunc>
     void RecreateSymbolsDatabase(const wxArrayString& files, eUpdateMode updateMode, GoindDownFunc pFuncGoingDown,
                                  bool parseFuncBodies = true);
+
+    /**
+     * @brief same as RecreateSymbolsDatabase, but the files are lexed and parsed by 'workersCount' threads while the
+     * calling thread stores their symbols into the database (committing every few thousands files)
+     */
+    void RecreateSymbolsDatabaseInParallel(const wxArrayString& files, eUpdateMode updateMode,
+                                           const std::function<bool()>& pFuncGoingDown, bool parseFuncBodies,
+                                           size_t workersCount);
     
     /**
      * @brief parse folder
@@ -328,7 +359,11 @@ void PHPLookupTable::RecreateSymbolsDatabase(const wxArrayString& files, eUpdate
         wxStopWatch sw;
         sw.Start();
 
-        m_allClasses.clear(); // clear the cache
+        {
+            // clear the cache
+            std::lock_guard<std::mutex> locker(m_allClassesLock);
+            m_allClasses.clear();
+        }
         m_db.Begin();
         for(size_t i = 0; i < files.GetCount(); ++i) {
             if(pFuncGoingDown()) { break; }
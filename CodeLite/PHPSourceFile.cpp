@@ -483,6 +483,13 @@ void PHPSourceFile::ParseFunctionSignature(int startingDepth)
             }
             var->SetFullName(name);
             var->SetTypeHint(MakeIdentifierAbsolute(typeHint));
+            if(m_delayedLookups.count(typeHint)) {
+                DelayedTypeHint delayed;
+                delayed.var = var;
+                delayed.className = typeHint;
+                delayed.globalTypeHint = MakeIdentifierAbsolute(m_delayedLookups[typeHint]);
+                m_delayedTypeHints.push_back(delayed);
+            }
             break;
         case '(':
             depth++;
@@ -1377,31 +1384,12 @@ wxString PHPSourceFile::DoMakeIdentifierAbsolute(const wxString& type, bool exac
 {
     if(m_converter) { return m_converter->MakeIdentifierAbsolute(type); }
 
-    static std::unordered_set<std::string> phpKeywords;
-    if(phpKeywords.empty()) {
-        // List taken from https://www.php.net/manual/en/language.types.intro.php
-        // Native types
-        phpKeywords.insert("bool");
-        phpKeywords.insert("int");
-        phpKeywords.insert("float");
-        phpKeywords.insert("string");
-        phpKeywords.insert("array");
-        phpKeywords.insert("object");
-        phpKeywords.insert("iterable");
-        phpKeywords.insert("callable");
-        phpKeywords.insert("null");
-        phpKeywords.insert("mixed");
-        phpKeywords.insert("void");
-        // Types that are common in documentation
-        phpKeywords.insert("boolean");
-        phpKeywords.insert("integer");
-        phpKeywords.insert("double");
-        phpKeywords.insert("real");
-        phpKeywords.insert("binery");
-        phpKeywords.insert("resource");
-        phpKeywords.insert("number");
-        phpKeywords.insert("callback");
-    }
+    // List taken from https://www.php.net/manual/en/language.types.intro.php
+    // (const, so that the files can be parsed by several threads)
+    static const std::unordered_set<std::string> phpKeywords = {
+        "bool", "int", "float", "string", "array", "object", "iterable", "callable", "null", "mixed", "void",
+        "boolean", "integer", "double", "real", "binery", "resource", "number", "callback"
+    };
     wxString typeWithNS(type);
     typeWithNS.Trim().Trim(false);
 
@@ -1438,7 +1426,11 @@ wxString PHPSourceFile::DoMakeIdentifierAbsolute(const wxString& type, bool exac
     wxString ns = Namespace()->GetFullName();
     if(!ns.EndsWith("\\")) { ns << "\\"; }
 
-    if(exactMatch && m_lookup && !typeWithNS.Contains("\\") && !m_lookup->ClassExists(ns + typeWithNS)) {
+    if(exactMatch && m_lookup && !typeWithNS.Contains("\\") && m_delayClassLookups) {
+        // decided by ResolveClassLookups(), use the current namespace meanwhile
+        m_delayedLookups[ns + typeWithNS] = "\\" + typeWithNS;
+        typeWithNS.Prepend(ns);
+    } else if(exactMatch && m_lookup && !typeWithNS.Contains("\\") && !m_lookup->ClassExists(ns + typeWithNS)) {
         // Only when "exactMatch" apply this logic, otherwise, we might be getting a partialy typed string
         // which we will not find by calling FindChild()
         typeWithNS.Prepend("\\"); // Use the global NS
@@ -1447,3 +1439,12 @@ wxString PHPSourceFile::DoMakeIdentifierAbsolute(const wxString& type, bool exac
     }
     return typeWithNS;
 }
+
+void PHPSourceFile::ResolveClassLookups()
+{
+    for(const DelayedTypeHint& delayed : m_delayedTypeHints) {
+        if(!m_lookup->ClassExists(delayed.className)) { delayed.var->SetTypeHint(delayed.globalTypeHint); }
+    }
+    m_delayedTypeHints.clear();
+    m_delayedLookups.clear();
+}
@@ -33,6 +33,7 @@
 #include <vector>
 
 class WXDLLIMPEXP_CL PHPLookupTable;
+class PHPEntityVariable;
 
 class WXDLLIMPEXP_CL PHPSourceFile
 {
@@ -51,6 +52,16 @@ class WXDLLIMPEXP_CL PHPSourceFile
     PHPSourceFile* m_converter;
     PHPLookupTable* m_lookup;
 
+    // A function argument type hint which depends on the classes known to the lookup table
+    struct DelayedTypeHint {
+        PHPEntityVariable* var;
+        wxString className;      // the class to look for
+        wxString globalTypeHint; // the type hint to use if the class does not exist
+    };
+    bool m_delayClassLookups = false;
+    std::map<wxString, wxString> m_delayedLookups; // class name in the current namespace -> global class name
+    std::vector<DelayedTypeHint> m_delayedTypeHints;
+
 public:
     typedef wxSharedPtr<PHPSourceFile> Ptr_t;
 
@@ -241,6 +252,18 @@ public:
      */
     void SetTypeAbsoluteConverter(PHPSourceFile* converter) { m_converter = converter; }
 
+    /**
+     * @brief don't look for classes in the lookup table while parsing, ResolveClassLookups() does it after the
+     * parse. Used when the file is parsed in a worker thread while the lookup table is being filled: the result then
+     * depends on when ResolveClassLookups() is called, not on the timing of the worker
+     */
+    void SetDelayClassLookups(bool delayClassLookups) { m_delayClassLookups = delayClassLookups; }
+
+    /**
+     * @brief complete the class lookups delayed by SetDelayClassLookups(true)
+     */
+    void ResolveClassLookups();
+
     /**
      * @brief check if we are inside a PHP block at the end of the given buffer
      */
@@ -236,12 +236,19 @@ void clSocketAsyncThread::BufferLoop(clSocketBase::Ptr_t socket)
             }
 
             // timeout, test to see if we got something on the socket
-            wxString buffer;
             if(socket->SelectReadMS(5) == clSocketBase::kSuccess) {
-                int rc = socket->Read(buffer);
-                if(rc == clSocketBase::kSuccess) {
-                    clCommandEvent event(wxEVT_ASYNC_SOCKET_INPUT);
+                int rc;
+                clCommandEvent event(wxEVT_ASYNC_SOCKET_INPUT);
+                if(m_mode & kAsyncSocketRawBuffer) {
+                    wxMemoryBuffer buffer;
+                    rc = socket->Read(buffer);
+                    event.SetStringRaw(std::string((const char*)buffer.GetData(), buffer.GetDataLen()));
+                } else {
+                    wxString buffer;
+                    rc = socket->Read(buffer);
                     event.SetString(buffer);
+                }
+                if(rc == clSocketBase::kSuccess) {
                     m_sink->AddPendingEvent(event);
 
                 } else if(rc == clSocketBase::kError) {
@@ -48,6 +48,7 @@ enum eAsyncSocketMode {
     kAsyncSocketMessage = (1 << 2),
     kAsyncSocketBuffer = (1 << 3),
     kAsyncSocketNonBlocking = (1 << 4),
+    kAsyncSocketRawBuffer = (1 << 5), // with kAsyncSocketBuffer: the input events carry the bytes read (GetStringRaw())
 };
 
 class WXDLLIMPEXP_CL clSocketAsyncThread : public wxThread
@@ -85,7 +85,7 @@ bool UnixProcess::ReadAll(int fd, std::string& content, int timeoutMilliseconds)
             int len = read(fd, buff, (sizeof(buff) - 1));
             if(len > 0) {
                 buff[len] = 0;
-                content.append(buff);
+                content.append(buff, len);
                 if(content.length() >= MAX_BUFF_SIZE) { return true; }
                 // clear the tv struct so next select() call will return immediately
                 tv.tv_usec = 0;
@@ -177,8 +177,9 @@ void UnixProcess::StartReaderThread()
                     process->m_owner->AddPendingEvent(evt);
                     break;
                 } else if(!content.empty()) {
+                    // stdout is delivered as is: it may be binary data or text in any encoding
                     clProcessEvent evt(wxEVT_ASYNC_PROCESS_OUTPUT);
-                    evt.SetOutput(wxString() << content);
+                    evt.SetOutputRaw(content);
                     process->m_owner->AddPendingEvent(evt);
                 }
                 content.clear();
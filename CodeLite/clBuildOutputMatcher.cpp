@@ -0,0 +1,432 @@
+#include "clBuildOutputMatcher.h"
+#include <algorithm>
+#include <deque>
+#include <string>
+
+namespace
+{
+/**
+ * @brief the literals required by a part of a pattern: any text matched by it contains one of 'literals'
+ */
+struct Required {
+    bool any = true; // nothing is required
+    std::vector<std::string> literals;
+
+    size_t MinLength() const
+    {
+        size_t len = std::string::npos;
+        for(const std::string& literal : literals) {
+            len = std::min(len, literal.length());
+        }
+        return len;
+    }
+
+    /**
+     * @brief is this a better (more selective) choice than 'other'?
+     */
+    bool IsBetterThan(const Required& other) const
+    {
+        if(any) {
+            return false;
+        }
+        if(other.any) {
+            return true;
+        }
+        size_t len = MinLength();
+        size_t otherLen = other.MinLength();
+        return len > otherLen || (len == otherLen && literals.size() < other.literals.size());
+    }
+};
+
+/**
+ * @brief a conservative parser of the ARE syntax (wxRE_ADVANCED) that collects the literals a match must contain.
+ * Whenever the pattern uses a construct it does not know, it gives up
+ */
+class LiteralsExtractor
+{
+    const wxString& m_pattern;
+    size_t m_pos = 0;
+    bool m_failed = false;
+
+protected:
+    bool AtEnd() const { return m_pos >= m_pattern.length(); }
+    wxUniChar Peek(size_t offset = 0) const
+    {
+        return (m_pos + offset) < m_pattern.length() ? m_pattern[m_pos + offset] : wxUniChar(0);
+    }
+
+    static bool IsDigit(wxUniChar ch) { return ch >= '0' && ch <= '9'; }
+    static bool IsAlnum(wxUniChar ch)
+    {
+        return IsDigit(ch) || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+    }
+
+    /**
+     * @brief skip a bracket expression, m_pos is on the opening '['
+     */
+    void SkipBracket()
+    {
+        ++m_pos;
+        if(Peek() == '^') {
+            ++m_pos;
+        }
+        if(Peek() == ']') {
+            ++m_pos; // a literal ']'
+        }
+        while(!AtEnd()) {
+            wxUniChar ch = Peek();
+            if(ch == ']') {
+                ++m_pos;
+                return;
+            } else if(ch == '\\') {
+                m_pos += 2;
+            } else if(ch == '[' && (Peek(1) == ':' || Peek(1) == '.' || Peek(1) == '=')) {
+                // [:class:], [.collating.] or [=equivalence=]
+                wxUniChar delim = Peek(1);
+                m_pos += 2;
+                while(!AtEnd() && !(Peek() == delim && Peek(1) == ']')) {
+                    ++m_pos;
+                }
+                m_pos += 2;
+            } else {
+                ++m_pos;
+            }
+        }
+        m_failed = true; // unterminated
+    }
+
+    /**
+     * @brief parse the quantifier following an atom (if any)
+     * @return 0: no quantifier, 1: the atom is required (possibly repeated), 2: the atom is optional
+     */
+    int ParseQuantifier()
+    {
+        int result = 0;
+        wxUniChar ch = Peek();
+        if(ch == '*' || ch == '?') {
+            ++m_pos;
+            result = 2;
+        } else if(ch == '+') {
+            ++m_pos;
+            result = 1;
+        } else if(ch == '{' && IsDigit(Peek(1))) {
+            ++m_pos;
+            long min = 0;
+            while(IsDigit(Peek())) {
+                min = min * 10 + (Peek().GetValue() - '0');
+                ++m_pos;
+            }
+            while(!AtEnd() && Peek() != '}') {
+                ++m_pos;
+            }
+            if(AtEnd()) {
+                m_failed = true;
+                return 0;
+            }
+            ++m_pos;
+            result = (min == 0) ? 2 : 1;
+        } else {
+            return 0;
+        }
+        if(Peek() == '?') {
+            ++m_pos; // non greedy
+        }
+        return result;
+    }
+
+    Required ParseSequence()
+    {
+        Required best;
+        std::string run;
+        auto endRun = [&]() {
+            if(!run.empty()) {
+                Required candidate;
+                candidate.any = false;
+                candidate.literals.push_back(run);
+                if(candidate.IsBetterThan(best)) {
+                    best.any = false;
+                    best.literals.swap(candidate.literals);
+                }
+                run.clear();
+            }
+        };
+
+        while(!AtEnd() && !m_failed) {
+            wxUniChar ch = Peek();
+            if(ch == '|' || ch == ')') {
+                break;
+            }
+
+            if(ch == '(') {
+                ++m_pos;
+                if(Peek() == '?') {
+                    if(Peek(1) != ':') {
+                        m_failed = true; // lookahead or embedded options
+                        break;
+                    }
+                    m_pos += 2;
+                }
+                Required group = ParseAlternation();
+                if(m_failed || Peek() != ')') {
+                    m_failed = true;
+                    break;
+                }
+                ++m_pos;
+                endRun();
+                if(ParseQuantifier() != 2 && group.IsBetterThan(best)) {
+                    best = group;
+                }
+                continue;
+            }
+
+            // a single character atom: 'literal' is set when it matches exactly one (ASCII) character
+            bool isLiteral = false;
+            char literal = 0;
+            if(ch == '\\') {
+                wxUniChar escaped = Peek(1);
+                if(escaped == 0 || IsDigit(escaped) || escaped == 'x' || escaped == 'u' || escaped == 'U' ||
+                   escaped == 'c') {
+                    m_failed = true; // back references and multi-character escapes
+                    break;
+                }
+                m_pos += 2;
+                if(!IsAlnum(escaped) && escaped.IsAscii()) {
+                    isLiteral = true;
+                    literal = (char)escaped.GetValue();
+                }
+            } else if(ch == '[') {
+                SkipBracket();
+            } else if(ch == '{' || ch == '*' || ch == '+' || ch == '?') {
+                m_failed = true; // a quantifier without an atom
+                break;
+            } else {
+                ++m_pos;
+                if(ch != '.' && ch != '^' && ch != '$' && ch.IsAscii()) {
+                    isLiteral = true;
+                    literal = (char)ch.GetValue();
+                }
+            }
+
+            int quantifier = ParseQuantifier();
+            if(!isLiteral || quantifier == 2) {
+                endRun();
+            } else {
+                run.push_back((literal >= 'A' && literal <= 'Z') ? (literal - 'A' + 'a') : literal);
+                if(quantifier == 1) {
+                    endRun();
+                }
+            }
+        }
+        endRun();
+        return best;
+    }
+
+    Required ParseAlternation()
+    {
+        Required result = ParseSequence();
+        while(!m_failed && Peek() == '|') {
+            ++m_pos;
+            Required branch = ParseSequence();
+            if(result.any || branch.any) {
+                result.any = true;
+                result.literals.clear();
+            } else {
+                for(const std::string& literal : branch.literals) {
+                    if(std::find(result.literals.begin(), result.literals.end(), literal) == result.literals.end()) {
+                        result.literals.push_back(literal);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+public:
+    LiteralsExtractor(const wxString& pattern)
+        : m_pattern(pattern)
+    {
+    }
+
+    Required Extract()
+    {
+        if(m_pattern.StartsWith("***")) {
+            return Required(); // a director
+        }
+        Required result = ParseAlternation();
+        if(m_failed || !AtEnd()) {
+            return Required();
+        }
+        return result;
+    }
+};
+} // namespace
+
+clBuildOutputMatcher::clBuildOutputMatcher() {}
+
+clBuildOutputMatcher::~clBuildOutputMatcher() {}
+
+void clBuildOutputMatcher::Clear()
+{
+    m_patterns.clear();
+    m_nodes.clear();
+    m_candidates.clear();
+    m_compiled = false;
+}
+
+int clBuildOutputMatcher::AddNode()
+{
+    m_nodes.push_back(Node());
+    m_nodes.back().next.fill(wxNOT_FOUND);
+    return m_nodes.size() - 1;
+}
+
+bool clBuildOutputMatcher::Add(const wxString& pattern, eSeverity severity, const wxString& fileIndex,
+                               const wxString& lineIndex, const wxString& columnIndex)
+{
+    Pattern p;
+    if(!fileIndex.ToLong(&p.fileIndex) || !lineIndex.ToLong(&p.lineIndex) || !columnIndex.ToLong(&p.columnIndex)) {
+        return false;
+    }
+    p.regex.reset(new wxRegEx(pattern, wxRE_ADVANCED | wxRE_ICASE));
+    if(!p.regex->IsValid()) {
+        return false;
+    }
+    p.severity = severity;
+    p.literals = GetRequiredLiterals(pattern);
+    m_patterns.push_back(p);
+    m_compiled = false;
+    return true;
+}
+
+void clBuildOutputMatcher::AddLiteral(const wxString& literal, size_t patternIndex)
+{
+    int state = 0;
+    for(wxString::const_iterator iter = literal.begin(); iter != literal.end(); ++iter) {
+        int ch = (*iter).GetValue();
+        int next = m_nodes[state].next[ch];
+        if(next == wxNOT_FOUND) {
+            next = AddNode();
+            m_nodes[state].next[ch] = next;
+        }
+        state = next;
+    }
+    m_nodes[state].patterns.push_back(patternIndex);
+}
+
+void clBuildOutputMatcher::Compile()
+{
+    m_nodes.clear();
+    AddNode();
+    for(size_t i = 0; i < m_patterns.size(); ++i) {
+        for(const wxString& literal : m_patterns[i].literals) {
+            AddLiteral(literal, i);
+        }
+    }
+
+    // turn the trie into an automaton: breadth first, each node inherits the outputs of its failure node and the
+    // missing transitions are taken from it
+    std::deque<int> queue;
+    Node& root = m_nodes[0];
+    for(int& next : root.next) {
+        if(next == wxNOT_FOUND) {
+            next = 0;
+        } else {
+            m_nodes[next].fail = 0;
+            queue.push_back(next);
+        }
+    }
+
+    while(!queue.empty()) {
+        int state = queue.front();
+        queue.pop_front();
+        for(size_t ch = 0; ch < 128; ++ch) {
+            int next = m_nodes[state].next[ch];
+            int fallback = m_nodes[m_nodes[state].fail].next[ch];
+            if(next == wxNOT_FOUND) {
+                m_nodes[state].next[ch] = fallback;
+                continue;
+            }
+            m_nodes[next].fail = fallback;
+            const std::vector<size_t>& inherited = m_nodes[fallback].patterns;
+            m_nodes[next].patterns.insert(m_nodes[next].patterns.end(), inherited.begin(), inherited.end());
+            queue.push_back(next);
+        }
+    }
+    m_candidates.assign(m_patterns.size(), 0);
+    m_compiled = true;
+}
+
+bool clBuildOutputMatcher::Matches(const wxString& line, Match& match)
+{
+    if(!m_compiled) {
+        Compile();
+    }
+
+    // scan the line once for the literals
+    std::fill(m_candidates.begin(), m_candidates.end(), 0);
+    int state = 0;
+    for(wxString::const_iterator iter = line.begin(); iter != line.end(); ++iter) {
+        wxUniChar::value_type ch = (*iter).GetValue();
+        if(ch >= 128) {
+            state = 0; // the literals are ASCII
+            continue;
+        }
+        if(ch >= 'A' && ch <= 'Z') {
+            ch = ch - 'A' + 'a';
+        }
+        state = m_nodes[state].next[ch];
+        for(size_t index : m_nodes[state].patterns) {
+            m_candidates[index] = 1;
+        }
+    }
+
+    for(size_t i = 0; i < m_patterns.size(); ++i) {
+        const Pattern& p = m_patterns[i];
+        if(!p.literals.IsEmpty() && !m_candidates[i]) {
+            continue;
+        }
+        wxRegEx& re = *p.regex;
+        if(!re.Matches(line)) {
+            continue;
+        }
+
+        match = Match();
+        match.severity = p.severity;
+        size_t count = re.GetMatchCount();
+        if(p.fileIndex >= 0 && count > (size_t)p.fileIndex) {
+            match.filename = re.GetMatch(line, p.fileIndex);
+        }
+
+        // keep the match length
+        match.length = re.GetMatch(line, 0).length();
+
+        long number;
+        if(p.lineIndex >= 0 && count > (size_t)p.lineIndex && re.GetMatch(line, p.lineIndex).ToLong(&number)) {
+            match.lineNumber = number - 1;
+        }
+
+        if(p.columnIndex >= 0 && count > (size_t)p.columnIndex) {
+            wxString strCol = re.GetMatch(line, p.columnIndex);
+            if(strCol.StartsWith(":")) {
+                strCol.Remove(0, 1);
+            }
+            if(!strCol.IsEmpty() && strCol.ToLong(&number)) {
+                match.column = number;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+wxArrayString clBuildOutputMatcher::GetRequiredLiterals(const wxString& pattern)
+{
+    wxArrayString literals;
+    Required required = LiteralsExtractor(pattern).Extract();
+    if(!required.any) {
+        for(const std::string& literal : required.literals) {
+            literals.Add(wxString(literal.c_str(), wxConvLibc));
+        }
+    }
+    return literals;
+}
@@ -0,0 +1,96 @@
+#ifndef CLBUILDOUTPUTMATCHER_H
+#define CLBUILDOUTPUTMATCHER_H
+
+#include "codelite_exports.h"
+#include <array>
+#include <memory>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/regex.h>
+#include <wx/string.h>
+
+/**
+ * @class clBuildOutputMatcher
+ * @brief matches build output lines against the error and warning patterns of a compiler.
+ *
+ * Most of the patterns can only match a line that contains some literal text ("error", "warning", "(.text+" ...).
+ * These literals are extracted from the patterns and compiled into a single Aho-Corasick automaton: a line is
+ * scanned once and only the patterns whose literals were found in it are run. Patterns without such a literal are
+ * always run.
+ *
+ * The regular expressions keep their last match: a matcher must be used by a single thread
+ */
+class WXDLLIMPEXP_CL clBuildOutputMatcher
+{
+public:
+    enum eSeverity {
+        kSeverityNone = 0,
+        kSeverityWarning,
+        kSeverityError,
+    };
+
+    struct Match {
+        eSeverity severity = kSeverityNone;
+        wxString filename;
+        int lineNumber = wxNOT_FOUND; // 0 based
+        int column = wxNOT_FOUND;
+        size_t length = 0; // the length of the text matched by the pattern
+    };
+
+protected:
+    struct Pattern {
+        std::shared_ptr<wxRegEx> regex;
+        long fileIndex;
+        long lineIndex;
+        long columnIndex;
+        eSeverity severity;
+        wxArrayString literals; // empty: no literal could be extracted from the pattern, it is always run
+    };
+
+    struct Node {
+        std::array<int, 128> next; // the automaton transitions (ASCII, lower case)
+        int fail = 0;
+        std::vector<size_t> patterns; // the patterns whose literal ends here
+    };
+
+    std::vector<Pattern> m_patterns;
+    std::vector<Node> m_nodes;
+    std::vector<char> m_candidates;
+    bool m_compiled = false;
+
+protected:
+    void AddLiteral(const wxString& literal, size_t patternIndex);
+    int AddNode();
+
+public:
+    clBuildOutputMatcher();
+    virtual ~clBuildOutputMatcher();
+
+    /**
+     * @brief add a pattern. The patterns are tried in the order they were added
+     * @return false if the pattern or its indexes are not valid (the pattern is ignored)
+     */
+    bool Add(const wxString& pattern, eSeverity severity, const wxString& fileIndex, const wxString& lineIndex,
+             const wxString& columnIndex);
+
+    /**
+     * @brief build the literals automaton. Matches() calls it when patterns were added since the last call
+     */
+    void Compile();
+
+    void Clear();
+    bool IsEmpty() const { return m_patterns.empty(); }
+
+    /**
+     * @brief match 'line' against the patterns, the first pattern that matches wins
+     */
+    bool Matches(const wxString& line, Match& match);
+
+    /**
+     * @brief return the literals (lower case) that any text matched by 'pattern' contains one of. An empty array
+     * means that no such literal could be found
+     */
+    static wxArrayString GetRequiredLiterals(const wxString& pattern);
+};
+
+#endif // CLBUILDOUTPUTMATCHER_H
@@ -0,0 +1,227 @@
+#include "clCodeCompletionFilter.h"
+#include <algorithm>
+#include <string.h>
+#include <wx/wxcrt.h>
+
+// the number of matches ranked by Filter(), the others are ranked when they are first requested
+#define CC_FILTER_RANKED_COUNT 100
+
+// the subsequence score
+#define CC_FILTER_SCORE_CHAR 1
+#define CC_FILTER_SCORE_WORD_START 8
+#define CC_FILTER_SCORE_CONSECUTIVE 4
+// between two keys with the same score, the shorter one ranks first
+#define CC_FILTER_SCORE_LENGTH_STEPS 16
+#define CC_FILTER_SCORE_MAX 0xFFFFFF
+
+namespace
+{
+bool IsLower(wxChar ch) { return ch >= 'a' && ch <= 'z'; }
+bool IsUpper(wxChar ch) { return ch >= 'A' && ch <= 'Z'; }
+bool IsAlnum(wxChar ch) { return IsLower(ch) || IsUpper(ch) || (ch >= '0' && ch <= '9'); }
+
+/**
+ * @brief does a word start at chars[pos]? At the start of the key, after '_' (or any other separator) and at the
+ * uppercase letter of a camelCase word
+ */
+bool IsWordStart(const wxChar* chars, size_t pos)
+{
+    if(pos == 0) {
+        return true;
+    }
+    wxChar prev = chars[pos - 1];
+    return !IsAlnum(prev) || (IsUpper(chars[pos]) && IsLower(prev));
+}
+
+uint64_t Pack(clCodeCompletionFilter::eMatchKind kind, size_t score, size_t index)
+{
+    // higher scores come first
+    score = std::min(score, (size_t)CC_FILTER_SCORE_MAX);
+    return ((uint64_t)kind << 56) | ((uint64_t)(CC_FILTER_SCORE_MAX - score) << 32) | (uint64_t)(index & 0xFFFFFFFF);
+}
+
+size_t UnpackIndex(uint64_t match) { return (size_t)(match & 0xFFFFFFFF); }
+clCodeCompletionFilter::eMatchKind UnpackKind(uint64_t match)
+{
+    return (clCodeCompletionFilter::eMatchKind)(match >> 56);
+}
+} // namespace
+
+clCodeCompletionFilter::clCodeCompletionFilter() { m_offsets.push_back(0); }
+
+clCodeCompletionFilter::~clCodeCompletionFilter() {}
+
+void clCodeCompletionFilter::Clear()
+{
+    m_chars.clear();
+    m_lowerChars.clear();
+    m_offsets.assign(1, 0);
+    m_filter.clear();
+    m_lowerFilter.clear();
+    m_filtered = false;
+    m_matches.clear();
+    m_candidates.clear();
+    m_rankedCount = 0;
+    m_startsWithCount = 0;
+    m_containsCount = 0;
+}
+
+void clCodeCompletionFilter::AddKey(const wxString& key)
+{
+    for(wxString::const_iterator iter = key.begin(); iter != key.end(); ++iter) {
+        wxChar ch = (wxChar)(*iter).GetValue();
+        m_chars.push_back(ch);
+        m_lowerChars.push_back((wxChar)wxTolower(ch));
+    }
+    m_offsets.push_back(m_chars.size());
+
+    // the previous matches do not cover this key
+    m_filtered = false;
+}
+
+bool clCodeCompletionFilter::DoMatch(size_t index, eMatchKind& kind, size_t& score) const
+{
+    size_t start = m_offsets[index];
+    size_t len = m_offsets[index + 1] - start;
+    size_t filterLen = m_lowerFilter.size();
+    if(filterLen > len) {
+        return false;
+    }
+
+    const wxChar* chars = m_chars.data() + start;
+    const wxChar* lowerChars = m_lowerChars.data() + start;
+    const wxChar* filter = m_filter.data();
+    const wxChar* lowerFilter = m_lowerFilter.data();
+    size_t filterBytes = filterLen * sizeof(wxChar);
+
+    // exact and 'starts with' matches keep the list order
+    score = 0;
+    if(memcmp(lowerChars, lowerFilter, filterBytes) == 0) {
+        bool sameCase = memcmp(chars, filter, filterBytes) == 0;
+        if(filterLen == len) {
+            kind = sameCase ? kExact : kExactNoCase;
+        } else {
+            kind = sameCase ? kStartsWith : kStartsWithNoCase;
+        }
+        return true;
+    }
+
+    // 'contains' matches keep the list order too
+    const wxChar* lowerEnd = lowerChars + len;
+    const wxChar* found = std::search(lowerChars + 1, lowerEnd, lowerFilter, lowerFilter + filterLen);
+    if(found != lowerEnd) {
+        size_t pos = found - lowerChars;
+        bool sameCase = (memcmp(chars + pos, filter, filterBytes) == 0) ||
+                        (std::search(chars + pos + 1, chars + len, filter, filter + filterLen) != chars + len);
+        kind = sameCase ? kContains : kContainsNoCase;
+        return true;
+    }
+
+    // the filter characters in order, anywhere in the key: "gfn" matches "GetFileName"
+    size_t matched = 0;
+    size_t lastPos = 0;
+    size_t total = 0;
+    for(size_t i = 0; i < len && matched < filterLen; ++i) {
+        if(lowerChars[i] != lowerFilter[matched]) {
+            continue;
+        }
+        total += CC_FILTER_SCORE_CHAR;
+        if(IsWordStart(chars, i)) {
+            total += CC_FILTER_SCORE_WORD_START;
+        }
+        if(matched && (lastPos + 1 == i)) {
+            total += CC_FILTER_SCORE_CONSECUTIVE;
+        }
+        lastPos = i;
+        ++matched;
+    }
+    if(matched < filterLen) {
+        return false;
+    }
+
+    size_t penalty = std::min(len - filterLen, (size_t)(CC_FILTER_SCORE_LENGTH_STEPS - 1));
+    kind = kSubsequence;
+    score = total * CC_FILTER_SCORE_LENGTH_STEPS - penalty;
+    return true;
+}
+
+void clCodeCompletionFilter::Filter(const wxString& filter)
+{
+    // when the new filter extends the previous one, only the previous matches can match
+    bool narrow = m_filtered && !m_lowerFilter.empty() && (filter.length() >= m_lowerFilter.size());
+    size_t prevLen = m_lowerFilter.size();
+    m_filter.clear();
+    for(wxString::const_iterator iter = filter.begin(); iter != filter.end(); ++iter) {
+        wxChar ch = (wxChar)(*iter).GetValue();
+        wxChar lowerCh = (wxChar)wxTolower(ch);
+        size_t pos = m_filter.size();
+        if(pos < prevLen) {
+            narrow = narrow && (m_lowerFilter[pos] == lowerCh);
+            m_lowerFilter[pos] = lowerCh;
+        } else {
+            m_lowerFilter.push_back(lowerCh);
+        }
+        m_filter.push_back(ch);
+    }
+    m_lowerFilter.resize(m_filter.size());
+    m_filtered = true;
+    m_startsWithCount = 0;
+    m_containsCount = 0;
+
+    size_t count = GetKeysCount();
+    m_matches.reserve(count);
+    m_candidates.reserve(count);
+
+    if(m_lowerFilter.empty()) {
+        // all the keys, in order
+        m_matches.clear();
+        for(size_t i = 0; i < count; ++i) {
+            m_matches.push_back(Pack(kExact, 0, i));
+        }
+        m_rankedCount = m_matches.size();
+        return;
+    }
+
+    eMatchKind kind;
+    size_t score;
+    if(narrow) {
+        m_candidates.swap(m_matches);
+        m_matches.clear();
+        for(size_t i = 0; i < m_candidates.size(); ++i) {
+            size_t index = UnpackIndex(m_candidates[i]);
+            if(DoMatch(index, kind, score)) {
+                m_matches.push_back(Pack(kind, score, index));
+            }
+        }
+    } else {
+        m_matches.clear();
+        for(size_t i = 0; i < count; ++i) {
+            if(DoMatch(i, kind, score)) {
+                m_matches.push_back(Pack(kind, score, i));
+            }
+        }
+    }
+
+    for(size_t i = 0; i < m_matches.size(); ++i) {
+        kind = UnpackKind(m_matches[i]);
+        if(kind <= kStartsWithNoCase) {
+            ++m_startsWithCount;
+        }
+        if(kind <= kContainsNoCase) {
+            ++m_containsCount;
+        }
+    }
+
+    // rank the first matches now, the list displays them immediately
+    m_rankedCount = std::min(m_matches.size(), (size_t)CC_FILTER_RANKED_COUNT);
+    std::partial_sort(m_matches.begin(), m_matches.begin() + m_rankedCount, m_matches.end());
+}
+
+size_t clCodeCompletionFilter::GetMatch(size_t pos) const
+{
+    if(pos >= m_rankedCount) {
+        std::sort(m_matches.begin() + m_rankedCount, m_matches.end());
+        m_rankedCount = m_matches.size();
+    }
+    return UnpackIndex(m_matches[pos]);
+}
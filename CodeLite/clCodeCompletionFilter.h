@@ -0,0 +1,93 @@
+#ifndef CLCODECOMPLETIONFILTER_H
+#define CLCODECOMPLETIONFILTER_H
+
+#include "codelite_exports.h"
+#include <stdint.h>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class clCodeCompletionFilter
+ * @brief filter and rank the code completion entries while the user types. The keys are normalized once per list and
+ * extending the filter only checks the previous matches again, so typing does not allocate.
+ *
+ * A key matches when the filter is a subsequence of it (case insensitive). The matches are ranked by kind: exact,
+ * exact (case insensitive), starts with, starts with (case insensitive), contains, contains (case insensitive) and
+ * subsequence. Within a kind, the keys keep the list order, except for the subsequence matches which are ordered by
+ * score (characters matching at a word start - camelCase or after '_' - and consecutive characters)
+ */
+class WXDLLIMPEXP_CL clCodeCompletionFilter
+{
+public:
+    enum eMatchKind {
+        kExact = 0,
+        kExactNoCase,
+        kStartsWith,
+        kStartsWithNoCase,
+        kContains,
+        kContainsNoCase,
+        kSubsequence,
+    };
+
+protected:
+    // The keys one after the other, as is and in lower case. Key 'i' is [m_offsets[i], m_offsets[i + 1])
+    std::vector<wxChar> m_chars;
+    std::vector<wxChar> m_lowerChars;
+    std::vector<size_t> m_offsets;
+
+    // The current filter
+    std::vector<wxChar> m_filter;
+    std::vector<wxChar> m_lowerFilter;
+    bool m_filtered = false;
+
+    // The matches: the match kind, the score and the key index packed in a number, so sorting them is cheap.
+    // The matches past the first ones are ranked on demand, hence 'mutable'
+    mutable std::vector<uint64_t> m_matches;
+    mutable size_t m_rankedCount = 0; // the matches [0, m_rankedCount) are in their final order
+    std::vector<uint64_t> m_candidates;
+    size_t m_startsWithCount = 0;
+    size_t m_containsCount = 0;
+
+protected:
+    bool DoMatch(size_t index, eMatchKind& kind, size_t& score) const;
+
+public:
+    clCodeCompletionFilter();
+    ~clCodeCompletionFilter();
+
+    /**
+     * @brief remove the keys
+     */
+    void Clear();
+
+    /**
+     * @brief add a key. Keys are addressed by the order they were added in
+     */
+    void AddKey(const wxString& key);
+    size_t GetKeysCount() const { return m_offsets.size() - 1; }
+
+    /**
+     * @brief filter the keys with 'filter'. An empty filter matches all the keys, in order.
+     * The first matches are ranked immediately, the others when they are first requested
+     */
+    void Filter(const wxString& filter);
+
+    size_t GetMatchesCount() const { return m_matches.size(); }
+
+    /**
+     * @brief return the index of the key ranked at 'pos'
+     */
+    size_t GetMatch(size_t pos) const;
+
+    /**
+     * @brief the number of exact and 'starts with' matches (case insensitive)
+     */
+    size_t GetStartsWithCount() const { return m_startsWithCount; }
+
+    /**
+     * @brief the number of exact, 'starts with' and 'contains' matches (case insensitive)
+     */
+    size_t GetContainsCount() const { return m_containsCount; }
+};
+
+#endif // CLCODECOMPLETIONFILTER_H
@@ -0,0 +1,44 @@
+#include "clFileReader.h"
+#include "file_logger.h"
+#include <stdio.h>
+
+// the size of a single read
+#define FILE_READER_CHUNK_SIZE (64 * 1024)
+
+clFileReader::clFileReader() {}
+
+clFileReader::~clFileReader() {}
+
+bool clFileReader::Open(const wxString& filename)
+{
+    Close();
+    FILE* fp = fopen(filename.mb_str(wxConvUTF8).data(), "rb");
+    if(!fp) { return false; }
+
+    // Read until EOF instead of trusting the file size: the file may change while we read it and special files
+    // (pipes, devices) have no size
+    size_t size = 0;
+    while(true) {
+        if(m_buffer.size() < size + FILE_READER_CHUNK_SIZE) { m_buffer.resize(size + FILE_READER_CHUNK_SIZE); }
+        size_t bytes = fread(&m_buffer[size], 1, FILE_READER_CHUNK_SIZE, fp);
+        size += bytes;
+        if(bytes < FILE_READER_CHUNK_SIZE) { break; }
+    }
+    bool ok = (ferror(fp) == 0);
+    fclose(fp);
+    if(!ok) {
+        clWARNING() << "Failed to read file:" << filename << clEndl;
+        m_buffer.clear();
+        return false;
+    }
+    m_buffer.resize(size);
+    m_isOpen = true;
+    return true;
+}
+
+void clFileReader::Close()
+{
+    // clear() keeps the capacity
+    m_buffer.clear();
+    m_isOpen = false;
+}
@@ -0,0 +1,38 @@
+#ifndef CLFILEREADER_H
+#define CLFILEREADER_H
+
+#include "codelite_exports.h"
+#include <string>
+#include <wx/string.h>
+
+/**
+ * @class clFileReader
+ * @brief read a file content into memory. The buffer is kept between Open() calls, so reading many files with the
+ * same reader allocates only when a file is larger than the previous ones.
+ * The content is read (not memory mapped) so a file truncated by another process while we scan it can not crash us
+ */
+class WXDLLIMPEXP_CL clFileReader
+{
+    std::string m_buffer;
+    bool m_isOpen = false;
+
+public:
+    clFileReader();
+    virtual ~clFileReader();
+
+    /**
+     * @brief read 'filename'. An empty file is opened successfully with GetSize() == 0
+     */
+    bool Open(const wxString& filename);
+
+    /**
+     * @brief forget the content (the buffer memory is kept for the next Open())
+     */
+    void Close();
+
+    bool IsOpen() const { return m_isOpen; }
+    const char* GetData() const { return m_buffer.data(); }
+    size_t GetSize() const { return m_buffer.size(); }
+};
+
+#endif // CLFILEREADER_H
@@ -1,14 +1,35 @@
 #include "clFileSystemWatcher.h"
 #include <algorithm>
 #include <set>
+#include "file_logger.h"
 #include "fileutils.h"
 
+#if !CL_FSW_USE_TIMER
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 wxDEFINE_EVENT(wxEVT_FILE_MODIFIED, clFileSystemEvent);
 wxDEFINE_EVENT(wxEVT_FILE_NOT_FOUND, clFileSystemEvent);
 
 // In milliseconds
 #define FILE_CHECK_INTERVAL 500
 
+#if !CL_FSW_USE_TIMER
+// A batch of changes is reported once no change was read for this long (in milliseconds)...
+#define FILE_CHANGES_QUIET_PERIOD 50
+// ... or once it is FILE_CHECK_INTERVAL old, so a file that keeps changing is still reported
+
+#define FILE_WATCH_MASK                                                                                      \
+    (IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | \
+     IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+#endif
+
 clFileSystemWatcher::clFileSystemWatcher()
     : m_owner(NULL)
 #if CL_FSW_USE_TIMER
@@ -17,51 +38,51 @@ clFileSystemWatcher::clFileSystemWatcher()
 {
 #if CL_FSW_USE_TIMER
     Bind(wxEVT_TIMER, &clFileSystemWatcher::OnTimer, this);
-#else
-    m_watcher.SetOwner(this);
-    Bind(wxEVT_FSWATCHER, &clFileSystemWatcher::OnFileModified, this);
 #endif
 }
 
 clFileSystemWatcher::~clFileSystemWatcher()
 {
-#if CL_FSW_USE_TIMER
     Stop();
+#if CL_FSW_USE_TIMER
     Unbind(wxEVT_TIMER, &clFileSystemWatcher::OnTimer, this);
-#else
-    m_watcher.RemoveAll();
-    Unbind(wxEVT_FSWATCHER, &clFileSystemWatcher::OnFileModified, this);
 #endif
 }
 
 void clFileSystemWatcher::SetFile(const wxFileName& filename)
 {
-#if CL_FSW_USE_TIMER
-    if(filename.Exists()) {
+    // the files are kept by their absolute path: it is the path the changes are reported with
+    wxFileName fn(filename);
+    fn.MakeAbsolute();
+    if(fn.Exists()) {
         m_files.clear();
         File f;
-        f.filename = filename;
-        f.lastModified = FileUtils::GetFileModificationTime(filename);
-        f.file_size = FileUtils::GetFileSize(filename);
-        m_files.insert(std::make_pair(filename.GetFullPath(), f));
+        f.filename = fn;
+        f.lastModified = FileUtils::GetFileModificationTime(fn);
+        f.file_size = FileUtils::GetFileSize(fn);
+        m_files.insert(std::make_pair(fn.GetFullPath(), f));
     }
-#else
-    m_watcher.RemoveAll();
-    wxFileName dironly = filename;
-    dironly.SetFullName(""); // must be directory only
-    m_watcher.Add(dironly);
-    m_watchedFile = filename; // but we keep the file name for later usage
+#if !CL_FSW_USE_TIMER
+    if(IsRunning()) { UpdateWatches(); }
 #endif
 }
 
 void clFileSystemWatcher::Start()
 {
-#if CL_FSW_USE_TIMER
     Stop();
-
+#if CL_FSW_USE_TIMER
     m_timer = new wxTimer(this);
     m_timer->Start(FILE_CHECK_INTERVAL, true);
 #else
+    m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(m_inotifyFd < 0) { return; }
+    if(::pipe2(m_wakeupPipe, O_CLOEXEC) != 0) {
+        ::close(m_inotifyFd);
+        m_inotifyFd = -1;
+        return;
+    }
+    UpdateWatches();
+    m_thread = new std::thread(&clFileSystemWatcher::WatcherMain, this);
 #endif
 }
 
@@ -73,18 +94,32 @@ void clFileSystemWatcher::Stop()
     }
     wxDELETE(m_timer);
 #else
-    m_watcher.RemoveAll();
+    if(m_thread) {
+        // wake up the worker thread, it exits once the pipe becomes readable
+        char ch = 'x';
+        ssize_t rc = ::write(m_wakeupPipe[1], &ch, 1);
+        wxUnusedVar(rc);
+        m_thread->join();
+        wxDELETE(m_thread);
+    }
+
+    auto closeFd = [](int& fd) {
+        if(fd >= 0) { ::close(fd); }
+        fd = -1;
+    };
+    closeFd(m_inotifyFd);
+    closeFd(m_wakeupPipe[0]);
+    closeFd(m_wakeupPipe[1]);
+    std::lock_guard<std::mutex> locker(m_watchesLock);
+    m_watches.clear();
+    m_watchedFolders.clear();
 #endif
 }
 
 void clFileSystemWatcher::Clear()
 {
-#if CL_FSW_USE_TIMER
     Stop();
     m_files.clear();
-#else
-    m_watcher.RemoveAll();
-#endif
 }
 
 #if CL_FSW_USE_TIMER
@@ -106,7 +141,7 @@ void clFileSystemWatcher::OnTimer(wxTimerEvent& event)
             // add the missing file to a set
             nonExistingFiles.insert(fn.GetFullPath());
         } else {
-            
+
 #ifdef __WXMSW__
             size_t prev_value = f.file_size;
             size_t curr_value = FileUtils::GetFileSize(fn);
@@ -145,27 +180,156 @@ void clFileSystemWatcher::OnTimer(wxTimerEvent& event)
 #endif
 
 #if !CL_FSW_USE_TIMER
-void clFileSystemWatcher::OnFileModified(wxFileSystemWatcherEvent& event)
+void clFileSystemWatcher::UpdateWatches()
 {
-    if(event.GetChangeType() == wxFSW_EVENT_MODIFY) {
-        const wxFileName& modpath = event.GetPath();
-        if(modpath == m_watchedFile) {
+    std::set<std::string> folders;
+    for(const auto& p : m_files) {
+        folders.insert(p.second.filename.GetPath().ToUTF8().data());
+    }
+
+    std::lock_guard<std::mutex> locker(m_watchesLock);
+    if(m_inotifyFd < 0) { return; }
+
+    // remove the watches we no longer need
+    for(auto iter = m_watchedFolders.begin(); iter != m_watchedFolders.end();) {
+        if(folders.count(iter->first) == 0) {
+            ::inotify_rm_watch(m_inotifyFd, iter->second);
+            m_watches.erase(iter->second);
+            iter = m_watchedFolders.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    // and add the new ones
+    for(const std::string& folder : folders) {
+        if(m_watchedFolders.count(folder)) { continue; }
+        int wd = ::inotify_add_watch(m_inotifyFd, folder.c_str(), FILE_WATCH_MASK);
+        if(wd < 0) {
+            clWARNING() << "clFileSystemWatcher: failed to watch folder" << wxString::FromUTF8(folder.c_str()) << "."
+                        << strerror(errno) << clEndl;
+            continue;
+        }
+        m_watchedFolders.insert({ folder, wd });
+        m_watches.insert({ wd, folder });
+    }
+}
+
+void clFileSystemWatcher::WatcherMain()
+{
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    std::set<std::string> changes;
+    bool checkAll = false;
+    std::chrono::steady_clock::time_point batchStart;
+
+    while(true) {
+        bool pending = checkAll || !changes.empty();
+        int timeout = pending ? FILE_CHANGES_QUIET_PERIOD : -1;
+
+        struct pollfd fds[2];
+        fds[0].fd = m_inotifyFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = m_wakeupPipe[0];
+        fds[1].events = POLLIN;
+        int rc = ::poll(fds, 2, timeout);
+        if(rc < 0 && errno == EINTR) { continue; }
+        if(rc < 0 || (fds[1].revents & POLLIN)) { break; }
+
+        if(rc > 0 && (fds[0].revents & POLLIN)) {
+            ssize_t len = ::read(m_inotifyFd, buffer, sizeof(buffer));
+            if(len > 0 && !pending) { batchStart = std::chrono::steady_clock::now(); }
+
+            std::lock_guard<std::mutex> locker(m_watchesLock);
+            for(ssize_t offset = 0; offset < len;) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+
+                auto iter = m_watches.find(event->wd);
+                if((event->mask & IN_Q_OVERFLOW) || (iter != m_watches.end() && event->len == 0)) {
+                    // events were lost or the folder itself was deleted / moved
+                    checkAll = true;
+                } else if(iter != m_watches.end()) {
+                    // the root folder path already ends with a separator
+                    std::string path = iter->second;
+                    if(path.empty() || path.back() != '/') { path.push_back('/'); }
+                    path.append(event->name);
+                    changes.insert(path);
+                }
+            }
+
+            // keep collecting changes while they keep coming, up to FILE_CHECK_INTERVAL
+            auto age = std::chrono::steady_clock::now() - batchStart;
+            if(age < std::chrono::milliseconds(FILE_CHECK_INTERVAL)) { continue; }
+        }
+
+        if(checkAll || !changes.empty()) {
+            // an empty list means "check all the files"
+            std::vector<std::string> paths;
+            if(!checkAll) { paths.assign(changes.begin(), changes.end()); }
+            CallAfter(&clFileSystemWatcher::OnFilesChanged, paths);
+            changes.clear();
+            checkAll = false;
+        }
+    }
+}
+
+void clFileSystemWatcher::OnFilesChanged(const std::vector<std::string>& paths)
+{
+    if(!IsRunning()) { return; }
+
+    std::vector<wxString> files;
+    if(paths.empty()) {
+        for(const auto& p : m_files) {
+            files.push_back(p.first);
+        }
+    } else {
+        for(const std::string& path : paths) {
+            wxString file = wxString::FromUTF8(path.c_str());
+            if(m_files.count(file)) { files.push_back(file); }
+        }
+    }
+
+    bool filesRemoved = false;
+    for(const wxString& file : files) {
+        File& f = m_files[file];
+        if(!f.filename.Exists()) {
+            if(GetOwner()) {
+                clFileSystemEvent evt(wxEVT_FILE_NOT_FOUND);
+                evt.SetPath(file);
+                GetOwner()->AddPendingEvent(evt);
+            }
+            m_files.erase(file);
+            filesRemoved = true;
+            continue;
+        }
+
+        // a file can grow within the same second, check its size as well
+        time_t lastModified = FileUtils::GetFileModificationTime(f.filename);
+        size_t fileSize = FileUtils::GetFileSize(f.filename);
+        if(lastModified != f.lastModified || fileSize != f.file_size) {
+            f.lastModified = lastModified;
+            f.file_size = fileSize;
             if(GetOwner()) {
                 clFileSystemEvent evt(wxEVT_FILE_MODIFIED);
-                evt.SetPath(modpath.GetFullPath());
+                evt.SetPath(file);
                 GetOwner()->AddPendingEvent(evt);
             }
         }
     }
+
+    if(filesRemoved) { UpdateWatches(); }
 }
 #endif
 
 void clFileSystemWatcher::RemoveFile(const wxFileName& filename)
 {
-#if CL_FSW_USE_TIMER
-    if(m_files.count(filename.GetFullPath())) {
-        m_files.erase(filename.GetFullPath());
+    wxFileName fn(filename);
+    fn.MakeAbsolute();
+    if(m_files.count(fn.GetFullPath())) {
+        m_files.erase(fn.GetFullPath());
     }
+#if !CL_FSW_USE_TIMER
+    if(IsRunning()) { UpdateWatches(); }
 #endif
 }
 
@@ -174,6 +338,6 @@ bool clFileSystemWatcher::IsRunning() const
 #if CL_FSW_USE_TIMER
     return m_timer;
 #else
-    return m_watcher.GetWatchedPathsCount();
+    return m_thread != nullptr;
 #endif
 }
@@ -7,14 +7,18 @@
 #include <wx/timer.h>
 #include <wx/filename.h>
 
-#ifdef __WXMSW__
-#define CL_FSW_USE_TIMER 1
+#ifdef __linux__
+#define CL_FSW_USE_TIMER 0
 #else
 #define CL_FSW_USE_TIMER 1
 #endif
 
 #if !CL_FSW_USE_TIMER
-#include <wx/fswatcher.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #endif
 
 class WXDLLIMPEXP_CL clFileSystemWatcher : public wxEvtHandler
@@ -28,12 +32,18 @@ public:
     };
 
     wxEvtHandler* m_owner;
-#if CL_FSW_USE_TIMER
     clFileSystemWatcher::File::Map_t m_files;
+#if CL_FSW_USE_TIMER
     wxTimer* m_timer;
 #else
-    wxFileSystemWatcher m_watcher;
-    wxFileName m_watchedFile;
+    // inotify: the folders containing the watched files are watched, the changes are read by a worker thread
+    // and reported to the main thread in batches
+    int m_inotifyFd = -1;
+    int m_wakeupPipe[2] = { -1, -1 };
+    std::thread* m_thread = nullptr;
+    std::mutex m_watchesLock; // protects m_watches and m_watchedFolders
+    std::unordered_map<int, std::string> m_watches;
+    std::unordered_map<std::string, int> m_watchedFolders;
 #endif
 
 public:
@@ -43,7 +53,9 @@ protected:
 #if CL_FSW_USE_TIMER
     void OnTimer(wxTimerEvent& event);
 #else
-    void OnFileModified(wxFileSystemWatcherEvent& event);
+    void UpdateWatches();
+    void WatcherMain();
+    void OnFilesChanged(const std::vector<std::string>& paths);
 #endif
 
 public:
@@ -66,7 +78,8 @@ public:
     /**
      * @brief start to watching list of files.
      * This object fires the following events (clFileSystemEvent):
-     * wxEVT_FILE_MODIFIED, wxEVT_FILE_DELETED
+     * wxEVT_FILE_MODIFIED, wxEVT_FILE_NOT_FOUND
+     * On Linux, the changes are reported by inotify, elsewhere the files are polled
      */
     void Start();
 
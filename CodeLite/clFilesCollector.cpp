@@ -7,6 +7,372 @@
 #include <wx/tokenzr.h>
 #include <vector>
 
+#if defined(__linux__)
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace
+{
+std::string ToUTF8String(const wxString& str)
+{
+    wxScopedCharBuffer buffer = str.ToUTF8();
+    return std::string(buffer.data(), buffer.length());
+}
+
+/**
+ * @brief a list of file masks, matched against the raw (UTF-8) bytes of a file name. Matches the same names as
+ * FileUtils::WildMatch(const wxArrayString&, const wxString&)
+ */
+class NameMasks
+{
+    bool m_matchAll = false;
+    std::vector<std::string> m_exact;
+    std::vector<std::string> m_wild;
+
+    static bool WildMatch(const char* pattern, const char* name)
+    {
+        // same as wxMatchWild(): hidden files are never matched by a wildcard
+        if(*name == '.') { return false; }
+
+        const char* starPattern = nullptr;
+        const char* starName = nullptr;
+        while(*name) {
+            if(*pattern == '*') {
+                starPattern = ++pattern;
+                starName = name;
+            } else if(*pattern == '?' || *pattern == *name) {
+                if(*pattern == '?') {
+                    // a single character, which may be more than one byte long
+                    while((((unsigned char)name[1]) & 0xC0) == 0x80) {
+                        ++name;
+                    }
+                }
+                ++pattern;
+                ++name;
+            } else if(starPattern) {
+                pattern = starPattern;
+                name = ++starName;
+            } else {
+                return false;
+            }
+        }
+        while(*pattern == '*') {
+            ++pattern;
+        }
+        return *pattern == 0;
+    }
+
+public:
+    NameMasks(const wxArrayString& masks)
+    {
+        for(const wxString& mask : masks) {
+            if(mask == "*") { m_matchAll = true; }
+            std::string str = ToUTF8String(mask);
+            if(mask.Contains("*")) {
+                m_wild.push_back(str);
+            } else {
+                m_exact.push_back(str);
+            }
+        }
+    }
+
+    bool Match(const char* name) const
+    {
+        if(m_matchAll) { return true; }
+        for(const std::string& exact : m_exact) {
+            if(exact == name) { return true; }
+        }
+        for(const std::string& wild : m_wild) {
+            if(WildMatch(wild.c_str(), name)) { return true; }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief a work stealing, multi-threaded, directory crawler. The directories are read with getdents64 and the
+ * entries are filtered on their raw names, a wxString is only created for the files collected.
+ *
+ * A folder reachable from more than one path (symlinks) is reported once. The real folders are scanned first, then
+ * the symlinked folders one by one in sorted order (a level of symlinks at a time), so the path that is reported does
+ * not depend on the threads timing: the path without symlinks if there is one, otherwise the smallest one
+ */
+class ParallelScanner
+{
+public:
+    // the filters. The folders are excluded by name, by mask or by their real path
+    NameMasks m_fileMasks;
+    NameMasks m_excludeFileMasks;
+    NameMasks m_excludeFolderMasks;
+    std::unordered_set<std::string> m_excludeFolderNames;
+    std::unordered_set<std::string> m_excludeFolderPaths;
+
+protected:
+    struct Worker {
+        std::mutex lock;
+        std::deque<std::string> folders;
+        std::vector<wxString> files;
+        std::vector<std::string> symlinks; // the symlinked folders found, scanned after the current pass
+    };
+
+    // the fixed part of linux_dirent64 (not exported by the libc headers), the NUL terminated name follows d_type
+    struct LinuxDirent64Header {
+        ino64_t d_ino;
+        off64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+    };
+
+    std::vector<Worker> m_workers;
+    std::atomic<size_t> m_pendingFolders; // queued or being read
+    std::atomic<size_t> m_queuedFolders;  // queued
+
+    // the idle workers wait for a folder to be queued or for the pass to end
+    std::mutex m_idleLock;
+    std::condition_variable m_idleCond;
+
+    // the folders visited so far, to cope with symlinks loops
+    std::mutex m_visitedLock;
+    std::set<std::pair<dev_t, ino_t> > m_visited;
+
+    bool IsExcludedFolder(const std::string& fullpath, const char* name) const
+    {
+        if(m_excludeFolderNames.count(name) || m_excludeFolderMasks.Match(name)) { return true; }
+        if(m_excludeFolderPaths.empty()) { return false; }
+
+        char* realPath = ::realpath(fullpath.c_str(), nullptr);
+        if(!realPath) { return m_excludeFolderPaths.count(fullpath) > 0; }
+        bool excluded = m_excludeFolderPaths.count(realPath) > 0;
+        free(realPath);
+        return excluded;
+    }
+
+    void Push(size_t workerIndex, std::string&& folder)
+    {
+        ++m_pendingFolders;
+        {
+            Worker& worker = m_workers[workerIndex];
+            std::lock_guard<std::mutex> locker(worker.lock);
+            worker.folders.push_back(std::move(folder));
+            ++m_queuedFolders;
+        }
+        // taking the lock makes sure that a worker about to wait sees the new folder
+        { std::lock_guard<std::mutex> locker(m_idleLock); }
+        m_idleCond.notify_one();
+    }
+
+    bool Pop(size_t workerIndex, std::string& folder)
+    {
+        // our own folders first (LIFO, the most recent folders are the "hottest" ones)
+        {
+            Worker& worker = m_workers[workerIndex];
+            std::lock_guard<std::mutex> locker(worker.lock);
+            if(!worker.folders.empty()) {
+                folder.swap(worker.folders.back());
+                worker.folders.pop_back();
+                --m_queuedFolders;
+                return true;
+            }
+        }
+
+        // steal the oldest folder of another worker, this is usually the one with the biggest subtree
+        for(size_t i = 1; i < m_workers.size(); ++i) {
+            Worker& victim = m_workers[(workerIndex + i) % m_workers.size()];
+            std::lock_guard<std::mutex> locker(victim.lock);
+            if(!victim.folders.empty()) {
+                folder.swap(victim.folders.front());
+                victim.folders.pop_front();
+                --m_queuedFolders;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ReadFolder(size_t workerIndex, const std::string& folder, std::vector<char>& buffer)
+    {
+        int fd = ::open(folder.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if(fd < 0) { return; }
+
+        struct stat st;
+        if(::fstat(fd, &st) == 0) {
+            std::lock_guard<std::mutex> locker(m_visitedLock);
+            if(!m_visited.insert({ st.st_dev, st.st_ino }).second) {
+                ::close(fd);
+                return;
+            }
+        }
+
+        Worker& worker = m_workers[workerIndex];
+        std::string fullpath = folder;
+        if(fullpath.empty() || fullpath.back() != '/') { fullpath.push_back('/'); }
+        size_t prefixLen = fullpath.length();
+
+        while(true) {
+            long bytes = ::syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+            if(bytes <= 0) { break; }
+
+            for(long offset = 0; offset < bytes;) {
+                const char* record = buffer.data() + offset;
+                const LinuxDirent64Header* entry = reinterpret_cast<const LinuxDirent64Header*>(record);
+                const char* name = record + offsetof(LinuxDirent64Header, d_type) + 1;
+                offset += entry->d_reclen;
+                if(name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) { continue; }
+
+                bool isDirectory = (entry->d_type == DT_DIR);
+                bool isSymlink = (entry->d_type == DT_LNK);
+                struct stat entryStat;
+                if(entry->d_type == DT_UNKNOWN && ::fstatat(fd, name, &entryStat, AT_SYMLINK_NOFOLLOW) == 0) {
+                    isDirectory = S_ISDIR(entryStat.st_mode);
+                    isSymlink = S_ISLNK(entryStat.st_mode);
+                }
+                if(isSymlink) {
+                    // follow symlinks, like wxFileName::DirExists() does
+                    isDirectory = (::fstatat(fd, name, &entryStat, 0) == 0) && S_ISDIR(entryStat.st_mode);
+                }
+
+                if(isDirectory) {
+                    fullpath.resize(prefixLen);
+                    fullpath.append(name);
+                    if(IsExcludedFolder(fullpath, name)) { continue; }
+                    if(isSymlink) {
+                        worker.symlinks.push_back(fullpath);
+                    } else {
+                        Push(workerIndex, std::string(fullpath));
+                    }
+
+                } else if(!m_excludeFileMasks.Match(name) && m_fileMasks.Match(name)) {
+                    fullpath.resize(prefixLen);
+                    fullpath.append(name);
+                    wxString file = wxString::FromUTF8(fullpath.c_str(), fullpath.length());
+                    if(file.IsEmpty()) { file = wxString(fullpath.c_str(), wxConvFile); }
+                    worker.files.push_back(file);
+                }
+            }
+        }
+        ::close(fd);
+    }
+
+    void WorkerMain(size_t workerIndex)
+    {
+        std::vector<char> buffer(64 * 1024);
+        std::string folder;
+        while(true) {
+            if(Pop(workerIndex, folder)) {
+                ReadFolder(workerIndex, folder, buffer);
+                if(--m_pendingFolders == 0) {
+                    // the pass is over, wake up the idle workers
+                    { std::lock_guard<std::mutex> locker(m_idleLock); }
+                    m_idleCond.notify_all();
+                }
+                continue;
+            }
+
+            // other workers are still reading folders which may contain more folders
+            std::unique_lock<std::mutex> locker(m_idleLock);
+            m_idleCond.wait(locker, [&]() { return m_pendingFolders.load() == 0 || m_queuedFolders.load() > 0; });
+            if(m_pendingFolders.load() == 0) { return; }
+        }
+    }
+
+    /**
+     * @brief scan the queued folders, in parallel, and their subfolders. The symlinked folders found are not scanned
+     */
+    void RunPass()
+    {
+        std::vector<std::thread> threads;
+        for(size_t i = 1; i < m_workers.size(); ++i) {
+            threads.push_back(std::thread(&ParallelScanner::WorkerMain, this, i));
+        }
+        WorkerMain(0);
+        for(std::thread& thr : threads) {
+            thr.join();
+        }
+    }
+
+    bool IsVisited(const std::string& folder)
+    {
+        struct stat st;
+        if(::stat(folder.c_str(), &st) != 0) { return true; }
+        std::lock_guard<std::mutex> locker(m_visitedLock);
+        return m_visited.count({ st.st_dev, st.st_ino }) > 0;
+    }
+
+public:
+    ParallelScanner(const wxArrayString& fileMasks, const wxArrayString& excludeFileMasks,
+                    const wxArrayString& excludeFolderMasks)
+        : m_fileMasks(fileMasks)
+        , m_excludeFileMasks(excludeFileMasks)
+        , m_excludeFolderMasks(excludeFolderMasks)
+        , m_pendingFolders(0)
+        , m_queuedFolders(0)
+    {
+    }
+
+    void Scan(const wxString& rootFolder, std::vector<wxString>& filesOutput)
+    {
+        size_t count = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+        m_workers = std::vector<Worker>(count);
+
+        std::string root = ToUTF8String(rootFolder);
+        while(root.length() > 1 && root.back() == '/') {
+            root.pop_back();
+        }
+        Push(0, std::move(root));
+        RunPass();
+
+        // Then the symlinked folders, one at a time and in order: a folder already reached from another path is
+        // skipped, whatever the threads timing
+        std::vector<std::string> symlinks;
+        while(true) {
+            for(Worker& worker : m_workers) {
+                std::move(worker.symlinks.begin(), worker.symlinks.end(), std::back_inserter(symlinks));
+                worker.symlinks.clear();
+            }
+            if(symlinks.empty()) { break; }
+
+            std::sort(symlinks.begin(), symlinks.end());
+            std::vector<std::string> level;
+            level.swap(symlinks);
+            for(std::string& folder : level) {
+                if(IsVisited(folder)) { continue; }
+                Push(0, std::move(folder));
+                RunPass();
+                // the symlinks found under this folder belong to the next level
+                for(Worker& worker : m_workers) {
+                    std::move(worker.symlinks.begin(), worker.symlinks.end(), std::back_inserter(symlinks));
+                    worker.symlinks.clear();
+                }
+            }
+        }
+
+        size_t total = 0;
+        for(const Worker& worker : m_workers) {
+            total += worker.files.size();
+        }
+        filesOutput.reserve(total);
+        for(Worker& worker : m_workers) {
+            std::move(worker.files.begin(), worker.files.end(), std::back_inserter(filesOutput));
+        }
+    }
+};
+} // namespace
+#endif
+
 clFilesScanner::clFilesScanner() {}
 
 clFilesScanner::~clFilesScanner() {}
@@ -24,6 +390,16 @@ size_t clFilesScanner::Scan(const wxString& rootFolder, std::vector<wxFileName>&
     wxArrayString specArr = ::wxStringTokenize(filespec.Lower(), ";,|", wxTOKEN_STRTOK);
     wxArrayString excludeSpecArr = ::wxStringTokenize(excludeFilespec.Lower(), ";,|", wxTOKEN_STRTOK);
     wxArrayString excludeFoldersSpecArr = ::wxStringTokenize(excludeFoldersSpec.Lower(), ";,|", wxTOKEN_STRTOK);
+#if defined(__linux__)
+    ParallelScanner scanner(specArr, excludeSpecArr, excludeFoldersSpecArr);
+    std::vector<wxString> files;
+    scanner.Scan(rootFolder, files);
+    filesOutput.reserve(files.size());
+    for(const wxString& file : files) {
+        filesOutput.push_back(wxFileName(file));
+    }
+    return filesOutput.size();
+#else
     std::queue<wxString> Q;
     Q.push(rootFolder);
 
@@ -59,6 +435,7 @@ size_t clFilesScanner::Scan(const wxString& rootFolder, std::vector<wxFileName>&
         }
     }
     return filesOutput.size();
+#endif
 }
 
 size_t clFilesScanner::Scan(const wxString& rootFolder, std::vector<wxString>& filesOutput, const wxString& filespec,
@@ -72,6 +449,19 @@ size_t clFilesScanner::Scan(const wxString& rootFolder, std::vector<wxString>& f
 
     wxArrayString specArr = ::wxStringTokenize(filespec.Lower(), ";,|", wxTOKEN_STRTOK);
     wxArrayString excludeSpecArr = ::wxStringTokenize(excludeFilespec.Lower(), ";,|", wxTOKEN_STRTOK);
+#if defined(__linux__)
+    ParallelScanner scanner(specArr, excludeSpecArr, wxArrayString());
+    for(const wxString& folder : excludeFolders) {
+        // a full path is compared against the real path of the folders, anything else against their name
+        if(folder.Contains("/")) {
+            scanner.m_excludeFolderPaths.insert(ToUTF8String(folder));
+        } else {
+            scanner.m_excludeFolderNames.insert(ToUTF8String(folder));
+        }
+    }
+    scanner.Scan(rootFolder, filesOutput);
+    return filesOutput.size();
+#else
     std::queue<wxString> Q;
     Q.push(rootFolder);
 
@@ -110,6 +500,7 @@ size_t clFilesScanner::Scan(const wxString& rootFolder, std::vector<wxString>& f
         }
     }
     return filesOutput.size();
+#endif
 }
 
 size_t clFilesScanner::ScanNoRecurse(const wxString& rootFolder, clFilesScanner::EntryData::Vec_t& results,
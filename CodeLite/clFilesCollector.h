@@ -35,6 +35,7 @@ public:
      * @param filespec files spec
      * @param excludeFolders list of folder to exclude from the search
      * @return number of files found
+     * @note on Linux, the folders are scanned in parallel and the order of the files is unspecified
      */
     size_t Scan(const wxString& rootFolder, std::vector<wxString>& filesOutput, const wxString& filespec = "*",
                 const wxString& excludeFilespec = "", const wxStringSet_t& excludeFolders = wxStringSet_t());
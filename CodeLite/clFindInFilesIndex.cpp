@@ -0,0 +1,714 @@
+#include "clFindInFilesIndex.h"
+#include "clFileReader.h"
+#include "clXXHash.h"
+#include "file_logger.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <time.h>
+#include <wx/filefn.h>
+#include <wx/wxsqlite3.h>
+
+// Bump this whenever the schema or the trigrams encoding change
+#define FIF_INDEX_VERSION "2"
+
+// Files bigger than this are not indexed (they are always searched)
+#define FIF_INDEX_MAX_FILE_SIZE (16 * 1024 * 1024)
+
+// Number of files stored in a single chunk
+#define FIF_INDEX_BATCH_SIZE 1000
+
+// Merge the chunks once there are more than this
+#define FIF_INDEX_MAX_CHUNKS 64
+
+// Number of trigrams merged per transaction when compacting
+#define FIF_INDEX_COMPACT_RANGE 4096
+
+// A file modified less than this before it was indexed may be modified again without changing its modification
+// time (file systems with a coarse time resolution), its content hash is checked
+#define FIF_INDEX_RACY_SECONDS 2
+
+// A trigram is 3 ASCII bytes, 7 bits each
+#define FIF_TRIGRAMS_COUNT (1 << 21)
+
+namespace
+{
+inline unsigned char FoldCase(unsigned char ch) { return (ch >= 'A' && ch <= 'Z') ? (ch + ('a' - 'A')) : ch; }
+
+inline bool IsIndexedByte(unsigned char ch) { return ch < 0x80 && ch != '\n'; }
+
+inline unsigned int MakeTrigram(unsigned char a, unsigned char b, unsigned char c)
+{
+    return ((unsigned int)a << 14) | ((unsigned int)b << 7) | (unsigned int)c;
+}
+
+/**
+ * @brief encode sorted ids as deltas in a LEB128 varint buffer
+ */
+void EncodeIds(const std::vector<wxLongLong_t>& ids, std::string& buffer)
+{
+    buffer.clear();
+    wxLongLong_t prev = 0;
+    for(size_t i = 0; i < ids.size(); ++i) {
+        unsigned long long delta = (unsigned long long)(ids[i] - prev);
+        prev = ids[i];
+        do {
+            unsigned char byte = delta & 0x7F;
+            delta >>= 7;
+            buffer.push_back((char)(delta ? (byte | 0x80) : byte));
+        } while(delta);
+    }
+}
+
+void DecodeIds(const unsigned char* buffer, int len, std::vector<wxLongLong_t>& ids)
+{
+    wxLongLong_t prev = 0;
+    unsigned long long delta = 0;
+    int shift = 0;
+    for(int i = 0; i < len; ++i) {
+        delta |= (unsigned long long)(buffer[i] & 0x7F) << shift;
+        if(buffer[i] & 0x80) {
+            shift += 7;
+            continue;
+        }
+        prev += (wxLongLong_t)delta;
+        ids.push_back(prev);
+        delta = 0;
+        shift = 0;
+    }
+}
+
+/**
+ * @brief the modification time in nanoseconds (the precision depends on the file system) and the size of 'path'
+ */
+bool GetFileStat(const wxString& path, wxLongLong_t& lastModified, wxLongLong_t& size)
+{
+    wxStructStat st;
+    if(wxStat(path, &st) != 0) { return false; }
+#if defined(__WXMSW__)
+    lastModified = (wxLongLong_t)st.st_mtime * 1000000000LL;
+#elif defined(__WXOSX__)
+    lastModified = (wxLongLong_t)st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    lastModified = (wxLongLong_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    size = st.st_size;
+    return true;
+}
+
+bool IsRacy(wxLongLong_t lastModified)
+{
+    return (lastModified / 1000000000LL) + FIF_INDEX_RACY_SECONDS >= (wxLongLong_t)time(NULL);
+}
+} // namespace
+
+clFindInFilesIndex::clFindInFilesIndex() {}
+
+clFindInFilesIndex::~clFindInFilesIndex() { Close(); }
+
+bool clFindInFilesIndex::Open(const wxFileName& dbfile)
+{
+    Close();
+
+    // Loading the files of a big index takes a while, the caller is usually the main thread
+    std::lock_guard<std::mutex> locker(m_queueLock);
+    m_shutdown = false;
+    m_thread = new std::thread(&clFindInFilesIndex::IndexerMain, this, dbfile);
+    return true;
+}
+
+bool clFindInFilesIndex::DoOpenDatabase(const wxFileName& dbfile)
+{
+    std::lock_guard<std::mutex> locker(m_dbLock);
+    try {
+        m_db = new wxSQLite3Database();
+        m_db->Open(dbfile.GetFullPath());
+        m_db->SetBusyTimeout(10);
+        DoCreateSchema();
+        DoLoadFiles();
+        m_dbfile = dbfile;
+
+    } catch(wxSQLite3Exception& e) {
+        clWARNING() << "Find In Files index: failed to open" << dbfile.GetFullPath() << "." << e.GetMessage()
+                    << clEndl;
+        wxDELETE(m_db);
+        m_files.clear();
+        return false;
+    }
+    clDEBUG() << "Find In Files index:" << dbfile.GetFullPath() << "is open," << m_files.size() << "files,"
+              << m_chunksCount << "chunks" << clEndl;
+    return true;
+}
+
+void clFindInFilesIndex::Close()
+{
+    // Stop the indexer thread first, it needs the database lock
+    std::thread* thread = nullptr;
+    {
+        std::lock_guard<std::mutex> locker(m_queueLock);
+        m_shutdown = true;
+        m_queue.clear();
+        m_queuedFiles.clear();
+        std::swap(thread, m_thread);
+    }
+    if(thread) {
+        m_queueCond.notify_all();
+        thread->join();
+        wxDELETE(thread);
+    }
+
+    std::lock_guard<std::mutex> locker(m_dbLock);
+    if(m_db) {
+        try {
+            m_db->Close();
+        } catch(wxSQLite3Exception& e) {
+            wxUnusedVar(e);
+        }
+        wxDELETE(m_db);
+    }
+    m_files.clear();
+    m_chunksCount = 0;
+    m_dbfile.Clear();
+}
+
+bool clFindInFilesIndex::IsOpen()
+{
+    std::lock_guard<std::mutex> locker(m_dbLock);
+    return m_db != nullptr;
+}
+
+void clFindInFilesIndex::DoCreateSchema()
+{
+    m_db->ExecuteUpdate("PRAGMA journal_mode = WAL;");
+    m_db->ExecuteUpdate("PRAGMA synchronous = OFF;");
+    m_db->ExecuteUpdate("CREATE TABLE IF NOT EXISTS META (NAME TEXT PRIMARY KEY, VALUE TEXT)");
+
+    wxString version;
+    wxSQLite3ResultSet rs = m_db->ExecuteQuery("SELECT VALUE FROM META WHERE NAME='VERSION'");
+    if(rs.NextRow()) { version = rs.GetString(0); }
+    rs.Finalize();
+
+    if(version != FIF_INDEX_VERSION) {
+        m_db->ExecuteUpdate("DROP TABLE IF EXISTS FILES");
+        m_db->ExecuteUpdate("DROP TABLE IF EXISTS POSTINGS");
+        m_db->ExecuteUpdate("INSERT OR REPLACE INTO META VALUES ('VERSION', '" FIF_INDEX_VERSION "')");
+    }
+
+    // AUTOINCREMENT: a re-indexed file must never get the id of a deleted file, the postings of deleted files
+    // are only removed by the compaction
+    m_db->ExecuteUpdate("CREATE TABLE IF NOT EXISTS FILES (ID INTEGER PRIMARY KEY AUTOINCREMENT, PATH TEXT, "
+                        "MTIME INTEGER, SIZE INTEGER, HASH INTEGER, RACY INTEGER, INDEXED INTEGER)");
+    m_db->ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS FILES_PATH ON FILES(PATH)");
+    m_db->ExecuteUpdate("CREATE TABLE IF NOT EXISTS POSTINGS (TRIGRAM INTEGER, CHUNK INTEGER, IDS BLOB, "
+                        "PRIMARY KEY(TRIGRAM, CHUNK))");
+}
+
+void clFindInFilesIndex::DoLoadFiles()
+{
+    m_files.clear();
+    wxSQLite3ResultSet rs = m_db->ExecuteQuery("SELECT ID, PATH, MTIME, SIZE, HASH, RACY, INDEXED FROM FILES");
+    while(rs.NextRow()) {
+        FileInfo info;
+        info.id = rs.GetInt64(0).GetValue();
+        info.lastModified = rs.GetInt64(2).GetValue();
+        info.size = rs.GetInt64(3).GetValue();
+        info.hash = (wxUint64)rs.GetInt64(4).GetValue();
+        info.racy = rs.GetInt(5) != 0;
+        info.indexed = rs.GetInt(6) != 0;
+        m_files.insert({ rs.GetString(1), info });
+    }
+    rs.Finalize();
+    m_chunksCount = m_db->ExecuteScalar("SELECT COUNT(DISTINCT CHUNK) FROM POSTINGS");
+}
+
+void clFindInFilesIndex::Update(const wxArrayString& files)
+{
+    if(files.IsEmpty()) return;
+    {
+        std::lock_guard<std::mutex> locker(m_queueLock);
+        if(!m_thread || m_shutdown) return;
+        for(size_t i = 0; i < files.size(); ++i) {
+            if(m_queuedFiles.insert(files.Item(i)).second) { m_queue.push_back(files.Item(i)); }
+        }
+    }
+    m_queueCond.notify_one();
+}
+
+bool clFindInFilesIndex::IsShutdown()
+{
+    std::lock_guard<std::mutex> locker(m_queueLock);
+    return m_shutdown;
+}
+
+void clFindInFilesIndex::IndexerMain(const wxFileName& dbfile)
+{
+    if(!DoOpenDatabase(dbfile)) {
+        // stop queueing files
+        std::lock_guard<std::mutex> locker(m_queueLock);
+        m_shutdown = true;
+        m_queue.clear();
+        m_queuedFiles.clear();
+        return;
+    }
+
+    // one flag per possible trigram, used to collect the unique trigrams of a file
+    std::vector<unsigned char> seen(FIF_TRIGRAMS_COUNT, 0);
+    while(true) {
+        std::vector<wxString> batch;
+        {
+            std::unique_lock<std::mutex> locker(m_queueLock);
+            m_queueCond.wait_for(locker, std::chrono::milliseconds(500),
+                                 [&]() { return m_shutdown || !m_queue.empty(); });
+            if(m_shutdown) { return; }
+            while(!m_queue.empty() && batch.size() < FIF_INDEX_BATCH_SIZE) {
+                batch.push_back(m_queue.front());
+                m_queuedFiles.erase(m_queue.front());
+                m_queue.pop_front();
+            }
+        }
+
+        if(batch.empty()) {
+            // idle: merge the chunks if needed
+            bool compact = false;
+            {
+                std::lock_guard<std::mutex> locker(m_dbLock);
+                compact = m_chunksCount > FIF_INDEX_MAX_CHUNKS;
+            }
+            if(compact) { DoCompact(); }
+            continue;
+        }
+
+        // what we know about these files
+        std::vector<FileInfo> infos(batch.size());
+        std::vector<bool> known(batch.size(), false);
+        {
+            std::lock_guard<std::mutex> locker(m_dbLock);
+            for(size_t i = 0; i < batch.size(); ++i) {
+                auto iter = m_files.find(batch[i]);
+                if(iter != m_files.end()) {
+                    infos[i] = iter->second;
+                    known[i] = true;
+                }
+            }
+        }
+
+        std::vector<IndexedFile> files(batch.size());
+        for(size_t i = 0; i < batch.size(); ++i) {
+            if(IsShutdown()) { return; }
+            DoIndexFile(batch[i], known[i] ? &infos[i] : nullptr, seen, files[i]);
+        }
+        DoStoreFiles(files);
+    }
+}
+
+void clFindInFilesIndex::DoIndexFile(const wxString& path, const FileInfo* known, std::vector<unsigned char>& seen,
+                                     IndexedFile& result)
+{
+    result.path = path;
+    result.exists = GetFileStat(path, result.info.lastModified, result.info.size) && wxFileName::FileExists(path);
+    if(!result.exists) { return; }
+
+    bool sameStat = known && known->lastModified == result.info.lastModified && known->size == result.info.size;
+    if(sameStat && !known->racy) {
+        result.modified = false;
+        return;
+    }
+
+    result.info.indexed = false;
+    result.info.racy = IsRacy(result.info.lastModified);
+    if(result.info.size > FIF_INDEX_MAX_FILE_SIZE) { return; }
+
+    clFileReader file;
+    if(!file.Open(path)) {
+        // keep it as "not indexed" so it is always searched
+        return;
+    }
+
+    const unsigned char* p = (const unsigned char*)file.GetData();
+    size_t size = file.GetSize();
+    result.info.hash = clXXHash::Hash64(p, size);
+    if(sameStat && known->indexed && known->hash == result.info.hash) {
+        // the content did not change
+        result.modified = false;
+        result.racyCleared = !result.info.racy;
+        return;
+    }
+
+    for(size_t i = 0; i + 2 < size; ++i) {
+        if(!IsIndexedByte(p[i + 2])) {
+            // no trigram can contain this byte
+            i += 2;
+            continue;
+        }
+        if(!IsIndexedByte(p[i]) || !IsIndexedByte(p[i + 1])) { continue; }
+
+        unsigned int trigram = MakeTrigram(FoldCase(p[i]), FoldCase(p[i + 1]), FoldCase(p[i + 2]));
+        if(!seen[trigram]) {
+            seen[trigram] = 1;
+            result.trigrams.push_back(trigram);
+        }
+    }
+
+    // reset the flags for the next file
+    for(size_t i = 0; i < result.trigrams.size(); ++i) {
+        seen[result.trigrams[i]] = 0;
+    }
+    result.info.indexed = true;
+}
+
+void clFindInFilesIndex::DoStoreFiles(const std::vector<IndexedFile>& files)
+{
+    std::lock_guard<std::mutex> locker(m_dbLock);
+    if(!m_db) return;
+
+    try {
+        m_db->Begin();
+        wxSQLite3Statement deleteStmt = m_db->PrepareStatement("DELETE FROM FILES WHERE PATH=?");
+        wxSQLite3Statement insertStmt = m_db->PrepareStatement(
+            "INSERT INTO FILES (ID, PATH, MTIME, SIZE, HASH, RACY, INDEXED) VALUES (NULL, ?, ?, ?, ?, ?, ?)");
+        wxSQLite3Statement racyStmt = m_db->PrepareStatement("UPDATE FILES SET RACY=0 WHERE PATH=?");
+
+        std::map<unsigned int, std::vector<wxLongLong_t> > postings;
+        for(size_t i = 0; i < files.size(); ++i) {
+            const IndexedFile& file = files[i];
+            if(!file.modified) {
+                if(file.racyCleared) {
+                    racyStmt.Bind(1, file.path);
+                    racyStmt.ExecuteUpdate();
+                    auto iter = m_files.find(file.path);
+                    if(iter != m_files.end()) { iter->second.racy = false; }
+                }
+                continue;
+            }
+
+            deleteStmt.Bind(1, file.path);
+            deleteStmt.ExecuteUpdate();
+            m_files.erase(file.path);
+            if(!file.exists) { continue; }
+
+            insertStmt.Bind(1, file.path);
+            insertStmt.Bind(2, wxLongLong(file.info.lastModified));
+            insertStmt.Bind(3, wxLongLong(file.info.size));
+            insertStmt.Bind(4, wxLongLong((wxLongLong_t)file.info.hash));
+            insertStmt.Bind(5, file.info.racy ? 1 : 0);
+            insertStmt.Bind(6, file.info.indexed ? 1 : 0);
+            insertStmt.ExecuteUpdate();
+
+            FileInfo info = file.info;
+            info.id = m_db->GetLastRowId().GetValue();
+            m_files.insert({ file.path, info });
+
+            // ids are increasing, so the postings lists are sorted
+            for(size_t j = 0; j < file.trigrams.size(); ++j) {
+                postings[file.trigrams[j]].push_back(info.id);
+            }
+        }
+
+        if(!postings.empty()) {
+            int chunk = m_db->ExecuteScalar("SELECT IFNULL(MAX(CHUNK), 0) + 1 FROM POSTINGS");
+            wxSQLite3Statement postingStmt = m_db->PrepareStatement("INSERT INTO POSTINGS VALUES (?, ?, ?)");
+            std::string buffer;
+            for(const auto& posting : postings) {
+                EncodeIds(posting.second, buffer);
+                postingStmt.Bind(1, (int)posting.first);
+                postingStmt.Bind(2, chunk);
+                postingStmt.Bind(3, (const unsigned char*)buffer.data(), (int)buffer.size());
+                postingStmt.ExecuteUpdate();
+            }
+            ++m_chunksCount;
+        }
+        m_db->Commit();
+
+    } catch(wxSQLite3Exception& e) {
+        clWARNING() << "Find In Files index: failed to store files." << e.GetMessage() << clEndl;
+        try {
+            m_db->Rollback();
+        } catch(wxSQLite3Exception& e1) {
+            wxUnusedVar(e1);
+        }
+        // our in memory view may no longer match the database
+        try {
+            DoLoadFiles();
+        } catch(wxSQLite3Exception& e2) {
+            wxUnusedVar(e2);
+        }
+    }
+}
+
+void clFindInFilesIndex::DoCompact()
+{
+    clDEBUG() << "Find In Files index: merging" << m_chunksCount << "chunks" << clEndl;
+
+    // The compaction is done in trigram ranges so searches are not blocked for too long. The ids of files that
+    // were deleted or re-indexed since are dropped
+    for(unsigned int from = 0; from < FIF_TRIGRAMS_COUNT; from += FIF_INDEX_COMPACT_RANGE) {
+        if(IsShutdown()) { return; }
+
+        std::lock_guard<std::mutex> locker(m_dbLock);
+        if(!m_db) return;
+
+        std::unordered_set<wxLongLong_t> liveIds;
+        liveIds.reserve(m_files.size());
+        for(const auto& file : m_files) {
+            if(file.second.indexed) { liveIds.insert(file.second.id); }
+        }
+
+        try {
+            m_db->Begin();
+            std::map<unsigned int, std::vector<wxLongLong_t> > postings;
+            {
+                wxSQLite3Statement st = m_db->PrepareStatement(
+                    "SELECT TRIGRAM, IDS FROM POSTINGS WHERE TRIGRAM >= ? AND TRIGRAM < ? ORDER BY TRIGRAM, CHUNK");
+                st.Bind(1, (int)from);
+                st.Bind(2, (int)(from + FIF_INDEX_COMPACT_RANGE));
+                wxSQLite3ResultSet rs = st.ExecuteQuery();
+                std::vector<wxLongLong_t> ids;
+                while(rs.NextRow()) {
+                    int len = 0;
+                    const unsigned char* blob = rs.GetBlob(1, len);
+                    ids.clear();
+                    DecodeIds(blob, len, ids);
+
+                    std::vector<wxLongLong_t>& merged = postings[(unsigned int)rs.GetInt(0)];
+                    for(size_t i = 0; i < ids.size(); ++i) {
+                        if(liveIds.count(ids[i])) { merged.push_back(ids[i]); }
+                    }
+                }
+                rs.Finalize();
+            }
+
+            wxSQLite3Statement deleteStmt =
+                m_db->PrepareStatement("DELETE FROM POSTINGS WHERE TRIGRAM >= ? AND TRIGRAM < ?");
+            deleteStmt.Bind(1, (int)from);
+            deleteStmt.Bind(2, (int)(from + FIF_INDEX_COMPACT_RANGE));
+            deleteStmt.ExecuteUpdate();
+
+            // the merged lists go to chunk 0: all their ids are smaller than the ids of any future chunk
+            wxSQLite3Statement insertStmt = m_db->PrepareStatement("INSERT INTO POSTINGS VALUES (?, 0, ?)");
+            std::string buffer;
+            for(auto& posting : postings) {
+                if(posting.second.empty()) continue;
+                std::sort(posting.second.begin(), posting.second.end());
+                EncodeIds(posting.second, buffer);
+                insertStmt.Bind(1, (int)posting.first);
+                insertStmt.Bind(2, (const unsigned char*)buffer.data(), (int)buffer.size());
+                insertStmt.ExecuteUpdate();
+            }
+            m_db->Commit();
+
+        } catch(wxSQLite3Exception& e) {
+            clWARNING() << "Find In Files index: compaction failed." << e.GetMessage() << clEndl;
+            try {
+                m_db->Rollback();
+            } catch(wxSQLite3Exception& e1) {
+                wxUnusedVar(e1);
+            }
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> locker(m_dbLock);
+    m_chunksCount = 1;
+}
+
+void clFindInFilesIndex::DoLoadPostings(unsigned int trigram, std::vector<wxLongLong_t>& ids)
+{
+    ids.clear();
+    wxSQLite3Statement st = m_db->PrepareStatement("SELECT IDS FROM POSTINGS WHERE TRIGRAM=? ORDER BY CHUNK");
+    st.Bind(1, (int)trigram);
+    wxSQLite3ResultSet rs = st.ExecuteQuery();
+    while(rs.NextRow()) {
+        int len = 0;
+        const unsigned char* blob = rs.GetBlob(0, len);
+        DecodeIds(blob, len, ids);
+    }
+    rs.Finalize();
+    if(!std::is_sorted(ids.begin(), ids.end())) { std::sort(ids.begin(), ids.end()); }
+}
+
+bool clFindInFilesIndex::Narrow(const std::vector<std::string>& literals, wxArrayString& files)
+{
+    // Collect the query trigrams
+    std::vector<unsigned int> trigrams;
+    for(size_t i = 0; i < literals.size(); ++i) {
+        const std::string& literal = literals[i];
+        for(size_t j = 0; j + 2 < literal.length(); ++j) {
+            unsigned char a = FoldCase(literal[j]), b = FoldCase(literal[j + 1]), c = FoldCase(literal[j + 2]);
+            if(IsIndexedByte(a) && IsIndexedByte(b) && IsIndexedByte(c)) {
+                trigrams.push_back(MakeTrigram(a, b, c));
+            }
+        }
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    if(trigrams.empty()) { return false; }
+
+    std::vector<wxLongLong_t> matchingIds;
+    std::vector<FileInfo> infos(files.size());
+    std::vector<bool> known(files.size(), false);
+    {
+        std::lock_guard<std::mutex> locker(m_dbLock);
+        if(!m_db) { return false; }
+
+        try {
+            // intersect the postings lists
+            std::vector<wxLongLong_t> ids, tmp;
+            for(size_t i = 0; i < trigrams.size(); ++i) {
+                DoLoadPostings(trigrams[i], ids);
+                if(i == 0) {
+                    matchingIds.swap(ids);
+                } else {
+                    tmp.clear();
+                    std::set_intersection(matchingIds.begin(), matchingIds.end(), ids.begin(), ids.end(),
+                                          std::back_inserter(tmp));
+                    matchingIds.swap(tmp);
+                }
+                if(matchingIds.empty()) break;
+            }
+        } catch(wxSQLite3Exception& e) {
+            clWARNING() << "Find In Files index: query failed." << e.GetMessage() << clEndl;
+            return false;
+        }
+
+        for(size_t i = 0; i < files.size(); ++i) {
+            auto iter = m_files.find(files.Item(i));
+            if(iter != m_files.end()) {
+                infos[i] = iter->second;
+                known[i] = true;
+            }
+        }
+    }
+
+    // Keep the files that may match, the files which are not indexed and the ones modified since they were indexed
+    // (or which may have been: the racy ones)
+    wxArrayString candidates;
+    wxArrayString staleFiles;
+    for(size_t i = 0; i < files.size(); ++i) {
+        const wxString& file = files.Item(i);
+        wxLongLong_t lastModified = 0;
+        wxLongLong_t size = 0;
+        if(!known[i] || infos[i].racy || !GetFileStat(file, lastModified, size) ||
+           lastModified != infos[i].lastModified || size != infos[i].size) {
+            candidates.Add(file);
+            staleFiles.Add(file);
+
+        } else if(!infos[i].indexed || std::binary_search(matchingIds.begin(), matchingIds.end(), infos[i].id)) {
+            candidates.Add(file);
+        }
+    }
+
+    clDEBUG() << "Find In Files index: searching" << candidates.size() << "out of" << files.size() << "files,"
+              << staleFiles.size() << "files queued for indexing" << clEndl;
+    files.swap(candidates);
+    Update(staleFiles);
+    return true;
+}
+
+void clFindInFilesIndex::GetRequiredLiterals(const wxString& findWhat, bool isRegex,
+                                             std::vector<std::string>& literals)
+{
+    if(isRegex && (findWhat.StartsWith("***") || findWhat.Contains("(?") || findWhat.Contains("|"))) {
+        // directors, embedded options and alternations: nothing is certainly required
+        return;
+    }
+
+    std::string current;
+    auto flush = [&]() {
+        if(current.length() >= 3) { literals.push_back(current); }
+        current.clear();
+    };
+    auto isAlnum = [](wxChar ch) {
+        return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9');
+    };
+    auto append = [&](wxChar ch) {
+        if(ch < 0x80 && ch != '\n') {
+            current.push_back((char)FoldCase((unsigned char)ch));
+        } else {
+            flush();
+        }
+    };
+
+    size_t len = findWhat.length();
+    for(size_t i = 0; i < len; ++i) {
+        wxChar ch = findWhat[i];
+        if(!isRegex) {
+            append(ch);
+            continue;
+        }
+
+        switch(ch) {
+        case '\\':
+            if(i + 1 >= len) {
+                flush();
+            } else if(isAlnum(findWhat[i + 1])) {
+                // a class shorthand, a back reference, a character entry... skip it and whatever alphanumeric
+                // characters follow it
+                flush();
+                ++i;
+                while(i + 1 < len && isAlnum(findWhat[i + 1])) {
+                    ++i;
+                }
+            } else {
+                // an escaped character
+                append(findWhat[++i]);
+            }
+            break;
+        case '[': {
+            // a bracket expression: skip it
+            flush();
+            size_t j = i + 1;
+            if(j < len && findWhat[j] == '^') ++j;
+            if(j < len && findWhat[j] == ']') ++j;
+            while(j < len && findWhat[j] != ']') {
+                if(findWhat[j] == '\\' || findWhat[j] == '[') ++j;
+                ++j;
+            }
+            i = j;
+            break;
+        }
+        case '(': {
+            // a group may be optional or repeated, skip it
+            flush();
+            int depth = 1;
+            size_t j = i + 1;
+            while(j < len && depth) {
+                if(findWhat[j] == '\\') {
+                    ++j;
+                } else if(findWhat[j] == '(') {
+                    ++depth;
+                } else if(findWhat[j] == ')') {
+                    --depth;
+                }
+                ++j;
+            }
+            i = j - 1;
+            break;
+        }
+        case '*':
+        case '?':
+            // the previous character is optional
+            if(!current.empty()) current.pop_back();
+            flush();
+            break;
+        case '{':
+            if(!current.empty()) current.pop_back();
+            flush();
+            while(i + 1 < len && findWhat[i] != '}') {
+                ++i;
+            }
+            break;
+        case '+':
+        case '.':
+        case '^':
+        case '$':
+        case ')':
+            flush();
+            break;
+        default:
+            append(ch);
+            break;
+        }
+    }
+    flush();
+}
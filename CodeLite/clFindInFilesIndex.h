@@ -0,0 +1,124 @@
+#ifndef CLFINDINFILESINDEX_H
+#define CLFINDINFILESINDEX_H
+
+#include "codelite_exports.h"
+#include "macros.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+class wxSQLite3Database;
+
+/**
+ * @class clFindInFilesIndex
+ * @brief a persistent trigram index used by the "Find In Files" to skip files which can not contain a match.
+ *
+ * For every indexed file, the index stores the set of trigrams (3 consecutive ASCII bytes, folded to lower case)
+ * found in its content. A search looks up the trigrams of the literals any match must contain and only the
+ * files containing all of them are searched. Files which are not indexed yet, or were modified since they were
+ * indexed, are always searched (and queued for indexing), so the index never hides a match. A file is
+ * "modified" when its size or its modification time (in nanoseconds where the file system has them) changed.
+ * When the modification time was too close to the indexing time to tell a later change apart, the content hash
+ * decides.
+ *
+ * The postings are written in "chunks" (one per indexed batch of files). Chunks are merged by a background
+ * compaction once there are too many of them.
+ *
+ * All the public methods are thread safe. The indexing is done by an internal worker thread
+ */
+class WXDLLIMPEXP_CL clFindInFilesIndex
+{
+public:
+    struct FileInfo {
+        wxLongLong_t id = 0;
+        wxLongLong_t lastModified = 0; // nanoseconds
+        wxLongLong_t size = 0;
+        wxUint64 hash = 0;    // the content hash (XXH64)
+        bool racy = false;    // modified within FIF_INDEX_RACY_SECONDS of its indexing: stat() can not prove that it
+                              // did not change since, the content hash must be checked
+        bool indexed = false; // false for files that are too big for the index, these files are always searched
+    };
+
+protected:
+    wxSQLite3Database* m_db = nullptr;
+    wxFileName m_dbfile;
+    std::mutex m_dbLock; // protects m_db, m_files and m_chunksCount
+    std::unordered_map<wxString, FileInfo> m_files;
+    size_t m_chunksCount = 0;
+
+    // the indexer thread and its queue
+    std::thread* m_thread = nullptr;
+    std::mutex m_queueLock;
+    std::condition_variable m_queueCond;
+    std::deque<wxString> m_queue;
+    wxStringSet_t m_queuedFiles;
+    bool m_shutdown = false;
+
+protected:
+    struct IndexedFile {
+        wxString path;
+        bool exists = false;
+        bool modified = true;      // false if the file did not change since it was indexed
+        bool racyCleared = false; // unmodified, and now known to be so by stat() alone
+        FileInfo info;
+        std::vector<unsigned int> trigrams;
+    };
+
+    bool DoOpenDatabase(const wxFileName& dbfile);
+    void DoCreateSchema();
+    void DoLoadFiles();
+    void IndexerMain(const wxFileName& dbfile);
+    void DoIndexFile(const wxString& path, const FileInfo* known, std::vector<unsigned char>& seen,
+                     IndexedFile& result);
+    void DoStoreFiles(const std::vector<IndexedFile>& files);
+    void DoCompact();
+    void DoLoadPostings(unsigned int trigram, std::vector<wxLongLong_t>& ids);
+    bool IsShutdown();
+
+public:
+    clFindInFilesIndex();
+    virtual ~clFindInFilesIndex();
+
+    /**
+     * @brief start the indexer thread, which opens (or creates) the index database and loads it. Until it is
+     * loaded, IsOpen() returns false and the searches do not use the index
+     */
+    bool Open(const wxFileName& dbfile);
+
+    /**
+     * @brief stop the indexer thread and close the database
+     */
+    void Close();
+
+    bool IsOpen();
+
+    /**
+     * @brief queue files for indexing. Files that no longer exist are removed from the index, files which did
+     * not change since they were indexed are skipped
+     */
+    void Update(const wxArrayString& files);
+
+    /**
+     * @brief remove from 'files' the ones that can not contain all the 'literals'
+     * @param literals lower case ASCII strings that any match must contain (see GetRequiredLiterals)
+     * @return false if the index can not be used for this query ('files' is unmodified)
+     */
+    bool Narrow(const std::vector<std::string>& literals, wxArrayString& files);
+
+    /**
+     * @brief collect the lower case ASCII literals that any match of 'findWhat' must contain. For regular
+     * expressions, only the parts that are certainly required are collected (nothing if the expression contains
+     * an alternation)
+     */
+    static void GetRequiredLiterals(const wxString& findWhat, bool isRegex, std::vector<std::string>& literals);
+};
+
+#endif // CLFINDINFILESINDEX_H
@@ -0,0 +1,382 @@
+#include "clGdbMIParser.h"
+#include <string>
+
+// deeper values are rejected rather than risking the stack
+#define GDB_MI_MAX_DEPTH 256
+
+namespace
+{
+bool IsBlank(wxUniChar ch) { return ch == ' ' || ch == '\t' || ch == '\r'; }
+bool IsOctal(wxUniChar ch) { return ch >= '0' && ch <= '7'; }
+
+/**
+ * @brief append the bytes of a run of octal escapes (usually a UTF-8 sequence)
+ */
+void FlushBytes(std::string& bytes, wxString& str)
+{
+    if(bytes.empty()) {
+        return;
+    }
+    wxString decoded = wxString::FromUTF8(bytes.c_str(), bytes.length());
+    if(decoded.IsEmpty()) {
+        decoded = wxString::From8BitData(bytes.c_str(), bytes.length());
+    }
+    str << decoded;
+    bytes.clear();
+}
+} // namespace
+
+//===------------------------------------------------
+// clGdbMIValue
+//===------------------------------------------------
+
+void clGdbMIValue::Clear()
+{
+    m_kind = kNone;
+    m_name.clear();
+    m_value.clear();
+    m_children.clear();
+}
+
+const clGdbMIValue& clGdbMIValue::operator[](const wxString& name) const
+{
+    static const clGdbMIValue nullValue;
+    for(const clGdbMIValue& child : m_children) {
+        if(child.m_name == name) {
+            return child;
+        }
+    }
+    return nullValue;
+}
+
+//===------------------------------------------------
+// clGdbMIRecord
+//===------------------------------------------------
+
+void clGdbMIRecord::Clear()
+{
+    type = kUnknown;
+    token.clear();
+    resultClass.clear();
+    results.Clear();
+    streamOutput.clear();
+}
+
+//===------------------------------------------------
+// clGdbMIParser
+//===------------------------------------------------
+
+bool clGdbMIParser::ReadCString(Iter_t& iter, const Iter_t& end, wxString& str)
+{
+    // skip the opening quote
+    ++iter;
+    std::string bytes;
+    Iter_t start = iter;
+    while(iter != end) {
+        wxUniChar ch = *iter;
+        if(ch == '"') {
+            if(start != iter) {
+                FlushBytes(bytes, str);
+                str.append(start, iter);
+            }
+            FlushBytes(bytes, str);
+            ++iter;
+            return true;
+        }
+
+        if(ch != '\\') {
+            ++iter;
+            continue;
+        }
+
+        // an escape: take the text before it
+        if(start != iter) {
+            FlushBytes(bytes, str);
+            str.append(start, iter);
+        }
+        ++iter;
+        if(iter == end) {
+            break;
+        }
+        ch = *iter;
+        if(IsOctal(ch)) {
+            int byte = 0;
+            for(int i = 0; i < 3 && iter != end && IsOctal(*iter); ++i, ++iter) {
+                byte = byte * 8 + ((*iter).GetValue() - '0');
+            }
+            bytes.push_back((char)byte);
+            start = iter;
+            continue;
+        }
+
+        FlushBytes(bytes, str);
+        switch(ch.GetValue()) {
+        case 'n':
+            str << '\n';
+            break;
+        case 't':
+            str << '\t';
+            break;
+        case 'r':
+            str << '\r';
+            break;
+        case 'a':
+            str << '\a';
+            break;
+        case 'b':
+            str << '\b';
+            break;
+        case 'f':
+            str << '\f';
+            break;
+        case 'v':
+            str << '\v';
+            break;
+        case 'e':
+            str << '\x1b';
+            break;
+        default:
+            // \" \\ and anything else: the character itself
+            str << ch;
+            break;
+        }
+        ++iter;
+        start = iter;
+    }
+    // unterminated string
+    FlushBytes(bytes, str);
+    return false;
+}
+
+bool clGdbMIParser::ReadValue(Iter_t& iter, const Iter_t& end, clGdbMIValue& value, size_t depth)
+{
+    if(iter == end || depth > GDB_MI_MAX_DEPTH) {
+        return false;
+    }
+
+    wxUniChar ch = *iter;
+    if(ch == '"') {
+        value.m_kind = clGdbMIValue::kConst;
+        return ReadCString(iter, end, value.m_value);
+    }
+
+    if(ch == '{' || ch == '[') {
+        bool isTuple = (ch == '{');
+        wxUniChar closeChar = isTuple ? '}' : ']';
+        value.m_kind = isTuple ? clGdbMIValue::kTuple : clGdbMIValue::kList;
+        ++iter;
+        if(iter != end && *iter == closeChar) {
+            ++iter;
+            return true;
+        }
+        while(iter != end) {
+            value.m_children.push_back(clGdbMIValue());
+            clGdbMIValue& child = value.m_children.back();
+            // a list holds either values or results
+            wxUniChar first = *iter;
+            bool ok = (!isTuple && (first == '"' || first == '{' || first == '['))
+                          ? ReadValue(iter, end, child, depth + 1)
+                          : ReadResult(iter, end, child, depth + 1);
+            if(!ok || iter == end) {
+                return false;
+            }
+            if(*iter == closeChar) {
+                ++iter;
+                return true;
+            }
+            if(*iter != ',') {
+                return false;
+            }
+            ++iter;
+        }
+        return false;
+    }
+
+    // not a valid MI value, but some gdb versions emit bare words: take it up to the next delimiter
+    value.m_kind = clGdbMIValue::kConst;
+    Iter_t start = iter;
+    while(iter != end && *iter != ',' && *iter != '}' && *iter != ']') {
+        ++iter;
+    }
+    value.m_value.assign(start, iter);
+    return true;
+}
+
+bool clGdbMIParser::ReadResult(Iter_t& iter, const Iter_t& end, clGdbMIValue& value, size_t depth)
+{
+    Iter_t start = iter;
+    while(iter != end && *iter != '=') {
+        wxUniChar ch = *iter;
+        if(ch == ',' || ch == '"' || ch == '{' || ch == '}' || ch == '[' || ch == ']') {
+            return false;
+        }
+        ++iter;
+    }
+    if(iter == end) {
+        return false;
+    }
+    value.m_name.assign(start, iter);
+    ++iter; // '='
+    return ReadValue(iter, end, value, depth);
+}
+
+wxString clGdbMIParser::GetToken(const wxString& line)
+{
+    Iter_t iter = line.begin();
+    while(iter != line.end() && *iter >= '0' && *iter <= '9') {
+        ++iter;
+    }
+    return wxString(line.begin(), iter);
+}
+
+bool clGdbMIParser::Parse(const wxString& line, clGdbMIRecord& record)
+{
+    record.Clear();
+    Iter_t iter = line.begin();
+    Iter_t end = line.end();
+
+    // the optional token
+    while(iter != end && *iter >= '0' && *iter <= '9') {
+        ++iter;
+    }
+    record.token.assign(line.begin(), iter);
+    if(iter == end) {
+        return false;
+    }
+
+    wxUniChar prefix = *iter;
+    switch(prefix.GetValue()) {
+    case '^':
+        record.type = clGdbMIRecord::kResult;
+        break;
+    case '*':
+        record.type = clGdbMIRecord::kExecAsync;
+        break;
+    case '+':
+        record.type = clGdbMIRecord::kStatusAsync;
+        break;
+    case '=':
+        record.type = clGdbMIRecord::kNotifyAsync;
+        break;
+    case '~':
+        record.type = clGdbMIRecord::kConsoleStream;
+        break;
+    case '@':
+        record.type = clGdbMIRecord::kTargetStream;
+        break;
+    case '&':
+        record.type = clGdbMIRecord::kLogStream;
+        break;
+    case '(':
+        if(record.token.IsEmpty() && line.StartsWith("(gdb)")) {
+            record.type = clGdbMIRecord::kPrompt;
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+    ++iter;
+
+    if(prefix == '~' || prefix == '@' || prefix == '&') {
+        if(iter == end || *iter != '"' || !ReadCString(iter, end, record.streamOutput)) {
+            return false;
+        }
+        while(iter != end && IsBlank(*iter)) {
+            ++iter;
+        }
+        return iter == end;
+    }
+
+    Iter_t start = iter;
+    while(iter != end && *iter != ',') {
+        ++iter;
+    }
+    record.resultClass.assign(start, iter);
+    record.results.m_kind = clGdbMIValue::kTuple;
+    while(iter != end && *iter == ',') {
+        ++iter;
+        record.results.m_children.push_back(clGdbMIValue());
+        if(!ReadResult(iter, end, record.results.m_children.back(), 0)) {
+            return false;
+        }
+    }
+    while(iter != end && IsBlank(*iter)) {
+        ++iter;
+    }
+    return iter == end;
+}
+
+//===------------------------------------------------
+// clGdbMIOutputQueue
+//===------------------------------------------------
+
+void clGdbMIOutputQueue::DoAddLine(wxString::const_iterator begin, wxString::const_iterator end)
+{
+    static const wxString prompt = "(gdb)";
+    while(true) {
+        while(begin != end && IsBlank(*begin)) {
+            ++begin;
+        }
+        while(begin != end) {
+            wxString::const_iterator last = end;
+            --last;
+            if(!IsBlank(*last)) {
+                break;
+            }
+            end = last;
+        }
+
+        // drop the prompt (gdb may print it in front of the next record)
+        wxString::const_iterator iter = begin;
+        wxString::const_iterator promptIter = prompt.begin();
+        while(iter != end && promptIter != prompt.end() && *iter == *promptIter) {
+            ++iter;
+            ++promptIter;
+        }
+        if(promptIter != prompt.end()) {
+            break;
+        }
+        begin = iter;
+    }
+
+    if(begin != end) {
+        m_lines.push_back(wxString(begin, end));
+    }
+}
+
+void clGdbMIOutputQueue::Append(const wxString& output)
+{
+    wxString::const_iterator lineStart = output.begin();
+    for(wxString::const_iterator iter = output.begin(); iter != output.end(); ++iter) {
+        if(*iter != '\n') {
+            continue;
+        }
+        if(m_partialLine.IsEmpty()) {
+            DoAddLine(lineStart, iter);
+        } else {
+            m_partialLine.append(lineStart, iter);
+            DoAddLine(m_partialLine.begin(), m_partialLine.end());
+            m_partialLine.clear();
+        }
+        lineStart = iter;
+        ++lineStart;
+    }
+    m_partialLine.append(lineStart, output.end());
+}
+
+bool clGdbMIOutputQueue::Pop(wxString& line)
+{
+    if(m_lines.empty()) {
+        return false;
+    }
+    line.swap(m_lines.front());
+    m_lines.pop_front();
+    return true;
+}
+
+void clGdbMIOutputQueue::Clear()
+{
+    m_lines.clear();
+    m_partialLine.clear();
+}
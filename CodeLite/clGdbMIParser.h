@@ -0,0 +1,143 @@
+#ifndef CLGDBMIPARSER_H
+#define CLGDBMIPARSER_H
+
+#include "codelite_exports.h"
+#include <deque>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class clGdbMIValue
+ * @brief a GDB/MI value: a c-string constant, a tuple or a list. The members of tuples (and of lists of results) are
+ * named
+ */
+class WXDLLIMPEXP_CL clGdbMIValue
+{
+public:
+    enum eKind {
+        kNone = 0,
+        kConst,
+        kTuple,
+        kList,
+    };
+    typedef std::vector<clGdbMIValue> Vec_t;
+
+protected:
+    eKind m_kind = kNone;
+    wxString m_name;
+    wxString m_value; // the unescaped c-string
+    Vec_t m_children;
+    friend class clGdbMIParser;
+
+public:
+    clGdbMIValue() {}
+    ~clGdbMIValue() {}
+
+    void Clear();
+
+    /**
+     * @brief false for the value returned when a member is not found
+     */
+    bool IsOk() const { return m_kind != kNone; }
+    eKind GetKind() const { return m_kind; }
+    const wxString& GetName() const { return m_name; }
+    const wxString& GetValue() const { return m_value; }
+    const Vec_t& GetChildren() const { return m_children; }
+
+    /**
+     * @brief the first member named 'name'. A value that is not IsOk() when there is none, so lookups can be chained:
+     * record["frame"]["line"]
+     */
+    const clGdbMIValue& operator[](const wxString& name) const;
+
+    /**
+     * @brief convert the constant to a number
+     */
+    bool GetLong(long& value) const { return m_kind == kConst && m_value.ToLong(&value); }
+};
+
+/**
+ * @class clGdbMIRecord
+ * @brief a single line of GDB/MI output
+ */
+class WXDLLIMPEXP_CL clGdbMIRecord
+{
+public:
+    enum eType {
+        kUnknown = 0,   // not a MI record (e.g. the debuggee output)
+        kResult,        // ^done, ^running, ^connected, ^error, ^exit
+        kExecAsync,     // *stopped, *running
+        kStatusAsync,   // +download
+        kNotifyAsync,   // =thread-created, =library-loaded ...
+        kConsoleStream, // ~"..."
+        kTargetStream,  // @"..."
+        kLogStream,     // &"..."
+        kPrompt,        // (gdb)
+    };
+
+    eType type = kUnknown;
+    wxString token;        // the command token, empty if the record has none
+    wxString resultClass;  // "done", "stopped" ...
+    clGdbMIValue results;  // a tuple with the results
+    wxString streamOutput; // the unescaped text of a stream record
+
+public:
+    void Clear();
+    const clGdbMIValue& operator[](const wxString& name) const { return results[name]; }
+};
+
+/**
+ * @class clGdbMIParser
+ * @brief a hand written parser of GDB/MI records
+ */
+class WXDLLIMPEXP_CL clGdbMIParser
+{
+    typedef wxString::const_iterator Iter_t;
+
+protected:
+    static bool ReadCString(Iter_t& iter, const Iter_t& end, wxString& str);
+    static bool ReadValue(Iter_t& iter, const Iter_t& end, clGdbMIValue& value, size_t depth);
+    static bool ReadResult(Iter_t& iter, const Iter_t& end, clGdbMIValue& value, size_t depth);
+
+public:
+    /**
+     * @brief parse a single line of MI output into 'record'
+     * @return false if the line is not a valid MI record. The record then holds what could be parsed
+     */
+    static bool Parse(const wxString& line, clGdbMIRecord& record);
+
+    /**
+     * @brief return the token of 'line' (its leading digits) without parsing the rest of it
+     */
+    static wxString GetToken(const wxString& line);
+};
+
+/**
+ * @class clGdbMIOutputQueue
+ * @brief splits the debugger output into lines. The lines are trimmed, empty lines and "(gdb)" prompts are dropped
+ */
+class WXDLLIMPEXP_CL clGdbMIOutputQueue
+{
+    std::deque<wxString> m_lines;
+    wxString m_partialLine; // the last line received, when it is not complete yet
+
+protected:
+    void DoAddLine(wxString::const_iterator begin, wxString::const_iterator end);
+
+public:
+    /**
+     * @brief queue the complete lines of 'output'
+     */
+    void Append(const wxString& output);
+
+    /**
+     * @brief take the oldest line
+     */
+    bool Pop(wxString& line);
+
+    bool IsEmpty() const { return m_lines.empty(); }
+    size_t GetCount() const { return m_lines.size(); }
+    void Clear();
+};
+
+#endif // CLGDBMIPARSER_H
@@ -0,0 +1,62 @@
+#include "clLiteralMatcher.h"
+#include <string.h>
+
+static inline unsigned char FoldCase(unsigned char ch) { return (ch >= 'A' && ch <= 'Z') ? (ch + ('a' - 'A')) : ch; }
+
+clLiteralMatcher::clLiteralMatcher(const std::string& pattern, bool ignoreCase)
+    : m_pattern(pattern)
+    , m_ignoreCase(ignoreCase)
+{
+    if(m_ignoreCase) {
+        for(size_t i = 0; i < m_pattern.length(); ++i) {
+            m_pattern[i] = (char)FoldCase((unsigned char)m_pattern[i]);
+        }
+    }
+
+    // The bad character table: how far we can shift when the byte under the pattern's last position
+    // is 'ch'. The last pattern byte is excluded
+    size_t len = m_pattern.length();
+    for(size_t i = 0; i < 256; ++i) {
+        m_skip[i] = len;
+    }
+    for(size_t i = 0; (i + 1) < len; ++i) {
+        unsigned char ch = (unsigned char)m_pattern[i];
+        m_skip[ch] = len - 1 - i;
+        if(m_ignoreCase && ch >= 'a' && ch <= 'z') { m_skip[ch - ('a' - 'A')] = len - 1 - i; }
+    }
+}
+
+clLiteralMatcher::~clLiteralMatcher() {}
+
+size_t clLiteralMatcher::Find(const char* buffer, size_t len, size_t from) const
+{
+    size_t plen = m_pattern.length();
+    if(plen == 0 || from >= len || (len - from) < plen) { return std::string::npos; }
+
+    const unsigned char* p = (const unsigned char*)m_pattern.data();
+    const unsigned char* h = (const unsigned char*)buffer;
+    if(!m_ignoreCase) {
+        if(plen == 1) {
+            // memchr is vectorized by the C library
+            const void* where = memchr(h + from, p[0], len - from);
+            return where ? (const unsigned char*)where - h : std::string::npos;
+        }
+
+        size_t last = plen - 1;
+        for(size_t i = from; i + plen <= len; i += m_skip[h[i + last]]) {
+            if(h[i + last] == p[last] && memcmp(h + i, p, last) == 0) { return i; }
+        }
+
+    } else {
+        size_t last = plen - 1;
+        for(size_t i = from; i + plen <= len; i += m_skip[h[i + last]]) {
+            if(FoldCase(h[i + last]) != p[last]) continue;
+            size_t j = 0;
+            while(j < last && FoldCase(h[i + j]) == p[j]) {
+                ++j;
+            }
+            if(j == last) { return i; }
+        }
+    }
+    return std::string::npos;
+}
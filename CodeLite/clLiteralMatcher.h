@@ -0,0 +1,32 @@
+#ifndef CLLITERALMATCHER_H
+#define CLLITERALMATCHER_H
+
+#include "codelite_exports.h"
+#include <string>
+
+/**
+ * @class clLiteralMatcher
+ * @brief Boyer-Moore-Horspool search of a fixed string in raw bytes (e.g. UTF-8 file content).
+ * The case insensitive mode folds ASCII letters only, it should be used with ASCII patterns
+ */
+class WXDLLIMPEXP_CL clLiteralMatcher
+{
+    std::string m_pattern;
+    bool m_ignoreCase = false;
+    size_t m_skip[256];
+
+public:
+    clLiteralMatcher(const std::string& pattern, bool ignoreCase);
+    virtual ~clLiteralMatcher();
+
+    /**
+     * @brief find the first occurrence of the pattern in buffer[from, len)
+     * @return the match offset or std::string::npos
+     */
+    size_t Find(const char* buffer, size_t len, size_t from = 0) const;
+
+    const std::string& GetPattern() const { return m_pattern; }
+    bool IsIgnoreCase() const { return m_ignoreCase; }
+};
+
+#endif // CLLITERALMATCHER_H
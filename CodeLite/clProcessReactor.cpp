@@ -0,0 +1,474 @@
+#include "clProcessReactor.h"
+
+#if defined(__WXMAC__) || defined(__WXGTK__)
+#include "StringUtils.h"
+#include "asyncprocess.h"
+#include "file_logger.h"
+#include "processreaderthread.h"
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <sys/select.h>
+#endif
+
+// the output of a process is delivered at most once per interval
+#define REACTOR_FLUSH_INTERVAL_MS 20
+
+// how often we check whether the processes that are not redirected are still alive
+#define REACTOR_ALIVE_CHECK_MS 50
+
+// the size of a single read()
+#define REACTOR_READ_SIZE (1024 * 64)
+
+// an escape sequence longer than this is not waited for
+#define REACTOR_MAX_ESCAPE_LENGTH 256
+
+// the epoll data of the wakeup pipe, channel ids start at 1
+#define REACTOR_WAKEUP_ID 0
+
+namespace
+{
+void SetFdFlags(int fd, bool nonBlocking)
+{
+    ::fcntl(fd, F_SETFD, ::fcntl(fd, F_GETFD) | FD_CLOEXEC);
+    if(nonBlocking) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+}
+
+/**
+ * @brief does buffer[escape] start an escape sequence that is not complete yet?
+ * This follows the states of StringUtils::StripTerminalColouring
+ */
+bool IsIncompleteEscape(const std::string& buffer, size_t escape, size_t len)
+{
+    bool osc = false;
+    for(size_t i = escape + 1; i < len; ++i) {
+        char ch = buffer[i];
+        if(osc) {
+            if(ch == '\a') {
+                return false;
+            }
+        } else if(ch == ']') {
+            osc = true;
+        } else if(ch != 0 && strchr("mKGJHXBCDd", ch)) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+clProcessReactor::clProcessReactor()
+{
+    m_shutdown.store(false);
+}
+
+clProcessReactor::~clProcessReactor()
+{
+    if(m_thread.joinable()) {
+        m_shutdown.store(true);
+        Wakeup();
+        m_thread.join();
+    }
+    if(m_pollFd != wxNOT_FOUND) {
+        ::close(m_pollFd);
+    }
+    for(int fd : m_wakeupPipe) {
+        if(fd != wxNOT_FOUND) {
+            ::close(fd);
+        }
+    }
+}
+
+clProcessReactor& clProcessReactor::Get()
+{
+    static clProcessReactor reactor;
+    return reactor;
+}
+
+void clProcessReactor::EnsureStarted()
+{
+    if(m_thread.joinable()) {
+        return;
+    }
+
+    if(::pipe(m_wakeupPipe) != 0) {
+        clWARNING() << "Process reactor: failed to create the wakeup pipe." << strerror(errno) << clEndl;
+        m_wakeupPipe[0] = m_wakeupPipe[1] = wxNOT_FOUND;
+    } else {
+        SetFdFlags(m_wakeupPipe[0], true);
+        SetFdFlags(m_wakeupPipe[1], true);
+    }
+
+#ifdef __linux__
+    m_pollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if(m_pollFd == wxNOT_FOUND) {
+        clWARNING() << "Process reactor: epoll_create1 error:" << strerror(errno) << clEndl;
+    } else if(m_wakeupPipe[0] != wxNOT_FOUND) {
+        epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u64 = REACTOR_WAKEUP_ID;
+        ::epoll_ctl(m_pollFd, EPOLL_CTL_ADD, m_wakeupPipe[0], &ev);
+    }
+#endif
+    m_thread = std::thread(&clProcessReactor::WorkerMain, this);
+}
+
+void clProcessReactor::Wakeup()
+{
+    if(m_wakeupPipe[1] != wxNOT_FOUND) {
+        char ch = 0;
+        // the pipe is non blocking: when it is full, the reactor is already awake
+        ssize_t rc = ::write(m_wakeupPipe[1], &ch, 1);
+        wxUnusedVar(rc);
+    }
+}
+
+bool clProcessReactor::Register(IProcess* process, wxEvtHandler* parent, int stdoutFd, int stderrFd,
+                                bool stripColours)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        EnsureStarted();
+        if(stdoutFd == wxNOT_FOUND) {
+            Watched watched;
+            watched.process = process;
+            watched.parent = parent;
+            m_watched.push_back(watched);
+        } else {
+            uint64_t stdoutId = m_nextId;
+            if(!AddChannel(process, parent, process->GetCallback(), stdoutFd, false, stripColours)) {
+                return false;
+            }
+            if(stderrFd != wxNOT_FOUND &&
+               !AddChannel(process, parent, process->GetCallback(), stderrFd, true, stripColours)) {
+                RemoveChannel(stdoutId);
+                return false;
+            }
+        }
+    }
+    Wakeup();
+    return true;
+}
+
+void clProcessReactor::Unregister(IProcess* process)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<uint64_t> ids;
+    for(const auto& p : m_channels) {
+        if(p.second.process == process) {
+            ids.push_back(p.first);
+        }
+    }
+    for(uint64_t id : ids) {
+        RemoveChannel(id);
+    }
+    m_watched.erase(std::remove_if(m_watched.begin(), m_watched.end(),
+                                   [process](const Watched& w) { return w.process == process; }),
+                    m_watched.end());
+}
+
+bool clProcessReactor::AddChannel(IProcess* process, wxEvtHandler* parent, IProcessCallback* callback, int fd,
+                                  bool isStderr, bool stripColours)
+{
+#ifdef __linux__
+    if(m_pollFd == wxNOT_FOUND) {
+        clWARNING() << "Process reactor: can not watch fd" << fd << ": no epoll instance" << clEndl;
+        return false;
+    }
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = m_nextId;
+    if(::epoll_ctl(m_pollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        clWARNING() << "Process reactor: failed to watch fd" << fd << ":" << strerror(errno) << clEndl;
+        return false;
+    }
+#else
+    if(fd >= FD_SETSIZE) {
+        clWARNING() << "Process reactor: can not watch fd" << fd << ": it does not fit in a fd_set" << clEndl;
+        return false;
+    }
+#endif
+    uint64_t id = m_nextId++;
+    Channel& channel = m_channels[id];
+    channel.process = process;
+    channel.parent = parent;
+    channel.callback = callback;
+    channel.fd = fd;
+    channel.isStderr = isStderr;
+    channel.stripColours = stripColours;
+    channel.lastFlush = Clock_t::now() - std::chrono::milliseconds(REACTOR_FLUSH_INTERVAL_MS);
+    return true;
+}
+
+void clProcessReactor::RemoveChannel(uint64_t id)
+{
+    auto iter = m_channels.find(id);
+    if(iter == m_channels.end()) {
+        return;
+    }
+#ifdef __linux__
+    // the fd is still open: the process closes it only after unregistering
+    if(!iter->second.eof) {
+        ::epoll_ctl(m_pollFd, EPOLL_CTL_DEL, iter->second.fd, nullptr);
+    }
+#endif
+    m_channels.erase(iter);
+}
+
+bool clProcessReactor::ReadChannel(Channel& channel)
+{
+    size_t oldSize = channel.buffer.size();
+    channel.buffer.resize(oldSize + REACTOR_READ_SIZE);
+    errno = 0;
+    ssize_t bytesRead = ::read(channel.fd, &channel.buffer[oldSize], REACTOR_READ_SIZE);
+    int errCode = errno;
+    channel.buffer.resize(oldSize + std::max<ssize_t>(bytesRead, 0));
+    if(bytesRead > 0) {
+        channel.pending = true;
+        return true;
+    }
+    // a pty master reports EIO once the child is gone
+    return bytesRead < 0 && (errCode == EINTR || errCode == EAGAIN);
+}
+
+size_t clProcessReactor::GetDecodableLength(const std::string& buffer, bool escapeSequences)
+{
+    size_t len = buffer.length();
+
+    // step back over the continuation bytes of the last sequence and check that its lead byte got all of them
+    size_t start = len;
+    while(start > 0 && (len - start) < 3 && (buffer[start - 1] & 0xC0) == 0x80) {
+        --start;
+    }
+    if(start > 0) {
+        unsigned char lead = buffer[start - 1];
+        size_t expected = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 1;
+        if(expected > 1 && (len - start + 1) < expected) {
+            len = start - 1;
+        }
+    }
+
+    if(escapeSequences && len > 0) {
+        size_t escape = buffer.rfind('\x1b', len - 1);
+        if(escape != std::string::npos && (len - escape) <= REACTOR_MAX_ESCAPE_LENGTH &&
+           IsIncompleteEscape(buffer, escape, len)) {
+            len = escape;
+        }
+    }
+    return len;
+}
+
+void clProcessReactor::FlushChannel(Channel& channel, bool all)
+{
+    channel.pending = false;
+    channel.lastFlush = Clock_t::now();
+    size_t len = all ? channel.buffer.length() : GetDecodableLength(channel.buffer, channel.stripColours);
+    if(len == 0) {
+        // wait for the rest of the sequence
+        return;
+    }
+
+    std::string output;
+    if(channel.stripColours) {
+        StringUtils::StripTerminalColouring(channel.buffer.substr(0, len), output);
+    } else {
+        output = channel.buffer.substr(0, len);
+    }
+    channel.buffer.erase(0, len);
+    if(output.empty()) {
+        return;
+    }
+
+    wxString text(output.c_str(), wxConvUTF8, output.length());
+    if(text.IsEmpty()) {
+        text = wxString::From8BitData(output.c_str(), output.length());
+    }
+
+    if(channel.callback) {
+        // the callback interface has no stderr notification
+        if(!channel.isStderr) {
+            channel.callback->CallAfter(&IProcessCallback::OnProcessOutput, text);
+        }
+    } else if(channel.parent) {
+        clProcessEvent e(channel.isStderr ? wxEVT_ASYNC_PROCESS_STDERR : wxEVT_ASYNC_PROCESS_OUTPUT);
+        e.SetOutput(text);
+        e.SetProcess(channel.process);
+        channel.parent->AddPendingEvent(e);
+    }
+}
+
+void clProcessReactor::NotifyTerminated(IProcess* process, wxEvtHandler* parent, IProcessCallback* callback)
+{
+    if(callback) {
+        callback->CallAfter(&IProcessCallback::OnProcessTerminated);
+    } else if(parent) {
+        clProcessEvent e(wxEVT_ASYNC_PROCESS_TERMINATED);
+        e.SetProcess(process);
+        parent->AddPendingEvent(e);
+    }
+}
+
+void clProcessReactor::DoChannelClosed(Channel& channel)
+{
+    FlushChannel(channel, true);
+    channel.eof = true;
+#ifdef __linux__
+    ::epoll_ctl(m_pollFd, EPOLL_CTL_DEL, channel.fd, nullptr);
+#endif
+
+    // like the reader thread did, keep reading stderr after stdout is closed (and the other way around): the process
+    // is terminated once all its descriptors are drained
+    IProcess* process = channel.process;
+    for(const auto& p : m_channels) {
+        if(p.second.process == process && !p.second.eof) {
+            return;
+        }
+    }
+    DoTerminated(process);
+}
+
+void clProcessReactor::DoTerminated(IProcess* process)
+{
+    wxEvtHandler* parent = nullptr;
+    IProcessCallback* callback = nullptr;
+    std::vector<uint64_t> ids;
+    for(auto& p : m_channels) {
+        Channel& channel = p.second;
+        if(channel.process == process) {
+            if(!channel.isStderr) {
+                parent = channel.parent;
+                callback = channel.callback;
+            }
+            FlushChannel(channel, true);
+            ids.push_back(p.first);
+        }
+    }
+    for(uint64_t id : ids) {
+        RemoveChannel(id);
+    }
+    NotifyTerminated(process, parent, callback);
+}
+
+int clProcessReactor::GetTimeout(Clock_t::time_point now) const
+{
+    int timeout = m_watched.empty() ? -1 : REACTOR_ALIVE_CHECK_MS;
+    for(const auto& p : m_channels) {
+        const Channel& channel = p.second;
+        if(!channel.pending) {
+            continue;
+        }
+        auto due = channel.lastFlush + std::chrono::milliseconds(REACTOR_FLUSH_INTERVAL_MS);
+        int ms = std::max(0, (int)std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count());
+        timeout = (timeout == -1) ? ms : std::min(timeout, ms);
+    }
+    return timeout;
+}
+
+void clProcessReactor::WorkerMain()
+{
+    std::vector<uint64_t> ready;
+    while(!m_shutdown.load()) {
+        ready.clear();
+        int timeout = 0;
+#ifdef __linux__
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            timeout = GetTimeout(Clock_t::now());
+        }
+        epoll_event events[64];
+        int count = ::epoll_wait(m_pollFd, events, 64, timeout);
+        if(count < 0 && errno != EINTR) {
+            // no epoll instance: keep checking the processes that are not redirected
+            std::this_thread::sleep_for(std::chrono::milliseconds(REACTOR_ALIVE_CHECK_MS));
+        }
+        for(int i = 0; i < count; ++i) {
+            if(events[i].data.u64 == REACTOR_WAKEUP_ID) {
+                char buffer[128];
+                while(::read(m_wakeupPipe[0], buffer, sizeof(buffer)) > 0) {
+                }
+            } else {
+                ready.push_back(events[i].data.u64);
+            }
+        }
+#else
+        fd_set rset;
+        FD_ZERO(&rset);
+        int maxFd = m_wakeupPipe[0];
+        std::vector<std::pair<uint64_t, int> > watched;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            timeout = GetTimeout(Clock_t::now());
+            for(const auto& p : m_channels) {
+                if(!p.second.eof) {
+                    watched.push_back({ p.first, p.second.fd });
+                }
+            }
+        }
+        if(m_wakeupPipe[0] != wxNOT_FOUND) {
+            FD_SET(m_wakeupPipe[0], &rset);
+        }
+        for(const auto& w : watched) {
+            FD_SET(w.second, &rset);
+            maxFd = std::max(maxFd, w.second);
+        }
+        timeval tv;
+        tv.tv_sec = timeout / 1000;
+        tv.tv_usec = (timeout % 1000) * 1000;
+        int count = ::select(maxFd + 1, &rset, nullptr, nullptr, timeout == -1 ? nullptr : &tv);
+        if(count > 0) {
+            if(m_wakeupPipe[0] != wxNOT_FOUND && FD_ISSET(m_wakeupPipe[0], &rset)) {
+                char buffer[128];
+                while(::read(m_wakeupPipe[0], buffer, sizeof(buffer)) > 0) {
+                }
+            }
+            for(const auto& w : watched) {
+                if(FD_ISSET(w.second, &rset)) {
+                    ready.push_back(w.first);
+                }
+            }
+        }
+#endif
+        if(m_shutdown.load()) {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(uint64_t id : ready) {
+            // the channel may have been removed while we were waiting
+            auto iter = m_channels.find(id);
+            if(iter == m_channels.end() || iter->second.eof || ReadChannel(iter->second)) {
+                continue;
+            }
+            DoChannelClosed(iter->second);
+        }
+
+        Clock_t::time_point now = Clock_t::now();
+        for(auto& p : m_channels) {
+            Channel& channel = p.second;
+            if(channel.pending && (now - channel.lastFlush) >= std::chrono::milliseconds(REACTOR_FLUSH_INTERVAL_MS)) {
+                FlushChannel(channel, false);
+            }
+        }
+
+        for(size_t i = 0; i < m_watched.size();) {
+            Watched& w = m_watched[i];
+            if(w.process->IsAlive()) {
+                ++i;
+                continue;
+            }
+            NotifyTerminated(w.process, w.parent, w.process->GetCallback());
+            m_watched.erase(m_watched.begin() + i);
+        }
+    }
+}
+#endif //#if defined(__WXMAC__) || defined(__WXGTK__)
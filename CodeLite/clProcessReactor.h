@@ -0,0 +1,113 @@
+#ifndef CLPROCESSREACTOR_H
+#define CLPROCESSREACTOR_H
+
+#if defined(__WXMAC__) || defined(__WXGTK__)
+#include "codelite_exports.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <wx/event.h>
+
+class IProcess;
+class IProcessCallback;
+
+/**
+ * @class clProcessReactor
+ * @brief a single thread that reads the output of all the asynchronous processes.
+ *
+ * The process file descriptors are multiplexed with epoll (select() on the other Unix flavours, poll() does not
+ * support the ptys on macOS). The bytes read are kept per descriptor and converted to wxString only up to the last
+ * complete UTF-8 sequence (and outside of a terminal escape sequence when the colours are stripped), so a character
+ * is never split between two events. The output of a descriptor is delivered at most once per
+ * REACTOR_FLUSH_INTERVAL_MS: a burst of output becomes a few large clProcessEvent instead of one per read()
+ */
+class WXDLLIMPEXP_CL clProcessReactor
+{
+public:
+    typedef std::chrono::steady_clock Clock_t;
+
+protected:
+    struct Channel {
+        IProcess* process = nullptr;
+        wxEvtHandler* parent = nullptr;
+        IProcessCallback* callback = nullptr;
+        int fd = wxNOT_FOUND;
+        bool isStderr = false;
+        bool stripColours = true;
+        bool pending = false; // 'buffer' holds output that was not delivered yet
+        bool eof = false;     // the descriptor is no longer watched, the other channels of the process may still be
+        std::string buffer;
+        Clock_t::time_point lastFlush;
+    };
+
+    // processes that are not redirected: we only watch for their termination
+    struct Watched {
+        IProcess* process = nullptr;
+        wxEvtHandler* parent = nullptr;
+    };
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::unordered_map<uint64_t, Channel> m_channels; // by channel id
+    std::vector<Watched> m_watched;
+    uint64_t m_nextId = 1;
+    int m_pollFd = wxNOT_FOUND; // the epoll instance
+    int m_wakeupPipe[2] = { wxNOT_FOUND, wxNOT_FOUND };
+    std::atomic_bool m_shutdown;
+
+protected:
+    clProcessReactor();
+    void EnsureStarted();
+    void Wakeup();
+    void WorkerMain();
+    bool AddChannel(IProcess* process, wxEvtHandler* parent, IProcessCallback* callback, int fd, bool isStderr,
+                    bool stripColours);
+    void RemoveChannel(uint64_t id);
+    /**
+     * @brief read once from the channel. Return false on EOF or error
+     */
+    bool ReadChannel(Channel& channel);
+    void FlushChannel(Channel& channel, bool all);
+    void NotifyTerminated(IProcess* process, wxEvtHandler* parent, IProcessCallback* callback);
+    /**
+     * @brief the channel reached EOF: deliver what is left and stop watching it. Once all the channels of its process
+     * are at EOF, the process is reported as terminated
+     */
+    void DoChannelClosed(Channel& channel);
+    /**
+     * @brief the output of 'process' ended: deliver what is left and forget about the process
+     */
+    void DoTerminated(IProcess* process);
+    int GetTimeout(Clock_t::time_point now) const;
+
+public:
+    static clProcessReactor& Get();
+    virtual ~clProcessReactor();
+
+    /**
+     * @brief start reading the output of 'process'
+     * @param parent the events handler notified with wxEVT_ASYNC_PROCESS_* (unless the process has a callback)
+     * @param stdoutFd the process output, wxNOT_FOUND if it is not redirected (only its termination is reported)
+     * @param stderrFd the process stderr when it is read separately, wxNOT_FOUND otherwise
+     * @return false if the descriptors could not be watched, the caller should read them itself
+     */
+    bool Register(IProcess* process, wxEvtHandler* parent, int stdoutFd, int stderrFd, bool stripColours);
+
+    /**
+     * @brief stop reading the output of 'process'. No event about it is sent once this function returns
+     */
+    void Unregister(IProcess* process);
+
+    /**
+     * @brief the length of the longest prefix of 'buffer' that can be converted without splitting a UTF-8 sequence
+     * (or an escape sequence, if 'escapeSequences' is set)
+     */
+    static size_t GetDecodableLength(const std::string& buffer, bool escapeSequences);
+};
+#endif //#if defined(__WXMAC__) || defined(__WXGTK__)
+#endif // CLPROCESSREACTOR_H
@@ -0,0 +1,107 @@
+#include "clXXHash.h"
+#include "clFileReader.h"
+#include <string.h>
+
+// XXH64, as described in https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+namespace
+{
+const wxUint64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const wxUint64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const wxUint64 PRIME64_3 = 0x165667B19E3779F9ULL;
+const wxUint64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const wxUint64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline wxUint64 RotateLeft(wxUint64 value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+// the input is read as little endian
+inline wxUint64 Read64(const unsigned char* p)
+{
+    wxUint64 value = 0;
+    for(int i = 7; i >= 0; --i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+inline wxUint32 Read32(const unsigned char* p)
+{
+    return (wxUint32)p[0] | ((wxUint32)p[1] << 8) | ((wxUint32)p[2] << 16) | ((wxUint32)p[3] << 24);
+}
+
+inline wxUint64 Round(wxUint64 acc, wxUint64 input)
+{
+    acc += input * PRIME64_2;
+    acc = RotateLeft(acc, 31);
+    return acc * PRIME64_1;
+}
+
+inline wxUint64 MergeRound(wxUint64 acc, wxUint64 value)
+{
+    acc ^= Round(0, value);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+} // namespace
+
+wxUint64 clXXHash::Hash64(const void* data, size_t len, wxUint64 seed)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + len;
+    wxUint64 hash;
+
+    if(len >= 32) {
+        // process the input in stripes of 32 bytes, with 4 accumulators
+        wxUint64 acc1 = seed + PRIME64_1 + PRIME64_2;
+        wxUint64 acc2 = seed + PRIME64_2;
+        wxUint64 acc3 = seed;
+        wxUint64 acc4 = seed - PRIME64_1;
+        const unsigned char* limit = end - 32;
+        do {
+            acc1 = Round(acc1, Read64(p));
+            acc2 = Round(acc2, Read64(p + 8));
+            acc3 = Round(acc3, Read64(p + 16));
+            acc4 = Round(acc4, Read64(p + 24));
+            p += 32;
+        } while(p <= limit);
+
+        hash = RotateLeft(acc1, 1) + RotateLeft(acc2, 7) + RotateLeft(acc3, 12) + RotateLeft(acc4, 18);
+        hash = MergeRound(hash, acc1);
+        hash = MergeRound(hash, acc2);
+        hash = MergeRound(hash, acc3);
+        hash = MergeRound(hash, acc4);
+    } else {
+        hash = seed + PRIME64_5;
+    }
+
+    hash += (wxUint64)len;
+
+    // the remaining bytes
+    for(; p + 8 <= end; p += 8) {
+        hash ^= Round(0, Read64(p));
+        hash = RotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if(p + 4 <= end) {
+        hash ^= (wxUint64)Read32(p) * PRIME64_1;
+        hash = RotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for(; p < end; ++p) {
+        hash ^= (*p) * PRIME64_5;
+        hash = RotateLeft(hash, 11) * PRIME64_1;
+    }
+
+    // avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+bool clXXHash::HashFile(const wxString& filename, wxUint64& hash)
+{
+    clFileReader file;
+    if(!file.Open(filename)) { return false; }
+    hash = Hash64(file.GetData(), file.GetSize());
+    return true;
+}
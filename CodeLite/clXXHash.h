@@ -0,0 +1,29 @@
+#ifndef CLXXHASH_H
+#define CLXXHASH_H
+
+#include "codelite_exports.h"
+#include <stddef.h>
+#include <wx/defs.h>
+#include <wx/string.h>
+
+/**
+ * @class clXXHash
+ * @brief the 64 bit xxHash (XXH64) of a buffer or a file content. A fast non cryptographic hash, used to tell whether
+ * a file content changed
+ */
+class WXDLLIMPEXP_CL clXXHash
+{
+public:
+    /**
+     * @brief return the XXH64 hash of 'len' bytes of 'data'
+     */
+    static wxUint64 Hash64(const void* data, size_t len, wxUint64 seed = 0);
+
+    /**
+     * @brief hash the content of 'filename'
+     * @return false if the file could not be read
+     */
+    static bool HashFile(const wxString& filename, wxUint64& hash);
+};
+
+#endif // CLXXHASH_H
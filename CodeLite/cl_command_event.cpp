@@ -55,6 +55,7 @@ clCommandEvent& clCommandEvent::operator=(const clCommandEvent& src)
     m_oldName = src.m_oldName;
     m_lineNumber = src.m_lineNumber;
     m_selected = src.m_selected;
+    m_stringRaw = src.m_stringRaw;
 
     // Copy wxCommandEvent members here
     m_eventType = src.m_eventType;
@@ -402,6 +403,7 @@ clParseEvent::clParseEvent(wxEventType commandType, int winid)
     : clCommandEvent(commandType, winid)
     , m_curfileIndex(0)
     , m_totalFiles(0)
+    , m_filesPerSecond(0)
 {
 }
 
@@ -412,6 +414,7 @@ clParseEvent& clParseEvent::operator=(const clParseEvent& src)
     clCommandEvent::operator=(src);
     m_curfileIndex = src.m_curfileIndex;
     m_totalFiles = src.m_totalFiles;
+    m_filesPerSecond = src.m_filesPerSecond;
     return *this;
 }
 
@@ -434,6 +437,7 @@ clProcessEvent& clProcessEvent::operator=(const clProcessEvent& src)
     clCommandEvent::operator=(src);
     m_process = src.m_process;
     m_output = src.m_output;
+    m_outputRaw = src.m_outputRaw;
     return *this;
 }
 
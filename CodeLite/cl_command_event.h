@@ -33,6 +33,7 @@
 #include "codelite_exports.h"
 #include "entry.h"
 #include "wxCodeCompletionBoxEntry.hpp"
+#include <string>
 #include <vector>
 #include <wx/arrstr.h>
 #include <wx/event.h>
@@ -148,6 +149,7 @@ protected:
     bool m_allowed;
     int m_lineNumber;
     bool m_selected;
+    std::string m_stringRaw;
 
 public:
     clCommandEvent(wxEventType commandType = wxEVT_NULL, int winid = 0);
@@ -178,6 +180,15 @@ public:
         return *this;
     }
     int GetLineNumber() const { return m_lineNumber; }
+    /**
+     * @brief raw bytes attached to the event (e.g. the data read from a socket), they are not converted to wxString
+     */
+    clCommandEvent& SetStringRaw(const std::string& str)
+    {
+        this->m_stringRaw = str;
+        return *this;
+    }
+    const std::string& GetStringRaw() const { return m_stringRaw; }
     clCommandEvent& SetAllowed(bool allowed)
     {
         this->m_allowed = allowed;
@@ -549,6 +560,7 @@ class IProcess;
 class WXDLLIMPEXP_CL clProcessEvent : public clCommandEvent
 {
     wxString m_output;
+    std::string m_outputRaw;
     IProcess* m_process;
 
 public:
@@ -561,6 +573,8 @@ public:
     void SetOutput(const wxString& output) { this->m_output = output; }
     void SetProcess(IProcess* process) { this->m_process = process; }
     const wxString& GetOutput() const { return m_output; }
+    void SetOutputRaw(const std::string& outputRaw) { this->m_outputRaw = outputRaw; }
+    const std::string& GetOutputRaw() const { return m_outputRaw; }
     IProcess* GetProcess() { return m_process; }
 };
 
@@ -721,6 +735,7 @@ class WXDLLIMPEXP_CL clParseEvent : public clCommandEvent
 {
     size_t m_curfileIndex;
     size_t m_totalFiles;
+    size_t m_filesPerSecond;
 
 public:
     clParseEvent(wxEventType commandType = wxEVT_NULL, int winid = 0);
@@ -732,6 +747,8 @@ public:
     void SetTotalFiles(size_t totalFiles) { this->m_totalFiles = totalFiles; }
     size_t GetCurfileIndex() const { return m_curfileIndex; }
     size_t GetTotalFiles() const { return m_totalFiles; }
+    void SetFilesPerSecond(size_t filesPerSecond) { this->m_filesPerSecond = filesPerSecond; }
+    size_t GetFilesPerSecond() const { return m_filesPerSecond; }
 };
 
 typedef void (wxEvtHandler::*clParseEventFunction)(clParseEvent&);
@@ -29,6 +29,7 @@
 #include "cl_indexer_reply.h"
 #include "cl_indexer_request.h"
 #include "cl_standard_paths.h"
+#include "clXXHash.h"
 #include "clindexerprotocol.h"
 #include "code_completion_api.h"
 #include "codelite_exports.h"
@@ -50,6 +51,7 @@
 #include "wx/tokenzr.h"
 #include "wxStringHash.h"
 #include <algorithm>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <wx/app.h>
@@ -143,6 +145,7 @@ TagsManager::TagsManager()
     : wxEvtHandler()
     , m_codeliteIndexerPath(wxT("codelite_indexer"))
     , m_codeliteIndexerProcess(NULL)
+    , m_indexerRunning(false)
     , m_canRestartIndexer(true)
     , m_lang(NULL)
     , m_evtHandler(NULL)
@@ -167,6 +170,7 @@ TagsManager::TagsManager()
 TagsManager::~TagsManager()
 {
     m_symbolsCache.reset(nullptr);
+    m_indexerRunning = false;
     if(m_codeliteIndexerProcess) {
 
         // Dont kill the indexer process, just terminate the
@@ -208,6 +212,7 @@ void TagsManager::OpenDatabase(const wxFileName& fileName)
     db->OpenDatabase(fileName);
     db->SetEnableCaseInsensitive(!(m_tagsOptions.GetFlags() & CC_IS_CASE_SENSITIVE));
     db->SetSingleSearchLimit(m_tagsOptions.GetCcNumberOfDisplayItems());
+    db->SetUseNameIndex(true);
 
     if(db->GetVersion() != db->GetSchemaVersion()) {
         db->RecreateDatabase();
@@ -229,7 +234,7 @@ void TagsManager::OpenDatabase(const wxFileName& fileName)
 
 TagTreePtr TagsManager::ParseSourceFile(const wxFileName& fp, std::vector<CommentPtr>* comments)
 {
-    wxString tags;
+    std::string tags;
 
     if(!m_codeliteIndexerProcess) {
         clWARNING() << "Indexer process is not running..." << clEndl;
@@ -237,8 +242,8 @@ TagTreePtr TagsManager::ParseSourceFile(const wxFileName& fp, std::vector<Commen
     }
     SourceToTags(fp, tags);
 
-    int dummy;
-    TagTreePtr ttp = TagTreePtr(TreeFromTags(tags, dummy));
+    int dummy = 0;
+    TagTreePtr ttp = TreeFromIndexerOutput(tags, dummy);
 
     if(comments && GetParseComments()) {
         // parse comments
@@ -313,13 +318,16 @@ void TagsManager::StartCodeLiteIndexer()
     if(m_codeliteIndexerPath.FileExists() == false) {
         CL_ERROR(wxT("ERROR: Could not locate indexer: %s"), m_codeliteIndexerPath.GetFullPath().c_str());
         m_codeliteIndexerProcess = NULL;
+        m_indexerRunning = false;
         return;
     }
 
     // concatenate the PID to identifies this channel to this instance of codelite
     cmd << wxT("\"") << m_codeliteIndexerPath.GetFullPath() << wxT("\" ") << uid << wxT(" --pid");
+    cmd << " --workers " << GetIndexerWorkers();
     m_codeliteIndexerProcess =
         CreateAsyncProcess(this, cmd, IProcessCreateDefault, clStandardPaths::Get().GetUserDataDir());
+    m_indexerRunning = (m_codeliteIndexerProcess != NULL);
 }
 
 void TagsManager::RestartCodeLiteIndexer()
@@ -334,9 +342,25 @@ void TagsManager::RestartCodeLiteIndexer()
 
 void TagsManager::SetCodeLiteIndexerPath(const wxString& path) { m_codeliteIndexerPath = path; }
 
+size_t TagsManager::GetIndexerWorkers() const
+{
+#ifdef __WXMSW__
+    // the indexer does not support a worker pool under Windows
+    return 1;
+#else
+    size_t workers = m_tagsOptions.GetParserWorkers();
+    if(workers == 0) {
+        int cpus = wxThread::GetCPUCount();
+        workers = cpus > 0 ? cpus : 1;
+    }
+    return workers;
+#endif
+}
+
 void TagsManager::OnIndexerTerminated(clProcessEvent& event)
 {
     wxUnusedVar(event);
+    m_indexerRunning = false;
     wxDELETE(m_codeliteIndexerProcess);
     StartCodeLiteIndexer();
 }
@@ -344,7 +368,7 @@ void TagsManager::OnIndexerTerminated(clProcessEvent& event)
 //---------------------------------------------------------------------
 // Parsing
 //---------------------------------------------------------------------
-void TagsManager::SourceToTags(const wxFileName& source, wxString& tags, const wxString& kinds)
+static std::string GetIndexerChannelName()
 {
     std::stringstream s;
     s << ::wxGetProcessId();
@@ -352,8 +376,94 @@ void TagsManager::SourceToTags(const wxFileName& source, wxString& tags, const w
     char channel_name[1024];
     memset(channel_name, 0, sizeof(channel_name));
     sprintf(channel_name, PIPE_NAME, s.str().c_str());
+    return channel_name;
+}
+
+wxString TagsManager::DoGetCtagsOptions(const wxString& kinds) const
+{
+    wxString ctagsCmd;
+    ctagsCmd << " " << m_tagsOptions.ToString() << " --excmd=pattern --sort=no --fields=aKmSsnit --c-kinds=" << kinds
+             << " --c++-kinds=" << kinds << " ";
+    return ctagsCmd;
+}
+
+void TagsManager::DoConvertIndexerTags(const std::string& buffer, wxString& tags) const
+{
+    // convert the data into wxString
+    if(m_encoding == wxFONTENCODING_DEFAULT || m_encoding == wxFONTENCODING_SYSTEM)
+        tags = wxString(buffer.c_str(), wxConvUTF8);
+    else
+        tags = wxString(buffer.c_str(), wxCSConv(m_encoding));
+    if(tags.empty()) {
+        tags = wxString::From8BitData(buffer.c_str());
+    }
+}
+
+void TagsManager::DoForEachIndexerTag(const std::string& output,
+                                      const std::function<void(TagEntry&)>& onTag) const
+{
+    std::unique_ptr<wxCSConv> csConv;
+    const wxMBConv* conv = &wxConvUTF8;
+    if(m_encoding != wxFONTENCODING_DEFAULT && m_encoding != wxFONTENCODING_SYSTEM) {
+        csConv.reset(new wxCSConv(m_encoding));
+        conv = csConv.get();
+    }
+
+    // one tag per line, empty lines are skipped
+    const char* p = output.c_str();
+    const char* end = p + output.length();
+    while(p < end) {
+        const char* eol = p;
+        while(eol < end && *eol != '\n' && *eol != '\r') {
+            ++eol;
+        }
+        if(eol > p) {
+            TagEntry tag;
+            tag.FromLine(p, eol - p, *conv);
+            onTag(tag);
+        }
+        p = eol + 1;
+    }
+}
 
-    clNamedPipeClient client(channel_name);
+void TagsManager::TagsFromIndexerOutput(const std::string& output, std::vector<TagEntry>& tags) const
+{
+    DoForEachIndexerTag(output, [&](TagEntry& tag) {
+        // locals are not added to the tree
+        if(tag.GetKind() != wxT("local")) {
+            tags.push_back(tag);
+        }
+    });
+}
+
+TagTreePtr TagsManager::TreeFromIndexerOutput(const std::string& output, int& count) const
+{
+    TagEntry root;
+    root.SetName(wxT("<ROOT>"));
+    TagTreePtr tree(new TagTree(wxT("<ROOT>"), root));
+    DoForEachIndexerTag(output, [&](TagEntry& tag) {
+        // locals are not added to the tree
+        if(tag.GetKind() != wxT("local")) {
+            count++;
+            tree->AddEntry(tag);
+        }
+    });
+    return tree;
+}
+
+void TagsManager::SourceToTags(const wxFileName& source, wxString& tags, const wxString& kinds)
+{
+    std::string buffer;
+    if(SourceToTags(source, buffer, kinds)) {
+        DoConvertIndexerTags(buffer, tags);
+    } else {
+        tags.Clear();
+    }
+}
+
+bool TagsManager::SourceToTags(const wxFileName& source, std::string& tags, const wxString& kinds)
+{
+    clNamedPipeClient client(GetIndexerChannelName().c_str());
 
     // Build a request for the indexer
     clIndexerRequest req;
@@ -366,22 +476,19 @@ void TagsManager::SourceToTags(const wxFileName& source, wxString& tags, const w
     req.setFiles(files);
 
     // set ctags options to be used
-    wxString ctagsCmd;
-    ctagsCmd << " " << m_tagsOptions.ToString() << " --excmd=pattern --sort=no --fields=aKmSsnit --c-kinds=" << kinds
-             << " --c++-kinds=" << kinds << " ";
-    req.setCtagOptions(ctagsCmd.mb_str(wxConvUTF8).data());
+    req.setCtagOptions(DoGetCtagsOptions(kinds).mb_str(wxConvUTF8).data());
 
     // clDEBUG1() << "Sending CTAGS command:" << ctagsCmd << clEndl;
     // connect to the indexer
     if(!client.connect()) {
         clWARNING() << "Failed to connect to indexer process. Indexer ID:" << wxGetProcessId() << clEndl;
-        return;
+        return false;
     }
 
     // send the request
     if(!clIndexerProtocol::SendRequest(&client, req)) {
         clWARNING() << "Failed to send request to indexer. Indexer ID:" << wxGetProcessId() << clEndl;
-        return;
+        return false;
     }
 
     // read the reply
@@ -392,26 +499,79 @@ void TagsManager::SourceToTags(const wxFileName& source, wxString& tags, const w
         if(!clIndexerProtocol::ReadReply(&client, reply, errmsg)) {
             clWARNING() << "Failed to read indexer reply: " << (wxString() << errmsg) << clEndl;
             RestartCodeLiteIndexer();
-            return;
+            return false;
         }
     } catch(std::bad_alloc& ex) {
         clWARNING() << "std::bad_alloc exception caught" << clEndl;
-        tags.Clear();
-        return;
+        tags.clear();
+        return false;
     }
 
     // clDEBUG1() << "SourceToTags: [" << reply.getTags() << "]" << clEndl;
+    tags = reply.getTags();
+    return true;
+}
 
-    // convert the data into wxString
-    if(m_encoding == wxFONTENCODING_DEFAULT || m_encoding == wxFONTENCODING_SYSTEM)
-        tags = wxString(reply.getTags().c_str(), wxConvUTF8);
-    else
-        tags = wxString(reply.getTags().c_str(), wxCSConv(m_encoding));
-    if(tags.empty()) {
-        tags = wxString::From8BitData(reply.getTags().c_str());
+bool TagsManager::SourceToTagsBatch(const wxArrayString& files,
+                                    const std::function<bool(const wxString&, const std::string&)>& onFileTags,
+                                    const wxString& kinds)
+{
+    if(files.empty()) {
+        return true;
+    }
+
+    clNamedPipeClient client(GetIndexerChannelName().c_str());
+
+    // Build a single request for all the files
+    clIndexerRequest req;
+    req.setCmd(clIndexerRequest::CLI_PARSE_BATCH);
+
+    std::vector<std::string> filesVec;
+    filesVec.reserve(files.size());
+    for(const wxString& file : files) {
+        filesVec.push_back(file.mb_str(wxConvUTF8).data());
+    }
+    req.setFiles(filesVec);
+    req.setCtagOptions(DoGetCtagsOptions(kinds).mb_str(wxConvUTF8).data());
+
+    if(!client.connect()) {
+        clWARNING() << "Failed to connect to indexer process. Indexer ID:" << wxGetProcessId() << clEndl;
+        return false;
+    }
+
+    if(!clIndexerProtocol::SendRequest(&client, req)) {
+        clWARNING() << "Failed to send batch request to indexer. Indexer ID:" << wxGetProcessId() << clEndl;
+        return false;
     }
 
-    // clDEBUG1() << "Tags:\n" << tags << clEndl;
+    // the indexer replies once per file and ends the batch with an 'end of batch' reply
+    while(true) {
+        clIndexerReply reply;
+        try {
+            std::string errmsg;
+            if(!clIndexerProtocol::ReadReply(&client, reply, errmsg)) {
+                clWARNING() << "Failed to read indexer batch reply: " << (wxString() << errmsg) << clEndl;
+                return false;
+            }
+        } catch(std::bad_alloc& ex) {
+            clWARNING() << "std::bad_alloc exception caught" << clEndl;
+            return false;
+        }
+
+        if(reply.getCompletionCode() == clIndexerReply::CLI_REPLY_END_OF_BATCH) {
+            break;
+        }
+
+        static const std::string noTags;
+        bool success = reply.getCompletionCode() == clIndexerReply::CLI_REPLY_SUCCESS;
+
+        wxString filename(reply.getFileName().c_str(), wxConvUTF8);
+        if(!onFileTags(filename, success ? reply.getTags() : noTags)) {
+            // the caller is no longer interested
+            return false;
+        }
+    }
+    return true;
 }
 
 TagTreePtr TagsManager::TreeFromTags(const wxArrayString& tags, int& count)
@@ -1319,25 +1479,14 @@ void TagsManager::RetagFiles(const wxArrayString& files, RetagType type, wxEvtHa
         return;
     }
 
-    // step 2: remove all files which do not need retag
-    if(type == Retag_Quick || type == Retag_Quick_No_Scan) {
-        DoFilterNonNeededFilesForRetaging(strFiles, GetDatabase());
-    }
-
-    // If there are no files to tag - send the 'end' event
-    if(strFiles.IsEmpty()) {
-#if wxUSE_GUI
-        wxFrame* frame = dynamic_cast<wxFrame*>(wxTheApp->GetTopWindow());
-        if(frame) {
-            clParseThreadEvent retaggingCompletedEvent(wxPARSE_THREAD_RETAGGING_COMPLETED);
-            frame->GetEventHandler()->AddPendingEvent(retaggingCompletedEvent);
-        }
-#endif
-        return;
-    }
+    // step 2: on a quick retag, the parser thread filters the files which do not need a retag (this requires
+    // hashing the modified files, we don't want to do it here) and removes the tags of the others
+    bool quickRetag = (type == Retag_Quick || type == Retag_Quick_No_Scan);
 
     // step 4: Remove tags belonging to these files
-    DeleteFilesTags(strFiles);
+    if(!quickRetag) {
+        DeleteFilesTags(strFiles);
+    }
 
     // step 5: build the database
     ParseRequest* req = new ParseRequest(ParseThreadST::Get()->GetNotifiedWindow());
@@ -1349,6 +1498,7 @@ void TagsManager::RetagFiles(const wxArrayString& files, RetagType type, wxEvtHa
     req->SetType(type == Retag_Quick_No_Scan ? ParseRequest::PR_PARSE_FILE_NO_INCLUDES
                                              : ParseRequest::PR_PARSE_AND_STORE);
     req->SetWorkspaceFiles(strFiles);
+    req->SetQuickRetag(quickRetag);
     ParseThreadST::Get()->Add(req);
 }
 
@@ -2411,7 +2561,7 @@ void TagsManager::UpdateFilesRetagTimestamp(const wxArrayString& files, ITagsSto
     db->Commit();
 }
 
-void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db)
+size_t TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db)
 {
     std::vector<FileEntryPtr> files_entries;
     db->GetFiles(files_entries);
@@ -2421,6 +2571,9 @@ void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITags
         files_set.insert(strFiles.Item(i));
     }
 
+    // files that were touched but whose content did not change
+    std::vector<std::pair<wxString, wxUint64> > unchangedFiles;
+    size_t filesCount = files_set.size();
     for(size_t i = 0; i < files_entries.size(); i++) {
         FileEntryPtr fe = files_entries.at(i);
 
@@ -2437,12 +2590,26 @@ void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITags
             }
 
             // if the timestamp from the database < then the actual timestamp, re-tag the file
+            // unless its content is the same as when it was tagged
+            wxUint64 hash = 0;
             if(fe->GetLastRetaggedTimestamp() >= modified) {
                 files_set.erase(iter);
+            } else if(fe->GetContentHash() && clXXHash::HashFile(*iter, hash) && hash == fe->GetContentHash()) {
+                unchangedFiles.push_back({ *iter, hash });
+                files_set.erase(iter);
             }
         }
     }
 
+    // Update the timestamp of the unchanged files, so they are not hashed again the next time
+    if(!unchangedFiles.empty()) {
+        db->Begin();
+        for(const auto& p : unchangedFiles) {
+            db->UpdateFileEntry(p.first, (int)time(NULL), p.second);
+        }
+        db->Commit();
+    }
+
     // copy back the files to the array
     std::unordered_set<wxString>::iterator iter = files_set.begin();
     strFiles.Clear();
@@ -2450,11 +2617,7 @@ void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITags
     for(; iter != files_set.end(); iter++) {
         strFiles.Add(*iter);
     }
-}
-
-void TagsManager::DoFilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db)
-{
-    FilterNonNeededFilesForRetaging(strFiles, db);
+    return filesCount - files_set.size();
 }
 
 wxString TagsManager::GetFunctionReturnValueFromPattern(TagEntryPtr tag)
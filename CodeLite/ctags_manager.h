@@ -45,6 +45,8 @@
 #include "wx/event.h"
 #include "wx/process.h"
 #include "wxStringHash.h"
+#include <atomic>
+#include <functional>
 #include <set>
 #include <wx/stopwatch.h>
 #include <wx/thread.h>
@@ -145,6 +147,7 @@ public:
 private:
     wxFileName m_codeliteIndexerPath;
     IProcess* m_codeliteIndexerProcess;
+    std::atomic_bool m_indexerRunning; // m_codeliteIndexerProcess != NULL, readable from the parse thread
     wxString m_ctagsCmd;
     wxStopWatch m_watch;
     TagsOptionsData m_tagsOptions;
@@ -534,6 +537,47 @@ public:
      */
     void SourceToTags(const wxFileName& source, wxString& tags, const wxString& kinds = "+p");
 
+    /**
+     * @brief same as above, 'tags' is the ctags output as received from the indexer (not converted to wxString).
+     * Use TreeFromIndexerOutput() or TagsFromIndexerOutput() to parse it
+     * @return true on success
+     */
+    bool SourceToTags(const wxFileName& source, std::string& tags, const wxString& kinds = "+p");
+
+    /**
+     * @brief pass a list of files to the indexer over a single connection. The indexer streams back the
+     * tags one file at a time and 'onFileTags' is called for each one of them (from the calling thread).
+     * Calling this method from several threads in parallel spreads the work between the indexer workers
+     * @param files the files to parse
+     * @param onFileTags callback called per file with the file name and its ctags output, as received from the
+     * indexer (see TagsFromIndexerOutput()). Return false to abort the batch
+     * @return true if the whole batch was received, false otherwise
+     */
+    bool SourceToTagsBatch(const wxArrayString& files,
+                           const std::function<bool(const wxString& filename, const std::string& tags)>& onFileTags,
+                           const wxString& kinds = "+p");
+
+    /**
+     * @brief parse the indexer ctags output directly into tags, without converting the whole output to wxString
+     * first. Local variables are skipped. This method is thread safe
+     */
+    void TagsFromIndexerOutput(const std::string& output, std::vector<TagEntry>& tags) const;
+
+    /**
+     * @brief same as TagsFromIndexerOutput(), into a tag tree
+     */
+    TagTreePtr TreeFromIndexerOutput(const std::string& output, int& count) const;
+
+    /**
+     * @brief return the number of worker processes used by the codelite_indexer
+     */
+    size_t GetIndexerWorkers() const;
+
+    /**
+     * @brief is the codelite_indexer process running? Safe to call from any thread
+     */
+    bool IsIndexerRunning() const { return m_indexerRunning; }
+
     /**
      * return list of files from the database(s). The returned list is ordered
      * by name (ascending)
@@ -786,11 +830,13 @@ public:
      */
     wxString GetFunctionReturnValueFromPattern(TagEntryPtr tag);
     /**
-     * @brief fileter a recently tagged files from the strFiles array
+     * @brief fileter a recently tagged files from the strFiles array. A file modified since it was tagged is
+     * filtered as well if its content hash did not change (e.g. after switching git branches)
      * @param strFiles
      * @param db
+     * @return the number of files filtered
      */
-    void FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db);
+    size_t FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db);
 
     /**
      * Parse tags from memory and constructs a TagTree.
@@ -842,6 +888,9 @@ protected:
     std::map<wxString, bool> m_typeScopeContainerCache;
 
     void DoParseModifiedText(const wxString& text, std::vector<TagEntryPtr>& tags);
+    wxString DoGetCtagsOptions(const wxString& kinds) const;
+    void DoConvertIndexerTags(const std::string& buffer, wxString& tags) const;
+    void DoForEachIndexerTag(const std::string& output, const std::function<void(TagEntry&)>& onTag) const;
 
     /**
      * Handler ctags process termination
@@ -914,7 +963,6 @@ protected:
     void FilterImplementation(const std::vector<TagEntryPtr>& src, std::vector<TagEntryPtr>& tags);
     void FilterDeclarations(const std::vector<TagEntryPtr>& src, std::vector<TagEntryPtr>& tags);
     wxString DoReplaceMacros(const wxString& name);
-    void DoFilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db);
     void DoGetFunctionTipForEmptyExpression(const wxString& word, const wxString& text, std::vector<TagEntryPtr>& tips,
                                             bool globalScopeOnly = false);
     void TryFindImplDeclUsingNS(const wxString& scope, const wxString& word, bool imp,
@@ -34,6 +34,10 @@
 #include "macros.h"
 #include "tokenizer.h"
 #include "wxStringHash.h"
+#include <algorithm>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
 #include <wx/regex.h>
 #include <wx/tokenzr.h>
 
@@ -443,6 +447,208 @@ wxString TagEntry::GetPattern() const
     return pattern;
 }
 
+namespace
+{
+/**
+ * @brief remove the anonymous parts of a "struct" or "union" ext field value
+ */
+void RemoveAnonymousScopes(wxString& val)
+{
+    if(!val.StartsWith(wxT("__anon"))) {
+        // an internal anonymous union / struct
+        // remove all parts of the
+        wxArrayString scopeArr;
+        wxString tmp, new_val;
+
+        scopeArr = wxStringTokenize(val, wxT(":"), wxTOKEN_STRTOK);
+        for(size_t i = 0; i < scopeArr.GetCount(); i++) {
+            if(scopeArr.Item(i).StartsWith(wxT("__anon")) == false) {
+                tmp << scopeArr.Item(i) << wxT("::");
+            }
+        }
+
+        tmp.EndsWith(wxT("::"), &new_val);
+        val.swap(new_val);
+    }
+}
+
+/**
+ * @brief the scope of an enumerator is the scope of its enum
+ */
+void FixEnumeratorScope(const wxString& kind, wxStringMap_t& extFields)
+{
+    if(kind == "enumerator" && extFields.count("enum")) {
+        // Remove the last parent
+        wxString& scope = extFields["enum"];
+        size_t where = scope.rfind("::");
+        if(where != wxString::npos) {
+            scope = scope.Mid(0, where);
+        } else {
+            // Global enum, remove this ext field
+            extFields.erase("enum");
+        }
+    }
+}
+
+inline bool IsSpace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+}
+
+/**
+ * @brief a range of the ctags line
+ */
+struct LineRange {
+    const char* begin;
+    const char* end;
+
+    LineRange(const char* b, const char* e)
+        : begin(b)
+        , end(e)
+    {
+    }
+    size_t length() const { return end - begin; }
+    bool empty() const { return begin == end; }
+    bool Equals(const char* str) const { return length() == strlen(str) && memcmp(begin, str, length()) == 0; }
+    bool StartsWith(const char* str) const
+    {
+        size_t len = strlen(str);
+        return length() >= len && memcmp(begin, str, len) == 0;
+    }
+
+    LineRange TrimRight() const
+    {
+        const char* e = end;
+        while(e > begin && IsSpace(e[-1])) {
+            --e;
+        }
+        return LineRange(begin, e);
+    }
+
+    LineRange Trim() const
+    {
+        const char* b = begin;
+        while(b < end && IsSpace(*b)) {
+            ++b;
+        }
+        return LineRange(b, end).TrimRight();
+    }
+
+    /**
+     * @brief return the position of 'ch', or 'end' if not found
+     */
+    const char* Find(char ch) const
+    {
+        const char* where = static_cast<const char*>(memchr(begin, ch, length()));
+        return where ? where : end;
+    }
+
+    wxString ToString(const wxMBConv& conv) const
+    {
+        if(empty()) { return wxString(); }
+        wxString str(begin, conv, length());
+        if(str.empty()) { str = wxString::From8BitData(begin, length()); }
+        return str;
+    }
+
+    /**
+     * @brief parse the number the range starts with. Like wxString::ToLong() (which the ctags line parser used),
+     * 'value' is updated even when the number is followed by other characters ("12;" gives 12) and is left unchanged
+     * when the range does not start with a number or the number overflows
+     */
+    void ToLong(long& value) const
+    {
+        char buffer[32];
+        size_t len = std::min(length(), sizeof(buffer) - 1);
+        memcpy(buffer, begin, len);
+        buffer[len] = 0;
+        char* numberEnd = nullptr;
+        errno = 0;
+        long number = strtol(buffer, &numberEnd, 10);
+        if(numberEnd != buffer && errno != ERANGE) { value = number; }
+    }
+};
+} // namespace
+
+void TagEntry::FromLine(const char* line, size_t len, const wxMBConv& conv)
+{
+    // see FromLine(const wxString&) for the line format. Each field is converted to wxString once
+    LineRange strLine(line, line + len);
+    long lineNumber = wxNOT_FOUND;
+    wxStringMap_t extFields;
+
+    // get the token name
+    const char* tab = strLine.Find('\t');
+    LineRange name(strLine.begin, tab);
+    strLine.begin = (tab == strLine.end) ? tab : tab + 1;
+
+    // get the file name
+    tab = strLine.Find('\t');
+    LineRange fileName(strLine.begin, tab);
+    strLine.begin = (tab == strLine.end) ? tab : tab + 1;
+
+    // here we can get two options:
+    // pattern followed by ;"
+    // or
+    // line number followed by ;"
+    const char* end = strLine.begin;
+    while(true) {
+        end = LineRange(end, strLine.end).Find(';');
+        if(end == strLine.end) {
+            // invalid pattern found
+            return;
+        }
+        if((end + 1) < strLine.end && end[1] == '"') { break; }
+        ++end;
+    }
+
+    wxString pattern;
+    if(strLine.StartsWith("/^")) {
+        // regular expression pattern found
+        pattern = LineRange(strLine.begin, end).TrimRight().ToString(conv);
+    } else {
+        // line number pattern found
+        LineRange number = LineRange(strLine.begin, end).Trim();
+        pattern = number.ToString(conv);
+        number.ToLong(lineNumber);
+    }
+    strLine.begin = end + 2;
+
+    // next is the kind of the token
+    if(strLine.StartsWith("\t")) { ++strLine.begin; }
+
+    tab = strLine.Find('\t');
+    LineRange kind(strLine.begin, tab);
+    strLine.begin = (tab == strLine.end) ? tab : tab + 1;
+
+    // the ext fields: "key:value" separated by tabs
+    while(!strLine.empty()) {
+        tab = strLine.Find('\t');
+        LineRange token(strLine.begin, tab);
+        strLine.begin = (tab == strLine.end) ? tab : tab + 1;
+        if(token.empty()) { continue; }
+
+        const char* colon = token.Find(':');
+        LineRange key = LineRange(token.begin, colon).Trim();
+        LineRange val = LineRange(colon == token.end ? colon : colon + 1, token.end).Trim();
+        if(key.Equals("line") && !val.empty()) {
+            val.ToLong(lineNumber);
+        } else {
+            wxString value = val.ToString(conv);
+            if(key.Equals("union") || key.Equals("struct")) {
+                // remove the anonymous part of the struct / union
+                RemoveAnonymousScopes(value);
+            }
+            extFields.insert({ key.ToString(conv), value });
+        }
+    }
+
+    wxString kindStr = kind.TrimRight().ToString(conv);
+    FixEnumeratorScope(kindStr, extFields);
+    this->Create(fileName.TrimRight().ToString(conv), name.TrimRight().ToString(conv), lineNumber, pattern, kindStr,
+                 extFields);
+}
+
 void TagEntry::FromLine(const wxString& line)
 {
     // label	C:\src\wxCustomControls\clTreeCtrl\clChoice.cpp	/^        const wxString& label = m_choices[i];$/;"
@@ -508,24 +714,8 @@ void TagEntry::FromLine(const wxString& line)
                 val.ToLong(&lineNumber);
             } else {
                 if(key == wxT("union") || key == wxT("struct")) {
-
                     // remove the anonymous part of the struct / union
-                    if(!val.StartsWith(wxT("__anon"))) {
-                        // an internal anonymous union / struct
-                        // remove all parts of the
-                        wxArrayString scopeArr;
-                        wxString tmp, new_val;
-
-                        scopeArr = wxStringTokenize(val, wxT(":"), wxTOKEN_STRTOK);
-                        for(size_t i = 0; i < scopeArr.GetCount(); i++) {
-                            if(scopeArr.Item(i).StartsWith(wxT("__anon")) == false) {
-                                tmp << scopeArr.Item(i) << wxT("::");
-                            }
-                        }
-
-                        tmp.EndsWith(wxT("::"), &new_val);
-                        val.swap(new_val);
-                    }
+                    RemoveAnonymousScopes(val);
                 }
                 extFields.insert({ key, val });
             }
@@ -537,17 +727,7 @@ void TagEntry::FromLine(const wxString& line)
     fileName = fileName.Trim();
     pattern = pattern.Trim();
 
-    if(kind == "enumerator" && extFields.count("enum")) {
-        // Remove the last parent
-        wxString& scope = extFields["enum"];
-        size_t where = scope.rfind("::");
-        if(where != wxString::npos) {
-            scope = scope.Mid(0, where);
-        } else {
-            // Global enum, remove this ext field
-            extFields.erase("enum");
-        }
-    }
+    FixEnumeratorScope(kind, extFields);
 
     //    if(kind == wxT("enumerator")) {
     //        // enums are specials, they are a scope, when they declared as "enum class ..." (C++11),
@@ -134,6 +134,12 @@ public:
 
     void FromLine(const wxString& line);
 
+    /**
+     * @brief same as FromLine(const wxString&), directly from the (not null terminated) ctags output. Only the
+     * fields are converted to wxString, using 'conv' (a field that fails to convert is read as 8 bit data)
+     */
+    void FromLine(const char* line, size_t len, const wxMBConv& conv = wxConvUTF8);
+
     /**
      * Copy constructor.
      */
@@ -85,6 +85,10 @@ public:
      */
     void AddLogLine(const wxArrayString& arr, int verbosity);
     static void SetVerbosity(int level);
+    /**
+     * @brief would a message with this verbosity be written to the log? Use it to avoid building expensive messages
+     */
+    static bool CanLog(int verbosity) { return verbosity <= m_verbosity; }
 
     // Set the verbosity as string
     static void SetVerbosity(const wxString& verbosity);
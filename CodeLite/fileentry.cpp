@@ -30,6 +30,7 @@ FileEntry::FileEntry()
 		: m_id                   (wxNOT_FOUND)
 		, m_file                 (wxEmptyString)
 		, m_lastRetaggedTimestamp((int)time(NULL))
+		, m_contentHash          (0)
 {
 }
 
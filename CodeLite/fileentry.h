@@ -33,6 +33,7 @@ class FileEntry
 	long      m_id;
 	wxString  m_file;
 	int       m_lastRetaggedTimestamp;
+	wxUint64  m_contentHash;
 
 public:
 	FileEntry();
@@ -51,6 +52,13 @@ public:
 	const int& GetLastRetaggedTimestamp() const {
 		return m_lastRetaggedTimestamp;
 	}
+	void SetContentHash(wxUint64 contentHash) {
+		this->m_contentHash = contentHash;
+	}
+	// the xxHash of the file content when it was retagged (0 if unknown)
+	wxUint64 GetContentHash() const {
+		return m_contentHash;
+	}
 	void SetId(const long& id) {
 		this->m_id = id;
 	}
@@ -138,6 +138,29 @@ bool FileUtils::ReadFileContent(const wxFileName& fn, wxString& data, const wxMB
     return true;
 }
 
+bool FileUtils::ReadFileContent(const wxFileName& fn, std::string& data)
+{
+    data.clear();
+    FILE* fp = fopen(fn.GetFullPath().mb_str(wxConvUTF8).data(), "rb");
+    if(!fp) {
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long fsize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    data.resize(fsize > 0 ? fsize : 0);
+    if(!data.empty() && fread(&data[0], 1, data.length(), fp) != data.length()) {
+        clERROR() << "Failed to read file content:" << fn << "." << strerror(errno);
+        fclose(fp);
+        data.clear();
+        return false;
+    }
+    fclose(fp);
+    return true;
+}
+
 void FileUtils::OpenFileExplorerAndSelect(const wxFileName& filename)
 {
 #ifdef __WXMSW__
@@ -56,6 +56,11 @@ public:
 public:
     static bool ReadFileContent(const wxFileName& fn, wxString& data, const wxMBConv& conv = wxConvUTF8);
 
+    /**
+     * @brief read the file content as is (no conversion)
+     */
+    static bool ReadFileContent(const wxFileName& fn, std::string& data);
+
     /**
      * @brief attempt to read up to bufferSize from the beginning of file
      */
@@ -68,6 +68,11 @@ public:
 
     virtual bool GetUseCache() const { return m_useCache; }
 
+    /**
+     * @brief answer the name lookups from an in memory index instead of querying the storage (when supported)
+     */
+    virtual void SetUseNameIndex(bool useNameIndex) { wxUnusedVar(useNameIndex); }
+
     /**
      * @brief clear the storage cache
      */
@@ -230,17 +235,19 @@ public:
     /**
      * @brief insert entry by file name
      * @param filename
+     * @param hash the xxHash of the file content (0 if unknown)
      * @return
      */
-    virtual int InsertFileEntry(const wxString& filename, int timestamp) = 0;
+    virtual int InsertFileEntry(const wxString& filename, int timestamp, wxUint64 hash = 0) = 0;
 
     /**
      * @brief update file entry using file name as key
      * @param filename
      * @param timestamp new timestamp
+     * @param hash the xxHash of the file content (0 if unknown)
      * @return
      */
-    virtual int UpdateFileEntry(const wxString& filename, int timestamp) = 0;
+    virtual int UpdateFileEntry(const wxString& filename, int timestamp, wxUint64 hash = 0) = 0;
 
     // -------------------------- TagEntry -------------------------------------------
     /**
@@ -361,6 +368,19 @@ public:
     virtual void Commit() = 0;
     virtual void Rollback() = 0;
 
+    /**
+     * @brief start a bulk insert session. Use this before storing a large number of tags (e.g. full retag):
+     * the search indexes and triggers are not maintained per row, instead they are rebuilt once when
+     * EndBulkInsert() is called. This only applies to an empty database: the indexes of a populated database are
+     * kept, since other threads keep searching it meanwhile
+     */
+    virtual void BeginBulkInsert() = 0;
+
+    /**
+     * @brief end a bulk insert session and rebuild the search indexes
+     */
+    virtual void EndBulkInsert() = 0;
+
     /**
      * Delete all entries from database that are related to filename.
      * @param path Database name
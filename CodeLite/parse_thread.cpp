@@ -27,6 +27,7 @@
 #include "CxxVariableScanner.h"
 #include "cl_command_event.h"
 #include "cl_standard_paths.h"
+#include "clXXHash.h"
 #include "cpp_scanner.h"
 #include "crawler_include.h"
 #include "ctags_manager.h"
@@ -40,9 +41,17 @@
 #include "precompiled_header.h"
 #include "tags_storage_sqlite3.h"
 #include "wxStringHash.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <tags_options_data.h>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <wx/ffile.h>
 #include <wx/stopwatch.h>
@@ -50,6 +59,15 @@
 
 #define DEBUG_MESSAGE(x) CL_DEBUG1(x.c_str())
 
+// Minimum number of files for storing the tags in a bulk insert session
+#define BULK_INSERT_MIN_FILES 500
+
+// Maximum number of parsed files waiting to be stored. The indexer workers wait while the database is behind
+#define INDEXER_QUEUE_MAX_FILES 256
+
+// Number of files an indexer worker hashes and then sends to the indexer in a single request
+#define INDEXER_REQUEST_MAX_FILES 64
+
 #define TEST_DESTROY()                                                                                        \
     {                                                                                                         \
         if(TestDestroy()) {                                                                                   \
@@ -90,6 +108,8 @@ clParseThreadEvent& clParseThreadEvent::operator=(const clParseThreadEvent& src)
     m_requestUID = src.m_requestUID;
     m_caller = src.m_caller;
     m_requestType = src.m_requestType;
+    m_filesParsed = src.m_filesParsed;
+    m_filesSkipped = src.m_filesSkipped;
     return *this;
 }
 
@@ -205,12 +225,12 @@ void ParseThread::ParseIncludeFiles(ParseRequest* req, const wxString& filename,
     ParseAndStoreFiles(req->GetParent(), arrFiles, db);
 }
 
-TagTreePtr ParseThread::DoTreeFromTags(const wxString& tags, int& count)
+TagTreePtr ParseThread::DoTreeFromTags(const std::string& tags, int& count)
 {
-    return TagsManagerST::Get()->TreeFromTags(tags, count);
+    return TagsManagerST::Get()->TreeFromIndexerOutput(tags, count);
 }
 
-void ParseThread::DoStoreTags(const wxString& tags, const wxString& filename, int& count, ITagsStoragePtr db)
+void ParseThread::DoStoreTags(const std::string& tags, const wxString& filename, int& count, ITagsStoragePtr db)
 {
     TagTreePtr ttp = DoTreeFromTags(tags, count);
     db->Begin();
@@ -219,6 +239,24 @@ void ParseThread::DoStoreTags(const wxString& tags, const wxString& filename, in
     db->Commit();
 }
 
+void ParseThread::DoDeleteTagsOfFiles(const wxArrayString& files, ITagsStoragePtr db)
+{
+    db->Begin();
+    for(const wxString& filename : files) {
+        db->DeleteByFileName({}, filename, false);
+    }
+    db->DeleteFromFiles(files);
+    db->Commit();
+}
+
+void ParseThread::DoUpdateFileEntry(const wxString& filename, wxUint64 hash, ITagsStoragePtr db)
+{
+    // the content hash lets a quick retag skip this file if it is touched without being modified
+    if(db->InsertFileEntry(filename, (int)time(NULL), hash) == TagExist) {
+        db->UpdateFileEntry(filename, (int)time(NULL), hash);
+    }
+}
+
 void ParseThread::SetCrawlerEnabeld(bool b)
 {
     wxCriticalSectionLocker locker(m_cs);
@@ -292,18 +330,23 @@ void ParseThread::ProcessSingleFile(ParseRequest* req)
     ITagsStoragePtr db(new TagsStorageSQLite());
     db->OpenDatabase(dbfile);
 
+    // hash the content before it is parsed: if the file changes in between, the hash no longer matches and the next
+    // quick retag parses it again
+    wxUint64 hash = 0;
+    clXXHash::HashFile(file_name, hash);
+
     // convert the file content into tags
-    wxString tags;
+    std::string tags;
     tagmgr->SourceToTags(file_name, tags);
 
-    clDEBUG1() << "Parsed file output: [" << tags << "]" << clEndl;
+    clDEBUG1() << "Parsed file output: [" << wxString::FromUTF8(tags.c_str()) << "]" << clEndl;
 
-    int count;
+    int count = 0;
     DoStoreTags(tags, file_name, count, db);
 
     db->Begin();
     // update the file retag timestamp
-    db->InsertFileEntry(file_name, (int)time(NULL));
+    DoUpdateFileEntry(file_name, hash, db);
 
     // Parse and store the macros found in this file
     PPTable::Instance()->Clear();
@@ -367,14 +410,248 @@ void ParseThread::GetFileListToParse(const wxString& filename, wxArrayString& ar
     }
 }
 
+namespace
+{
+struct IndexerBatchItem {
+    wxString filename;
+    wxUint64 hash = 0;
+    // a null entry marks a worker that completed its batch
+    std::shared_ptr<std::vector<TagEntry>> tags;
+};
+
+/**
+ * @class IndexerBatchQueue
+ * @brief the files converted by the indexer connections, waiting to be stored by the parse thread
+ */
+class IndexerBatchQueue
+{
+    std::deque<IndexerBatchItem> m_items;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+
+public:
+    /**
+     * @brief add an item. Blocks while the queue is full, unless 'cancelled' is set. The end of batch markers are
+     * never blocked
+     */
+    void Push(const IndexerBatchItem& item, const std::atomic_bool& cancelled)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if(item.tags) {
+            while(m_items.size() >= INDEXER_QUEUE_MAX_FILES && !cancelled) {
+                m_notFull.wait_for(lock, std::chrono::milliseconds(100));
+            }
+        }
+        m_items.push_back(item);
+        m_notEmpty.notify_one();
+    }
+
+    /**
+     * @brief take the oldest item, waiting up to 'timeoutMs' for one
+     */
+    bool Pop(IndexerBatchItem& item, int timeoutMs)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if(m_items.empty()) {
+            m_notEmpty.wait_for(lock, std::chrono::milliseconds(timeoutMs));
+            if(m_items.empty()) {
+                return false;
+            }
+        }
+        item = m_items.front();
+        m_items.pop_front();
+        m_notFull.notify_all();
+        return true;
+    }
+};
+} // namespace
+
 void ParseThread::ParseAndStoreFiles(wxEvtHandler* parent, const wxArrayString& arrFiles, ITagsStoragePtr db)
 {
+    // For large batches, it is cheaper to rebuild the search indexes once than to update them per row
+    bool bulkInsert = arrFiles.size() >= BULK_INSERT_MIN_FILES;
+    if(bulkInsert) {
+        db->BeginBulkInsert();
+    }
+
+    size_t filesCount = 0;
+    bool ok = true;
+    wxArrayString remainingFiles;
+    if(TagsManagerST::Get()->IsIndexerRunning()) {
+        ok = DoParseAndStoreFilesWithIndexer(parent, arrFiles, db, remainingFiles, filesCount);
+    } else {
+        remainingFiles = arrFiles;
+    }
+
+    // Whatever the indexer could not deliver is parsed with a single "codelite_indexer --batch" run
+    if(ok && !remainingFiles.IsEmpty()) {
+        clDEBUG() << "Parsing" << remainingFiles.size() << "files using a ctags file" << clEndl;
+        ok = DoParseAndStoreFilesWithCtags(parent, remainingFiles, db, filesCount);
+    }
+
+    if(bulkInsert) {
+        PostStatusMessage(parent, _("Building indexes..."));
+        db->EndBulkInsert();
+    }
+
+    if(!ok) {
+        return;
+    }
+
+    PostStatusMessage(parent, _("Done"));
+    CHECK_PTR_RET(parent);
+
+    // if we added new symbols to the database, send an even to the main thread
+    // to clear the tags cache
+    if(filesCount) {
+        clParseThreadEvent clearCacheEvent(wxPARSE_THREAD_CLEAR_TAGS_CACHE);
+        parent->AddPendingEvent(clearCacheEvent);
+    }
+}
+
+bool ParseThread::DoParseAndStoreFilesWithIndexer(wxEvtHandler* parent, const wxArrayString& arrFiles,
+                                                  ITagsStoragePtr db, wxArrayString& missingFiles, size_t& count)
+{
+    size_t workers = std::min(TagsManagerST::Get()->GetIndexerWorkers(), arrFiles.size());
+    if(workers == 0) {
+        return true;
+    }
+
+    // Spread the files between the workers in a round robin fashion, so each worker gets a similar mix
+    std::vector<wxArrayString> shards(workers);
+    for(size_t i = 0; i < arrFiles.size(); ++i) {
+        shards[i % workers].Add(arrFiles.Item(i));
+    }
+
+    clDEBUG() << "Parsing" << arrFiles.size() << "files using" << workers << "indexer workers" << clEndl;
+    PostStatusMessage(parent, _("Parsing files..."));
+
+    // Each connection runs on its own thread. The ctags output is converted into tags on these threads,
+    // while this thread is the only one writing to the database
+    IndexerBatchQueue queue;
+    std::atomic_bool cancelled(false);
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for(size_t i = 0; i < workers; ++i) {
+        const wxArrayString& shard = shards[i];
+        threads.emplace_back([&queue, &cancelled, &shard]() {
+            // The files are hashed right before they are sent to the indexer. If a file changes in between, its hash
+            // no longer matches and the next quick retag parses it again
+            for(size_t first = 0; first < shard.size() && !cancelled; first += INDEXER_REQUEST_MAX_FILES) {
+                wxArrayString files;
+                std::unordered_map<wxString, wxUint64> hashes;
+                for(size_t i = first; i < shard.size() && i < first + INDEXER_REQUEST_MAX_FILES; ++i) {
+                    wxUint64 hash = 0;
+                    clXXHash::HashFile(shard.Item(i), hash);
+                    hashes[shard.Item(i)] = hash;
+                    files.Add(shard.Item(i));
+                }
+
+                bool ok = TagsManagerST::Get()->SourceToTagsBatch(
+                    files, [&](const wxString& filename, const std::string& tags) -> bool {
+                        if(cancelled) {
+                            return false;
+                        }
+                        IndexerBatchItem item;
+                        item.filename = filename;
+                        auto iter = hashes.find(filename);
+                        item.hash = (iter == hashes.end()) ? 0 : iter->second;
+                        item.tags = std::make_shared<std::vector<TagEntry>>();
+                        TagsManagerST::Get()->TagsFromIndexerOutput(tags, *item.tags);
+                        queue.Push(item, cancelled);
+                        return true;
+                    });
+                if(!ok) {
+                    // the files not received are parsed with ctags
+                    break;
+                }
+            }
+            queue.Push(IndexerBatchItem(), cancelled);
+        });
+    }
+
+    wxStringSet_t storedFiles;
+    size_t completedWorkers = 0;
+    size_t maxVal = arrFiles.size();
+    db->Begin();
+    while(completedWorkers < workers) {
+        IndexerBatchItem item;
+        if(!queue.Pop(item, 100)) {
+            if(TestDestroy()) {
+                cancelled = true;
+            }
+            continue;
+        }
+
+        if(!item.tags) {
+            ++completedWorkers;
+            continue;
+        }
+
+        // give a shutdown request a chance. We keep draining the queue until all workers are done
+        if(cancelled || TestDestroy()) {
+            cancelled = true;
+            continue;
+        }
+
+        TagEntry root;
+        root.SetName(wxT("<ROOT>"));
+        TagTreePtr ttp(new TagTree(wxT("<ROOT>"), root));
+        for(TagEntry& tag : *item.tags) {
+            ttp->AddEntry(tag);
+        }
+
+        db->Store(ttp, {}, false);
+        DoUpdateFileEntry(item.filename, item.hash, db);
+        storedFiles.insert(item.filename);
+        ++count;
+
+        if((count % 1000) == 0) {
+            PostStatusMessage(parent, _("Flushing to disk.."));
+            // Commit what we got so far
+            db->Commit();
+            // Start a new transaction
+            db->Begin();
+        }
+        PostStatusMessage(parent, wxString() << _("Parsing file ") << storedFiles.size() << "/" << maxVal);
+    }
+
+    for(std::thread& t : threads) {
+        t.join();
+    }
+
+    if(cancelled) {
+        // Do an ordered shutdown: rollback any transaction
+        db->Rollback();
+        return false;
+    }
+    db->Commit();
+
+    for(const wxString& file : arrFiles) {
+        if(storedFiles.count(file) == 0) {
+            missingFiles.Add(file);
+        }
+    }
+    return true;
+}
+
+bool ParseThread::DoParseAndStoreFilesWithCtags(wxEvtHandler* parent, const wxArrayString& arrFiles,
+                                                ITagsStoragePtr db, size_t& count)
+{
+    // Hash the files before ctags reads them (see DoParseAndStoreFilesWithIndexer())
+    std::unordered_map<wxString, wxUint64> hashes;
+    for(const wxString& file : arrFiles) {
+        wxUint64 hash = 0;
+        clXXHash::HashFile(file, hash);
+        hashes[file] = hash;
+    }
 
     // Generate ctags files under the tmp folder
     PostStatusMessage(parent, _("Generating ctags file..."));
     wxString ctagsFileDir = db->GetDatabaseFileName().GetPath();
     if(!CTags::Generate(arrFiles, ctagsFileDir)) {
-        return;
+        return false;
     }
     PostStatusMessage(parent, _("Generating ctags file...success"));
 
@@ -383,7 +660,7 @@ void ParseThread::ParseAndStoreFiles(wxEvtHandler* parent, const wxArrayString&
     CTags ctags(ctagsFileDir);
     if(!ctags.IsOpened()) {
         clWARNING() << "Failed to open ctags file under:" << ctagsFileDir << clEndl;
-        return;
+        return false;
     }
 
     wxString curfile;
@@ -400,14 +677,13 @@ void ParseThread::ParseAndStoreFiles(wxEvtHandler* parent, const wxArrayString&
             // rollback any transaction
             // and close the database
             db->Rollback();
-            return;
+            return false;
         }
 
         // Send notification to the main window with our progress report
         db->Store(ttp, {}, false);
-        if(db->InsertFileEntry(curfile, (int)time(NULL)) == TagExist) {
-            db->UpdateFileEntry(curfile, (int)time(NULL));
-        }
+        auto iter = hashes.find(curfile);
+        DoUpdateFileEntry(curfile, (iter == hashes.end()) ? 0 : iter->second, db);
 
         if((tagsCount % 1000) == 0) {
             PostStatusMessage(parent, _("Flushing to disk.."));
@@ -422,15 +698,8 @@ void ParseThread::ParseAndStoreFiles(wxEvtHandler* parent, const wxArrayString&
 
     // Commit whats left
     db->Commit();
-    PostStatusMessage(parent, _("Done"));
-    CHECK_PTR_RET(parent);
-
-    // if we added new symbols to the database, send an even to the main thread
-    // to clear the tags cache
-    if(tagsCount) {
-        clParseThreadEvent clearCacheEvent(wxPARSE_THREAD_CLEAR_TAGS_CACHE);
-        parent->AddPendingEvent(clearCacheEvent);
-    }
+    count += tagsCount;
+    return true;
 }
 
 void ParseThread::ProcessDeleteTagsOfFiles(ParseRequest* req)
@@ -441,12 +710,7 @@ void ParseThread::ProcessDeleteTagsOfFiles(ParseRequest* req)
     const wxString& dbfile = req->GetDbfile();
     ITagsStoragePtr db(new TagsStorageSQLite());
     db->OpenDatabase(dbfile);
-    db->Begin();
-    for(const wxString& filename : req->GetWorkspaceFiles()) {
-        db->DeleteByFileName({}, filename, false);
-    }
-    db->DeleteFromFiles(req->GetWorkspaceFiles());
-    db->Commit();
+    DoDeleteTagsOfFiles(req->GetWorkspaceFiles(), db);
 }
 
 void ParseThread::ProcessParseAndStore(ParseRequest* req)
@@ -477,12 +741,23 @@ void ParseThread::ProcessParseAndStore(ParseRequest* req)
 
     // filter binary files
     FilterBinaryFiles(filesList);
+
+    // on a quick retag, skip the files that did not change since they were tagged
+    size_t filesSkipped = 0;
+    if(req->IsQuickRetag()) {
+        filesSkipped = TagsManagerST::Get()->FilterNonNeededFilesForRetaging(filesList, db);
+        DoDeleteTagsOfFiles(filesList, db);
+        clDEBUG() << "Quick retag:" << filesList.size() << "files to parse," << filesSkipped
+                  << "unchanged files skipped" << clEndl;
+    }
     ParseAndStoreFiles(req->GetParent(), filesList, db);
 
     // Send notification to the main window with our progress report
     if(req->GetParent()) {
         clParseThreadEvent retaggingCompletedEvent(wxPARSE_THREAD_RETAGGING_COMPLETED);
         retaggingCompletedEvent.SetFiles(req->GetWorkspaceFiles());
+        retaggingCompletedEvent.SetFilesParsed(filesList.size());
+        retaggingCompletedEvent.SetFilesSkipped(filesSkipped);
         req->GetParent()->AddPendingEvent(retaggingCompletedEvent);
     }
 }
@@ -601,11 +876,17 @@ void ParseThread::ProcessSimpleNoIncludes(ParseRequest* req)
     ITagsStoragePtr db(new TagsStorageSQLite());
     db->OpenDatabase(dbfile);
 
-    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files, db);
+    size_t filesSkipped = TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files, db);
+    if(req->IsQuickRetag()) {
+        // the tags of these files were not removed yet
+        DoDeleteTagsOfFiles(files, db);
+    }
     ParseAndStoreFiles(req->GetParent(), files, db);
 
     CHECK_PTR_RET(req->GetParent());
     clParseThreadEvent e(wxPARSE_THREAD_RETAGGING_COMPLETED);
+    e.SetFilesParsed(files.size());
+    e.SetFilesSkipped(filesSkipped);
     req->GetParent()->AddPendingEvent(e);
 }
 
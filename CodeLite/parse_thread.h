@@ -166,8 +166,15 @@ private:
      */
     virtual ~ParseThread();
 
-    void DoStoreTags(const wxString& tags, const wxString& filename, int& count, ITagsStoragePtr db);
-    TagTreePtr DoTreeFromTags(const wxString& tags, int& count);
+    void DoStoreTags(const std::string& tags, const wxString& filename, int& count, ITagsStoragePtr db);
+    void DoDeleteTagsOfFiles(const wxArrayString& files, ITagsStoragePtr db);
+
+    /**
+     * @brief update the FILES table entry of a file that was just tagged
+     * @param hash the content hash of the file, computed before it was parsed (0 if unknown)
+     */
+    void DoUpdateFileEntry(const wxString& filename, wxUint64 hash, ITagsStoragePtr db);
+    TagTreePtr DoTreeFromTags(const std::string& tags, int& count);
     void DoNotifyReady(wxEvtHandler* caller, int requestType);
 
 private:
@@ -192,6 +199,21 @@ private:
     void ProcessIncludeStatements(ParseRequest* req);
     void GetFileListToParse(const wxString& filename, wxArrayString& arrFiles);
     void ParseAndStoreFiles(wxEvtHandler* parent, const wxArrayString& arrFiles, ITagsStoragePtr db);
+    /**
+     * @brief parse the files using the codelite_indexer worker pool and store the tags into the database.
+     * The files are spread between the workers, each worker streams back the tags one file at a time
+     * @param missingFiles [output] files that were not parsed (e.g. the indexer went down in the middle)
+     * @param count [output] number of files stored
+     * @return false if the operation was cancelled
+     */
+    bool DoParseAndStoreFilesWithIndexer(wxEvtHandler* parent, const wxArrayString& arrFiles, ITagsStoragePtr db,
+                                         wxArrayString& missingFiles, size_t& count);
+    /**
+     * @brief parse the files by running "codelite_indexer --batch" and reading the generated ctags file
+     * @return false on error or if the operation was cancelled
+     */
+    bool DoParseAndStoreFilesWithCtags(wxEvtHandler* parent, const wxArrayString& arrFiles, ITagsStoragePtr db,
+                                       size_t& count);
     void FindIncludedFiles(ParseRequest* req, wxArrayString& files);
 };
 
@@ -211,6 +233,8 @@ class WXDLLIMPEXP_CL clParseThreadEvent : public clCommandEvent
     int m_requestUID = 0;
     wxEvtHandler* m_caller = nullptr;
     int m_requestType = ParseRequest::PR_INVALID;
+    size_t m_filesParsed = 0;
+    size_t m_filesSkipped = 0;
 
 private:
     // Make GetInt private
@@ -234,6 +258,13 @@ public:
     wxEvtHandler* GetCaller() const { return m_caller; }
     void SetRequestType(int requestType) { m_requestType = requestType; }
     int GetRequestType() const { return m_requestType; }
+    void SetFilesParsed(size_t filesParsed) { m_filesParsed = filesParsed; }
+    size_t GetFilesParsed() const { return m_filesParsed; }
+    /**
+     * @brief the number of files that were not parsed again since they did not change since they were tagged
+     */
+    void SetFilesSkipped(size_t filesSkipped) { m_filesSkipped = filesSkipped; }
+    size_t GetFilesSkipped() const { return m_filesSkipped; }
 };
 
 typedef void (wxEvtHandler::*clParseThreadEventFunction)(clParseThreadEvent&);
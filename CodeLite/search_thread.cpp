@@ -22,7 +22,9 @@
 //
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
+#include "clFileReader.h"
 #include "clFilesCollector.h"
+#include "clLiteralMatcher.h"
 #include "cppwordscanner.h"
 #include "dirtraverser.h"
 #include "fileutils.h"
@@ -30,8 +32,12 @@
 #include "search_thread.h"
 #include "wx/event.h"
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <wx/dir.h>
 #if wxUSE_GUI
 #include <wx/fontmap.h>
@@ -58,6 +64,12 @@ wxDEFINE_EVENT(wxEVT_SEARCH_THREAD_SEARCHSTARTED, wxCommandEvent);
     }                                         \
     wxThread::Sleep(1);
 
+// Number of files a parallel search worker may scan ahead of the files already reported
+#define PARALLEL_SEARCH_WINDOW_PER_WORKER 64
+
+// Send the matches found by a parallel search at least that often (ms)
+#define PARALLEL_SEARCH_FLUSH_INTERVAL 250
+
 //----------------------------------------------------------------
 // SearchData
 //----------------------------------------------------------------
@@ -99,7 +111,7 @@ SearchThread::SearchThread()
     IndexWordChars();
 }
 
-SearchThread::~SearchThread() {}
+SearchThread::~SearchThread() { m_index.Close(); }
 
 void SearchThread::IndexWordChars()
 {
@@ -191,6 +203,7 @@ void SearchThread::DoSearchFiles(ThreadRequest* req)
     StopSearch(false);
     wxArrayString fileList;
     GetFiles(data, fileList);
+    NarrowFilesUsingIndex(data, fileList);
 
     wxStopWatch sw;
 
@@ -206,6 +219,14 @@ void SearchThread::DoSearchFiles(ThreadRequest* req)
         }
     }
 
+    wxString findWhat;
+    wxArrayString filters;
+    GetFindWhatAndFilters(data, findWhat, filters);
+    if(CanSearchInParallel(data, findWhat)) {
+        DoSearchFilesInParallel(fileList, data, findWhat, filters);
+        return;
+    }
+
     for(size_t i = 0; i < fileList.Count(); i++) {
         m_summary.SetNumFileScanned((int)i + 1);
 
@@ -297,36 +318,319 @@ void SearchThread::DoSearchFile(const wxString& fileName, const SearchData* data
         // simple search
         wxString findString;
         wxArrayString filters;
-        findString = data->GetFindString();
-        if(data->IsEnablePipeSupport()) {
-            if(data->GetFindString().Find('|') != wxNOT_FOUND) {
-                findString = data->GetFindString().BeforeFirst('|');
-
-                wxString filtersString = data->GetFindString().AfterFirst('|');
-                filters = ::wxStringTokenize(filtersString, "|", wxTOKEN_STRTOK);
-                if(!data->IsMatchCase()) {
-                    for(size_t i = 0; i < filters.size(); ++i) {
-                        filters.Item(i).MakeLower();
-                    }
+        GetFindWhatAndFilters(data, findString, filters);
+
+        // Dont search for empty strings
+        if(findString.empty()) { return; }
+
+        size_t count = m_results.size();
+        DoSearchContent(fileData, fileName, data, findString, filters, m_results);
+        m_summary.SetNumMatchesFound(m_summary.GetNumMatchesFound() + (int)(m_results.size() - count));
+    }
+
+    if(m_results.empty() == false) { SendEvent(wxEVT_SEARCH_THREAD_MATCHFOUND, data->GetOwner()); }
+}
+
+void SearchThread::GetFindWhatAndFilters(const SearchData* data, wxString& findWhat, wxArrayString& filters) const
+{
+    findWhat = data->GetFindString();
+    filters.clear();
+    if(data->IsEnablePipeSupport()) {
+        if(data->GetFindString().Find('|') != wxNOT_FOUND) {
+            findWhat = data->GetFindString().BeforeFirst('|');
+
+            wxString filtersString = data->GetFindString().AfterFirst('|');
+            filters = ::wxStringTokenize(filtersString, "|", wxTOKEN_STRTOK);
+            if(!data->IsMatchCase()) {
+                for(size_t i = 0; i < filters.size(); ++i) {
+                    filters.Item(i).MakeLower();
                 }
             }
         }
+    }
+    if(!data->IsMatchCase()) { findWhat.MakeLower(); }
+}
 
-        // Dont search for empty strings
-        if(findString.empty()) { return; }
-        
-        if(!data->IsMatchCase()) { findString.MakeLower(); }
-        while(tkz.HasMoreTokens()) {
+void SearchThread::DoSearchContent(const wxString& content, const wxString& fileName, const SearchData* data,
+                                   const wxString& findWhat, const wxArrayString& filters, SearchResultList& results)
+{
+    int lineNumber = 1;
+    int lineOffset = 0;
+    wxStringTokenizer tkz(content, wxT("\n"), wxTOKEN_RET_EMPTY_ALL);
+    while(tkz.HasMoreTokens()) {
+        // Read the next line
+        wxString line = tkz.NextToken();
+        DoSearchLine(line, lineNumber, lineOffset, fileName, data, findWhat, filters, NULL, results);
+        lineOffset += line.Length() + 1;
+        lineNumber++;
+    }
+}
 
-            // Read the next line
-            wxString line = tkz.NextToken();
-            DoSearchLine(line, lineNumber, lineOffset, fileName, data, findString, filters, states);
-            lineOffset += line.Length() + 1;
-            lineNumber++;
+namespace
+{
+/**
+ * @brief return the number of wxString characters the UTF-8 encoded 'buffer' decodes into
+ */
+size_t CountUTF8Chars(const char* buffer, size_t len)
+{
+    size_t count = 0;
+    const unsigned char* p = (const unsigned char*)buffer;
+    for(size_t i = 0; i < len; ++i) {
+        // count everything but the continuation bytes
+        if((p[i] & 0xC0) != 0x80) { ++count; }
+#if SIZEOF_WCHAR_T == 2
+        // characters outside of the BMP are stored as surrogate pairs
+        if(p[i] >= 0xF0) { ++count; }
+#endif
+    }
+    return count;
+}
+
+bool IsValidUTF8(const char* buffer, size_t len)
+{
+    const unsigned char* p = (const unsigned char*)buffer;
+    size_t i = 0;
+    while(i < len) {
+        unsigned char ch = p[i];
+        size_t extra = 0;
+        if(ch < 0x80) {
+            ++i;
+            continue;
+        } else if(ch >= 0xC2 && ch <= 0xDF) {
+            extra = 1;
+        } else if(ch >= 0xE0 && ch <= 0xEF) {
+            extra = 2;
+        } else if(ch >= 0xF0 && ch <= 0xF4) {
+            extra = 3;
+        } else {
+            return false;
+        }
+        if((i + extra) >= len) { return false; }
+        for(size_t j = 1; j <= extra; ++j) {
+            if((p[i + j] & 0xC0) != 0x80) { return false; }
+        }
+        // reject overlong forms, surrogates and code points above U+10FFFF
+        unsigned char next = p[i + 1];
+        if((ch == 0xE0 && next < 0xA0) || (ch == 0xED && next >= 0xA0) || (ch == 0xF0 && next < 0x90) ||
+           (ch == 0xF4 && next >= 0x90)) {
+            return false;
         }
+        i += extra + 1;
     }
+    return true;
+}
+} // namespace
 
-    if(m_results.empty() == false) { SendEvent(wxEVT_SEARCH_THREAD_MATCHFOUND, data->GetOwner()); }
+bool SearchThread::CanSearchInParallel(const SearchData* data, const wxString& findWhat) const
+{
+    if(data->IsRegularExpression() || findWhat.IsEmpty()) { return false; }
+
+    // The raw bytes matcher folds ASCII letters only
+    if(!data->IsMatchCase() && !findWhat.IsAscii()) { return false; }
+
+    // Searching the raw bytes requires UTF-8 encoded files
+    return IsUTF8Encoding(data);
+}
+
+bool SearchThread::IsUTF8Encoding(const SearchData* data) const
+{
+#if wxUSE_GUI
+    wxFontEncoding enc = wxFontMapper::GetEncodingFromName(data->GetEncoding().c_str());
+    wxCSConv fontEncConv(enc);
+    return fontEncConv.IsUTF8();
+#else
+    return wxConvLibc.IsUTF8();
+#endif
+}
+
+void SearchThread::SetIndexFile(const wxFileName& indexFile)
+{
+    if(indexFile.IsOk()) {
+        m_index.Open(indexFile);
+    } else {
+        m_index.Close();
+    }
+}
+
+void SearchThread::UpdateIndex(const wxArrayString& files) { m_index.Update(files); }
+
+void SearchThread::NarrowFilesUsingIndex(const SearchData* data, wxArrayString& files)
+{
+    // The index holds the trigrams of the files raw bytes, these are the characters only for UTF-8 (or ASCII) files
+    if(!m_index.IsOpen() || files.IsEmpty() || !IsUTF8Encoding(data)) { return; }
+
+    std::vector<std::string> literals;
+    if(data->IsRegularExpression()) {
+        clFindInFilesIndex::GetRequiredLiterals(data->GetFindString(), true, literals);
+    } else {
+        // every match must contain the searched string and all the pipe filters
+        wxString findWhat;
+        wxArrayString filters;
+        GetFindWhatAndFilters(data, findWhat, filters);
+        clFindInFilesIndex::GetRequiredLiterals(findWhat, false, literals);
+        for(size_t i = 0; i < filters.size(); ++i) {
+            clFindInFilesIndex::GetRequiredLiterals(filters.Item(i), false, literals);
+        }
+    }
+    m_index.Narrow(literals, files);
+}
+
+void SearchThread::DoSearchFilesInParallel(const wxArrayString& files, const SearchData* data,
+                                           const wxString& findWhat, const wxArrayString& filters)
+{
+    struct FileResult {
+        bool done = false;
+        bool failed = false;
+        SearchResultList results;
+    };
+
+    size_t workersCount = std::max(1u, std::thread::hardware_concurrency());
+    if(workersCount > files.size()) { workersCount = std::max((size_t)1, (size_t)files.size()); }
+    const size_t window = workersCount * PARALLEL_SEARCH_WINDOW_PER_WORKER;
+
+    clLiteralMatcher matcher(std::string(findWhat.mb_str(wxConvUTF8).data()), !data->IsMatchCase());
+    std::vector<FileResult> fileResults(files.size());
+    std::mutex lock;
+    std::condition_variable cv;
+    size_t nextFile = 0;
+    size_t reportedFiles = 0;
+    bool abort = false;
+
+    // The workers take the files in order and never run more than 'window' files ahead of the reporting loop
+    std::vector<std::thread> workers;
+    for(size_t w = 0; w < workersCount; ++w) {
+        workers.push_back(std::thread([&]() {
+            clFileReader reader;
+            while(true) {
+                size_t index = 0;
+                {
+                    std::unique_lock<std::mutex> locker(lock);
+                    cv.wait(locker, [&]() {
+                        return abort || nextFile >= files.size() || nextFile < (reportedFiles + window);
+                    });
+                    if(abort || nextFile >= files.size()) { return; }
+                    index = nextFile++;
+                }
+
+                SearchResultList results;
+                bool failed = false;
+                DoSearchFileBuffer(reader, files.Item(index), data, matcher, findWhat, filters, results, failed);
+                {
+                    std::lock_guard<std::mutex> locker(lock);
+                    fileResults[index].results.swap(results);
+                    fileResults[index].failed = failed;
+                    fileResults[index].done = true;
+                }
+                cv.notify_all();
+            }
+        }));
+    }
+
+    // Report the results in the files order
+    wxStopWatch flushTimer;
+    for(size_t i = 0; i < files.size(); ++i) {
+        m_summary.SetNumFileScanned((int)i + 1);
+
+        FileResult result;
+        bool ready = false;
+        while(!ready && !TestStopSearch()) {
+            std::unique_lock<std::mutex> locker(lock);
+            ready = cv.wait_for(locker, std::chrono::milliseconds(100), [&]() { return fileResults[i].done; });
+            if(ready) {
+                result.results.swap(fileResults[i].results);
+                result.failed = fileResults[i].failed;
+                reportedFiles = i + 1;
+            }
+        }
+
+        // give user chance to cancel the search ...
+        if(!ready) {
+            // Send cancel event
+            SendEvent(wxEVT_SEARCH_THREAD_SEARCHCANCELED, data->GetOwner());
+            StopSearch(false);
+            break;
+        }
+        cv.notify_all();
+
+        if(result.failed) {
+            m_summary.GetFailedFiles().Add(files.Item(i));
+            continue;
+        }
+
+        m_summary.SetNumMatchesFound(m_summary.GetNumMatchesFound() + (int)result.results.size());
+        m_results.splice(m_results.end(), result.results);
+        if(!m_results.empty() && flushTimer.Time() >= PARALLEL_SEARCH_FLUSH_INTERVAL) {
+            SendMatches(data->GetOwner());
+            flushTimer.Start();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        abort = true;
+    }
+    cv.notify_all();
+    for(size_t w = 0; w < workers.size(); ++w) {
+        workers[w].join();
+    }
+}
+
+void SearchThread::DoSearchFileBuffer(clFileReader& reader, const wxString& fileName, const SearchData* data,
+                                      const clLiteralMatcher& matcher, const wxString& findWhat,
+                                      const wxArrayString& filters, SearchResultList& results, bool& failed)
+{
+    failed = false;
+    if(!wxFileName::FileExists(fileName)) { return; }
+
+    if(!reader.Open(fileName)) {
+        failed = true;
+        return;
+    }
+
+    const char* buffer = reader.GetData();
+    size_t size = reader.GetSize();
+
+    // Same as the line by line search: the content ends at the first NUL byte
+    const char* nul = (const char*)memchr(buffer, 0, size);
+    if(nul) { size = nul - buffer; }
+
+    // The case folding here is ASCII only: a case insensitive search for a non ASCII string never gets here (see
+    // CanSearchInParallel()) and non ASCII letters in the file are compared as is
+    size_t pos = matcher.Find(buffer, size);
+    if(pos == std::string::npos) { return; }
+
+    if(!IsValidUTF8(buffer, size)) {
+        // Same as FileUtils::ReadFileContent(): if the content can not be decoded, treat it as 8 bit data
+        DoSearchContent(wxString::From8BitData(buffer, size), fileName, data, findWhat, filters, results);
+        return;
+    }
+
+    // Only the lines containing a match are decoded, the offsets of the lines in between are computed from the
+    // raw bytes
+    int lineNumber = 1;
+    int lineOffset = 0;
+    size_t lineStart = 0;
+    while(pos != std::string::npos) {
+        // move to the line containing the match
+        const char* nl = NULL;
+        while((nl = (const char*)memchr(buffer + lineStart, '\n', pos - lineStart)) != NULL) {
+            size_t lineEnd = nl - buffer;
+            lineOffset += (int)CountUTF8Chars(buffer + lineStart, lineEnd - lineStart) + 1;
+            ++lineNumber;
+            lineStart = lineEnd + 1;
+        }
+
+        const char* eol = (const char*)memchr(buffer + pos, '\n', size - pos);
+        size_t lineEnd = eol ? (eol - buffer) : size;
+        wxString line = wxString::FromUTF8(buffer + lineStart, lineEnd - lineStart);
+        DoSearchLine(line, lineNumber, lineOffset, fileName, data, findWhat, filters, NULL, results);
+        if(!eol) { break; }
+
+        lineOffset += (int)line.Length() + 1;
+        ++lineNumber;
+        lineStart = lineEnd + 1;
+        pos = matcher.Find(buffer, size, lineStart);
+    }
 }
 
 void SearchThread::DoSearchLineRE(const wxString& line, const int lineNum, const int lineOffset,
@@ -413,7 +717,7 @@ void SearchThread::DoSearchLineRE(const wxString& line, const int lineNum, const
 
 void SearchThread::DoSearchLine(const wxString& line, const int lineNum, const int lineOffset, const wxString& fileName,
                                 const SearchData* data, const wxString& findWhat, const wxArrayString& filters,
-                                TextStatesPtr statesPtr)
+                                TextStatesPtr statesPtr, SearchResultList& results)
 {
     wxString modLine = line;
 
@@ -524,10 +828,7 @@ void SearchThread::DoSearchLine(const wxString& line, const int lineNum, const i
                 }
             }
 
-            if(canAdd) {
-                m_results.push_back(result);
-                m_summary.SetNumMatchesFound(m_summary.GetNumMatchesFound() + 1);
-            }
+            if(canAdd) { results.push_back(result); }
 
             if(!AdjustLine(modLine, pos, findWhat)) { break; }
             col += (int)findWhat.Length();
@@ -587,6 +888,16 @@ void SearchThread::SendEvent(wxEventType type, wxEvtHandler* owner)
     }
 }
 
+void SearchThread::SendMatches(wxEvtHandler* owner)
+{
+    if(m_results.empty() || (!m_notifiedWindow && !owner)) return;
+
+    wxCommandEvent event(wxEVT_SEARCH_THREAD_MATCHFOUND, GetId());
+    event.SetClientData(new SearchResultList(m_results));
+    m_results.clear();
+    SEND_ST_EVENT();
+}
+
 void SearchThread::FilterFiles(wxArrayString& files, const SearchData* data)
 {
     wxArrayString tmpFiles;
@@ -25,6 +25,7 @@
 #ifndef SEARCH_THREAD_H
 #define SEARCH_THREAD_H
 
+#include "clFindInFilesIndex.h"
 #include "codelite_exports.h"
 #include "cppwordscanner.h"
 #include "singleton.h"
@@ -42,6 +43,8 @@
 class wxEvtHandler;
 class SearchResult;
 class SearchThread;
+class clLiteralMatcher;
+class clFileReader;
 
 //----------------------------------------------------------
 // The searched data class to be passed to the search thread
@@ -333,6 +336,7 @@ class WXDLLIMPEXP_CL SearchThread : public WorkerThread
     bool m_matchCase;
     wxCriticalSection m_cs;
     int m_counter = 0;
+    clFindInFilesIndex m_index;
 
 public:
     /**
@@ -371,6 +375,17 @@ public:
      */
     void SetWordChars(const wxString& chars);
 
+    /**
+     * @brief use the trigram index stored in 'indexFile' to narrow down the files to search.
+     * Pass an empty file name to stop using the index
+     */
+    void SetIndexFile(const wxFileName& indexFile);
+
+    /**
+     * @brief notify the index that 'files' were modified, added or deleted
+     */
+    void UpdateIndex(const wxArrayString& files);
+
 private:
     /**
      * Return files to search
@@ -393,13 +408,44 @@ private:
      */
     void DoSearchFiles(ThreadRequest* data);
 
+    /**
+     * Search the files using a pool of worker threads. Each worker memory maps its files and scans their raw
+     * UTF-8 bytes, only the lines containing a match are converted into wxString. The results are reported
+     * in the order of 'files'
+     */
+    void DoSearchFilesInParallel(const wxArrayString& files, const SearchData* data, const wxString& findWhat,
+                                 const wxArrayString& filters);
+
+    /**
+     * Can 'data' be searched by DoSearchFilesInParallel()? (plain string search in UTF-8 encoded files)
+     */
+    bool CanSearchInParallel(const SearchData* data, const wxString& findWhat) const;
+
+    // Are the files to search UTF-8 encoded?
+    bool IsUTF8Encoding(const SearchData* data) const;
+
+    // Remove from 'files' the files that can not contain a match, using the index (if available)
+    void NarrowFilesUsingIndex(const SearchData* data, wxArrayString& files);
+
+    // Split the find string into the string to search and the pipe filters
+    void GetFindWhatAndFilters(const SearchData* data, wxString& findWhat, wxArrayString& filters) const;
+
     // Perform search on a single file
     void DoSearchFile(const wxString& fileName, const SearchData* data);
 
+    // Perform search on a single file (called from the worker threads, each with its own reader)
+    void DoSearchFileBuffer(clFileReader& reader, const wxString& fileName, const SearchData* data,
+                            const clLiteralMatcher& matcher, const wxString& findWhat, const wxArrayString& filters,
+                            SearchResultList& results, bool& failed);
+
+    // Perform a plain string search on a file content, line by line
+    void DoSearchContent(const wxString& content, const wxString& fileName, const SearchData* data,
+                         const wxString& findWhat, const wxArrayString& filters, SearchResultList& results);
+
     // Perform search on a line
     void DoSearchLine(const wxString& line, const int lineNum, const int lineOffset, const wxString& fileName,
                       const SearchData* data, const wxString& findWhat, const wxArrayString& filters,
-                      TextStatesPtr statesPtr);
+                      TextStatesPtr statesPtr, SearchResultList& results);
 
     // Perform search on a line using regular expression
     void DoSearchLineRE(const wxString& line, const int lineNum, const int lineOffset, const wxString& fileName,
@@ -408,6 +454,9 @@ private:
     // Send an event to the notified window
     void SendEvent(wxEventType type, wxEvtHandler* owner);
 
+    // Send the matches collected so far to the notified window
+    void SendMatches(wxEvtHandler* owner);
+
     // return a compiled regex object for the expression
     wxRegEx& GetRegex(const wxString& expr, bool matchCase);
 
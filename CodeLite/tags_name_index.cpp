@@ -0,0 +1,351 @@
+#include "tags_name_index.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+// Entries added since the last merge are searched linearly, until there are this many of them (or 1/8 of the
+// sorted entries)
+#define NAME_INDEX_MIN_PENDING 4096
+
+// Removed entries are purged once they are 1/4 of the entries
+#define NAME_INDEX_MIN_REMOVED 1024
+
+namespace
+{
+inline unsigned char FoldCase(unsigned char ch) { return (ch >= 'A' && ch <= 'Z') ? (ch + ('a' - 'A')) : ch; }
+
+std::string ToUTF8String(const wxString& str)
+{
+    const wxScopedCharBuffer buffer = str.ToUTF8();
+    return std::string(buffer.data(), buffer.length());
+}
+
+std::string FoldString(const std::string& str)
+{
+    std::string folded(str);
+    for(size_t i = 0; i < folded.length(); ++i) {
+        folded[i] = (char)FoldCase((unsigned char)folded[i]);
+    }
+    return folded;
+}
+
+/**
+ * @brief compare 'a' and 'b' with their ASCII letters folded to lower case
+ */
+int CompareFolded(const char* a, size_t alen, const char* b, size_t blen)
+{
+    size_t len = std::min(alen, blen);
+    for(size_t i = 0; i < len; ++i) {
+        unsigned char ca = FoldCase((unsigned char)a[i]);
+        unsigned char cb = FoldCase((unsigned char)b[i]);
+        if(ca != cb) { return ca < cb ? -1 : 1; }
+    }
+    return alen == blen ? 0 : (alen < blen ? -1 : 1);
+}
+
+/**
+ * @brief does 'str' start with the (already folded) 'prefix', ignoring the case of the ASCII letters?
+ */
+bool StartsWithFolded(const char* str, size_t len, const std::string& prefix)
+{
+    if(len < prefix.length()) { return false; }
+    for(size_t i = 0; i < prefix.length(); ++i) {
+        if(FoldCase((unsigned char)str[i]) != (unsigned char)prefix[i]) { return false; }
+    }
+    return true;
+}
+
+/**
+ * @brief does 'str' contain the (already folded) 'part', ignoring the case of the ASCII letters?
+ */
+bool ContainsFolded(const char* str, size_t len, const std::string& part)
+{
+    if(len < part.length()) { return false; }
+    const unsigned char first = part[0];
+    for(size_t i = 0; i + part.length() <= len; ++i) {
+        if(FoldCase((unsigned char)str[i]) == first && StartsWithFolded(str + i, len - i, part)) { return true; }
+    }
+    return false;
+}
+} // namespace
+
+TagsNameIndex::TagsNameIndex() {}
+
+TagsNameIndex::~TagsNameIndex() {}
+
+void TagsNameIndex::Clear()
+{
+    // swap with empty containers to release the memory
+    std::vector<Entry>().swap(m_entries);
+    std::vector<char>().swap(m_names);
+    std::vector<std::string>().swap(m_strings);
+    std::unordered_map<std::string, unsigned int>().swap(m_stringIds);
+    std::unordered_map<unsigned int, std::vector<unsigned int> >().swap(m_fileEntries);
+    std::vector<unsigned int>().swap(m_byName);
+    std::vector<unsigned int>().swap(m_byScopeAndName);
+    m_sortedCount = 0;
+    m_removedCount = 0;
+}
+
+unsigned int TagsNameIndex::DoIntern(const std::string& str)
+{
+    auto iter = m_stringIds.find(str);
+    if(iter != m_stringIds.end()) { return iter->second; }
+    unsigned int id = (unsigned int)m_strings.size();
+    m_strings.push_back(str);
+    m_stringIds.insert({ str, id });
+    return id;
+}
+
+int TagsNameIndex::DoCompareNames(const Entry& a, const Entry& b) const
+{
+    const char* na = m_names.data() + a.nameOffset;
+    const char* nb = m_names.data() + b.nameOffset;
+    int rc = CompareFolded(na, a.nameLen, nb, b.nameLen);
+    if(rc != 0) { return rc; }
+
+    // same name, ignoring the case: keep a stable order
+    int raw = memcmp(na, nb, a.nameLen);
+    if(raw != 0) { return raw; }
+    return a.id < b.id ? -1 : (a.id > b.id ? 1 : 0);
+}
+
+bool TagsNameIndex::DoNameMatches(const Entry& entry, const std::string& name, const std::string& foldedName,
+                                  size_t flags) const
+{
+    const char* entryName = m_names.data() + entry.nameOffset;
+    if(!(flags & kPartialMatch)) {
+        // exact matches are case sensitive
+        return entry.nameLen == name.length() && memcmp(entryName, name.c_str(), name.length()) == 0;
+    }
+    if(flags & kIgnoreCase) { return StartsWithFolded(entryName, entry.nameLen, foldedName); }
+    return entry.nameLen >= name.length() && memcmp(entryName, name.c_str(), name.length()) == 0;
+}
+
+void TagsNameIndex::Add(wxLongLong_t id, const wxString& name, const wxString& scope, const wxString& file)
+{
+    // the entries are kept ordered by ID
+    if(id <= GetLastId()) { return; }
+
+    std::string utf8Name = ToUTF8String(name);
+    Entry entry;
+    entry.id = id;
+    entry.nameOffset = (unsigned int)m_names.size();
+    entry.nameLen = (unsigned int)utf8Name.length();
+    entry.scope = DoIntern(ToUTF8String(scope));
+    entry.file = DoIntern(ToUTF8String(file));
+    m_names.insert(m_names.end(), utf8Name.begin(), utf8Name.end());
+
+    m_fileEntries[entry.file].push_back((unsigned int)m_entries.size());
+    m_entries.push_back(entry);
+}
+
+void TagsNameIndex::DoRemoveEntry(unsigned int index)
+{
+    Entry& entry = m_entries[index];
+    if(entry.file == kRemoved) { return; }
+    entry.file = kRemoved;
+    ++m_removedCount;
+}
+
+void TagsNameIndex::RemoveFile(const wxString& file, wxLongLong_t maxId)
+{
+    auto strIter = m_stringIds.find(ToUTF8String(file));
+    if(strIter == m_stringIds.end()) { return; }
+
+    auto iter = m_fileEntries.find(strIter->second);
+    if(iter == m_fileEntries.end()) { return; }
+
+    std::vector<unsigned int> remaining;
+    for(unsigned int index : iter->second) {
+        if(maxId < 0 || m_entries[index].id <= maxId) {
+            DoRemoveEntry(index);
+        } else if(m_entries[index].file != kRemoved) {
+            remaining.push_back(index);
+        }
+    }
+
+    if(remaining.empty()) {
+        m_fileEntries.erase(iter);
+    } else {
+        iter->second.swap(remaining);
+    }
+}
+
+void TagsNameIndex::Remove(wxLongLong_t id)
+{
+    auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), id,
+                                 [](const Entry& entry, wxLongLong_t id) { return entry.id < id; });
+    if(iter != m_entries.end() && iter->id == id) { DoRemoveEntry((unsigned int)(iter - m_entries.begin())); }
+}
+
+void TagsNameIndex::Commit()
+{
+    size_t pending = m_entries.size() - m_sortedCount;
+    if(pending && (pending >= NAME_INDEX_MIN_PENDING || pending >= m_sortedCount / 8 || m_sortedCount == 0)) {
+        DoMergePending();
+    }
+    if(m_removedCount >= NAME_INDEX_MIN_REMOVED && m_removedCount >= m_entries.size() / 4) { DoPurgeRemoved(); }
+}
+
+void TagsNameIndex::DoMergePending()
+{
+    auto byName = [this](unsigned int a, unsigned int b) { return DoCompareNames(m_entries[a], m_entries[b]) < 0; };
+    auto byScopeAndName = [this](unsigned int a, unsigned int b) {
+        const Entry& ea = m_entries[a];
+        const Entry& eb = m_entries[b];
+        if(ea.scope != eb.scope) { return ea.scope < eb.scope; }
+        return DoCompareNames(ea, eb) < 0;
+    };
+
+    std::vector<unsigned int> pending;
+    pending.reserve(m_entries.size() - m_sortedCount);
+    for(size_t i = m_sortedCount; i < m_entries.size(); ++i) {
+        pending.push_back((unsigned int)i);
+    }
+
+    std::vector<unsigned int> merged;
+    merged.reserve(m_entries.size());
+
+    std::sort(pending.begin(), pending.end(), byName);
+    std::merge(m_byName.begin(), m_byName.end(), pending.begin(), pending.end(), std::back_inserter(merged), byName);
+    m_byName.swap(merged);
+
+    merged.clear();
+    std::sort(pending.begin(), pending.end(), byScopeAndName);
+    std::merge(m_byScopeAndName.begin(), m_byScopeAndName.end(), pending.begin(), pending.end(),
+               std::back_inserter(merged), byScopeAndName);
+    m_byScopeAndName.swap(merged);
+
+    m_sortedCount = m_entries.size();
+}
+
+void TagsNameIndex::DoPurgeRemoved()
+{
+    // compact the entries and the names, keeping their order
+    std::vector<unsigned int> newIndex(m_entries.size(), kRemoved);
+    std::vector<Entry> entries;
+    std::vector<char> names;
+    entries.reserve(m_entries.size() - m_removedCount);
+    size_t sortedCount = 0;
+    for(size_t i = 0; i < m_entries.size(); ++i) {
+        Entry entry = m_entries[i];
+        if(entry.file == kRemoved) { continue; }
+
+        const char* name = m_names.data() + entry.nameOffset;
+        entry.nameOffset = (unsigned int)names.size();
+        names.insert(names.end(), name, name + entry.nameLen);
+
+        newIndex[i] = (unsigned int)entries.size();
+        entries.push_back(entry);
+        if(i < m_sortedCount) { ++sortedCount; }
+    }
+
+    auto remap = [&](std::vector<unsigned int>& sorted) {
+        std::vector<unsigned int> result;
+        result.reserve(sortedCount);
+        for(unsigned int index : sorted) {
+            if(newIndex[index] != kRemoved) { result.push_back(newIndex[index]); }
+        }
+        sorted.swap(result);
+    };
+    remap(m_byName);
+    remap(m_byScopeAndName);
+
+    m_fileEntries.clear();
+    for(size_t i = 0; i < entries.size(); ++i) {
+        m_fileEntries[entries[i].file].push_back((unsigned int)i);
+    }
+
+    m_entries.swap(entries);
+    m_names.swap(names);
+    m_sortedCount = sortedCount;
+    m_removedCount = 0;
+}
+
+void TagsNameIndex::Find(const wxString& scope, const wxString& name, size_t flags, size_t limit,
+                         std::vector<wxLongLong_t>& ids) const
+{
+    if(name.IsEmpty() || limit == 0) { return; }
+
+    std::string utf8Name = ToUTF8String(name);
+    std::string foldedName = FoldString(utf8Name);
+    bool hasScope = !scope.IsEmpty();
+    unsigned int scopeId = kRemoved;
+    if(hasScope) {
+        auto iter = m_stringIds.find(ToUTF8String(scope));
+        if(iter == m_stringIds.end()) { return; }
+        scopeId = iter->second;
+    }
+
+    size_t found = 0;
+    auto collect = [&](const Entry& entry) {
+        if(entry.file == kRemoved || (hasScope && entry.scope != scopeId)) { return; }
+        if(!DoNameMatches(entry, utf8Name, foldedName, flags)) { return; }
+        ids.push_back(entry.id);
+        ++found;
+    };
+
+    // The sorted entries: all the candidates are in the range of names starting with 'foldedName'
+    const std::vector<unsigned int>& sorted = hasScope ? m_byScopeAndName : m_byName;
+    auto first = std::lower_bound(sorted.begin(), sorted.end(), 0, [&](unsigned int index, int) {
+        const Entry& entry = m_entries[index];
+        if(hasScope && entry.scope != scopeId) { return entry.scope < scopeId; }
+        return CompareFolded(m_names.data() + entry.nameOffset, entry.nameLen, foldedName.c_str(),
+                             foldedName.length()) < 0;
+    });
+
+    for(auto iter = first; iter != sorted.end() && found < limit; ++iter) {
+        const Entry& entry = m_entries[*iter];
+        if(hasScope && entry.scope != scopeId) { break; }
+        if(!StartsWithFolded(m_names.data() + entry.nameOffset, entry.nameLen, foldedName)) { break; }
+        if(!(flags & kPartialMatch) && entry.nameLen != utf8Name.length()) { break; }
+        collect(entry);
+    }
+
+    // The entries added since the last merge
+    for(size_t i = m_sortedCount; i < m_entries.size() && found < limit; ++i) {
+        collect(m_entries[i]);
+    }
+}
+
+void TagsNameIndex::FindSubstring(const wxString& part, size_t limit, std::vector<wxLongLong_t>& ids) const
+{
+    if(part.IsEmpty() || limit == 0) { return; }
+
+    std::string foldedPart = FoldString(ToUTF8String(part));
+    size_t found = 0;
+    for(size_t i = 0; i < m_entries.size() && found < limit; ++i) {
+        const Entry& entry = m_entries[i];
+        if(entry.file == kRemoved) { continue; }
+        if(ContainsFolded(m_names.data() + entry.nameOffset, entry.nameLen, foldedPart)) {
+            ids.push_back(entry.id);
+            ++found;
+        }
+    }
+}
+
+TagsNameIndex::MemoryUsage TagsNameIndex::GetMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.entries = GetCount();
+    usage.removedEntries = m_removedCount;
+    usage.pendingEntries = m_entries.size() - m_sortedCount;
+    usage.namesBytes = m_names.capacity();
+    usage.stringsCount = m_strings.size();
+
+    // the interned strings are stored twice: in m_strings and as the keys of m_stringIds
+    for(const std::string& str : m_strings) {
+        usage.stringsBytes += 2 * (sizeof(std::string) + str.capacity());
+    }
+    usage.stringsBytes += m_stringIds.bucket_count() * sizeof(void*);
+
+    usage.entriesBytes = m_entries.capacity() * sizeof(Entry) +
+                         (m_byName.capacity() + m_byScopeAndName.capacity()) * sizeof(unsigned int);
+    for(const auto& p : m_fileEntries) {
+        usage.entriesBytes += sizeof(p) + p.second.capacity() * sizeof(unsigned int);
+    }
+
+    usage.totalBytes = usage.namesBytes + usage.stringsBytes + usage.entriesBytes;
+    return usage;
+}
@@ -0,0 +1,121 @@
+#ifndef TAGS_NAME_INDEX_H
+#define TAGS_NAME_INDEX_H
+
+#include "codelite_exports.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/longlong.h>
+#include <wx/string.h>
+
+/**
+ * @class TagsNameIndex
+ * @brief an in memory index of the tags names and scopes, used to answer the code completion lookups without
+ * querying the database. The index only holds the tag IDs, the tags themselves are still read from the database.
+ *
+ * Names are kept in a single UTF-8 buffer, scopes and files are interned. Two arrays of entries are kept sorted:
+ * by name and by scope + name (the names are compared with their ASCII letters folded to lower case, like the
+ * SQLite LIKE operator does). Entries added after the last merge are searched linearly until they are merged into
+ * the sorted arrays. Removed entries are only flagged until enough of them are collected.
+ */
+class WXDLLIMPEXP_CL TagsNameIndex
+{
+public:
+    struct MemoryUsage {
+        size_t entries = 0;          // live entries
+        size_t removedEntries = 0;   // entries flagged as removed, not purged yet
+        size_t pendingEntries = 0;   // entries not merged into the sorted arrays yet
+        size_t namesBytes = 0;       // the names buffer
+        size_t stringsCount = 0;     // interned scopes and files
+        size_t stringsBytes = 0;     // interned scopes and files, including their lookup table
+        size_t entriesBytes = 0;     // the entries and the sorted arrays
+        size_t totalBytes = 0;
+    };
+
+    enum eFlags {
+        kPartialMatch = (1 << 0), // name is a prefix
+        kIgnoreCase = (1 << 1),   // ASCII letters are compared case insensitively (partial matches only)
+    };
+
+protected:
+    struct Entry {
+        wxLongLong_t id;
+        unsigned int nameOffset;
+        unsigned int nameLen;
+        unsigned int scope;
+        unsigned int file; // kRemoved once the entry is removed
+    };
+    static const unsigned int kRemoved = (unsigned int)-1;
+
+    std::vector<Entry> m_entries; // ordered by ID
+    std::vector<char> m_names;
+    std::vector<std::string> m_strings;
+    std::unordered_map<std::string, unsigned int> m_stringIds;
+    std::unordered_map<unsigned int, std::vector<unsigned int> > m_fileEntries;
+
+    // indexes into m_entries: the first m_sortedCount entries sorted by name / scope + name
+    std::vector<unsigned int> m_byName;
+    std::vector<unsigned int> m_byScopeAndName;
+    size_t m_sortedCount = 0;
+    size_t m_removedCount = 0;
+
+protected:
+    unsigned int DoIntern(const std::string& str);
+    int DoCompareNames(const Entry& a, const Entry& b) const;
+    bool DoNameMatches(const Entry& entry, const std::string& name, const std::string& foldedName,
+                       size_t flags) const;
+    void DoMergePending();
+    void DoPurgeRemoved();
+    void DoRemoveEntry(unsigned int index);
+
+public:
+    TagsNameIndex();
+    virtual ~TagsNameIndex();
+
+    void Clear();
+
+    /**
+     * @brief add a tag. IDs must be added in ascending order
+     */
+    void Add(wxLongLong_t id, const wxString& name, const wxString& scope, const wxString& file);
+
+    /**
+     * @brief merge the entries added since the last call into the sorted arrays (if there are enough of them) and
+     * purge the removed entries (if there are enough of them). Call this after a batch of changes
+     */
+    void Commit();
+
+    /**
+     * @brief remove the tags of 'file' whose ID is smaller or equal to 'maxId' (-1 for all of them)
+     */
+    void RemoveFile(const wxString& file, wxLongLong_t maxId = -1);
+
+    /**
+     * @brief remove the tag with the given ID
+     */
+    void Remove(wxLongLong_t id);
+
+    /**
+     * @brief find the tags named 'name'
+     * @param scope when not empty, only the tags of this scope are returned
+     * @param flags eFlags
+     * @param limit maximum number of IDs to collect
+     * @param ids [output] the IDs are appended to it
+     */
+    void Find(const wxString& scope, const wxString& name, size_t flags, size_t limit,
+              std::vector<wxLongLong_t>& ids) const;
+
+    /**
+     * @brief find the tags whose name contains 'part' (ASCII letters are compared case insensitively)
+     */
+    void FindSubstring(const wxString& part, size_t limit, std::vector<wxLongLong_t>& ids) const;
+
+    /**
+     * @brief the greatest ID in the index (0 if empty)
+     */
+    wxLongLong_t GetLastId() const { return m_entries.empty() ? 0 : m_entries.back().id; }
+    size_t GetCount() const { return m_entries.size() - m_removedCount; }
+    MemoryUsage GetMemoryUsage() const;
+};
+
+#endif // TAGS_NAME_INDEX_H
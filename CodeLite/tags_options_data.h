@@ -105,6 +105,7 @@ protected:
     wxString m_clangMacros;
     wxString m_clangCachePolicy;
     size_t m_ccNumberOfDisplayItems;
+    size_t m_parserWorkers;
     size_t m_version;
 
 public:
@@ -135,6 +136,11 @@ public:
         this->m_ccNumberOfDisplayItems = ccNumberOfDisplayItems;
     }
     size_t GetCcNumberOfDisplayItems() const { return m_ccNumberOfDisplayItems; }
+    /**
+     * @brief number of codelite_indexer worker processes. 0 means: one worker per CPU
+     */
+    void SetParserWorkers(size_t parserWorkers) { this->m_parserWorkers = parserWorkers; }
+    size_t GetParserWorkers() const { return m_parserWorkers; }
     void SetClangCachePolicy(const wxString& clangCachePolicy) { this->m_clangCachePolicy = clangCachePolicy; }
     const wxString& GetClangCachePolicy() const { return m_clangCachePolicy; }
     void SetClangMacros(const wxString& clangMacros) { this->m_clangMacros = clangMacros; }
@@ -27,6 +27,8 @@
 #include "precompiled_header.h"
 #include "tags_storage_sqlite3.h"
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <wx/longlong.h>
 #include <wx/tokenzr.h>
 
@@ -81,6 +83,10 @@ void TagsStorageSQLite::OpenDatabase(const wxFileName& fileName)
     } catch(wxSQLite3Exception& e) {
         clWARNING() << "Failed to open file:" << m_fileName.GetFullPath() << "." << e.GetMessage();
     }
+
+    // the name index belongs to the previous database
+    m_nameIndex.Clear();
+    m_nameIndexDirty = true;
 }
 
 void TagsStorageSQLite::CreateSchema()
@@ -110,7 +116,7 @@ void TagsStorageSQLite::CreateSchema()
         m_db->ExecuteUpdate(sql);
 
         sql = wxT("create  table if not exists FILES (ID INTEGER PRIMARY KEY AUTOINCREMENT, file string, last_retagged "
-                  "integer);");
+                  "integer, hash integer);");
         m_db->ExecuteUpdate(sql);
 
         sql = wxT("create  table if not exists MACROS (ID INTEGER PRIMARY KEY AUTOINCREMENT, file string, line "
@@ -133,45 +139,21 @@ void TagsStorageSQLite::CreateSchema()
 
         m_db->ExecuteUpdate(trigger1);
 
-        wxString trigger2 = wxT("CREATE TRIGGER IF NOT EXISTS tags_insert AFTER INSERT ON tags ")
-            wxT("FOR EACH ROW WHEN NEW.scope = '<global>' ") wxT("BEGIN ")
-                wxT("    INSERT INTO global_tags (id, name, tag_id) VALUES (NULL, NEW.name, NEW.id);") wxT("END;");
-        m_db->ExecuteUpdate(trigger2);
-
         // Create unique index on tags table
         sql = wxT("CREATE UNIQUE INDEX IF NOT EXISTS TAGS_UNIQ on tags(kind, path, signature, typeref);");
         m_db->ExecuteUpdate(sql);
 
-        sql = wxT("CREATE INDEX IF NOT EXISTS KIND_IDX on tags(kind);");
-        m_db->ExecuteUpdate(sql);
-
         sql = wxT("CREATE INDEX IF NOT EXISTS FILE_IDX on tags(file);");
         m_db->ExecuteUpdate(sql);
 
         sql = wxT("CREATE UNIQUE INDEX IF NOT EXISTS MACROS_UNIQ on MACROS(name);");
         m_db->ExecuteUpdate(sql);
 
-        sql = wxT("CREATE INDEX IF NOT EXISTS global_tags_idx_1 on global_tags(name);");
-        m_db->ExecuteUpdate(sql);
-
         sql = wxT("CREATE INDEX IF NOT EXISTS global_tags_idx_2 on global_tags(tag_id);");
         m_db->ExecuteUpdate(sql);
 
-        // Create search indexes
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_NAME on tags(name);");
-        m_db->ExecuteUpdate(sql);
-
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_SCOPE on tags(scope);");
-        m_db->ExecuteUpdate(sql);
-
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_PATH on tags(path);");
-        m_db->ExecuteUpdate(sql);
-
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_PARENT on tags(parent);");
-        m_db->ExecuteUpdate(sql);
-
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_TYPEREF on tags(typeref);");
-        m_db->ExecuteUpdate(sql);
+        // Create search indexes (this also restores them if a bulk insert was interrupted)
+        DoCreateSearchIndexes();
 
         sql = wxT("CREATE INDEX IF NOT EXISTS MACROS_NAME on MACROS(name);");
         m_db->ExecuteUpdate(sql);
@@ -193,6 +175,84 @@ void TagsStorageSQLite::CreateSchema()
     }
 }
 
+void TagsStorageSQLite::DoCreateSearchIndexes()
+{
+    wxString trigger2 = wxT("CREATE TRIGGER IF NOT EXISTS tags_insert AFTER INSERT ON tags ")
+        wxT("FOR EACH ROW WHEN NEW.scope = '<global>' ") wxT("BEGIN ")
+            wxT("    INSERT INTO global_tags (id, name, tag_id) VALUES (NULL, NEW.name, NEW.id);") wxT("END;");
+    m_db->ExecuteUpdate(trigger2);
+
+    m_db->ExecuteUpdate(wxT("CREATE INDEX IF NOT EXISTS KIND_IDX on tags(kind);"));
+    m_db->ExecuteUpdate(wxT("CREATE INDEX IF NOT EXISTS global_tags_idx_1 on global_tags(name);"));
+    m_db->ExecuteUpdate(wxT("CREATE INDEX IF NOT EXISTS TAGS_NAME on tags(name);"));
+    m_db->ExecuteUpdate(wxT("CREATE INDEX IF NOT EXISTS TAGS_SCOPE on tags(scope);"));
+    m_db->ExecuteUpdate(wxT("CREATE INDEX IF NOT EXISTS TAGS_PATH on tags(path);"));
+    m_db->ExecuteUpdate(wxT("CREATE INDEX IF NOT EXISTS TAGS_PARENT on tags(parent);"));
+    m_db->ExecuteUpdate(wxT("CREATE INDEX IF NOT EXISTS TAGS_TYPEREF on tags(typeref);"));
+}
+
+void TagsStorageSQLite::DoDropSearchIndexes()
+{
+    // TAGS_UNIQ (needed by "INSERT OR REPLACE"), FILE_IDX and global_tags_idx_2 (needed for deleting)
+    // are kept
+    m_db->ExecuteUpdate(wxT("DROP TRIGGER IF EXISTS tags_insert"));
+    m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS KIND_IDX"));
+    m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS global_tags_idx_1"));
+    m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS TAGS_NAME"));
+    m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS TAGS_SCOPE"));
+    m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS TAGS_PATH"));
+    m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS TAGS_PARENT"));
+    m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS TAGS_TYPEREF"));
+}
+
+void TagsStorageSQLite::BeginBulkInsert()
+{
+    if(m_bulkInsert || !IsOpen()) return;
+
+    try {
+        // remember where the new rows start, the 'tags_insert' trigger work is done for them in EndBulkInsert()
+        wxSQLite3ResultSet rs = m_db->ExecuteQuery(wxT("SELECT IFNULL(MAX(ID), 0) FROM TAGS"));
+        m_bulkInsertLastId = rs.NextRow() ? rs.GetInt64(0) : wxLongLong(0);
+        rs.Finalize();
+
+        // The other threads keep looking up the database while we store the tags. Without its indexes, a
+        // populated database is slow to search: the indexes are only dropped while the database is (re)built
+        if(m_bulkInsertLastId > 0) {
+            clDEBUG() << "Bulk insert: the tags database is not empty, keeping its indexes" << clEndl;
+            return;
+        }
+
+        DoDropSearchIndexes();
+        m_bulkInsert = true;
+        ClearCache();
+
+    } catch(wxSQLite3Exception& e) {
+        clWARNING() << "Failed to start bulk insert:" << e.GetMessage() << clEndl;
+    }
+}
+
+void TagsStorageSQLite::EndBulkInsert()
+{
+    if(!m_bulkInsert) return;
+    m_bulkInsert = false;
+
+    try {
+        // Do what the 'tags_insert' trigger would have done for the new rows
+        wxSQLite3Statement st = m_db->PrepareStatement(
+            wxT("INSERT INTO global_tags (id, name, tag_id) SELECT NULL, name, id FROM tags WHERE id > ? AND scope = "
+                "'<global>'"));
+        st.Bind(1, m_bulkInsertLastId);
+        st.ExecuteUpdate();
+
+        // and rebuild the indexes, once
+        DoCreateSearchIndexes();
+
+    } catch(wxSQLite3Exception& e) {
+        clWARNING() << "Failed to complete bulk insert:" << e.GetMessage() << clEndl;
+    }
+    ClearCache();
+}
+
 void TagsStorageSQLite::RecreateDatabase()
 {
     try {
@@ -335,6 +395,7 @@ void TagsStorageSQLite::DeleteByFileName(const wxFileName& path, const wxString&
         m_db->ExecuteUpdate(sql);
 
         if(autoCommit) m_db->Commit();
+        if(m_useNameIndex) { m_nameIndex.RemoveFile(fileName); }
     } catch(wxSQLite3Exception& e) {
         wxUnusedVar(e);
         if(autoCommit) { m_db->Rollback(); }
@@ -418,6 +479,7 @@ void TagsStorageSQLite::GetFiles(const wxString& partialName, std::vector<FileEn
             fe->SetId(res.GetInt(0));
             fe->SetFile(res.GetString(1));
             fe->SetLastRetaggedTimestamp(res.GetInt(2));
+            fe->SetContentHash((wxUint64)res.GetInt64(3).GetValue());
 
             wxFileName fileName(fe->GetFile());
             wxString match = match_path ? fileName.GetFullPath() : fileName.GetFullName();
@@ -476,6 +538,7 @@ void TagsStorageSQLite::GetFiles(std::vector<FileEntryPtr>& files)
             fe->SetId(res.GetInt(0));
             fe->SetFile(res.GetString(1));
             fe->SetLastRetaggedTimestamp(res.GetInt(2));
+            fe->SetContentHash((wxUint64)res.GetInt64(3).GetValue());
 
             files.push_back(fe);
         }
@@ -648,6 +711,19 @@ void TagsStorageSQLite::GetTagsByScopeAndName(const wxString& scope, const wxStr
 {
     if(name.IsEmpty()) return;
 
+    if(DoSyncNameIndex()) {
+        // the global_tags table holds the tags of the '<global>' scope
+        size_t flags = (partialNameAllowed ? TagsNameIndex::kPartialMatch : 0) |
+                       (m_enableCaseInsensitive ? TagsNameIndex::kIgnoreCase : 0);
+        std::vector<wxLongLong_t> ids;
+        do {
+            ids.clear();
+            m_nameIndex.Find(scope.IsEmpty() ? wxString(wxT("<global>")) : scope, name, flags,
+                             GetSingleSearchLimit(), ids);
+        } while(!DoFetchTagsByIds(ids, tags));
+        return;
+    }
+
     wxString sql;
     sql << wxT("select * from tags where ");
 
@@ -821,13 +897,14 @@ int TagsStorageSQLite::DeleteFileEntry(const wxString& filename)
     return TagOk;
 }
 
-int TagsStorageSQLite::InsertFileEntry(const wxString& filename, int timestamp)
+int TagsStorageSQLite::InsertFileEntry(const wxString& filename, int timestamp, wxUint64 hash)
 {
     try {
         wxSQLite3Statement statement =
-            m_db->GetPrepareStatement(wxT("INSERT OR REPLACE INTO FILES VALUES(NULL, ?, ?)"));
+            m_db->GetPrepareStatement(wxT("INSERT OR REPLACE INTO FILES VALUES(NULL, ?, ?, ?)"));
         statement.Bind(1, filename);
         statement.Bind(2, timestamp);
+        statement.Bind(3, wxLongLong((wxLongLong_t)hash));
         statement.ExecuteUpdate();
 
     } catch(wxSQLite3Exception& exc) {
@@ -836,13 +913,14 @@ int TagsStorageSQLite::InsertFileEntry(const wxString& filename, int timestamp)
     return TagOk;
 }
 
-int TagsStorageSQLite::UpdateFileEntry(const wxString& filename, int timestamp)
+int TagsStorageSQLite::UpdateFileEntry(const wxString& filename, int timestamp, wxUint64 hash)
 {
     try {
         wxSQLite3Statement statement =
-            m_db->GetPrepareStatement(wxT("UPDATE OR REPLACE FILES SET last_retagged=? WHERE file=?"));
+            m_db->GetPrepareStatement(wxT("UPDATE OR REPLACE FILES SET last_retagged=?, hash=? WHERE file=?"));
         statement.Bind(1, timestamp);
-        statement.Bind(2, filename);
+        statement.Bind(2, wxLongLong((wxLongLong_t)hash));
+        statement.Bind(3, filename);
         statement.ExecuteUpdate();
 
     } catch(wxSQLite3Exception& exc) {
@@ -857,10 +935,12 @@ int TagsStorageSQLite::DoInsertTagEntry(const TagEntry& tag)
     if(!tag.IsOk()) return TagOk;
 
     // does not matter if we insert or update, the cache must be cleared for any related tags
-    if(GetUseCache()) { ClearCache(); }
+    // (in bulk insert mode, the cache is cleared once when the session begins and ends)
+    if(GetUseCache() && !m_bulkInsert) { ClearCache(); }
+    m_nameIndexDirty = true;
 
     try {
-        wxSQLite3Statement statement = m_db->GetPrepareStatement(
+        wxSQLite3Statement& statement = m_db->GetCachedStatement(
             wxT("INSERT OR REPLACE INTO TAGS VALUES (NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
         statement.Bind(1, tag.GetName());
         statement.Bind(2, tag.GetFile());
@@ -1172,7 +1252,19 @@ void TagsStorageSQLite::GetTagsByScopeAndName(const wxArrayString& scope, const
         GetTagsByScopeAndName(wxString(wxT("<global>")), name, partialNameAllowed, tags);
     }
 
-    if(scopes.IsEmpty() == false) {
+    if(scopes.IsEmpty() == false && DoSyncNameIndex()) {
+        size_t flags = (partialNameAllowed ? TagsNameIndex::kPartialMatch : 0) |
+                       (m_enableCaseInsensitive ? TagsNameIndex::kIgnoreCase : 0);
+        size_t limit = (size_t)GetSingleSearchLimit();
+        std::vector<wxLongLong_t> ids;
+        do {
+            ids.clear();
+            for(size_t i = 0; i < scopes.GetCount() && (tags.size() + ids.size()) < limit; ++i) {
+                m_nameIndex.Find(scopes.Item(i), name, flags, limit - tags.size() - ids.size(), ids);
+            }
+        } while(!DoFetchTagsByIds(ids, tags));
+
+    } else if(scopes.IsEmpty() == false) {
         wxString sql;
         sql << wxT("select * from tags where scope in(");
 
@@ -1387,10 +1479,108 @@ void TagsStorageSQLiteCache::DoStore(const wxString& key, const std::vector<TagE
     m_cache[key] = tags;
 }
 
-void TagsStorageSQLite::ClearCache() { m_cache.Clear(); }
+void TagsStorageSQLite::ClearCache()
+{
+    m_cache.Clear();
+    // the database was modified (possibly by another connection), pick up the new tags on the next lookup
+    m_nameIndexDirty = true;
+}
 
 void TagsStorageSQLite::SetUseCache(bool useCache) { ITagsStorage::SetUseCache(useCache); }
 
+void TagsStorageSQLite::SetUseNameIndex(bool useNameIndex)
+{
+    m_useNameIndex = useNameIndex;
+    m_nameIndex.Clear();
+    m_nameIndexDirty = true;
+}
+
+bool TagsStorageSQLite::DoSyncNameIndex()
+{
+    if(!m_useNameIndex || !IsOpen()) { return false; }
+    if(!m_nameIndexDirty) { return true; }
+
+    try {
+        wxLongLong_t lastId = m_nameIndex.GetLastId();
+        if(lastId > 0) {
+            // IDs are never reused, unless the database was re-created
+            wxSQLite3ResultSet rs = m_db->ExecuteQuery(wxT("SELECT IFNULL(MAX(ID), 0) FROM TAGS"));
+            if(rs.NextRow() && rs.GetInt64(0).GetValue() < lastId) {
+                m_nameIndex.Clear();
+                lastId = 0;
+            }
+            rs.Finalize();
+        }
+
+        // Load the tags added since the last sync. A file that was re-tagged gets new IDs: drop its older tags
+        wxSQLite3Statement st =
+            m_db->PrepareStatement(wxT("SELECT ID, name, scope, file FROM TAGS WHERE ID > ? ORDER BY ID"));
+        st.Bind(1, wxLongLong(lastId));
+        wxSQLite3ResultSet rs = st.ExecuteQuery();
+
+        std::unordered_set<wxString> files;
+        size_t count = 0;
+        while(rs.NextRow()) {
+            wxString file = rs.GetString(3);
+            if(lastId > 0 && files.insert(file).second) { m_nameIndex.RemoveFile(file, lastId); }
+            m_nameIndex.Add(rs.GetInt64(0).GetValue(), rs.GetString(1), rs.GetString(2), file);
+            ++count;
+        }
+        rs.Finalize();
+        m_nameIndex.Commit();
+        m_nameIndexDirty = false;
+
+        if(lastId == 0) {
+            clDEBUG() << "Tags name index loaded:" << count << "tags,"
+                      << (m_nameIndex.GetMemoryUsage().totalBytes / 1024) << "KB" << clEndl;
+        }
+        return true;
+
+    } catch(wxSQLite3Exception& e) {
+        clWARNING() << "Failed to update the tags name index:" << e.GetMessage() << clEndl;
+    }
+    return false;
+}
+
+bool TagsStorageSQLite::DoFetchTagsByIds(const std::vector<wxLongLong_t>& ids, std::vector<TagEntryPtr>& tags)
+{
+    if(ids.empty()) { return true; }
+
+    wxString sql;
+    sql << wxT("select * from tags where ID IN (");
+    for(size_t i = 0; i < ids.size(); ++i) {
+        if(i) { sql << wxT(","); }
+        sql << ids[i];
+    }
+    sql << wxT(")");
+
+    std::vector<TagEntryPtr> fetched;
+    DoFetchTags(sql, fetched);
+
+    // the rows come in the table order, put them back in the order of the IDs
+    std::unordered_map<wxLongLong_t, TagEntryPtr> found;
+    found.reserve(fetched.size());
+    for(size_t i = 0; i < fetched.size(); ++i) {
+        found.insert({ fetched[i]->GetId(), fetched[i] });
+    }
+
+    bool stale = false;
+    for(size_t i = 0; i < ids.size(); ++i) {
+        if(found.count(ids[i]) == 0) {
+            // deleted or replaced by another connection, forget it
+            m_nameIndex.Remove(ids[i]);
+            stale = true;
+        }
+    }
+    if(stale) { return false; }
+
+    tags.reserve(tags.size() + ids.size());
+    for(size_t i = 0; i < ids.size(); ++i) {
+        tags.push_back(found[ids[i]]);
+    }
+    return true;
+}
+
 PPToken TagsStorageSQLite::GetMacro(const wxString& name)
 {
     PPToken token;
@@ -1498,6 +1688,18 @@ void TagsStorageSQLite::GetTagsByName(const wxString& prefix, std::vector<TagEnt
     try {
         if(prefix.IsEmpty()) return;
 
+        if(DoSyncNameIndex()) {
+            size_t flags = (exactMatch ? 0 : TagsNameIndex::kPartialMatch) |
+                           (m_enableCaseInsensitive ? TagsNameIndex::kIgnoreCase : 0);
+            size_t limit = (size_t)GetSingleSearchLimit();
+            std::vector<wxLongLong_t> ids;
+            do {
+                ids.clear();
+                m_nameIndex.Find(wxEmptyString, prefix, flags, tags.size() < limit ? limit - tags.size() : 1, ids);
+            } while(!DoFetchTagsByIds(ids, tags));
+            return;
+        }
+
         wxString sql;
         sql << wxT("select * from tags where ");
         DoAddNamePartToQuery(sql, prefix, !exactMatch, false);
@@ -1576,6 +1778,16 @@ void TagsStorageSQLite::GetTagsByPartName(const wxString& partname, std::vector<
     try {
         if(partname.IsEmpty()) return;
 
+        if(DoSyncNameIndex()) {
+            size_t limit = (size_t)GetSingleSearchLimit();
+            std::vector<wxLongLong_t> ids;
+            do {
+                ids.clear();
+                m_nameIndex.FindSubstring(partname, tags.size() < limit ? limit - tags.size() : 1, ids);
+            } while(!DoFetchTagsByIds(ids, tags));
+            return;
+        }
+
         wxString tmpName(partname);
         tmpName.Replace(wxT("_"), wxT("^_"));
 
@@ -1657,7 +1869,7 @@ void TagsStorageSQLite::RemoveNonWorkspaceSymbols(const std::vector<wxString>& s
 
 const wxString& TagsStorageSQLite::GetVersion() const
 {
-    static const wxString gTagsDatabaseVersion(wxT("CodeLite Version 11.1"));
+    static const wxString gTagsDatabaseVersion(wxT("CodeLite Version 11.2"));
     return gTagsDatabaseVersion;
 }
 
@@ -30,6 +30,7 @@
 #include "fileentry.h"
 #include "istorage.h"
 #include "tag_tree.h"
+#include "tags_name_index.h"
 #include "wxStringHash.h"
 #include <unordered_map>
 #include <wx/filename.h>
@@ -73,6 +74,7 @@
  * | id           | Number | ID
  * | file         | String | Full path of the file
  * | last_retagged| Number | Timestamp for the last time this file was retagged
+ * | hash         | Number | xxHash of the file content when it was retagged (0 if unknown)
  *
  * Table Name: MACROS
  *
@@ -121,18 +123,37 @@ public:
 
     void Close()
     {
-        if(IsOpen()) wxSQLite3Database::Close();
-
+        // the cached statements must be finalized before the database is closed
         m_statements.clear();
+
+        if(IsOpen()) wxSQLite3Database::Close();
     }
 
     wxSQLite3Statement GetPrepareStatement(const wxString& sql) { return wxSQLite3Database::PrepareStatement(sql); }
+
+    /**
+     * @brief return a prepared statement for 'sql' which is compiled once and reused by the following calls.
+     * The statement is owned by the database: do not copy it (copying a wxSQLite3Statement moves its ownership)
+     */
+    wxSQLite3Statement& GetCachedStatement(const wxString& sql)
+    {
+        std::unordered_map<wxString, wxSQLite3Statement>::iterator iter = m_statements.find(sql);
+        if(iter == m_statements.end()) {
+            iter = m_statements.insert({ sql, wxSQLite3Database::PrepareStatement(sql) }).first;
+        }
+        return iter->second;
+    }
 };
 
 class WXDLLIMPEXP_CL TagsStorageSQLite : public ITagsStorage
 {
     clSqliteDB* m_db;
     TagsStorageSQLiteCache m_cache;
+    bool m_bulkInsert = false;
+    wxLongLong m_bulkInsertLastId = 0;
+    TagsNameIndex m_nameIndex;
+    bool m_useNameIndex = false;
+    bool m_nameIndexDirty = true;
 
 private:
     /**
@@ -152,6 +173,21 @@ private:
     void DoAddNamePartToQuery(wxString& sql, const wxString& name, bool partial, bool prependAnd);
     void DoAddLimitPartToQuery(wxString& sql, const std::vector<TagEntryPtr>& tags);
     int DoInsertTagEntry(const TagEntry& tag);
+    void DoCreateSearchIndexes();
+    void DoDropSearchIndexes();
+
+    /**
+     * @brief bring the name index up to date with the database (if needed)
+     * @return true if the name index can be used for lookups
+     */
+    bool DoSyncNameIndex();
+
+    /**
+     * @brief fetch the tags with the given IDs and append them to 'tags', in the order of 'ids'
+     * @return false if some of the IDs are no longer in the database. These IDs are removed from the name index and
+     * nothing is appended: the caller should look the IDs up again, so the stale IDs do not count against its limit
+     */
+    bool DoFetchTagsByIds(const std::vector<wxLongLong_t>& ids, std::vector<TagEntryPtr>& tags);
 
 public:
     static TagEntry* FromSQLite3ResultSet(wxSQLite3ResultSet& rs);
@@ -179,6 +215,13 @@ public:
 
     virtual void SetUseCache(bool useCache);
 
+    /**
+     * @brief answer GetTagsByScopeAndName, GetTagsByName and GetTagsByPartName from an in memory index of the tags
+     * names. The index is loaded on the first lookup and updated with the new tags when the cache is cleared
+     */
+    virtual void SetUseNameIndex(bool useNameIndex);
+    const TagsNameIndex& GetNameIndex() const { return m_nameIndex; }
+
     /**
      * Return the currently opened database.
      * @return Currently open database
@@ -290,6 +333,9 @@ public:
      */
     void Rollback() { return m_db->Rollback(); }
 
+    void BeginBulkInsert();
+    void EndBulkInsert();
+
     /**
      * Test whether the database is opened
      * @return true if database is attached to a file
@@ -496,17 +542,19 @@ public:
     /**
      * @brief insert entry by file name
      * @param filename
+     * @param hash the xxHash of the file content (0 if unknown)
      * @return
      */
-    virtual int InsertFileEntry(const wxString& filename, int timestamp);
+    virtual int InsertFileEntry(const wxString& filename, int timestamp, wxUint64 hash = 0);
 
     /**
      * @brief update file entry using file name as key
      * @param filename
      * @param timestamp new timestamp
+     * @param hash the xxHash of the file content (0 if unknown)
      * @return
      */
-    virtual int UpdateFileEntry(const wxString& filename, int timestamp);
+    virtual int UpdateFileEntry(const wxString& filename, int timestamp, wxUint64 hash = 0);
 
     /**
      * @brief return true if type exist under a given scope.
@@ -25,6 +25,7 @@
 
 #include "file_logger.h"
 #include "unixprocess_impl.h"
+#include "clProcessReactor.h"
 #include <cstring>
 #include "file_logger.h"
 #include "fileutils.h"
@@ -265,7 +266,6 @@ UnixProcessImpl::UnixProcessImpl(wxEvtHandler* parent)
     : IProcess(parent)
     , m_readHandle(-1)
     , m_writeHandle(-1)
-    , m_thr(NULL)
 {
 }
 
@@ -273,15 +273,11 @@ UnixProcessImpl::~UnixProcessImpl() { Cleanup(); }
 
 void UnixProcessImpl::Cleanup()
 {
+    // Stop reading before the handles are closed (and possibly reused)
+    Detach();
     close(GetReadHandle());
     close(GetWriteHandle());
     if(GetStderrHandle() != wxNOT_FOUND) { close(GetStderrHandle()); }
-    if(m_thr) {
-        // Stop the reader thread
-        m_thr->Stop();
-        delete m_thr;
-    }
-    m_thr = NULL;
 
     if(GetPid() != wxNOT_FOUND) {
         wxKill(GetPid(), GetHardKill() ? wxSIGKILL : wxSIGTERM, NULL, wxKILL_CHILDREN);
@@ -509,11 +505,17 @@ IProcess* UnixProcessImpl::Execute(wxEvtHandler* parent, const wxString& cmd, si
 
 void UnixProcessImpl::StartReaderThread()
 {
-    // Launch the 'Reader' thread
-    m_thr = new ProcessReaderThread();
-    m_thr->SetProcess(this);
-    m_thr->SetNotifyWindow(m_parent);
-    m_thr->Start();
+    // The output of all the processes is read by a single thread
+    m_registered = clProcessReactor::Get().Register(this, m_parent, IsRedirect() ? GetReadHandle() : wxNOT_FOUND,
+                                                    IsRedirect() ? GetStderrHandle() : wxNOT_FOUND,
+                                                    !(m_flags & IProcessRawOutput));
+    if(!m_registered) {
+        // Launch our own 'Reader' thread
+        m_thr = new ProcessReaderThread();
+        m_thr->SetProcess(this);
+        m_thr->SetNotifyWindow(m_parent);
+        m_thr->Start();
+    }
 }
 
 void UnixProcessImpl::Terminate()
@@ -536,6 +538,10 @@ bool UnixProcessImpl::WriteToConsole(const wxString& buff)
 
 void UnixProcessImpl::Detach()
 {
+    if(m_registered) {
+        clProcessReactor::Get().Unregister(this);
+        m_registered = false;
+    }
     if(m_thr) {
         // Stop the reader thread
         m_thr->Stop();
@@ -37,7 +37,8 @@ class WXDLLIMPEXP_CL UnixProcessImpl : public IProcess
     int m_readHandle;
     int m_stderrHandle = wxNOT_FOUND;
     int m_writeHandle;
-    ProcessReaderThread* m_thr = nullptr;
+    bool m_registered = false; // our output is read by clProcessReactor
+    ProcessReaderThread* m_thr = nullptr; // used when clProcessReactor can not watch our handles
     wxString m_tty;
     friend class wxTerminal;
 private:
@@ -0,0 +1,94 @@
+#include "benchmark.h"
+#include <atomic>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace
+{
+std::atomic<size_t> s_allocationsCount(0);
+}
+
+// count the heap allocations, see IBenchmark::GetAllocationsCount()
+void* operator new(size_t size)
+{
+    ++s_allocationsCount;
+    void* p = malloc(size == 0 ? 1 : size);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+
+Benchmarks* Benchmarks::ms_instance = 0;
+
+Benchmarks::Benchmarks()
+    : m_scale(1.0)
+{
+}
+
+Benchmarks::~Benchmarks() {}
+
+Benchmarks* Benchmarks::Instance()
+{
+    if(ms_instance == 0) {
+        ms_instance = new Benchmarks();
+    }
+    return ms_instance;
+}
+
+void Benchmarks::Release()
+{
+    if(ms_instance) {
+        delete ms_instance;
+    }
+    ms_instance = 0;
+}
+
+void Benchmarks::AddBenchmark(IBenchmark* b) { m_benchmarks.push_back(b); }
+
+size_t Benchmarks::RunBenchmarks(const wxString& filter)
+{
+    size_t count = 0;
+    size_t errors = 0;
+    for(size_t i = 0; i < m_benchmarks.size(); ++i) {
+        wxString name = m_benchmarks[i]->GetName();
+        if(!filter.IsEmpty() && !name.Contains(filter)) continue;
+
+        printf("----> %s\n", m_benchmarks[i]->GetName());
+        fflush(stdout);
+        ++count;
+        if(!m_benchmarks[i]->run()) {
+            printf("    %s: FAILED\n", m_benchmarks[i]->GetName());
+            ++errors;
+        }
+    }
+
+    printf("\n====> Summary: <====\n\n");
+    printf("    %u benchmarks executed, %u failed\n", (int)count, (int)errors);
+    return errors;
+}
+
+size_t IBenchmark::Scaled(size_t count) const
+{
+    size_t scaled = (size_t)(count * Benchmarks::Instance()->GetScale());
+    return scaled == 0 ? 1 : scaled;
+}
+
+void IBenchmark::Report(const wxString& what, size_t count, const wxString& unit, wxLongLong elapsedMs) const
+{
+    double ms = elapsedMs.ToDouble();
+    double perSec = ms > 0.0 ? (count * 1000.0 / ms) : 0.0;
+    printf("    %-40s: %10u %s in %8.0f ms (%12.0f %s/sec)\n",
+           (const char*)what.mb_str(wxConvUTF8).data(),
+           (unsigned)count,
+           (const char*)unit.mb_str(wxConvUTF8).data(),
+           ms,
+           perSec,
+           (const char*)unit.mb_str(wxConvUTF8).data());
+    fflush(stdout);
+}
+
+size_t IBenchmark::GetAllocationsCount() { return s_allocationsCount.load(); }
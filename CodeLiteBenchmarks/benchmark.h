@@ -0,0 +1,85 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <vector>
+#include <wx/stopwatch.h>
+#include <wx/string.h>
+
+class IBenchmark;
+/**
+ * @class Benchmarks
+ * @brief the benchmarks registry and runner
+ */
+class Benchmarks
+{
+    static Benchmarks* ms_instance;
+    std::vector<IBenchmark*> m_benchmarks;
+    double m_scale;
+
+public:
+    static Benchmarks* Instance();
+    static void Release();
+
+    void AddBenchmark(IBenchmark* b);
+
+    /**
+     * @brief run all the benchmarks whose name contains 'filter' (all of them if 'filter' is empty)
+     * @return the number of failed benchmarks
+     */
+    size_t RunBenchmarks(const wxString& filter);
+
+    /**
+     * @brief the workload size multiplier (1.0 by default). Benchmarks should scale their input sizes by it
+     */
+    void SetScale(double scale) { m_scale = scale; }
+    double GetScale() const { return m_scale; }
+
+private:
+    Benchmarks();
+    ~Benchmarks();
+};
+
+/**
+ * @class IBenchmark
+ * @brief the benchmark interface
+ */
+class IBenchmark
+{
+public:
+    IBenchmark() { Benchmarks::Instance()->AddBenchmark(this); }
+    virtual ~IBenchmark() {}
+    virtual const char* GetName() const = 0;
+    virtual bool run() = 0;
+
+    /**
+     * @brief return 'count' multiplied by the current scale (at least 1)
+     */
+    size_t Scaled(size_t count) const;
+
+    /**
+     * @brief print a single measurement line: "<what>: <count> <unit> in <ms> ms (<count/sec> <unit>/sec)"
+     */
+    void Report(const wxString& what, size_t count, const wxString& unit, wxLongLong elapsedMs) const;
+
+    /**
+     * @brief the number of heap allocations (operator new) made by the process so far. Take the difference
+     * between two calls to count the allocations of the code in between
+     */
+    static size_t GetAllocationsCount();
+};
+
+///////////////////////////////////////////////////////////
+// Helper macros:
+///////////////////////////////////////////////////////////
+
+#define BENCHMARK_FUNC(Name)                                  \
+    class Benchmark_##Name : public IBenchmark                \
+    {                                                         \
+    public:                                                   \
+        virtual const char* GetName() const { return #Name; } \
+        virtual bool run();                                   \
+    };                                                        \
+    Benchmark_##Name theBenchmark##Name;                      \
+    bool Benchmark_##Name::run()
+
+#endif // BENCHMARK_H
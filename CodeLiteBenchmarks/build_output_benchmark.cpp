@@ -0,0 +1,131 @@
+#include "benchmark.h"
+#include "clBuildOutputMatcher.h"
+#include <memory>
+#include <stdio.h>
+#include <vector>
+#include <wx/regex.h>
+
+// lines of build output at scale 1.0
+#define BENCH_BUILD_OUTPUT_LINES 200000
+
+namespace
+{
+struct GCCPattern {
+    const char* pattern;
+    clBuildOutputMatcher::eSeverity severity;
+    const char* fileIndex;
+    const char* lineIndex;
+    const char* columnIndex;
+};
+
+// the default GCC patterns, warnings first (the order in which the build tab tries them)
+const GCCPattern gccPatterns[] = {
+    { "([a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ *)(:)([0-9]+ *)(:)([0-9:]*)?[ \\t]*(warning|required)",
+      clBuildOutputMatcher::kSeverityWarning, "1", "3", "4" },
+    { "([a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ *)(:)([0-9]+ *)(:)([0-9:]*)?( note)",
+      clBuildOutputMatcher::kSeverityWarning, "1", "3", "-1" },
+    { "([a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ *)(:)([0-9]+ *)(:)([0-9:]*)?([ ]+instantiated)",
+      clBuildOutputMatcher::kSeverityWarning, "1", "3", "-1" },
+    { "(In file included from *)([a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ *)(:)([0-9]+ *)(:)([0-9:]*)?",
+      clBuildOutputMatcher::kSeverityWarning, "2", "4", "-1" },
+    { "^([^ ][a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ *)(:)([0-9]*)([:0-9]*)(: )((fatal "
+      "error)|(error)|(undefined reference)|([\\t ]*required from))",
+      clBuildOutputMatcher::kSeverityError, "1", "3", "4" },
+    { "^([^ ][a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ *)(:)([^ ][a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ "
+      "*)(:)(\\(\\.text\\+[0-9a-fx]*\\))",
+      clBuildOutputMatcher::kSeverityError, "3", "1", "-1" },
+    { "^([^ ][a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ *)(:)([^ ][a-zA-Z:]{0,2}[ a-zA-Z\\.0-9_/\\+\\-]+ "
+      "*)(:)([0-9]+)(:)",
+      clBuildOutputMatcher::kSeverityError, "3", "1", "-1" },
+    { "undefined reference to", clBuildOutputMatcher::kSeverityError, "-1", "-1", "-1" },
+    { "\\*\\*\\* \\[[a-zA-Z\\-_0-9 ]+\\] (Error)", clBuildOutputMatcher::kSeverityError, "-1", "-1", "-1" },
+};
+
+/**
+ * @brief the output of a large build: mostly compiler command lines with a few diagnostics
+ */
+std::vector<wxString> CreateBuildOutput(size_t count)
+{
+    std::vector<wxString> lines;
+    lines.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        wxString file;
+        file << "src/module_" << (i / 100) << "/source_file_" << i << ".cpp";
+        switch(i % 50) {
+        case 0:
+            lines.push_back("make[1]: Entering directory '/home/user/src/project/build/module_" +
+                            wxString::Format("%u", (unsigned)(i / 100)) + "'\n");
+            break;
+        case 7:
+            lines.push_back(file + ":120:17: warning: unused variable 'result' [-Wunused-variable]\n");
+            break;
+        case 8:
+            lines.push_back(file + ":98:5: note: declared here\n");
+            break;
+        case 21:
+            lines.push_back(file + ":42:9: error: 'Foo' was not declared in this scope\n");
+            break;
+        case 33:
+            lines.push_back("In file included from " + file + ":12:0:\n");
+            break;
+        default:
+            lines.push_back("/usr/bin/c++ -DNDEBUG -I/home/user/src/project/include -O2 -g -Wall -std=c++11 -o "
+                            "CMakeFiles/module.dir/source_file_" +
+                            wxString::Format("%u", (unsigned)i) + ".cpp.o -c /home/user/src/project/" + file + "\n");
+            break;
+        }
+    }
+    return lines;
+}
+} // namespace
+
+BENCHMARK_FUNC(BuildOutputMatcher)
+{
+    std::vector<wxString> lines = CreateBuildOutput(Scaled(BENCH_BUILD_OUTPUT_LINES));
+
+    // what the build tab did so far: try every pattern on every line
+    std::vector<std::shared_ptr<wxRegEx> > regexes;
+    for(const GCCPattern& p : gccPatterns) {
+        regexes.push_back(std::shared_ptr<wxRegEx>(new wxRegEx(p.pattern, wxRE_ADVANCED | wxRE_ICASE)));
+    }
+    std::vector<int> expected;
+    expected.reserve(lines.size());
+    wxStopWatch sw;
+    for(const wxString& line : lines) {
+        int severity = clBuildOutputMatcher::kSeverityNone;
+        for(size_t i = 0; i < regexes.size(); ++i) {
+            if(regexes[i]->Matches(line)) {
+                severity = gccPatterns[i].severity;
+                break;
+            }
+        }
+        expected.push_back(severity);
+    }
+    wxLongLong regexMs = sw.Time();
+
+    // the literals pre-filter
+    clBuildOutputMatcher matcher;
+    for(const GCCPattern& p : gccPatterns) {
+        matcher.Add(p.pattern, p.severity, p.fileIndex, p.lineIndex, p.columnIndex);
+    }
+    matcher.Compile();
+    size_t mismatches = 0;
+    size_t diagnostics = 0;
+    sw.Start();
+    for(size_t i = 0; i < lines.size(); ++i) {
+        clBuildOutputMatcher::Match match;
+        int severity = matcher.Matches(lines[i], match) ? match.severity : clBuildOutputMatcher::kSeverityNone;
+        if(severity != expected[i]) {
+            ++mismatches;
+        }
+        if(severity != clBuildOutputMatcher::kSeverityNone) {
+            ++diagnostics;
+        }
+    }
+    wxLongLong matcherMs = sw.Time();
+
+    Report("Match (all the patterns)", lines.size(), "lines", regexMs);
+    Report("Match (literals pre-filter)", lines.size(), "lines", matcherMs);
+    printf("    %u diagnostics, %u mismatches\n", (unsigned)diagnostics, (unsigned)mismatches);
+    return mismatches == 0;
+}
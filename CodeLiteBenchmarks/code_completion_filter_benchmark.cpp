@@ -0,0 +1,155 @@
+#include "benchmark.h"
+#include "clCodeCompletionFilter.h"
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+// the size of the completion list at scale 1.0 (a global tags or LSP list)
+#define BENCH_CC_FILTER_ENTRIES 20000
+
+namespace
+{
+const char* words[] = { "GetFileName", "m_count", "setbuf", "wxstr", "OnSize", "gfn" };
+
+/**
+ * @brief identifiers made of the usual words, in different styles
+ */
+std::vector<wxString> CreateKeys(size_t count)
+{
+    static const char* parts[] = { "get",  "Set",    "File", "name", "_path", "Buffer", "m_",    "size",
+                                   "Count", "on",    "Str",  "wx",   "Item",  "Data",   "Value", "Is" };
+    const size_t partsCount = sizeof(parts) / sizeof(parts[0]);
+    std::vector<wxString> keys;
+    keys.reserve(count);
+    unsigned seed = 1;
+    for(size_t i = 0; i < count; ++i) {
+        wxString key;
+        size_t len = 1 + (i % 4);
+        for(size_t j = 0; j < len; ++j) {
+            seed = seed * 1103515245 + 12345;
+            key << parts[(seed >> 16) % partsCount];
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+/**
+ * @brief what wxCodeCompletionBox::FilterResults did so far: lower case every entry and look for the filter in it
+ */
+size_t OldFilter(const std::vector<wxString>& keys, const wxString& word, std::vector<size_t>& matches)
+{
+    matches.clear();
+    wxString lcFilter = word.Lower();
+    std::vector<size_t> exactMatches, exactMatchesI, startsWith, startsWithI, contains, containsI;
+    for(size_t i = 0; i < keys.size(); ++i) {
+        const wxString& entryText = keys[i];
+        wxString lcEntryText = entryText.Lower();
+        if(word == entryText) {
+            exactMatches.push_back(i);
+        } else if(lcEntryText == lcFilter) {
+            exactMatchesI.push_back(i);
+        } else if(entryText.StartsWith(word)) {
+            startsWith.push_back(i);
+        } else if(lcEntryText.StartsWith(lcFilter)) {
+            startsWithI.push_back(i);
+        } else if(entryText.Contains(word)) {
+            contains.push_back(i);
+        } else if(lcEntryText.Contains(lcFilter)) {
+            containsI.push_back(i);
+        }
+    }
+    matches.insert(matches.end(), exactMatches.begin(), exactMatches.end());
+    matches.insert(matches.end(), exactMatchesI.begin(), exactMatchesI.end());
+    matches.insert(matches.end(), startsWith.begin(), startsWith.end());
+    matches.insert(matches.end(), startsWithI.begin(), startsWithI.end());
+    matches.insert(matches.end(), contains.begin(), contains.end());
+    matches.insert(matches.end(), containsI.begin(), containsI.end());
+    return exactMatches.size() + exactMatchesI.size() + startsWith.size() + startsWithI.size();
+}
+
+/**
+ * @brief the exact, 'starts with' and 'contains' matches must come in the same order
+ */
+bool SameMatches(clCodeCompletionFilter& filter, const std::vector<size_t>& oldMatches, size_t oldStartsWithCount)
+{
+    if(filter.GetStartsWithCount() != oldStartsWithCount || filter.GetContainsCount() != oldMatches.size() ||
+       filter.GetMatchesCount() < oldMatches.size()) {
+        return false;
+    }
+    std::vector<size_t> newMatches;
+    for(size_t i = 0; i < oldMatches.size(); ++i) {
+        newMatches.push_back(filter.GetMatch(i));
+    }
+    return std::equal(oldMatches.begin(), oldMatches.end(), newMatches.begin());
+}
+} // namespace
+
+BENCHMARK_FUNC(CodeCompletionFilter)
+{
+    std::vector<wxString> keys = CreateKeys(Scaled(BENCH_CC_FILTER_ENTRIES));
+    const size_t wordsCount = sizeof(words) / sizeof(words[0]);
+
+    // type every word one character at a time
+    size_t keystrokes = 0;
+    for(size_t i = 0; i < wordsCount; ++i) {
+        keystrokes += wxString(words[i]).length();
+    }
+
+    std::vector<size_t> oldMatches;
+    size_t allocations = GetAllocationsCount();
+    wxStopWatch sw;
+    for(size_t i = 0; i < wordsCount; ++i) {
+        wxString word = words[i];
+        for(size_t len = 1; len <= word.length(); ++len) {
+            OldFilter(keys, word.Left(len), oldMatches);
+        }
+    }
+    wxLongLong oldMs = sw.Time();
+    size_t oldAllocations = GetAllocationsCount() - allocations;
+
+    // the keys are normalized once, when the list is shown. Then every keystroke narrows the previous matches
+    clCodeCompletionFilter filter;
+    sw.Start();
+    for(size_t i = 0; i < keys.size(); ++i) {
+        filter.AddKey(keys[i]);
+    }
+    wxLongLong addMs = sw.Time();
+
+    std::vector<wxString> prefixes;
+    for(size_t i = 0; i < wordsCount; ++i) {
+        wxString word = words[i];
+        for(size_t len = 1; len <= word.length(); ++len) {
+            prefixes.push_back(word.Left(len));
+        }
+    }
+    allocations = GetAllocationsCount();
+    sw.Start();
+    for(size_t i = 0; i < prefixes.size(); ++i) {
+        filter.Filter(prefixes[i]);
+        // the list displays the first rows
+        for(size_t row = 0; row < std::min(filter.GetMatchesCount(), (size_t)20); ++row) {
+            filter.GetMatch(row);
+        }
+    }
+    wxLongLong newMs = sw.Time();
+    size_t newAllocations = GetAllocationsCount() - allocations;
+
+    Report("Filter (lower case + contains)", keystrokes * keys.size(), "entries", oldMs);
+    Report("Normalize the keys", keys.size(), "entries", addMs);
+    Report("Filter (incremental)", keystrokes * keys.size(), "entries", newMs);
+    printf("    Allocations per keystroke: %.1f (lower case + contains), %.1f (incremental)\n",
+           (double)oldAllocations / keystrokes, (double)newAllocations / keystrokes);
+
+    for(size_t i = 0; i < prefixes.size(); ++i) {
+        size_t oldStartsWithCount = OldFilter(keys, prefixes[i], oldMatches);
+        filter.Filter(prefixes[i]);
+        if(!SameMatches(filter, oldMatches, oldStartsWithCount)) {
+            printf("    The matches of '%s' differ\n", (const char*)prefixes[i].mb_str(wxConvUTF8).data());
+            return false;
+        }
+    }
+    printf("    %u keystrokes, %u fuzzy matches for '%s'\n", (unsigned)keystrokes,
+           (unsigned)(filter.GetMatchesCount() - filter.GetContainsCount()), words[wordsCount - 1]);
+    return true;
+}
@@ -0,0 +1,130 @@
+#include "benchmark.h"
+#include "entry.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <wx/ffile.h>
+#include <wx/tokenzr.h>
+#include <wx/utils.h>
+
+// 200,000 ctags lines at scale 1.0
+#define BENCH_CTAGS_LINES 200000
+
+namespace
+{
+/**
+ * @brief the ctags output to parse: the content of the file pointed by $CL_BENCH_CTAGS_FILE (e.g. a captured
+ * indexer reply) if set, a synthetic output otherwise
+ */
+std::string LoadCtagsOutput(size_t linesCount)
+{
+    std::string output;
+    wxString capturedFile;
+    if(::wxGetEnv("CL_BENCH_CTAGS_FILE", &capturedFile)) {
+        wxFFile fp(capturedFile, "rb");
+        if(fp.IsOpened()) {
+            output.resize((size_t)fp.Length());
+            output.resize(fp.Read(&output[0], output.size()));
+            printf("    Using the ctags output from: %s\n", (const char*)capturedFile.mb_str(wxConvUTF8).data());
+            return output;
+        }
+    }
+
+    for(size_t i = 0; i < linesCount; ++i) {
+        std::string n = std::to_string(i);
+        std::string file = "/home/user/src/project/module_" + std::to_string(i / 100) + "/file.cpp";
+        switch(i % 4) {
+        case 0:
+            output += "Class_" + n + "\t" + file + "\t/^class Class_" + n + " : public Base {$/;\"\tclass\tline:" +
+                      n + "\tinherits:Base\n";
+            break;
+        case 1:
+            output += "Method_" + n + "\t" + file + "\t/^void Class::Method_" + n +
+                      "(int a, const wxString& b) {$/;\"\tfunction\tline:" + n +
+                      "\tclass:ns::Class\tsignature:(int a, const wxString& b)\taccess:public\n";
+            break;
+        case 2:
+            output += "m_member" + n + "\t" + file + "\t/^    std::vector<int> m_member" + n + ";$/;\"\tmember\tline:" +
+                      n + "\tclass:ns::Class\taccess:private\n";
+            break;
+        default:
+            output += "kValue" + n + "\t" + file + "\t/^    kValue" + n + ",$/;\"\tenumerator\tline:" + n +
+                      "\tenum:ns::Class::eKind\n";
+            break;
+        }
+    }
+    return output;
+}
+
+bool SameTag(const TagEntry& a, const TagEntry& b)
+{
+    return a.GetName() == b.GetName() && a.GetKind() == b.GetKind() && a.GetFile() == b.GetFile() &&
+           a.GetPattern() == b.GetPattern() && a.GetLine() == b.GetLine() && a.GetScope() == b.GetScope() &&
+           a.GetSignature() == b.GetSignature() && a.GetAccess() == b.GetAccess() &&
+           a.GetInheritsAsString() == b.GetInheritsAsString();
+}
+} // namespace
+
+BENCHMARK_FUNC(CtagsLineParser)
+{
+    std::string output = LoadCtagsOutput(Scaled(BENCH_CTAGS_LINES));
+
+    // the previous code path: convert the whole reply to wxString, split it into lines and parse each line
+    std::vector<TagEntry> oldTags;
+    size_t allocations = GetAllocationsCount();
+    wxStopWatch sw;
+    {
+        wxString tags(output.c_str(), wxConvUTF8, output.length());
+        wxArrayString lines = ::wxStringTokenize(tags, "\r\n", wxTOKEN_STRTOK);
+        oldTags.reserve(lines.size());
+        for(const wxString& line : lines) {
+            TagEntry tag;
+            tag.FromLine(line);
+            oldTags.push_back(tag);
+        }
+    }
+    wxLongLong oldMs = sw.Time();
+    size_t oldAllocations = GetAllocationsCount() - allocations;
+
+    // parse the lines directly from the UTF-8 buffer
+    std::vector<TagEntry> newTags;
+    newTags.reserve(oldTags.size());
+    allocations = GetAllocationsCount();
+    sw.Start();
+    {
+        const char* p = output.c_str();
+        const char* end = p + output.length();
+        while(p < end) {
+            const char* eol = p;
+            while(eol < end && *eol != '\n' && *eol != '\r') {
+                ++eol;
+            }
+            if(eol > p) {
+                TagEntry tag;
+                tag.FromLine(p, eol - p);
+                newTags.push_back(tag);
+            }
+            p = eol + 1;
+        }
+    }
+    wxLongLong newMs = sw.Time();
+    size_t newAllocations = GetAllocationsCount() - allocations;
+
+    Report("Parse (wxString lines)", oldTags.size(), "tags", oldMs);
+    Report("Parse (UTF-8 buffer)", newTags.size(), "tags", newMs);
+    printf("    Allocations per tag: %.1f (wxString lines), %.1f (UTF-8 buffer)\n",
+           oldTags.empty() ? 0.0 : (double)oldAllocations / oldTags.size(),
+           newTags.empty() ? 0.0 : (double)newAllocations / newTags.size());
+
+    if(oldTags.size() != newTags.size()) {
+        printf("    Tags count mismatch: %u != %u\n", (unsigned)oldTags.size(), (unsigned)newTags.size());
+        return false;
+    }
+    for(size_t i = 0; i < oldTags.size(); ++i) {
+        if(!SameTag(oldTags[i], newTags[i])) {
+            printf("    Tag %u differs: %s\n", (unsigned)i, (const char*)oldTags[i].GetName().mb_str(wxConvUTF8).data());
+            return false;
+        }
+    }
+    return true;
+}
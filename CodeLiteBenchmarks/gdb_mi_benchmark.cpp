@@ -0,0 +1,211 @@
+#include "benchmark.h"
+#include "clGdbMIParser.h"
+#include <algorithm>
+#include <stdio.h>
+#include <wx/arrstr.h>
+#include <wx/ffile.h>
+#include <wx/regex.h>
+#include <wx/tokenzr.h>
+#include <wx/utils.h>
+
+// the size of the MI output replayed at scale 1.0
+#define BENCH_GDB_MI_BYTES (100 * 1024 * 1024)
+// the size of the chunks the debugger output arrives in
+#define BENCH_GDB_MI_CHUNK 4000
+
+namespace
+{
+/**
+ * @brief the transcript to replay: the file pointed by $CL_BENCH_GDB_MI_TRANSCRIPT if set, a synthetic one (a
+ * session stopping in a deep call stack with many shared libraries) otherwise
+ */
+wxString LoadTranscript()
+{
+    wxString capturedFile;
+    if(::wxGetEnv("CL_BENCH_GDB_MI_TRANSCRIPT", &capturedFile)) {
+        wxFFile fp(capturedFile, "rb");
+        wxString content;
+        if(fp.IsOpened() && fp.ReadAll(&content, wxConvUTF8) && !content.IsEmpty()) {
+            printf("    Using the MI transcript: %s\n", (const char*)capturedFile.mb_str(wxConvUTF8).data());
+            return content;
+        }
+    }
+
+    wxString transcript;
+    for(size_t i = 0; i < 200; ++i) {
+        transcript << "=library-loaded,id=\"/usr/lib/x86_64-linux-gnu/libmodule_" << i
+                   << ".so\",target-name=\"/usr/lib/x86_64-linux-gnu/libmodule_" << i
+                   << ".so\",host-name=\"/usr/lib/x86_64-linux-gnu/libmodule_" << i
+                   << ".so\",symbols-loaded=\"0\",thread-group=\"i1\",ranges=[{from=\"0x00007ffff7dd5090\",to="
+                      "\"0x00007ffff7df5c00\"}]\n";
+    }
+    transcript << "~\"Breakpoint 1 at 0x4011a6: file /home/user/src/project/main.cpp, line 42.\\n\"\n";
+    transcript << "00000012^done,bkpt={number=\"12\",type=\"breakpoint\",disp=\"keep\",enabled=\"y\",addr="
+                  "\"0x00000000004011a6\",func=\"main(int, char**)\",file=\"main.cpp\",fullname=\"/home/user/src/"
+                  "project/main.cpp\",line=\"42\",thread-groups=[\"i1\"],times=\"0\",original-location=\"main.cpp:42\"}\n";
+    transcript << "(gdb) \n";
+    transcript << "*stopped,reason=\"breakpoint-hit\",disp=\"keep\",bkptno=\"12\",frame={addr=\"0x00000000004011a6\","
+                  "func=\"main\",args=[{name=\"argc\",value=\"1\"},{name=\"argv\",value=\"0x7fffffffe0b8\"}],file="
+                  "\"main.cpp\",fullname=\"/home/user/src/project/main.cpp\",line=\"42\"},thread-id=\"1\","
+                  "stopped-threads=\"all\",core=\"3\"\n";
+    transcript << "00000013^done,depth=\"64\"\n";
+    transcript << "00000014^done,stack=[";
+    for(size_t i = 0; i < 64; ++i) {
+        transcript << (i ? "," : "") << "frame={level=\"" << i << "\",addr=\"0x00000000004011a6\",func=\"Namespace::"
+                   << "Class::Method_" << i << "(std::vector<int, std::allocator<int> > const&)\",file=\"source_" << i
+                   << ".cpp\",fullname=\"/home/user/src/project/source_" << i << ".cpp\",line=\"" << (i * 10 + 1)
+                   << "\"}";
+    }
+    transcript << "]\n";
+    transcript << "00000015^done,numchild=\"100\",children=[";
+    for(size_t i = 0; i < 100; ++i) {
+        transcript << (i ? "," : "") << "child={name=\"var1.[" << i << "]\",exp=\"[" << i
+                   << "]\",numchild=\"0\",value=\"\\\"caf\\303\\251 " << i << "\\\"\",type=\"std::string\",thread-id="
+                   << "\"1\"}";
+    }
+    transcript << "],has_more=\"0\"\n";
+    for(size_t i = 0; i < 50; ++i) {
+        transcript << "~\"0x00007ffff7dd5090  0x00007ffff7df5c00  Yes         /usr/lib/x86_64-linux-gnu/libmodule_" << i
+                   << ".so\\n\"\n";
+    }
+    transcript << "(gdb) \n";
+    return transcript;
+}
+
+/**
+ * @brief feed 'transcript' 'count' times to 'consume', in chunks
+ */
+template <typename Func> void Replay(const wxString& transcript, size_t count, Func consume)
+{
+    size_t offset = 0;
+    size_t total = transcript.length() * count;
+    for(size_t fed = 0; fed < total;) {
+        size_t len = std::min((size_t)BENCH_GDB_MI_CHUNK, transcript.length() - offset);
+        consume(transcript.Mid(offset, len));
+        fed += len;
+        offset = (offset + len) % transcript.length();
+    }
+}
+
+struct Totals {
+    size_t lines = 0;
+    size_t invalid = 0;   // lines that are not MI records
+    long breakpoints = 0; // the sum of the breakpoint ids found, as a checksum
+    long depth = 0;
+
+    bool operator==(const Totals& other) const
+    {
+        return lines == other.lines && invalid == other.invalid && breakpoints == other.breakpoints &&
+               depth == other.depth;
+    }
+};
+
+void ProcessRecords(clGdbMIOutputQueue& queue, clGdbMIRecord& record, Totals& totals)
+{
+    wxString line;
+    while(queue.Pop(line)) {
+        ++totals.lines;
+        if(!clGdbMIParser::Parse(line, record)) {
+            ++totals.invalid;
+            continue;
+        }
+        long number;
+        if(record.resultClass == "done" && record["bkpt"]["number"].GetLong(number)) {
+            totals.breakpoints += number;
+        } else if(record["bkptno"].GetLong(number)) {
+            totals.breakpoints += number;
+        } else if(record["depth"].GetLong(number)) {
+            totals.depth += number;
+        }
+    }
+}
+} // namespace
+
+BENCHMARK_FUNC(GdbMIReplay)
+{
+    wxString transcript = LoadTranscript();
+    if(!transcript.EndsWith("\n")) {
+        transcript << "\n";
+    }
+    size_t count = std::max((size_t)1, Scaled(BENCH_GDB_MI_BYTES) / transcript.length());
+    size_t total = transcript.length() * count;
+
+    // what the debugger did so far: tokenize every chunk, consume the lines with RemoveAt(0) and run the regexes
+    Totals before;
+    {
+        static wxRegEx reBreak(wxT("done,bkpt={number=\"([0-9]+)\""));
+        static wxRegEx reGetBreakNo(wxT("bkptno=\"([0-9]+)\""));
+        static wxRegEx reFrameDepth(wxT("depth=\"([0-9]+)\""));
+        wxArrayString outputArr;
+        wxString incompleteLine;
+        wxStopWatch sw;
+        Replay(transcript, count, [&](const wxString& bufferRead) {
+            wxArrayString lines = wxStringTokenize(bufferRead, "\n", wxTOKEN_STRTOK);
+            if(lines.IsEmpty()) {
+                return;
+            }
+            if(!incompleteLine.empty()) {
+                lines.Item(0).Prepend(incompleteLine);
+                incompleteLine.Clear();
+            }
+            if(!bufferRead.EndsWith(wxT("\n"))) {
+                incompleteLine = lines.Last();
+                lines.RemoveAt(lines.GetCount() - 1);
+            }
+            for(size_t i = 0; i < lines.GetCount(); ++i) {
+                wxString& line = lines.Item(i);
+                line.Replace(wxT("(gdb)"), wxT(""));
+                line.Trim().Trim(false);
+                if(!line.IsEmpty()) {
+                    outputArr.Add(line);
+                }
+            }
+            while(!outputArr.IsEmpty()) {
+                wxString line = outputArr.Item(0);
+                outputArr.RemoveAt(0);
+                ++before.lines;
+                long number;
+                if(reBreak.Matches(line) && reBreak.GetMatch(line, 1).ToLong(&number)) {
+                    before.breakpoints += number;
+                } else if(reGetBreakNo.Matches(line) && reGetBreakNo.GetMatch(line, 1).ToLong(&number)) {
+                    before.breakpoints += number;
+                } else if(reFrameDepth.Matches(line) && reFrameDepth.GetMatch(line, 1).ToLong(&number)) {
+                    before.depth += number;
+                }
+            }
+        });
+        Report("Replay (tokenize + regex)", total, "chars", sw.Time());
+    }
+
+    // the output queue + the MI parser
+    Totals after;
+    {
+        clGdbMIOutputQueue queue;
+        clGdbMIRecord record;
+        wxStopWatch sw;
+        Replay(transcript, count, [&](const wxString& bufferRead) {
+            queue.Append(bufferRead);
+            ProcessRecords(queue, record, after);
+        });
+        Report("Replay (queue + MI parser)", total, "chars", sw.Time());
+    }
+
+    // the chunks must be framed like the whole transcript. The tokenizer is not a reference: it joins two lines when
+    // a chunk starts with the line feed that ends the previous one
+    Totals expected;
+    {
+        clGdbMIOutputQueue queue;
+        clGdbMIRecord record;
+        queue.Append(transcript);
+        ProcessRecords(queue, record, expected);
+        expected.lines *= count;
+        expected.invalid *= count;
+        expected.breakpoints *= count;
+        expected.depth *= count;
+    }
+
+    printf("    %u lines (%u not MI records, %u with the tokenizer), checksums: %ld/%ld (%ld/%ld with the regexes)\n",
+           (unsigned)after.lines, (unsigned)after.invalid, (unsigned)before.lines, after.breakpoints, after.depth,
+           before.breakpoints, before.depth);
+    return after == expected;
+}
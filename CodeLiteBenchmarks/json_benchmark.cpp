@@ -0,0 +1,217 @@
+#include "CompileCommandsIndex.h"
+#include "JSON.h"
+#include "benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+// ~50MB of compile_commands.json at scale 1.0
+#define BENCH_COMPILE_COMMANDS 110000
+// a large code completion reply, parsed BENCH_COMPLETION_REPLIES times
+#define BENCH_COMPLETION_ITEMS 10000
+#define BENCH_COMPLETION_REPLIES 20
+
+namespace
+{
+/**
+ * @brief the compile_commands.json to parse: the file pointed by $CL_BENCH_COMPILE_COMMANDS if set, a synthetic one
+ * (formatted like the CMake output) otherwise
+ */
+std::string LoadCompileCommands(size_t count)
+{
+    std::string content;
+    wxString capturedFile;
+    if(::wxGetEnv("CL_BENCH_COMPILE_COMMANDS", &capturedFile)) {
+        wxFFile fp(capturedFile, "rb");
+        if(fp.IsOpened()) {
+            content.resize((size_t)fp.Length());
+            content.resize(fp.Read(&content[0], content.size()));
+            printf("    Using the compilation database: %s\n", (const char*)capturedFile.mb_str(wxConvUTF8).data());
+            return content;
+        }
+    }
+
+    content = "[\n";
+    for(size_t i = 0; i < count; ++i) {
+        std::string dir = "/home/user/src/project/module_" + std::to_string(i / 100);
+        std::string file = dir + "/source_file_" + std::to_string(i) + ".cpp";
+        content += "{\n  \"directory\": \"/home/user/src/project/build\",\n";
+        content += "  \"command\": \"/usr/bin/c++ -DWXUSINGDLL -D__WXGTK__ -DNDEBUG -I/home/user/src/project/include "
+                   "-I/usr/lib/x86_64-linux-gnu/wx/include/gtk3-unicode-3.0 -I/usr/include/wx-3.0 "
+                   "-I" +
+                   dir + " -O2 -g -Wall -std=c++11 -o CMakeFiles/module.dir/source_file_" + std::to_string(i) +
+                   ".cpp.o -c " + file + "\",\n";
+        content += "  \"file\": \"" + file + "\"\n}";
+        content += (i + 1 < count) ? ",\n" : "\n";
+    }
+    content += "]";
+    return content;
+}
+
+/**
+ * @brief a textDocument/completion reply, similar to the ones sent by clangd
+ */
+std::string CreateCompletionReply(size_t count)
+{
+    std::string reply = "{\"id\":42,\"jsonrpc\":\"2.0\",\"result\":{\"isIncomplete\":true,\"items\":[";
+    for(size_t i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        if(i) {
+            reply += ",";
+        }
+        reply += "{\"detail\":\"void\",\"documentation\":{\"kind\":\"plaintext\",\"value\":\"Set the \\\"value\\\" of "
+                 "item " +
+                 n + "\\n\\tSee also: Get" + n + "()\"},\"filterText\":\"SetValue" + n +
+                 "\",\"insertText\":\"SetValue" + n + "\",\"insertTextFormat\":1,\"kind\":2,\"label\":\" SetValue" +
+                 n + "(const wxString &value)\",\"score\":0.5" + n +
+                 ",\"sortText\":\"3f2ccccdSetValue\",\"textEdit\":{\"newText\":\"SetValue" + n +
+                 "\",\"range\":{\"end\":{\"character\":12,\"line\":120},\"start\":{\"character\":8,\"line\":120}}}}";
+    }
+    reply += "]}}";
+    return reply;
+}
+} // namespace
+
+BENCHMARK_FUNC(JSONCompileCommands)
+{
+    std::string content = LoadCompileCommands(Scaled(BENCH_COMPILE_COMMANDS));
+    size_t bytes = content.length();
+
+    size_t allocations = GetAllocationsCount();
+    wxStopWatch sw;
+    JSON root(std::move(content));
+    wxLongLong parseMs = sw.Time();
+    size_t parseAllocations = GetAllocationsCount() - allocations;
+    if(!root.isOk()) {
+        printf("    Failed to parse the compilation database\n");
+        return false;
+    }
+
+    // read the entries the way the code completion does
+    JSONItem arr = root.toElement();
+    size_t count = arr.arraySize();
+    size_t totalLength = 0;
+    sw.Start();
+    for(size_t i = 0; i < count; ++i) {
+        JSONItem entry = arr.arrayItem(i);
+        totalLength += entry.namedObject("file").toString().length();
+        totalLength += entry.namedObject("directory").toString().length();
+        totalLength += entry.namedObject("command").toString().length();
+    }
+    wxLongLong walkMs = sw.Time();
+
+    sw.Start();
+    size_t formattedLength = 0;
+    char* formatted = arr.FormatRawString(true);
+    wxLongLong formatMs = sw.Time();
+    if(formatted) {
+        formattedLength = strlen(formatted);
+    }
+
+    Report("Parse", bytes / 1024, "KB", parseMs);
+    Report("Read entries", count, "entries", walkMs);
+    Report("Format", formattedLength / 1024, "KB", formatMs);
+    printf("    Allocations while parsing: %u (%u entries, %u characters read)\n", (unsigned)parseAllocations,
+           (unsigned)count, (unsigned)totalLength);
+
+    // the formatted output parses back to the same document
+    bool ok = false;
+    if(formatted) {
+        JSON again(formatted, formattedLength);
+        char* formattedAgain = again.toElement().FormatRawString(true);
+        ok = formattedAgain && strcmp(formatted, formattedAgain) == 0;
+        free(formattedAgain);
+    }
+    free(formatted);
+    if(!ok) {
+        printf("    The formatted compilation database does not parse back to the same content\n");
+    }
+    return ok;
+}
+
+BENCHMARK_FUNC(JSONCompletionReply)
+{
+    std::string reply = CreateCompletionReply(Scaled(BENCH_COMPLETION_ITEMS));
+
+    size_t itemsCount = 0;
+    size_t labelsLength = 0;
+    size_t allocations = GetAllocationsCount();
+    wxStopWatch sw;
+    for(size_t i = 0; i < BENCH_COMPLETION_REPLIES; ++i) {
+        // what ResponseMessage does with a reply
+        JSON json(reply.c_str(), reply.length());
+        JSONItem items = json.toElement().namedObject("result").namedObject("items");
+        int count = items.arraySize();
+        for(int j = 0; j < count; ++j) {
+            JSONItem item = items.arrayItem(j);
+            labelsLength += item.namedObject("label").toString().length();
+            labelsLength += item.namedObject("textEdit").namedObject("newText").toString().length();
+            labelsLength += item["textEdit"]["range"]["start"]["line"].toInt();
+        }
+        itemsCount += count;
+    }
+    wxLongLong ms = sw.Time();
+    size_t totalAllocations = GetAllocationsCount() - allocations;
+
+    Report("Parse and read completion replies", itemsCount, "items", ms);
+    printf("    Reply size: %u KB, allocations per item: %.1f (%u characters read)\n", (unsigned)(reply.length() / 1024),
+           itemsCount ? (double)totalAllocations / itemsCount : 0.0, (unsigned)labelsLength);
+    return itemsCount == Scaled(BENCH_COMPLETION_ITEMS) * BENCH_COMPLETION_REPLIES;
+}
+
+BENCHMARK_FUNC(CompileCommandsIndex)
+{
+    std::string content = LoadCompileCommands(Scaled(BENCH_COMPILE_COMMANDS));
+    wxFileName fn(wxFileName::CreateTempFileName("compile_commands"));
+    {
+        wxFFile fp(fn.GetFullPath(), "wb");
+        if(!fp.IsOpened() || !fp.Write(content.c_str(), content.length())) {
+            printf("    Failed to write the compilation database\n");
+            return false;
+        }
+    }
+    content.clear();
+    content.shrink_to_fit();
+
+    // the DOM: load the whole file and read the flags of every entry
+    size_t allocations = GetAllocationsCount();
+    wxStopWatch sw;
+    size_t domEntries = 0;
+    {
+        JSON root(fn);
+        JSONItem arr = root.toElement();
+        int count = arr.arraySize();
+        for(int i = 0; i < count; ++i) {
+            JSONItem entry = arr.arrayItem(i);
+            if(!entry.namedObject("command").toString().empty() && !entry.namedObject("file").toString().empty()) {
+                ++domEntries;
+            }
+        }
+    }
+    wxLongLong domMs = sw.Time();
+    size_t domAllocations = GetAllocationsCount() - allocations;
+
+    // the streaming reader and the interned flags
+    allocations = GetAllocationsCount();
+    sw.Start();
+    CompileCommandsIndex index;
+    index.Load(fn);
+    wxLongLong indexMs = sw.Time();
+    size_t indexAllocations = GetAllocationsCount() - allocations;
+
+    ::wxRemoveFile(fn.GetFullPath());
+
+    Report("DOM load", domEntries, "entries", domMs);
+    Report("Streaming flags load", index.GetEntriesCount(), "entries", indexMs);
+    printf("    Allocations: %u (DOM), %u (index). Distinct flags: %u\n", (unsigned)domAllocations,
+           (unsigned)indexAllocations, (unsigned)index.GetFlags().size());
+    if(index.GetEntriesCount() != domEntries) {
+        printf("    Read %u entries out of %u\n", (unsigned)index.GetEntriesCount(), (unsigned)domEntries);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,28 @@
+#include "benchmark.h"
+#include <stdio.h>
+#include <wx/init.h>
+#include <wx/log.h>
+
+// Usage: codelite-benchmarks [--scale <factor>] [<name-filter>]
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    wxLogNull NOLOG;
+
+    wxString filter;
+    for(int i = 1; i < argc; ++i) {
+        wxString arg = argv[i];
+        if(arg == "--scale" && (i + 1) < argc) {
+            double scale = 1.0;
+            if(wxString(argv[++i]).ToCDouble(&scale) && scale > 0.0) {
+                Benchmarks::Instance()->SetScale(scale);
+            }
+        } else {
+            filter = arg;
+        }
+    }
+
+    size_t errors = Benchmarks::Instance()->RunBenchmarks(filter);
+    Benchmarks::Release();
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include "benchmark.h"
+#include "tag_tree.h"
+#include "tags_storage_sqlite3.h"
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+// 10,000 files x 100 tags = 1M tags at scale 1.0
+#define BENCH_FILES_COUNT 10000
+#define BENCH_TAGS_PER_FILE 100
+#define BENCH_FILES_PER_TRANSACTION 1000
+
+namespace
+{
+/**
+ * @brief build a synthetic tree for the n-th file: one class, its members and a few global functions
+ */
+TagTreePtr CreateFileTree(size_t fileNo)
+{
+    wxString filename;
+    filename << "/synthetic/src/file_" << fileNo << ".cpp";
+    wxString className;
+    className << "Class_" << fileNo;
+
+    TagEntry root;
+    root.SetName(wxT("<ROOT>"));
+    TagTreePtr tree(new TagTree(wxT("<ROOT>"), root));
+
+    wxStringMap_t noFields;
+    TagEntry classTag;
+    classTag.Create(filename, className, 1, "/^class " + className + " {$/", "class", noFields);
+    tree->AddEntry(classTag);
+
+    for(size_t i = 1; i < BENCH_TAGS_PER_FILE; ++i) {
+        wxString name;
+        wxStringMap_t fields;
+        fields.insert(std::make_pair(wxString("signature"), wxString("(int a, const wxString& b)")));
+        if((i % 10) == 0) {
+            // a global function
+            name << "Function_" << fileNo << "_" << i;
+        } else {
+            name << "Method_" << i;
+            fields.insert(std::make_pair(wxString("class"), className));
+        }
+        TagEntry tag;
+        tag.Create(filename, name, (int)(i + 1), "/^void " + name + "(int a, const wxString& b) {$/",
+                   (i % 2) ? "function" : "prototype", fields);
+        tree->AddEntry(tag);
+    }
+    return tree;
+}
+
+enum eStoreMode {
+    kPrepareEveryRow, // what TagsStorageSQLite::Store() did before caching its INSERT statement
+    kCachedStatement,
+    kBulkInsert,
+};
+
+/**
+ * @brief store 'tree' the way TagsStorageSQLite::Store() did before: prepare the INSERT statement for every row
+ */
+void StorePreparingEveryRow(TagsStorageSQLite& db, TagTreePtr tree)
+{
+    TreeWalker<wxString, TagEntry> walker(tree->GetRoot());
+    for(; !walker.End(); walker++) {
+        if(walker.GetNode() == tree->GetRoot()) {
+            continue;
+        }
+        const TagEntry& tag = walker.GetNode()->GetData();
+        wxSQLite3Statement statement =
+            db.PrepareStatement(wxT("INSERT OR REPLACE INTO TAGS VALUES (NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
+        statement.Bind(1, tag.GetName());
+        statement.Bind(2, tag.GetFile());
+        statement.Bind(3, tag.GetLine());
+        statement.Bind(4, tag.GetKind());
+        statement.Bind(5, tag.GetAccess());
+        statement.Bind(6, tag.GetSignature());
+        statement.Bind(7, tag.GetPattern());
+        statement.Bind(8, tag.GetParent());
+        statement.Bind(9, tag.GetInheritsAsString());
+        statement.Bind(10, tag.GetPath());
+        statement.Bind(11, tag.GetTyperef());
+        statement.Bind(12, tag.GetScope());
+        statement.Bind(13, tag.GetReturnValue());
+        statement.ExecuteUpdate();
+    }
+}
+
+bool StoreSyntheticTags(const IBenchmark* benchmark, eStoreMode mode, const wxString& what)
+{
+    wxFileName dbfile(wxFileName::CreateTempFileName("clbench"));
+    wxRemoveFile(dbfile.GetFullPath());
+
+    bool ok = true;
+    {
+        TagsStorageSQLite db;
+        db.OpenDatabase(dbfile);
+        size_t filesCount = benchmark->Scaled(BENCH_FILES_COUNT);
+
+        // Only the storage calls are measured, not the generation of the synthetic tags
+        wxStopWatch sw;
+        if(mode == kBulkInsert) db.BeginBulkInsert();
+        db.Begin();
+        sw.Pause();
+
+        for(size_t i = 0; i < filesCount; ++i) {
+            TagTreePtr tree = CreateFileTree(i);
+            sw.Resume();
+            if(mode == kPrepareEveryRow) {
+                StorePreparingEveryRow(db, tree);
+            } else {
+                db.Store(tree, wxFileName(), false);
+            }
+            if(((i + 1) % BENCH_FILES_PER_TRANSACTION) == 0) {
+                db.Commit();
+                db.Begin();
+            }
+            sw.Pause();
+        }
+
+        sw.Resume();
+        db.Commit();
+        if(mode == kBulkInsert) db.EndBulkInsert();
+        sw.Pause();
+        benchmark->Report(what, filesCount * BENCH_TAGS_PER_FILE, "rows", sw.Time());
+
+        // Sanity: the last stored tag must be searchable using the (re)built indexes
+        std::vector<TagEntryPtr> tags;
+        wxString lastPath;
+        lastPath << "Class_" << (filesCount - 1) << "::Method_1";
+        db.GetTagsByPath(lastPath, tags);
+        ok = (tags.size() == 1);
+    }
+    wxRemoveFile(dbfile.GetFullPath());
+    return ok;
+}
+} // namespace
+
+BENCHMARK_FUNC(tags_storage_store_prepare_every_row)
+{
+    return StoreSyntheticTags(this, kPrepareEveryRow, "Store (statement prepared per row)");
+}
+
+BENCHMARK_FUNC(tags_storage_store_per_row)
+{
+    return StoreSyntheticTags(this, kCachedStatement, "TagsStorageSQLite::Store");
+}
+
+BENCHMARK_FUNC(tags_storage_store_bulk_insert)
+{
+    return StoreSyntheticTags(this, kBulkInsert, "TagsStorageSQLite::Store (bulk insert)");
+}
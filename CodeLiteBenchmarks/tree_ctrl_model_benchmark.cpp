@@ -0,0 +1,150 @@
+#include "benchmark.h"
+#include "clTreeCtrlModel.h"
+#include <stdio.h>
+#include <vector>
+
+// the tree at scale 1.0: 1000 folders of 1000 items each, about 1M rows when expanded
+#define BENCH_TREE_FOLDERS 1000
+#define BENCH_TREE_FOLDER_ITEMS 1000
+
+// the lookups are cheap now, but a walk over the list takes a few ms per lookup
+#define BENCH_TREE_LOOKUPS 100000
+#define BENCH_TREE_WALK_LOOKUPS 50
+
+namespace
+{
+unsigned NextRandom(unsigned& seed)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7FFF;
+}
+
+size_t RandomIndex(unsigned& seed, size_t count)
+{
+    size_t high = NextRandom(seed);
+    return ((high << 15) | NextRandom(seed)) % count;
+}
+
+/**
+ * @brief what clTreeCtrlModel::GetItemIndex did so far: count the visible rows before 'item' in the list
+ */
+int OldGetItemIndex(clTreeCtrlModel& model, clRowEntry* item)
+{
+    int counter = 0;
+    for(clRowEntry* row = model.GetRoot(); row && row != item; row = row->GetNext()) {
+        if(row->IsVisible()) {
+            ++counter;
+        }
+    }
+    return counter;
+}
+
+/**
+ * @brief what clTreeCtrlModel::GetItemFromIndex did so far: return the index-th visible row of the list
+ */
+clRowEntry* OldGetItemFromIndex(clTreeCtrlModel& model, int index)
+{
+    for(clRowEntry* row = model.GetRoot(); row; row = row->GetNext()) {
+        if(!row->IsVisible()) {
+            continue;
+        }
+        if(index == 0) {
+            return row;
+        }
+        --index;
+    }
+    return nullptr;
+}
+} // namespace
+
+BENCHMARK_FUNC(TreeCtrlModel)
+{
+    const size_t foldersCount = Scaled(BENCH_TREE_FOLDERS);
+    clTreeCtrlModel model(nullptr);
+    model.SetSortFunction(nullptr);
+
+    wxStopWatch sw;
+    wxTreeItemId root = model.AddRoot("root", wxNOT_FOUND, wxNOT_FOUND, nullptr);
+    std::vector<clRowEntry*> folders;
+    for(size_t i = 0; i < foldersCount; ++i) {
+        wxString label;
+        label << "folder" << (unsigned)i;
+        wxTreeItemId folder = model.AppendItem(root, label, wxNOT_FOUND, wxNOT_FOUND, nullptr);
+        for(size_t j = 0; j < BENCH_TREE_FOLDER_ITEMS; ++j) {
+            wxString itemLabel;
+            itemLabel << "item" << (unsigned)j;
+            model.AppendItem(folder, itemLabel, wxNOT_FOUND, wxNOT_FOUND, nullptr);
+        }
+        folders.push_back(model.ToPtr(folder));
+    }
+    model.ExpandAllChildren(root);
+    wxLongLong buildMs = sw.Time();
+    const size_t rowsCount = model.GetExpandedLines();
+
+    std::vector<clRowEntry*> rows;
+    rows.reserve(rowsCount);
+    for(clRowEntry* row = model.GetRoot(); row; row = row->GetNext()) {
+        rows.push_back(row);
+    }
+
+    // what the control does while scrolling and painting: from a line to its row and back
+    unsigned seed = 1;
+    const size_t lookups = Scaled(BENCH_TREE_LOOKUPS);
+    sw.Start();
+    for(size_t i = 0; i < lookups; ++i) {
+        if(!model.GetItemFromIndex(RandomIndex(seed, rowsCount))) {
+            return false;
+        }
+    }
+    wxLongLong fromIndexMs = sw.Time();
+
+    sw.Start();
+    for(size_t i = 0; i < lookups; ++i) {
+        if(model.GetItemIndex(rows[RandomIndex(seed, rows.size())]) == wxNOT_FOUND) {
+            return false;
+        }
+    }
+    wxLongLong indexMs = sw.Time();
+
+    // collapse and expand a folder, then find the first row on the screen
+    sw.Start();
+    for(size_t i = 0; i < lookups; ++i) {
+        clRowEntry* folder = folders[RandomIndex(seed, folders.size())];
+        folder->SetExpanded(!folder->IsExpanded());
+        model.GetItemFromIndex(model.GetItemIndex(folder));
+    }
+    wxLongLong toggleMs = sw.Time();
+
+    // the walk over the list, on a few rows only
+    std::vector<clRowEntry*> walkRows;
+    std::vector<int> walkIndexes;
+    for(size_t i = 0; i < BENCH_TREE_WALK_LOOKUPS; ++i) {
+        clRowEntry* row = rows[RandomIndex(seed, rows.size())];
+        if(row->IsVisible()) {
+            walkRows.push_back(row);
+            walkIndexes.push_back(model.GetItemIndex(row));
+        }
+    }
+    sw.Start();
+    for(size_t i = 0; i < walkRows.size(); ++i) {
+        OldGetItemFromIndex(model, walkIndexes[i]);
+        OldGetItemIndex(model, walkRows[i]);
+    }
+    wxLongLong walkMs = sw.Time();
+
+    Report("Build the tree", rowsCount, "rows", buildMs);
+    Report("Row from index + index of row (list walk)", walkRows.size() * 2, "lookups", walkMs);
+    Report("Row from index + index of row", lookups * 2, "lookups", fromIndexMs + indexMs);
+    Report("Expand/collapse a folder + lookup", lookups, "toggles", toggleMs);
+
+    for(size_t i = 0; i < walkRows.size(); ++i) {
+        if(OldGetItemIndex(model, walkRows[i]) != walkIndexes[i] ||
+           OldGetItemFromIndex(model, walkIndexes[i]) != walkRows[i]) {
+            printf("    The index of '%s' differs from the list walk\n",
+                   (const char*)walkRows[i]->GetLabel().mb_str(wxConvUTF8).data());
+            return false;
+        }
+    }
+    printf("    %u rows, %u visible after the toggles\n", (unsigned)rows.size(), (unsigned)model.GetExpandedLines());
+    return true;
+}
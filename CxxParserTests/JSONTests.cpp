@@ -0,0 +1,125 @@
+#include "JSON.h"
+#include "tester.h"
+#include <math.h>
+#include <string>
+
+TEST_FUNC(test_json_parse)
+{
+    JSON root(wxString("{\"name\": \"codelite\", \"version\": 14, \"ratio\": -2.5e-1, \"enabled\": true, "
+                       "\"list\": [1, [2, 3], {\"x\": null}], \"empty\": {}}"));
+    CHECK_BOOL(root.isOk());
+    JSONItem json = root.toElement();
+    CHECK_WXSTRING(json["name"].toString(), "codelite");
+    CHECK_BOOL(json["version"].toInt() == 14);
+    CHECK_BOOL(fabs(json["ratio"].toDouble() + 0.25) < 1e-9);
+    CHECK_BOOL(json["enabled"].toBool());
+    // the names are looked up case insensitively
+    CHECK_BOOL(json["NAME"].isString());
+    CHECK_SIZE(json["list"].arraySize(), 3);
+    CHECK_SIZE(json["list"][1].arraySize(), 2);
+    CHECK_BOOL(json["list"][1][1].toInt() == 3);
+    CHECK_BOOL(json["list"][2]["x"].isNull());
+    CHECK_BOOL(json["empty"].isOk() && !json["empty"].firstChild().isOk());
+    CHECK_BOOL(!json["missing"].isOk());
+    return true;
+}
+
+TEST_FUNC(test_json_invalid)
+{
+    CHECK_BOOL(!JSON(wxString("{\"a\": }")).isOk());
+    CHECK_BOOL(!JSON(wxString("[1, 2")).isOk());
+    CHECK_BOOL(!JSON(wxString("{\"a\" 1}")).isOk());
+    CHECK_BOOL(!JSON(wxString("nul")).isOk());
+    return true;
+}
+
+TEST_FUNC(test_json_escapes)
+{
+    JSON root(wxString("{\"s\": \"tab\\tquote\\\"slash\\\\\\/nl\\n\", \"u\": \"\\u00e9\\u20ac\\ud83d\\ude00\"}"));
+    CHECK_BOOL(root.isOk());
+    JSONItem json = root.toElement();
+    CHECK_WXSTRING(json["s"].toString(), "tab\tquote\"slash\\/nl\n");
+    // a two bytes, a three bytes and a four bytes (surrogate pair) UTF-8 sequence
+    CHECK_BOOL(json["u"].toString() == wxString::FromUTF8("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"));
+
+    // the writer escapes what the parser unescapes
+    wxString text = json.format(false);
+    JSON copy(text);
+    CHECK_BOOL(copy.isOk());
+    CHECK_BOOL(copy.toElement()["s"].toString() == json["s"].toString());
+    CHECK_BOOL(copy.toElement()["u"].toString() == json["u"].toString());
+    return true;
+}
+
+TEST_FUNC(test_json_writer_round_trip)
+{
+    const char* text = "{\"a\":1,\"b\":[true,false,null],\"c\":{\"d\":\"e\",\"f\":-3},\"g\":0.500000}";
+    JSON root(wxString::FromUTF8(text));
+    CHECK_BOOL(root.isOk());
+    wxString compact = root.toElement().format(false);
+    CHECK_WXSTRING(compact, text);
+
+    // the formatted output parses back to the same document
+    JSON formatted(root.toElement().format(true));
+    CHECK_BOOL(formatted.isOk());
+    CHECK_WXSTRING(formatted.toElement().format(false), text);
+    return true;
+}
+
+TEST_FUNC(test_json_parse_buffer)
+{
+    // the text is parsed from a buffer which is not null terminated after the value
+    std::string buffer = "{\"id\": 3, \"result\": [\"x\\ny\"]}Content-Length: 2";
+    size_t len = buffer.find('}') + 1;
+    JSON root(buffer.c_str(), len);
+    CHECK_BOOL(root.isOk());
+    CHECK_BOOL(root.toElement()["id"].toInt() == 3);
+    CHECK_WXSTRING(root.toElement()["result"][0].toString(), "x\ny");
+    // the buffer is left untouched
+    CHECK_BOOL(buffer == "{\"id\": 3, \"result\": [\"x\\ny\"]}Content-Length: 2");
+
+    // a value cut in the middle is rejected, without reading past the end
+    JSON truncated(buffer.c_str(), 15);
+    CHECK_BOOL(!truncated.isOk());
+    return true;
+}
+
+TEST_FUNC(test_json_replace_property)
+{
+    // replace the same subtree many times, like clConfig does when it writes an item
+    JSON root(cJSON_Object);
+    JSONItem json = root.toElement();
+    for(int i = 0; i < 1000; ++i) {
+        json.removeProperty("item");
+        JSONItem item = JSONItem::createObject("item");
+        item.addProperty("index", i);
+        item.addProperty("name", wxString::Format("name %d", i));
+        json.append(item);
+
+        json.removeProperty("value");
+        json.addProperty("value", wxString::Format("value %d", i));
+    }
+    CHECK_BOOL(json["item"]["index"].toInt() == 999);
+    CHECK_WXSTRING(json["item"]["name"].toString(), "name 999");
+    CHECK_WXSTRING(json["value"].toString(), "value 999");
+    CHECK_WXSTRING(json.format(false), "{\"item\":{\"index\":999,\"name\":\"name 999\"},\"value\":\"value 999\"}");
+    return true;
+}
+
+TEST_FUNC(test_json_detach_property)
+{
+    JSON root(wxString("{\"a\": {\"b\": [1, 2]}, \"c\": \"d\"}"));
+    JSON detached(root.toElement().detachProperty("a"));
+    CHECK_BOOL(detached.isOk());
+    CHECK_BOOL(!root.toElement()["a"].isOk());
+    CHECK_SIZE(detached.toElement()["b"].arraySize(), 2);
+
+    // a detached subtree can be added to another document
+    JSONItem added = JSONItem::createObject("x");
+    added.addProperty("y", wxString("z"));
+    root.toElement().append(added);
+    JSON detachedAdded(root.toElement().detachProperty("x"));
+    CHECK_WXSTRING(detachedAdded.toElement()["y"].toString(), "z");
+    CHECK_WXSTRING(root.toElement().format(false), "{\"c\":\"d\"}");
+    return true;
+}
@@ -0,0 +1,110 @@
+#include "clBuildOutputMatcher.h"
+#include "tester.h"
+
+namespace
+{
+// the required literals of 'pattern', sorted and comma separated
+wxString GetLiterals(const wxString& pattern)
+{
+    wxArrayString literals = clBuildOutputMatcher::GetRequiredLiterals(pattern);
+    literals.Sort();
+    return wxJoin(literals, ',', '\0');
+}
+} // namespace
+
+TEST_FUNC(test_build_matcher_literals)
+{
+    CHECK_WXSTRING(GetLiterals("error"), "error");
+    CHECK_WXSTRING(GetLiterals("^([^ ]+):([0-9]+): error"), ": error");
+    // the longest run of literal characters is kept
+    CHECK_WXSTRING(GetLiterals("in function (.*):"), "in function ");
+    return true;
+}
+
+TEST_FUNC(test_build_matcher_literals_alternation)
+{
+    CHECK_WXSTRING(GetLiterals("error|warning"), "error,warning");
+    CHECK_WXSTRING(GetLiterals("(fatal error|undefined reference)"), "fatal error,undefined reference");
+    // a branch without a literal can match anything
+    CHECK_WXSTRING(GetLiterals("error|.*"), "");
+    CHECK_WXSTRING(GetLiterals("(error|)x"), "x");
+    return true;
+}
+
+TEST_FUNC(test_build_matcher_literals_optional)
+{
+    CHECK_WXSTRING(GetLiterals("(error)?"), "");
+    CHECK_WXSTRING(GetLiterals("(error)?:"), ":");
+    CHECK_WXSTRING(GetLiterals("(error)*abc"), "abc");
+    // a required group is used
+    CHECK_WXSTRING(GetLiterals("x(error)+"), "error");
+    CHECK_WXSTRING(GetLiterals("x(?:warning)"), "warning");
+    // an optional character ends the literal before it
+    CHECK_WXSTRING(GetLiterals("warnings?:"), "warning");
+    CHECK_WXSTRING(GetLiterals("ab*cd"), "cd");
+    return true;
+}
+
+TEST_FUNC(test_build_matcher_literals_classes)
+{
+    // a bracket expression is not a literal
+    CHECK_WXSTRING(GetLiterals("[Ee]rror"), "rror");
+    CHECK_WXSTRING(GetLiterals("err[o]r"), "err");
+    CHECK_WXSTRING(GetLiterals("[]x]abc"), "abc");
+    CHECK_WXSTRING(GetLiterals("[[:digit:]]+ errors"), " errors");
+    CHECK_WXSTRING(GetLiterals("[a-z]"), "");
+    // unterminated
+    CHECK_WXSTRING(GetLiterals("abc[de"), "");
+    return true;
+}
+
+TEST_FUNC(test_build_matcher_literals_escapes)
+{
+    CHECK_WXSTRING(GetLiterals("\\(\\.text\\+"), "(.text+");
+    // class escapes are not literals
+    CHECK_WXSTRING(GetLiterals("\\d+ error"), " error");
+    // on a tie the first literal is kept
+    CHECK_WXSTRING(GetLiterals("ab\\scd"), "ab");
+    // back references and character codes: give up
+    CHECK_WXSTRING(GetLiterals("(a)\\1error"), "");
+    CHECK_WXSTRING(GetLiterals("\\x41error"), "");
+    return true;
+}
+
+TEST_FUNC(test_build_matcher_literals_repetitions)
+{
+    // {0,n} makes the atom optional
+    CHECK_WXSTRING(GetLiterals("a{0,3}bcd"), "bcd");
+    CHECK_WXSTRING(GetLiterals("abc{0,2}"), "ab");
+    CHECK_WXSTRING(GetLiterals("x(error){0,1}"), "x");
+    // {n} with n > 0 keeps it
+    CHECK_WXSTRING(GetLiterals("ab{2}c"), "ab");
+    CHECK_WXSTRING(GetLiterals("(abc){2,}"), "abc");
+    // a quantifier we don't parse
+    CHECK_WXSTRING(GetLiterals("a{,2}error"), "");
+    return true;
+}
+
+TEST_FUNC(test_build_matcher_literals_case)
+{
+    // the literals are lower case, the lines are matched case insensitively
+    CHECK_WXSTRING(GetLiterals("ERROR"), "error");
+    CHECK_WXSTRING(GetLiterals("Undefined Reference"), "undefined reference");
+    // embedded options and directors are not analysed
+    CHECK_WXSTRING(GetLiterals("(?i)error"), "");
+    CHECK_WXSTRING(GetLiterals("***=error"), "");
+
+    clBuildOutputMatcher matcher;
+    CHECK_BOOL(matcher.Add("([^ ]+):([0-9]+): (Error|Warning)", clBuildOutputMatcher::kSeverityError, "1", "2", "-1"));
+    CHECK_BOOL(matcher.Add("^[a-z]+[0-9]+$", clBuildOutputMatcher::kSeverityWarning, "-1", "-1", "-1"));
+    clBuildOutputMatcher::Match match;
+    CHECK_BOOL(matcher.Matches("main.cpp:12: ERROR: oops", match));
+    CHECK_BOOL(match.severity == clBuildOutputMatcher::kSeverityError);
+    CHECK_WXSTRING(match.filename, "main.cpp");
+    CHECK_BOOL(match.lineNumber == 11);
+    // a pattern without literals is always tried
+    CHECK_BOOL(matcher.Matches("foo42", match));
+    CHECK_BOOL(match.severity == clBuildOutputMatcher::kSeverityWarning);
+    CHECK_BOOL(!matcher.Matches("nothing to see", match));
+    return true;
+}
@@ -0,0 +1,108 @@
+#include "clCodeCompletionFilter.h"
+#include "tester.h"
+
+namespace
+{
+const char* filterKeys[] = { "getName", "name",    "Name",        "NameSpace", "nameOf",
+                             "SetName", "NAME",    "GetFileName", "m_name",    "unrelated" };
+
+void AddKeys(clCodeCompletionFilter& filter, const char** keys, size_t count)
+{
+    for(size_t i = 0; i < count; ++i) {
+        filter.AddKey(keys[i]);
+    }
+}
+
+// the matching keys, ranked and comma separated
+wxString GetMatches(const clCodeCompletionFilter& filter, const char** keys)
+{
+    wxString str;
+    for(size_t i = 0; i < filter.GetMatchesCount(); ++i) {
+        if(!str.IsEmpty()) { str << ","; }
+        str << keys[filter.GetMatch(i)];
+    }
+    return str;
+}
+
+wxString FilterOnce(const wxString& text)
+{
+    clCodeCompletionFilter filter;
+    AddKeys(filter, filterKeys, sizeof(filterKeys) / sizeof(filterKeys[0]));
+    filter.Filter(text);
+    return GetMatches(filter, filterKeys);
+}
+} // namespace
+
+TEST_FUNC(test_cc_filter_case_variants)
+{
+    clCodeCompletionFilter filter;
+    AddKeys(filter, filterKeys, sizeof(filterKeys) / sizeof(filterKeys[0]));
+    filter.Filter("Name");
+    // exact, exact (no case), starts with, starts with (no case), contains, contains (no case). Within a kind the
+    // keys keep the list order
+    CHECK_WXSTRING(GetMatches(filter, filterKeys),
+                   "Name,name,NAME,NameSpace,nameOf,getName,SetName,GetFileName,m_name");
+    CHECK_SIZE(filter.GetStartsWithCount(), 5);
+    CHECK_SIZE(filter.GetContainsCount(), 9);
+
+    // an empty filter matches all the keys, in order
+    filter.Filter("");
+    CHECK_SIZE(filter.GetMatchesCount(), filter.GetKeysCount());
+    CHECK_SIZE(filter.GetMatch(3), 3);
+    return true;
+}
+
+TEST_FUNC(test_cc_filter_narrowing)
+{
+    // typing one character at a time gives the same matches as filtering at once
+    clCodeCompletionFilter filter;
+    AddKeys(filter, filterKeys, sizeof(filterKeys) / sizeof(filterKeys[0]));
+    wxString typed;
+    for(const char* ch = "nameof"; *ch; ++ch) {
+        typed << *ch;
+        filter.Filter(typed);
+        CHECK_WXSTRING(GetMatches(filter, filterKeys), FilterOnce(typed));
+    }
+    CHECK_WXSTRING(GetMatches(filter, filterKeys), "nameOf");
+
+    // changing a character in the middle does not narrow
+    filter.Filter("nbme");
+    CHECK_WXSTRING(GetMatches(filter, filterKeys), FilterOnce("nbme"));
+
+    // a key added after filtering is matched by the next filter
+    filter.Filter("nam");
+    filter.AddKey("namespace");
+    filter.Filter("name");
+    CHECK_SIZE(filter.GetMatchesCount(), 10);
+    return true;
+}
+
+TEST_FUNC(test_cc_filter_backspace)
+{
+    clCodeCompletionFilter filter;
+    AddKeys(filter, filterKeys, sizeof(filterKeys) / sizeof(filterKeys[0]));
+    filter.Filter("names");
+    CHECK_WXSTRING(GetMatches(filter, filterKeys), "NameSpace");
+    // deleting characters brings back the keys the longer filter dropped
+    filter.Filter("name");
+    CHECK_WXSTRING(GetMatches(filter, filterKeys), FilterOnce("name"));
+    filter.Filter("n");
+    CHECK_WXSTRING(GetMatches(filter, filterKeys), FilterOnce("n"));
+    filter.Filter("");
+    CHECK_SIZE(filter.GetMatchesCount(), filter.GetKeysCount());
+    return true;
+}
+
+TEST_FUNC(test_cc_filter_subsequence_score)
+{
+    const char* keys[] = { "gofunny", "msgFlushNow", "get_file_name", "GetFileName", "debugFn" };
+    clCodeCompletionFilter filter;
+    AddKeys(filter, keys, sizeof(keys) / sizeof(keys[0]));
+    filter.Filter("gfn");
+    // the 'contains' match comes first. Then the keys with more characters matching at a word start (camelCase or
+    // after '_'); on the same score the shorter key wins
+    CHECK_WXSTRING(GetMatches(filter, keys), "debugFn,GetFileName,get_file_name,msgFlushNow,gofunny");
+    CHECK_SIZE(filter.GetStartsWithCount(), 0);
+    CHECK_SIZE(filter.GetContainsCount(), 1);
+    return true;
+}
@@ -0,0 +1,119 @@
+#include "clGdbMIParser.h"
+#include "tester.h"
+
+TEST_FUNC(test_gdb_mi_result_record)
+{
+    clGdbMIRecord record;
+    CHECK_BOOL(clGdbMIParser::Parse("00000012^done,bkpt={number=\"1\",type=\"breakpoint\",line=\"42\"}", record));
+    CHECK_BOOL(record.type == clGdbMIRecord::kResult);
+    CHECK_WXSTRING(record.token, "00000012");
+    CHECK_WXSTRING(record.resultClass, "done");
+    CHECK_BOOL(record["bkpt"].GetKind() == clGdbMIValue::kTuple);
+    CHECK_WXSTRING(record["bkpt"]["type"].GetValue(), "breakpoint");
+    long line = 0;
+    CHECK_BOOL(record["bkpt"]["line"].GetLong(line) && line == 42);
+    CHECK_BOOL(!record["bkpt"]["missing"].IsOk());
+    CHECK_BOOL(!record["missing"]["line"].IsOk());
+    CHECK_WXSTRING(clGdbMIParser::GetToken("00000012^done"), "00000012");
+    CHECK_WXSTRING(clGdbMIParser::GetToken("^done"), "");
+
+    // a result class without results
+    CHECK_BOOL(clGdbMIParser::Parse("^running", record));
+    CHECK_WXSTRING(record.resultClass, "running");
+    CHECK_SIZE(record.results.GetChildren().size(), 0);
+    return true;
+}
+
+TEST_FUNC(test_gdb_mi_escapes)
+{
+    clGdbMIRecord record;
+    CHECK_BOOL(clGdbMIParser::Parse("^done,value=\"say \\\"hi\\\"\\n\\tback\\\\slash\"", record));
+    CHECK_WXSTRING(record["value"].GetValue(), "say \"hi\"\n\tback\\slash");
+
+    // octal escapes are the bytes of a UTF-8 sequence
+    CHECK_BOOL(clGdbMIParser::Parse("^done,value=\"caf\\303\\251 \\342\\202\\254\"", record));
+    CHECK_BOOL(record["value"].GetValue() == wxString::FromUTF8("caf\xC3\xA9 \xE2\x82\xAC"));
+
+    // an unterminated string
+    CHECK_BOOL(!clGdbMIParser::Parse("^done,value=\"abc", record));
+    return true;
+}
+
+TEST_FUNC(test_gdb_mi_nested_values)
+{
+    clGdbMIRecord record;
+    CHECK_BOOL(clGdbMIParser::Parse("^done,stack=[frame={level=\"0\",func=\"main\",args=[]},frame={level=\"1\","
+                                    "func=\"foo\",args=[{name=\"x\",value=\"{a = 1, b = [2]}\"}]}],"
+                                    "ids=[\"1\",\"2\"],empty={}",
+                                    record));
+    const clGdbMIValue& stack = record["stack"];
+    CHECK_BOOL(stack.GetKind() == clGdbMIValue::kList);
+    CHECK_SIZE(stack.GetChildren().size(), 2);
+    // a list of results
+    CHECK_WXSTRING(stack.GetChildren()[0].GetName(), "frame");
+    CHECK_WXSTRING(stack.GetChildren()[1]["func"].GetValue(), "foo");
+    CHECK_BOOL(stack.GetChildren()[0]["args"].GetKind() == clGdbMIValue::kList);
+    CHECK_SIZE(stack.GetChildren()[0]["args"].GetChildren().size(), 0);
+    // a list of tuples, the braces inside the c-string are not values
+    const clGdbMIValue& arg = stack.GetChildren()[1]["args"].GetChildren()[0];
+    CHECK_BOOL(arg.GetKind() == clGdbMIValue::kTuple);
+    CHECK_WXSTRING(arg["value"].GetValue(), "{a = 1, b = [2]}");
+    // a list of values
+    CHECK_SIZE(record["ids"].GetChildren().size(), 2);
+    CHECK_WXSTRING(record["ids"].GetChildren()[1].GetValue(), "2");
+    CHECK_BOOL(record["empty"].GetKind() == clGdbMIValue::kTuple);
+
+    // not closed
+    CHECK_BOOL(!clGdbMIParser::Parse("^done,stack=[frame={level=\"0\"}", record));
+    return true;
+}
+
+TEST_FUNC(test_gdb_mi_async_and_stream_records)
+{
+    clGdbMIRecord record;
+    CHECK_BOOL(clGdbMIParser::Parse(
+        "*stopped,reason=\"breakpoint-hit\",frame={addr=\"0x1\",func=\"main\",line=\"7\"},thread-id=\"1\"", record));
+    CHECK_BOOL(record.type == clGdbMIRecord::kExecAsync);
+    CHECK_WXSTRING(record.resultClass, "stopped");
+    CHECK_WXSTRING(record["reason"].GetValue(), "breakpoint-hit");
+    CHECK_WXSTRING(record["frame"]["func"].GetValue(), "main");
+    CHECK_WXSTRING(record["thread-id"].GetValue(), "1");
+
+    CHECK_BOOL(clGdbMIParser::Parse("=thread-group-started,id=\"i1\",pid=\"1234\"", record));
+    CHECK_BOOL(record.type == clGdbMIRecord::kNotifyAsync);
+    CHECK_WXSTRING(record["pid"].GetValue(), "1234");
+    CHECK_BOOL(clGdbMIParser::Parse("+download,section=\".text\"", record));
+    CHECK_BOOL(record.type == clGdbMIRecord::kStatusAsync);
+
+    CHECK_BOOL(clGdbMIParser::Parse("~\"Breakpoint 1 at 0x1: file a.c, line 7.\\n\"", record));
+    CHECK_BOOL(record.type == clGdbMIRecord::kConsoleStream);
+    CHECK_WXSTRING(record.streamOutput, "Breakpoint 1 at 0x1: file a.c, line 7.\n");
+    CHECK_BOOL(clGdbMIParser::Parse("@\"output\"", record));
+    CHECK_BOOL(record.type == clGdbMIRecord::kTargetStream);
+    CHECK_BOOL(clGdbMIParser::Parse("&\"warning\\n\"", record));
+    CHECK_BOOL(record.type == clGdbMIRecord::kLogStream);
+    CHECK_WXSTRING(record.streamOutput, "warning\n");
+
+    // the debuggee output is not a record
+    CHECK_BOOL(!clGdbMIParser::Parse("hello world", record));
+    CHECK_BOOL(record.type == clGdbMIRecord::kUnknown);
+    return true;
+}
+
+TEST_FUNC(test_gdb_mi_output_queue)
+{
+    clGdbMIOutputQueue queue;
+    queue.Append("(gdb) \n^done,a=\"1\"\n  ~\"par");
+    CHECK_SIZE(queue.GetCount(), 1);
+    queue.Append("tial\"\r\n(gdb)*stopped\n\n");
+    CHECK_SIZE(queue.GetCount(), 3);
+    wxString line;
+    CHECK_BOOL(queue.Pop(line));
+    CHECK_WXSTRING(line, "^done,a=\"1\"");
+    CHECK_BOOL(queue.Pop(line));
+    CHECK_WXSTRING(line, "~\"partial\"");
+    CHECK_BOOL(queue.Pop(line));
+    CHECK_WXSTRING(line, "*stopped");
+    CHECK_BOOL(!queue.Pop(line));
+    return true;
+}
@@ -0,0 +1,53 @@
+#include "clProcessReactor.h"
+#include "tester.h"
+
+#if defined(__WXMAC__) || defined(__WXGTK__)
+TEST_FUNC(test_process_reactor_decodable_ascii)
+{
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("", true), 0);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("hello world\n", false), 12);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("hello world\n", true), 12);
+    return true;
+}
+
+TEST_FUNC(test_process_reactor_decodable_utf8)
+{
+    // a 2 bytes sequence: U+00E9
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("caf\xC3", false), 3);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("caf\xC3\xA9", false), 5);
+
+    // a 3 bytes sequence: U+20AC
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("x\xE2", false), 1);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("x\xE2\x82", false), 1);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("x\xE2\x82\xAC", false), 4);
+
+    // a 4 bytes sequence: U+1F600
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("x\xF0", false), 1);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("x\xF0\x9F", false), 1);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("x\xF0\x9F\x98", false), 1);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("x\xF0\x9F\x98\x80", false), 5);
+
+    // only the last sequence is checked
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("\xC3\xA9\xE2\x82\xAC\xC3", true), 5);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("\xE2\x82", true), 0);
+    return true;
+}
+
+TEST_FUNC(test_process_reactor_decodable_escapes)
+{
+    // an unfinished colour sequence is kept for the next read, unless the escape sequences are not stripped
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("abc\x1b", true), 3);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("abc\x1b[3", true), 3);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("abc\x1b[3", false), 6);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("abc\x1b[31m", true), 8);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("abc\x1b[31mdef", true), 11);
+
+    // an OSC sequence ends with BEL
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("a\x1b]0;title", true), 1);
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("a\x1b]0;title\a", true), 11);
+
+    // a split UTF-8 sequence after an escape sequence
+    CHECK_SIZE(clProcessReactor::GetDecodableLength("\x1b[0m\xE2\x82", true), 4);
+    return true;
+}
+#endif
@@ -0,0 +1,118 @@
+#include "clRowIndexRanges.h"
+#include "tester.h"
+
+namespace
+{
+// the ranges as "first-last,first-last..."
+wxString ToString(const clRowIndexRanges& ranges)
+{
+    wxString str;
+    for(const clRowIndexRanges::Range_t& range : ranges.GetRanges()) {
+        if(!str.IsEmpty()) { str << ","; }
+        str << range.first << "-" << range.second;
+    }
+    return str;
+}
+} // namespace
+
+TEST_FUNC(test_row_index_ranges_add_remove)
+{
+    clRowIndexRanges ranges;
+    ranges.Add(10, 20);
+    ranges.Add(40, 30); // in any order
+    CHECK_WXSTRING(ToString(ranges), "10-20,30-40");
+    CHECK_SIZE(ranges.GetCount(), 22);
+    CHECK_BOOL(ranges.Contains(10) && ranges.Contains(20) && ranges.Contains(35));
+    CHECK_BOOL(!ranges.Contains(9) && !ranges.Contains(21) && !ranges.Contains(41));
+
+    // touching and overlapping ranges are merged
+    ranges.Add(21, 22);
+    CHECK_WXSTRING(ToString(ranges), "10-22,30-40");
+    ranges.Add(5, 31);
+    CHECK_WXSTRING(ToString(ranges), "5-40");
+
+    // remove splits the range
+    ranges.Remove(5);
+    ranges.Remove(40);
+    ranges.Remove(20);
+    ranges.Remove(100);
+    CHECK_WXSTRING(ToString(ranges), "6-19,21-39");
+    CHECK_BOOL(!ranges.Contains(20));
+    ranges.Add(0, 0);
+    ranges.Remove(0);
+    CHECK_WXSTRING(ToString(ranges), "6-19,21-39");
+
+    // a large range costs nothing
+    clRowIndexRanges large;
+    large.Add(1, 1000000);
+    CHECK_SIZE(large.GetCount(), 1000000);
+    CHECK_SIZE(large.GetRanges().size(), 1);
+    return true;
+}
+
+TEST_FUNC(test_row_index_ranges_expand)
+{
+    // row 5 is expanded and shows 3 children: the rows after it move down
+    size_t index = 0;
+    CHECK_BOOL(clRowIndexRanges::MoveIndex(4, 5, 3, index) && index == 4);
+    CHECK_BOOL(clRowIndexRanges::MoveIndex(5, 5, 3, index) && index == 5);
+    CHECK_BOOL(clRowIndexRanges::MoveIndex(6, 5, 3, index) && index == 9);
+
+    clRowIndexRanges ranges;
+    ranges.Add(2, 8);
+    ranges.Add(20, 21);
+    ranges.RowExpanded(5, 3);
+    // the new children (6-8) are not selected
+    CHECK_WXSTRING(ToString(ranges), "2-5,9-11,23-24");
+    CHECK_SIZE(ranges.GetCount(), 9);
+    return true;
+}
+
+TEST_FUNC(test_row_index_ranges_collapse)
+{
+    // row 5 is collapsed and hides its 3 children (6-8)
+    size_t index = 0;
+    CHECK_BOOL(clRowIndexRanges::MoveIndex(5, 5, -3, index) && index == 5);
+    CHECK_BOOL(!clRowIndexRanges::MoveIndex(6, 5, -3, index));
+    CHECK_BOOL(!clRowIndexRanges::MoveIndex(8, 5, -3, index));
+    CHECK_BOOL(clRowIndexRanges::MoveIndex(9, 5, -3, index) && index == 6);
+
+    clRowIndexRanges ranges;
+    ranges.Add(2, 6);
+    ranges.Add(8, 10);
+    ranges.Add(20, 21);
+    ranges.RowExpanded(5, -3);
+    // 2-5 stays, 6 and 8 are gone, 9-10 become 6-7 and touch 2-5
+    CHECK_WXSTRING(ToString(ranges), "2-7,17-18");
+
+    // a range inside the collapsed subtree
+    clRowIndexRanges hidden;
+    hidden.Add(6, 8);
+    hidden.RowExpanded(5, -3);
+    CHECK_BOOL(hidden.IsEmpty());
+
+    // expanding and collapsing again gives back the same indexes
+    clRowIndexRanges same;
+    same.Add(0, 3);
+    same.Add(10, 12);
+    same.RowExpanded(1, 4);
+    same.RowExpanded(1, -4);
+    CHECK_WXSTRING(ToString(same), "0-3,10-12");
+    return true;
+}
+
+TEST_FUNC(test_row_index_ranges_truncate)
+{
+    // the provider rows changed: the indexes past the end are dropped
+    clRowIndexRanges ranges;
+    ranges.Add(2, 4);
+    ranges.Add(10, 20);
+    ranges.Add(30, 40);
+    ranges.Truncate(15);
+    CHECK_WXSTRING(ToString(ranges), "2-4,10-14");
+    ranges.Truncate(10);
+    CHECK_WXSTRING(ToString(ranges), "2-4");
+    ranges.Truncate(0);
+    CHECK_BOOL(ranges.IsEmpty());
+    return true;
+}
@@ -0,0 +1,174 @@
+#include "clTreeCtrlModel.h"
+#include "tester.h"
+
+namespace
+{
+unsigned NextRandom(unsigned& seed)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7FFF;
+}
+
+/**
+ * @brief add 'count' items under random parents. One item out of three is inserted between its siblings
+ */
+void AddItems(clTreeCtrlModel& model, size_t count, unsigned& seed)
+{
+    std::vector<clRowEntry*> items;
+    for(clRowEntry* row = model.GetRoot(); row; row = row->GetNext()) {
+        items.push_back(row);
+    }
+    for(size_t i = 0; i < count; ++i) {
+        clRowEntry* parent = items[NextRandom(seed) % items.size()];
+        const clRowEntry::Vec_t& children = parent->GetChildren();
+        wxString label;
+        label << "item" << (unsigned)items.size();
+        wxTreeItemId item;
+        if(!children.empty() && (NextRandom(seed) % 3) == 0) {
+            wxTreeItemId prev(children[NextRandom(seed) % children.size()]);
+            item = model.InsertItem(wxTreeItemId(parent), prev, label, wxNOT_FOUND, wxNOT_FOUND, nullptr);
+        } else {
+            item = model.AppendItem(wxTreeItemId(parent), label, wxNOT_FOUND, wxNOT_FOUND, nullptr);
+        }
+        items.push_back(model.ToPtr(item));
+    }
+}
+
+/**
+ * @brief expand (or collapse) one item with children out of 'every'
+ */
+void ExpandItems(clTreeCtrlModel& model, bool expand, unsigned every, unsigned& seed)
+{
+    for(clRowEntry* row = model.GetRoot(); row; row = row->GetNext()) {
+        if(row->HasChildren() && (NextRandom(seed) % every) == 0) {
+            row->SetExpanded(expand);
+        }
+    }
+}
+
+void DeleteItems(clTreeCtrlModel& model, size_t count, unsigned& seed)
+{
+    for(size_t i = 0; i < count; ++i) {
+        std::vector<clRowEntry*> items;
+        for(clRowEntry* row = model.GetRoot()->GetNext(); row; row = row->GetNext()) {
+            items.push_back(row);
+        }
+        if(items.empty()) {
+            return;
+        }
+        model.DeleteItem(wxTreeItemId(items[NextRandom(seed) % items.size()]));
+    }
+}
+
+/**
+ * @brief compare the row <-> index mapping with a walk over the linked list of the items, the way it was done before
+ * the rows were counted per subtree
+ * @return the first difference, an empty string when there is none
+ */
+wxString CompareWithWalk(clTreeCtrlModel& model)
+{
+    wxString error;
+    clRowEntry::Vec_t visible;
+    for(clRowEntry* row = model.GetRoot(); row; row = row->GetNext()) {
+        // the index of a row is the number of visible rows before it
+        int index = model.GetItemIndex(row);
+        if(index != (int)visible.size()) {
+            error << "GetItemIndex(" << row->GetLabel() << ") = " << index << ", expected " << visible.size();
+            return error;
+        }
+        if(row->IsVisible()) {
+            visible.push_back(row);
+        }
+    }
+    if(model.GetExpandedLines() != visible.size()) {
+        error << "GetExpandedLines() = " << model.GetExpandedLines() << ", expected " << visible.size();
+        return error;
+    }
+    for(size_t i = 0; i < visible.size(); ++i) {
+        clRowEntry* row = model.GetItemFromIndex(i);
+        if(row != visible[i]) {
+            error << "GetItemFromIndex(" << i << ") = " << (row ? row->GetLabel() : wxString("null")) << ", expected "
+                  << visible[i]->GetLabel();
+            return error;
+        }
+        clRowEntry* next = (i + 1) < visible.size() ? visible[i + 1] : nullptr;
+        clRowEntry* prev = i ? visible[i - 1] : nullptr;
+        if(row->GetNextVisible() != next || row->GetPrevVisible() != prev) {
+            error << "the rows around " << row->GetLabel() << " are wrong";
+            return error;
+        }
+    }
+    if(model.GetItemFromIndex(visible.size())) {
+        error << "GetItemFromIndex(" << visible.size() << ") is not null";
+    }
+    return error;
+}
+} // namespace
+
+TEST_FUNC(test_tree_model_rows_index)
+{
+    unsigned seed = 1;
+    clTreeCtrlModel model(nullptr);
+    model.SetSortFunction(nullptr);
+    model.AddRoot("root", wxNOT_FOUND, wxNOT_FOUND, nullptr);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+
+    AddItems(model, 500, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    model.GetRoot()->SetExpanded(true);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    ExpandItems(model, true, 2, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    ExpandItems(model, false, 3, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+
+    // insert in the middle of expanded and collapsed subtrees
+    AddItems(model, 200, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    DeleteItems(model, 30, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    ExpandItems(model, true, 2, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+
+    model.ExpandAllChildren(wxTreeItemId(model.GetRoot()));
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    model.CollapseAllChildren(wxTreeItemId(model.GetRoot()));
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    CHECK_SIZE(model.GetExpandedLines(), 1);
+    return true;
+}
+
+TEST_FUNC(test_tree_model_rows_index_hidden_root)
+{
+    unsigned seed = 2;
+    clTreeCtrlModel model(nullptr);
+    model.SetSortFunction(nullptr);
+    model.AddRoot("root", wxNOT_FOUND, wxNOT_FOUND, nullptr);
+    // what a tree with wxTR_HIDE_ROOT does
+    model.GetRoot()->SetHidden(true);
+    model.GetRoot()->SetExpanded(true);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    CHECK_SIZE(model.GetExpandedLines(), 0);
+
+    AddItems(model, 500, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    ExpandItems(model, true, 2, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    ExpandItems(model, false, 3, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    DeleteItems(model, 30, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    AddItems(model, 200, seed);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+
+    // the root is shown again, and hidden when it is collapsed
+    model.GetRoot()->SetHidden(false);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    model.GetRoot()->SetExpanded(false);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    model.GetRoot()->SetHidden(true);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    model.GetRoot()->SetExpanded(true);
+    CHECK_WXSTRING(CompareWithWalk(model), "");
+    return true;
+}
@@ -279,9 +279,8 @@ void DbgCmdHandlerAsyncCmd::UpdateGotControl(DebuggerReasons reason, const wxStr
     m_observer->UpdateGotControl(reason, func);
 }
 
-bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
+bool DbgCmdHandlerAsyncCmd::ProcessRecord(const clGdbMIRecord& record, const wxString& line)
 {
-    wxString reason;
     //*stopped,reason="end-stepping-range",thread-id="1",frame={addr="0x0040156b",func="main",args=[{name="argc",value="1"},{name="argv",value="0x3e2c50"}],file="a.cpp",line="46"}
     // when reason is "end-stepping-range", it means that one of the following command was
     // completed:
@@ -292,34 +291,11 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
     m_gdb->GetDebugeePID(line);
 
     // Get the reason
-    GdbChildrenInfo info;
-    gdbParseListChildren(line.mb_str(wxConvUTF8).data(), info);
-
-    wxString func;
-    bool foundReason;
-
-    foundReason = false;
-    for(size_t i = 0; i < info.children.size(); i++) {
-        std::map<std::string, std::string> attr = info.children.at(i);
-        std::map<std::string, std::string>::const_iterator iter;
-
-        iter = attr.find("reason");
-        if(!foundReason && iter != attr.end()) {
-            foundReason = true;
-            reason = wxString(iter->second.c_str(), wxConvUTF8);
-            wxRemoveQuotes(reason);
-        }
-
-        if(foundReason) break;
-    }
-
+    const wxString& reason = record["reason"].GetValue();
     if(reason.IsEmpty()) return false;
 
-    int where = line.Find(wxT("func=\""));
-    if(where != wxNOT_FOUND) {
-        func = line.Mid(where + 6);
-        func = func.BeforeFirst(wxT('"'));
-    }
+    const clGdbMIValue& frame = record["frame"];
+    wxString func = frame["func"].GetValue();
 
     // Note:
     // This might look like a stupid if-else, since all taking
@@ -341,40 +317,26 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
             }
         }
 
-        // Now discover which bp was hit. Fortunately, that's in the next token: bkptno="12"
-        // Except that it no longer is in gdb 7.0. It's now: ..disp="keep",bkptno="12". So:
-        static wxRegEx reGetBreakNo(wxT("bkptno=\"([0-9]+)\""));
-        if(reGetBreakNo.Matches(line)) {
-            wxString number = reGetBreakNo.GetMatch(line, 1);
+        // Now discover which bp was hit: ..disp="keep",bkptno="12"
+        const clGdbMIValue& number = record["bkptno"];
+        if(number.IsOk()) {
             long id;
-            if(number.ToLong(&id)) {
+            if(number.GetLong(id)) {
                 if(id != wxNOT_FOUND && m_gdb->m_internalBpId == id) {
 
                     //*stopped,reason="breakpoint-hit",disp="del",bkptno="1",frame={addr="0x0040131e",func="main",args=[{name="argc",value="1"},
                     // {name="argv",value="0x602420"}],file="C:/src/TestArea/TestEXE/main.cpp",fullname="C:\\src\\TestArea\\TestEXE\\main.cpp",line="5"},thread-id="1",stopped-threads="all"
 
                     // try to locate the file name + line number:
-                    int filePos = line.Find(wxT("fullname=\""));
-                    int length = wxStrlen(wxT("fullname=\""));
+                    const clGdbMIValue& file = frame["fullname"].IsOk() ? frame["fullname"] : frame["file"];
                     wxString filename;
                     long curline = -1;
                     wxFileName curfile;
 
-                    if(filePos == wxNOT_FOUND) {
-                        filePos = line.Find(wxT("file=\""));
-                        length = wxStrlen(wxT("file=\""));
-                    }
-
-                    int linePos = line.Find(wxT("line=\""));
-                    if(linePos != wxNOT_FOUND) {
-                        wxString tmpLine = line.Mid(linePos + wxStrlen(wxT("line=\"")));
-                        tmpLine = tmpLine.BeforeFirst(wxT('"'));
-                        tmpLine.ToLong(&curline);
-                    }
+                    frame["line"].GetLong(curline);
 
-                    if(filePos != wxNOT_FOUND) {
-                        filename = line.Mid(filePos + length);
-                        filename = filename.BeforeFirst(wxT('"'));
+                    if(file.IsOk()) {
+                        filename = file.GetValue();
                         filename.Replace(wxT("\\"), wxT("/"));
                         filename.Replace(wxT("//"), wxT("/"));
                         curfile = filename;
@@ -434,13 +396,7 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
 
         // got signal
         // which signal?
-        wxString signame;
-        int where = line.Find(wxT("signal-name"));
-        if(where != wxNOT_FOUND) {
-            signame = line.Mid(where);
-            signame = signame.AfterFirst(wxT('"'));
-            signame = signame.BeforeFirst(wxT('"'));
-        }
+        const wxString& signame = record["signal-name"].GetValue();
 
         if(signame == wxT("SIGSEGV")) {
             UpdateGotControl(DBG_RECV_SIGNAL_SIGSEGV, func);
@@ -473,17 +429,11 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
         // We finished an execution of a function.
         // Return to the caller the gdb-result-var since we might want
         // to create a variable object out of it
-        wxString gdbVar;
-        int where = line.Find(wxT("gdb-result-var"));
-        if(where != wxNOT_FOUND) {
-
-            gdbVar = line.Mid(where + 14);
-            gdbVar = gdbVar.AfterFirst(wxT('"'));
-            gdbVar = gdbVar.BeforeFirst(wxT('"'));
-
+        const clGdbMIValue& gdbVar = record["gdb-result-var"];
+        if(gdbVar.IsOk()) {
             DebuggerEventData evt;
             evt.m_updateReason = DBG_UR_FUNCTIONFINISHED;
-            evt.m_expression = gdbVar;
+            evt.m_expression = gdbVar.GetValue();
             m_observer->DebuggerUpdate(evt);
         }
 
@@ -494,7 +444,7 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
     return true;
 }
 
-bool DbgCmdHandlerBp::ProcessOutput(const wxString& line)
+bool DbgCmdHandlerBp::ProcessRecord(const clGdbMIRecord& record, const wxString& line)
 {
     // parse the line, in case we have an error, keep this breakpoint in the queue
     if(line.StartsWith(wxT("^done"))) {
@@ -517,18 +467,15 @@ bool DbgCmdHandlerBp::ProcessOutput(const wxString& line)
     // so the breakpoint ID will come in form of
     // ^done,bkpt={number="2"....
     // ^done,wpt={number="2"
-    static wxRegEx reBreak(wxT("done,bkpt={number=\"([0-9]+)\""));
-    static wxRegEx reWatch(wxT("done,wpt={number=\"([0-9]+)\""));
-
     wxString number;
     long breakpointId(wxNOT_FOUND);
 
-    if(reBreak.Matches(line)) {
-        number = reBreak.GetMatch(line, 1);
+    if(record.resultClass == "done" && record["bkpt"]["number"].IsOk()) {
+        number = record["bkpt"]["number"].GetValue();
         m_observer->UpdateAddLine(wxString::Format(_("Found the breakpoint ID!")), true);
 
-    } else if(reWatch.Matches(line)) {
-        number = reWatch.GetMatch(line, 1);
+    } else if(record.resultClass == "done") {
+        number = record["wpt"]["number"].GetValue();
     }
 
     if(number.IsEmpty() == false) {
@@ -1320,18 +1267,14 @@ bool DbgCmdEvalVarObj::ProcessOutput(const wxString& line)
     return false;
 }
 
-bool DbgFindMainBreakpointIdHandler::ProcessOutput(const wxString& line)
+bool DbgFindMainBreakpointIdHandler::ProcessRecord(const clGdbMIRecord& record, const wxString& line)
 {
+    wxUnusedVar(line);
     // so the breakpoint ID will come in form of
     // ^done,bkpt={number="2"....
-    static wxRegEx reBreak(wxT("done,bkpt={number=\"([0-9]+)\""));
-    wxString number;
     long breakpointId(wxNOT_FOUND);
-
-    reBreak.Matches(line);
-    number = reBreak.GetMatch(line, 1);
-    if(number.IsEmpty() == false) {
-        if(number.ToLong(&breakpointId)) {
+    if(record.resultClass == "done") {
+        if(record["bkpt"]["number"].GetLong(breakpointId)) {
             // for debugging purpose
             m_observer->UpdateAddLine(wxString::Format(wxT("Storing internal breakpoint ID=%ld"), breakpointId), true);
             m_debugger->SetInternalMainBpID(breakpointId);
@@ -1340,13 +1283,14 @@ bool DbgFindMainBreakpointIdHandler::ProcessOutput(const wxString& line)
     return true;
 }
 
-bool DbgCmdHandlerStackDepth::ProcessOutput(const wxString& line)
+bool DbgCmdHandlerStackDepth::ProcessRecord(const clGdbMIRecord& record, const wxString& line)
 {
+    wxUnusedVar(line);
     DebuggerEventData e;
     long frameLevel(-1);
-    static wxRegEx reFrameDepth(wxT("depth=\"([0-9]+)\""));
-    if(reFrameDepth.Matches(line)) {
-        wxString strFrameDepth = reFrameDepth.GetMatch(line, 1);
+    const clGdbMIValue& depth = record["depth"];
+    if(depth.IsOk()) {
+        const wxString& strFrameDepth = depth.GetValue();
         if(strFrameDepth.ToLong(&frameLevel) && frameLevel != -1) {
             e.m_updateReason = DBG_UR_FRAMEDEPTH;
             e.m_frameInfo.level = strFrameDepth;
@@ -1391,13 +1335,11 @@ bool DbgVarObjUpdate::ProcessOutput(const wxString& line)
     return true;
 }
 
-bool DbgCmdHandlerExecRun::ProcessOutput(const wxString& line)
+bool DbgCmdHandlerExecRun::ProcessRecord(const clGdbMIRecord& record, const wxString& line)
 {
     if(line.StartsWith(wxT("^error"))) {
         // ^error,msg="..."
-        wxString errmsg = line.Mid(11); // skip |^error,msg=| (11 chars)
-        errmsg.Replace(wxT("\\\""), wxT("\""));
-        errmsg.Replace(wxT("\\n"), wxT("\n"));
+        const wxString& errmsg = record["msg"].GetValue();
 
         // exec-run failed, notify about it
         DebuggerEventData e;
@@ -1408,7 +1350,7 @@ bool DbgCmdHandlerExecRun::ProcessOutput(const wxString& line)
         return true;
 
     } else {
-        return DbgCmdHandlerAsyncCmd::ProcessOutput(line);
+        return DbgCmdHandlerAsyncCmd::ProcessRecord(record, line);
     }
 }
 
@@ -29,6 +29,7 @@
 #include "wx/event.h"
 #include "debuggerobserver.h"
 #include "debugger.h"
+#include "clGdbMIParser.h"
 
 class IDebugger;
 class DbgGdb;
@@ -59,6 +60,17 @@ public:
     virtual bool WantsErrors() const { return false; }
 
     virtual bool ProcessOutput(const wxString& line) = 0;
+
+    /**
+     * @brief parse 'line' into an MI record. The handlers that look up results call it from their ProcessOutput() and
+     * pass the record to their ProcessRecord(), so the lines are parsed only for them
+     */
+    static clGdbMIRecord ParseRecord(const wxString& line)
+    {
+        clGdbMIRecord record;
+        clGdbMIParser::Parse(line, record);
+        return record;
+    }
 };
 
 /**
@@ -130,7 +142,8 @@ public:
 
     virtual ~DbgCmdHandlerStackDepth() {}
 
-    virtual bool ProcessOutput(const wxString& line);
+    virtual bool ProcessOutput(const wxString& line) { return ProcessRecord(ParseRecord(line), line); }
+    bool ProcessRecord(const clGdbMIRecord& record, const wxString& line);
 };
 
 /**
@@ -155,7 +168,8 @@ public:
     virtual ~DbgCmdHandlerAsyncCmd() {}
 
     void UpdateGotControl(DebuggerReasons reason, const wxString& func);
-    virtual bool ProcessOutput(const wxString& line);
+    virtual bool ProcessOutput(const wxString& line) { return ProcessRecord(ParseRecord(line), line); }
+    bool ProcessRecord(const clGdbMIRecord& record, const wxString& line);
 };
 
 class DbgCmdHandlerExecRun : public DbgCmdHandlerAsyncCmd
@@ -167,7 +181,8 @@ public:
     }
 
     virtual ~DbgCmdHandlerExecRun() {}
-    virtual bool ProcessOutput(const wxString& line);
+    virtual bool ProcessOutput(const wxString& line) { return ProcessRecord(ParseRecord(line), line); }
+    bool ProcessRecord(const clGdbMIRecord& record, const wxString& line);
     virtual bool WantsErrors() const { return true; }
 };
 
@@ -209,7 +224,8 @@ public:
     }
 
     virtual ~DbgCmdHandlerBp() {}
-    virtual bool ProcessOutput(const wxString& line);
+    virtual bool ProcessOutput(const wxString& line) { return ProcessRecord(ParseRecord(line), line); }
+    bool ProcessRecord(const clGdbMIRecord& record, const wxString& line);
     virtual bool WantsErrors() const { return true; }
 };
 
@@ -491,7 +507,8 @@ public:
 
     virtual ~DbgFindMainBreakpointIdHandler() {}
 
-    virtual bool ProcessOutput(const wxString& line);
+    virtual bool ProcessOutput(const wxString& line) { return ProcessRecord(ParseRecord(line), line); }
+    bool ProcessRecord(const clGdbMIRecord& record, const wxString& line);
 };
 
 class DbgVarObjUpdate : public DbgCmdHandler
@@ -364,13 +364,11 @@ void DbgGdb::DoCleanup()
     SetIsRemoteDebugging(false);
     SetIsRemoteExtended(false);
     EmptyQueue();
-    m_gdbOutputArr.Clear();
+    // Clear any bufferd output
+    m_gdbOutput.Clear();
     m_bpList.clear();
     m_debuggeeProjectName.Clear();
 
-    // Clear any bufferd output
-    m_gdbOutputIncompleteLine.Clear();
-
     // Free allocated console for this session
     m_consoleFinder.FreeConsole();
 
@@ -713,11 +711,9 @@ bool DbgGdb::FilterMessage(const wxString& msg)
 
 void DbgGdb::Poke()
 {
-    static wxRegEx reCommand(wxT("^([0-9]{8})"));
-
     // poll the debugger output
     wxString curline;
-    if(!m_gdbProcess || m_gdbOutputArr.IsEmpty()) {
+    if(!m_gdbProcess || m_gdbOutput.IsEmpty()) {
         return;
     }
 
@@ -802,10 +798,10 @@ void DbgGdb::Poke()
                 m_observer->UpdateAddLine(curline);
             }
 
-        } else if(reCommand.Matches(curline)) {
+        } else if(clGdbMIParser::GetToken(curline).length() >= 8) {
 
             // not a gdb message, get the command associated with the message
-            wxString id = reCommand.GetMatch(curline, 1);
+            wxString id = curline.Left(8);
 
             if(GetCliHandler() && GetCliHandler()->GetCommandId() == id) {
                 // probably the "^done" message of the CLI command
@@ -1150,7 +1146,7 @@ bool DbgGdb::DoInitializeGdb(const DebugSessionInfo& sessionInfo)
         // Set a breakpoint at WinMain
         // Use a temporary one, so that it isn't duplicated in future sessions
         WriteCommand(breakinsertcmd + wxT("-t main"), NULL);
-        // Flag that we've done this. DbgFindMainBreakpointIdHandler::ProcessOutput uses this
+        // Flag that we've done this. DbgFindMainBreakpointIdHandler::ProcessRecord uses this
         // to decide whether or not to 'continue' after setting BPs after main()
         SetShouldBreakAtMain(true);
     } else {
@@ -1250,35 +1246,10 @@ void DbgGdb::OnDataRead(clProcessEvent& e)
         return;
 
     clDEBUG() << "GDB>>" << bufferRead;
-    wxArrayString lines = wxStringTokenize(bufferRead, "\n", wxTOKEN_STRTOK);
-    if(lines.IsEmpty()) {
-        return;
-    }
-
-    // Prepend the partially saved line from previous iteration to the first line
-    // of this iteration
-    if(!m_gdbOutputIncompleteLine.empty()) {
-        lines.Item(0).Prepend(m_gdbOutputIncompleteLine);
-        m_gdbOutputIncompleteLine.Clear();
-    }
-
-    // If the last line is in-complete, remove it from the array and keep it for next iteration
-    if(!bufferRead.EndsWith(wxT("\n"))) {
-        m_gdbOutputIncompleteLine = lines.Last();
-        lines.RemoveAt(lines.GetCount() - 1);
-    }
 
-    for(size_t i = 0; i < lines.GetCount(); ++i) {
-        wxString& line = lines.Item(i);
-
-        line.Replace(wxT("(gdb)"), wxT(""));
-        line.Trim().Trim(false);
-        if(line.IsEmpty() == false) {
-            m_gdbOutputArr.Add(line);
-        }
-    }
-
-    if(m_gdbOutputArr.IsEmpty() == false) {
+    // Split the output into lines, an incomplete last line is kept for the next time
+    m_gdbOutput.Append(bufferRead);
+    if(m_gdbOutput.IsEmpty() == false) {
         // Trigger GDB processing
         Poke();
     }
@@ -1286,18 +1257,9 @@ void DbgGdb::OnDataRead(clProcessEvent& e)
 
 bool DbgGdb::DoGetNextLine(wxString& line)
 {
+    // the queue holds trimmed, non empty lines
     line.Clear();
-    if(m_gdbOutputArr.IsEmpty()) {
-        return false;
-    }
-    line = m_gdbOutputArr.Item(0);
-    m_gdbOutputArr.RemoveAt(0);
-    line.Replace(wxT("(gdb)"), wxT(""));
-    line.Trim().Trim(false);
-    if(line.IsEmpty()) {
-        return false;
-    }
-    return true;
+    return m_gdbOutput.Pop(line);
 }
 
 void DbgGdb::SetInternalMainBpID(int bpId) { m_internalBpId = bpId; }
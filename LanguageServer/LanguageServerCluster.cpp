@@ -304,6 +304,7 @@ void LanguageServerCluster::StopAll()
     for(const std::unordered_map<wxString, LanguageServerProtocol::Ptr_t>::value_type& vt : m_servers) {
         // stop all current processes
         LanguageServerProtocol::Ptr_t server = vt.second;
+        server->LogLatencyStats();
         server.reset(nullptr);
     }
     m_servers.clear();
@@ -17,7 +17,13 @@ void CxxPreProcessorThread::ProcessRequest(ThreadRequest* request)
     CxxPreProcessorThread::Request* req = dynamic_cast<CxxPreProcessorThread::Request*>(request);
     CHECK_PTR_RET(req);
 
+    if(req->clearHeaderCache) {
+        m_headerCache.Clear();
+        return;
+    }
+
     CxxPreProcessor pp;
+    pp.SetHeaderCache(&m_headerCache);
     for(size_t i = 0; i < req->includePaths.GetCount(); ++i) {
         pp.AddIncludePath(req->includePaths.Item(i));
     }
@@ -28,7 +34,11 @@ void CxxPreProcessorThread::ProcessRequest(ThreadRequest* request)
 
     CL_DEBUG("Parsing of file: %s started\n", req->filename);
     pp.Parse(req->filename, kLexerOpt_CollectMacroValueNumbers | kLexerOpt_DontCollectMacrosDefinedInThisFile);
-    CL_DEBUG("Parsing of file: %s completed\n", req->filename);
+    CL_DEBUG("Parsing of file: %s completed (headers cache: %u hits, %u misses, %u entries)\n",
+             req->filename,
+             (unsigned)m_headerCache.GetHits(),
+             (unsigned)m_headerCache.GetMisses(),
+             (unsigned)m_headerCache.GetCount());
 
     CodeCompletionManager::Get().CallAfter(
         &CodeCompletionManager::OnParseThreadCollectedMacros, pp.GetDefinitions(), req->filename);
@@ -44,3 +54,10 @@ void CxxPreProcessorThread::QueueFile(const wxString& filename,
     req->filename = filename;
     Add(req);
 }
+
+void CxxPreProcessorThread::ClearHeaderCache()
+{
+    CxxPreProcessorThread::Request* req = new CxxPreProcessorThread::Request();
+    req->clearHeaderCache = true;
+    Add(req);
+}
@@ -26,16 +26,21 @@
 #ifndef CXXPREPROCESSORTHREAD_H
 #define CXXPREPROCESSORTHREAD_H
 
+#include "CxxPreProcessorHeaderCache.h"
 #include "worker_thread.h" // Base class: WorkerThread
 
 class CxxPreProcessorThread : public WorkerThread
 {
+    // the headers parsed by the previous requests, only accessed by the worker thread
+    CxxPreProcessorHeaderCache m_headerCache;
+
 public:
     struct Request : public ThreadRequest
     {
         wxString filename;
         wxArrayString definitions;
         wxArrayString includePaths;
+        bool clearHeaderCache = false;
 
         Request()
         {
@@ -50,6 +55,12 @@ public:
     virtual void ProcessRequest(ThreadRequest* request);
 
     void QueueFile(const wxString& filename, const wxArrayString& definitions, const wxArrayString& includePaths);
+
+    /**
+     * @brief forget the headers parsed so far (e.g. a build may have generated headers). The cache is cleared by the
+     * worker thread, before the next queued file is parsed
+     */
+    void ClearHeaderCache();
 };
 
 #endif // CXXPREPROCESSORTHREAD_H
@@ -0,0 +1,96 @@
+#include "FindInFilesIndexManager.h"
+#include "cl_config.h"
+#include "codelite_events.h"
+#include "event_notifier.h"
+#include "search_thread.h"
+#include "workspace.h"
+
+static FindInFilesIndexManager* ms_FindInFilesIndexManager = NULL;
+
+FindInFilesIndexManager::FindInFilesIndexManager()
+{
+    m_enabled = clConfig::Get().Read("FindInFiles/UseIndex", false);
+    EventNotifier::Get()->Bind(wxEVT_WORKSPACE_LOADED, &FindInFilesIndexManager::OnWorkspaceLoaded, this);
+    EventNotifier::Get()->Bind(wxEVT_WORKSPACE_CLOSED, &FindInFilesIndexManager::OnWorkspaceClosed, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_SAVED, &FindInFilesIndexManager::OnFileSaved, this);
+    EventNotifier::Get()->Bind(wxEVT_PROJ_FILE_ADDED, &FindInFilesIndexManager::OnFilesAdded, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_RENAMED, &FindInFilesIndexManager::OnFileRenamed, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_DELETED, &FindInFilesIndexManager::OnFileDeleted, this);
+}
+
+FindInFilesIndexManager::~FindInFilesIndexManager()
+{
+    EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_LOADED, &FindInFilesIndexManager::OnWorkspaceLoaded, this);
+    EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_CLOSED, &FindInFilesIndexManager::OnWorkspaceClosed, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, &FindInFilesIndexManager::OnFileSaved, this);
+    EventNotifier::Get()->Unbind(wxEVT_PROJ_FILE_ADDED, &FindInFilesIndexManager::OnFilesAdded, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_RENAMED, &FindInFilesIndexManager::OnFileRenamed, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_DELETED, &FindInFilesIndexManager::OnFileDeleted, this);
+}
+
+FindInFilesIndexManager& FindInFilesIndexManager::Get()
+{
+    if(!ms_FindInFilesIndexManager) { ms_FindInFilesIndexManager = new FindInFilesIndexManager; }
+    return *ms_FindInFilesIndexManager;
+}
+
+void FindInFilesIndexManager::Release() { wxDELETE(ms_FindInFilesIndexManager); }
+
+void FindInFilesIndexManager::OnWorkspaceLoaded(wxCommandEvent& event)
+{
+    event.Skip();
+    if(!m_enabled || !clCxxWorkspaceST::Get()->IsOpen()) { return; }
+
+    // The index is kept next to the tags database
+    wxFileName indexFile = clCxxWorkspaceST::Get()->GetTagsFileName();
+    indexFile.SetExt("findindex");
+    SearchThreadST::Get()->SetIndexFile(indexFile);
+
+    // Index the workspace files in the background, files that did not change are skipped
+    wxArrayString files;
+    clCxxWorkspaceST::Get()->GetWorkspaceFiles(files);
+    DoUpdate(files);
+}
+
+void FindInFilesIndexManager::OnWorkspaceClosed(wxCommandEvent& event)
+{
+    event.Skip();
+    SearchThreadST::Get()->SetIndexFile(wxFileName());
+}
+
+void FindInFilesIndexManager::OnFileSaved(clCommandEvent& event)
+{
+    event.Skip();
+    wxArrayString files;
+    files.Add(event.GetFileName());
+    DoUpdate(files);
+}
+
+void FindInFilesIndexManager::OnFilesAdded(clCommandEvent& event)
+{
+    event.Skip();
+    DoUpdate(event.GetStrings());
+}
+
+void FindInFilesIndexManager::OnFileRenamed(clFileSystemEvent& event)
+{
+    event.Skip();
+    wxArrayString files;
+    files.Add(event.GetPath());
+    files.Add(event.GetNewpath());
+    DoUpdate(files);
+}
+
+void FindInFilesIndexManager::OnFileDeleted(clFileSystemEvent& event)
+{
+    event.Skip();
+    wxArrayString files = event.GetPaths();
+    if(!event.GetPath().IsEmpty()) { files.Add(event.GetPath()); }
+    DoUpdate(files);
+}
+
+void FindInFilesIndexManager::DoUpdate(const wxArrayString& files)
+{
+    if(!m_enabled || files.IsEmpty()) { return; }
+    SearchThreadST::Get()->UpdateIndex(files);
+}
@@ -0,0 +1,37 @@
+#ifndef FINDINFILESINDEXMANAGER_H
+#define FINDINFILESINDEXMANAGER_H
+
+#include "cl_command_event.h"
+#include "clFileSystemEvent.h"
+#include <wx/event.h>
+
+/**
+ * @class FindInFilesIndexManager
+ * @brief opens the "Find In Files" trigram index of the current workspace and keeps it up to date with the files
+ * modified from within CodeLite. Files modified externally are detected by the index itself when searched.
+ * The index is disabled by default, set "FindInFiles/UseIndex" to enable it
+ */
+class FindInFilesIndexManager : public wxEvtHandler
+{
+protected:
+    bool m_enabled = false;
+
+protected:
+    void OnWorkspaceLoaded(wxCommandEvent& event);
+    void OnWorkspaceClosed(wxCommandEvent& event);
+    void OnFileSaved(clCommandEvent& event);
+    void OnFilesAdded(clCommandEvent& event);
+    void OnFileRenamed(clFileSystemEvent& event);
+    void OnFileDeleted(clFileSystemEvent& event);
+
+    void DoUpdate(const wxArrayString& files);
+
+public:
+    FindInFilesIndexManager();
+    virtual ~FindInFilesIndexManager();
+
+    static FindInFilesIndexManager& Get();
+    static void Release();
+};
+
+#endif // FINDINFILESINDEXMANAGER_H
@@ -319,6 +319,8 @@ void CodeCompletionManager::OnBuildEnded(clBuildEvent& e)
     e.Skip();
     m_compileCommandsGenerator->GenerateCompileCommands();
     m_buildInProgress = false;
+    // the build may have generated or modified headers
+    m_preProcessorThread.ClearHeaderCache();
 }
 
 void CodeCompletionManager::OnAppActivated(wxActivateEvent& e) { e.Skip(); }
@@ -533,6 +535,7 @@ void CodeCompletionManager::OnWorkspaceClosed(wxCommandEvent& event)
 {
     event.Skip();
     LanguageST::Get()->ClearAdditionalScopesCache();
+    m_preProcessorThread.ClearHeaderCache();
 }
 
 void CodeCompletionManager::OnEnvironmentVariablesModified(clCommandEvent& event)
@@ -640,6 +643,7 @@ void CodeCompletionManager::OnWorkspaceLoaded(wxCommandEvent& e)
 {
     e.Skip();
     m_compileCommandsGenerator->GenerateCompileCommands();
+    m_preProcessorThread.ClearHeaderCache();
 }
 
 void CodeCompletionManager::OnCodeCompletion(clCodeCompletionEvent& event)
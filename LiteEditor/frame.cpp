@@ -26,6 +26,7 @@
 #include "ColoursAndFontsManager.h"
 #include "CompilersFoundDlg.h"
 #include "DebuggerToolBar.h"
+#include "FindInFilesIndexManager.h"
 #include "ServiceProviderManager.h"
 #include "WelcomePage.h"
 #include "app.h"
@@ -825,6 +826,9 @@ clMainFrame::clMainFrame(wxWindow* pParent, wxWindowID id, const wxString& title
     // Start the code completion manager, we do this by calling it once
     CodeCompletionManager::Get();
 
+    // Same for the "Find In Files" index manager
+    FindInFilesIndexManager::Get();
+
     // Register keyboard shortcuts
     clKeyboardManager::Get()->AddGlobalAccelerator("selection_to_multi_caret", "Ctrl-Shift-L",
                                                    _("Edit::Split selection into multiple carets"));
@@ -869,6 +873,7 @@ clMainFrame::~clMainFrame(void)
 
     // Free the code completion manager
     CodeCompletionManager::Release();
+    FindInFilesIndexManager::Release();
 
     // Release the refactoring engine
     RefactoringEngine::Shutdown();
@@ -4888,7 +4893,12 @@ void clMainFrame::OnRetaggingCompleted(clParseThreadEvent& e)
     // Generate compile_commands.json file
     ManagerST::Get()->GenerateCompileCommands();
 
-    GetStatusBar()->SetMessage(_("Done"));
+    if(e.GetFilesSkipped()) {
+        GetStatusBar()->SetMessage(wxString() << _("Done: ") << e.GetFilesParsed() << _(" files parsed, ")
+                                              << e.GetFilesSkipped() << _(" unchanged files skipped"));
+    } else {
+        GetStatusBar()->SetMessage(_("Done"));
+    }
     GetWorkspacePane()->ClearProgress();
 
     // Clear all cached tags now that we got our database updated
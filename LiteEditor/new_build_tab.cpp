@@ -53,7 +53,6 @@
 #include <wx/dataview.h>
 #include <wx/dcmemory.h>
 #include <wx/fdrepdlg.h>
-#include <wx/regex.h>
 #include <wx/settings.h>
 #include "clFileSystemWorkspace.hpp"
 #include "clFileSystemWorkspaceConfig.hpp"
@@ -93,6 +92,7 @@ typedef std::map<int, AnnotationInfo> AnnotationInfoByLineMap_t;
 
 NewBuildTab::NewBuildTab(wxWindow* parent)
     : wxPanel(parent)
+    , m_parser([this]() { CallAfter(&NewBuildTab::DoProcessParsedLines); })
     , m_warnCount(0)
     , m_errorCount(0)
     , m_buildInterrupted(false)
@@ -102,7 +102,6 @@ NewBuildTab::NewBuildTab(wxWindow* parent)
     , m_buildpaneScrollTo(ScrollToFirstError)
     , m_buildInProgress(false)
     , m_maxlineWidth(wxNOT_FOUND)
-    , m_lastLineColoured(wxNOT_FOUND)
 {
     SetSize(wxNOT_FOUND, 400);
     m_curError = m_errorsAndWarningsList.end();
@@ -112,9 +111,9 @@ NewBuildTab::NewBuildTab(wxWindow* parent)
     m_view = new wxStyledTextCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxBORDER_NONE);
     // We dont really want to collect undo in the output tabs...
     InitView();
-    Bind(wxEVT_IDLE, &NewBuildTab::OnIdle, this);
 
     m_view->Bind(wxEVT_STC_HOTSPOT_CLICK, &NewBuildTab::OnHotspotClicked, this);
+    m_view->Bind(wxEVT_STC_STYLENEEDED, &NewBuildTab::OnStyleNeeded, this);
     EventNotifier::Get()->Bind(wxEVT_CL_THEME_CHANGED, &NewBuildTab::OnThemeChanged, this);
 
     bs->Add(m_view, 1, wxEXPAND | wxALL);
@@ -165,7 +164,9 @@ void NewBuildTab::OnBuildEnded(clCommandEvent& e)
     CL_DEBUG("Build Ended!");
     m_buildInProgress = false;
 
-    DoProcessOutput(true, false);
+    // the errors must be counted before we return: the build result is checked right after this event
+    m_parser.Flush();
+    DoProcessParsedLines();
 
     std::vector<clEditor*> editors;
     clMainFrame::Get()->GetMainBook()->GetAllEditors(editors, MainBook::kGetAll_Default);
@@ -185,14 +186,11 @@ void NewBuildTab::OnBuildEnded(clCommandEvent& e)
         term << wxString::Format(wxT(", %s: %02ld:%02ld:%02ld %s"), _("total time"), hours, minutes, sec, _("seconds"));
     }
 
-    m_output = term;
-    DoProcessOutput(true, true);
+    DoAppendPlainLine("====" + term + "====");
 
     if(m_buildInterrupted) {
-        wxString InterruptedMsg;
-        InterruptedMsg << _("(Build Cancelled)") << wxT("\n\n");
-        m_output = InterruptedMsg;
-        DoProcessOutput(true, false);
+        DoAppendPlainLine(_("(Build Cancelled)"));
+        DoAppendPlainLine("");
     }
 
     // Hide / Show the build tab according to the settings
@@ -249,10 +247,7 @@ void NewBuildTab::OnBuildStarted(clCommandEvent& e)
     m_showMe = (BuildTabSettingsData::ShowBuildPane)m_buildTabSettings.GetShowBuildPane();
     m_skipWarnings = m_buildTabSettings.GetSkipWarnings();
 
-    if(e.GetEventType() != wxEVT_SHELL_COMMAND_STARTED_NOCLEAN) {
-        DoClear();
-        DoCacheRegexes();
-    }
+    if(e.GetEventType() != wxEVT_SHELL_COMMAND_STARTED_NOCLEAN) { DoClear(); }
 
     // Show the tab if needed
     OutputPane* opane = clMainFrame::Get()->GetOutputPane();
@@ -287,98 +282,44 @@ void NewBuildTab::OnBuildStarted(clCommandEvent& e)
         const wxString& cmpname = clFileSystemWorkspace::Get().GetSettings().GetSelectedConfig()->GetCompiler();
         m_cmp = BuildSettingsConfigST::Get()->GetCompiler(cmpname);
     }
+    m_parser.Start(DoCreateMatcher(), m_cygwinRoot);
 }
 
 void NewBuildTab::OnBuildAddLine(clCommandEvent& e)
 {
     e.Skip(); // Always call skip..
-    m_output << e.GetString();
-    DoProcessOutput(false, false);
-}
-
-BuildLineInfo* NewBuildTab::DoProcessLine(const wxString& line)
-{
-    BuildLineInfo* buildLineInfo = new BuildLineInfo();
-    LINE_SEVERITY severity;
-    // Get the matching regex for this line
-    CmpPatternPtr cmpPatterPtr = GetMatchingRegex(line, severity);
-    buildLineInfo->SetSeverity(severity);
-    BuildLineInfo bli;
-    if(cmpPatterPtr && cmpPatterPtr->Matches(line, bli)) {
-        buildLineInfo->SetFilename(bli.GetFilename());
-        buildLineInfo->SetSeverity(bli.GetSeverity());
-        buildLineInfo->SetLineNumber(bli.GetLineNumber());
-        buildLineInfo->NormalizeFilename(m_directories, m_cygwinRoot);
-        buildLineInfo->SetRegexLineMatch(bli.GetRegexLineMatch());
-        buildLineInfo->SetColumn(bli.GetColumn());
-        if(severity == SV_WARNING) {
-            // Warning
-            m_errorsAndWarningsList.push_back(buildLineInfo);
-            m_warnCount++;
-        } else {
-            // Error
-            m_errorsAndWarningsList.push_back(buildLineInfo);
-            m_errorsList.push_back(buildLineInfo);
-            m_errorCount++;
-        }
-    }
-    return buildLineInfo;
+    m_parser.Add(e.GetString());
 }
 
-void NewBuildTab::DoCacheRegexes()
+std::shared_ptr<clBuildOutputMatcher> NewBuildTab::DoCreateMatcher() const
 {
-    m_cmpPatterns.clear();
-
-    // Loop over all known compilers and cache the regular expressions
-    BuildSettingsConfigCookie cookie;
-    CompilerPtr cmp = BuildSettingsConfigST::Get()->GetFirstCompiler(cookie);
-    while(cmp) {
-        CmpPatterns cmpPatterns;
-        const Compiler::CmpListInfoPattern& errPatterns = cmp->GetErrPatterns();
-        const Compiler::CmpListInfoPattern& warnPatterns = cmp->GetWarnPatterns();
-        Compiler::CmpListInfoPattern::const_iterator iter;
-        for(iter = errPatterns.begin(); iter != errPatterns.end(); iter++) {
-
-            CmpPatternPtr compiledPatternPtr(new CmpPattern(new wxRegEx(iter->pattern, wxRE_ADVANCED | wxRE_ICASE),
-                                                            iter->fileNameIndex, iter->lineNumberIndex,
-                                                            iter->columnIndex, SV_ERROR));
-            if(compiledPatternPtr->GetRegex()->IsValid()) { cmpPatterns.errorsPatterns.push_back(compiledPatternPtr); }
+    // warnings are tried first
+    std::shared_ptr<clBuildOutputMatcher> matcher(new clBuildOutputMatcher());
+    if(m_cmp) {
+        for(const Compiler::CmpInfoPattern& pattern : m_cmp->GetWarnPatterns()) {
+            matcher->Add(pattern.pattern, clBuildOutputMatcher::kSeverityWarning, pattern.fileNameIndex,
+                         pattern.lineNumberIndex, pattern.columnIndex);
         }
-
-        for(iter = warnPatterns.begin(); iter != warnPatterns.end(); iter++) {
-
-            CmpPatternPtr compiledPatternPtr(new CmpPattern(new wxRegEx(iter->pattern, wxRE_ADVANCED | wxRE_ICASE),
-                                                            iter->fileNameIndex, iter->lineNumberIndex,
-                                                            iter->columnIndex, SV_WARNING));
-            if(compiledPatternPtr->GetRegex()->IsValid()) { cmpPatterns.warningPatterns.push_back(compiledPatternPtr); }
+        for(const Compiler::CmpInfoPattern& pattern : m_cmp->GetErrPatterns()) {
+            matcher->Add(pattern.pattern, clBuildOutputMatcher::kSeverityError, pattern.fileNameIndex,
+                         pattern.lineNumberIndex, pattern.columnIndex);
         }
-
-        m_cmpPatterns.insert(std::make_pair(cmp->GetName(), cmpPatterns));
-        cmp = BuildSettingsConfigST::Get()->GetNextCompiler(cookie);
+        matcher->Compile();
     }
-}
-
-bool NewBuildTab::DoGetCompilerPatterns(const wxString& compilerName, CmpPatterns& patterns)
-{
-    MapCmpPatterns_t::iterator iter = m_cmpPatterns.find(compilerName);
-    if(iter == m_cmpPatterns.end()) { return false; }
-    patterns = iter->second;
-    return true;
+    return matcher;
 }
 
 void NewBuildTab::DoClear()
 {
     wxFont font = DoGetFont();
-    m_lastLineColoured = wxNOT_FOUND;
     m_maxlineWidth = wxNOT_FOUND;
     m_buildInterrupted = false;
-    m_directories.Clear();
+    m_parser.Clear();
     m_buildInfoPerFile.clear();
     m_warnCount = 0;
     m_errorCount = 0;
     m_errorsAndWarningsList.clear();
     m_errorsList.clear();
-    m_cmpPatterns.clear();
 
     // Delete all the user data
     std::for_each(m_viewData.begin(), m_viewData.end(), [&](std::pair<int, BuildLineInfo*> p) { delete p.second; });
@@ -481,25 +422,6 @@ void NewBuildTab::MarkEditor(clEditor* editor)
     editor->Refresh();
 }
 
-void NewBuildTab::DoSearchForDirectory(const wxString& line)
-{
-    // Check for makefile directory changes lines
-    if(line.Contains(wxT("Entering directory `"))) {
-        wxString currentDir = line.AfterFirst(wxT('`'));
-        currentDir = currentDir.BeforeLast(wxT('\''));
-
-        // Collect the m_baseDir
-        m_directories.Add(currentDir);
-
-    } else if(line.Contains(wxT("Entering directory '"))) {
-        wxString currentDir = line.AfterFirst(wxT('\''));
-        currentDir = currentDir.BeforeLast(wxT('\''));
-
-        // Collect the m_baseDir
-        m_directories.Add(currentDir);
-    }
-}
-
 void NewBuildTab::OnWorkspaceClosed(wxCommandEvent& e)
 {
     e.Skip();
@@ -514,70 +436,72 @@ void NewBuildTab::OnWorkspaceLoaded(wxCommandEvent& e)
     InitView();
 }
 
-void NewBuildTab::DoProcessOutput(bool compilationEnded, bool isSummaryLine)
+void NewBuildTab::DoProcessParsedLines()
 {
-    wxUnusedVar(isSummaryLine);
-    if(!compilationEnded && m_output.Find(wxT("\n")) == wxNOT_FOUND) {
-        // still dont have a complete line
-        return;
-    }
+    BuildOutputParser::Lines_t lines;
+    m_parser.TakeLines(lines);
+    DoAppendLines(lines);
+}
 
-    wxArrayString lines = ::wxStringTokenize(m_output, wxT("\n"), wxTOKEN_RET_DELIMS);
-    m_output.Clear();
+void NewBuildTab::DoAppendPlainLine(const wxString& text)
+{
+    BuildOutputParser::Lines_t lines;
+    lines.push_back({ text, new BuildLineInfo() });
+    DoAppendLines(lines);
+}
 
-    // Process only completed lines (i.e. a line that ends with '\n')
-    for(size_t i = 0; i < lines.GetCount(); ++i) {
-        if(!compilationEnded && !lines.Item(i).EndsWith(wxT("\n"))) {
-            m_output << lines.Item(i);
-            return;
+void NewBuildTab::DoAppendLines(BuildOutputParser::Lines_t& lines)
+{
+    if(lines.empty()) { return; }
+
+    wxString text;
+    int curline = m_view->GetLineCount() - 1; // -1 because the view always has 1 extra "\n"
+    int longestLine = wxNOT_FOUND;
+    size_t longestLength = 0;
+    for(BuildOutputParser::Line& line : lines) {
+        BuildLineInfo* buildLineInfo = line.info;
+        if(buildLineInfo->GetSeverity() == SV_WARNING) {
+            m_errorsAndWarningsList.push_back(buildLineInfo);
+            m_warnCount++;
+        } else if(buildLineInfo->GetSeverity() == SV_ERROR) {
+            m_errorsAndWarningsList.push_back(buildLineInfo);
+            m_errorsList.push_back(buildLineInfo);
+            m_errorCount++;
         }
 
-        wxString buildLine = lines.Item(i); //.Trim().Trim(false);
-        // If this is a line similar to 'Entering directory `'
-        // add the path in the directories array
-        DoSearchForDirectory(buildLine);
-        BuildLineInfo* buildLineInfo = DoProcessLine(buildLine);
-
         // keep the line info
         if(buildLineInfo->GetFilename().IsEmpty() == false) {
             m_buildInfoPerFile.insert(std::make_pair(buildLineInfo->GetFilename(), buildLineInfo));
         }
 
-        if(isSummaryLine) {
-            buildLine.Trim();
-            buildLine.Prepend("====");
-            buildLine.Append("====");
-            buildLineInfo->SetSeverity(SV_NONE);
-        }
-
-        // Keep the line number in the build tab
-        buildLineInfo->SetLineInBuildTab(m_view->GetLineCount() - 1); // -1 because the view always has 1 extra "\n"
         // Store the line info *before* we add the text
         // it is needed in the OnStyle function
-        m_viewData.insert(std::make_pair(buildLineInfo->GetLineInBuildTab(), buildLineInfo));
-
-        m_view->SetEditable(true);
-        buildLine.Trim();
-        wxString modText;
-        ::clStripTerminalColouring(buildLine, modText);
+        buildLineInfo->SetLineInBuildTab(curline);
+        m_viewData.insert(std::make_pair(curline, buildLineInfo));
 
-        int curline = m_view->GetLineCount() - 1;
-        m_view->AppendText(modText + "\n");
+        if(line.text.length() >= longestLength) {
+            longestLength = line.text.length();
+            longestLine = curline;
+        }
+        text << line.text << "\n";
+        ++curline;
+    }
 
-        // get the newly added line width
-        int endPosition = m_view->GetLineEndPosition(curline); // get character position from begin
-        int beginPosition = m_view->PositionFromLine(curline); // and end of line
+    m_view->SetEditable(true);
+    m_view->AppendText(text);
 
-        wxPoint beginPos = m_view->PointFromPosition(beginPosition);
-        wxPoint endPos = m_view->PointFromPosition(endPosition);
+    // measure only the longest line of the batch
+    int endPosition = m_view->GetLineEndPosition(longestLine);
+    int beginPosition = m_view->PositionFromLine(longestLine);
+    wxPoint beginPos = m_view->PointFromPosition(beginPosition);
+    wxPoint endPos = m_view->PointFromPosition(endPosition);
 
-        int curLen = (endPos.x - beginPos.x) + 10;
-        m_maxlineWidth = wxMax(m_maxlineWidth, curLen);
-        if(m_maxlineWidth > 0) { m_view->SetScrollWidth(m_maxlineWidth); }
-        m_view->SetEditable(false);
+    int curLen = (endPos.x - beginPos.x) + 10;
+    m_maxlineWidth = wxMax(m_maxlineWidth, curLen);
+    if(m_maxlineWidth > 0) { m_view->SetScrollWidth(m_maxlineWidth); }
+    m_view->SetEditable(false);
 
-        if(clConfig::Get().Read(kConfigBuildAutoScroll, true)) { m_view->ScrollToEnd(); }
-    }
+    if(clConfig::Get().Read(kConfigBuildAutoScroll, true)) { m_view->ScrollToEnd(); }
 }
 
 void NewBuildTab::CenterLineInView(int line)
@@ -798,17 +722,14 @@ void NewBuildTab::OnClearUI(wxUpdateUIEvent& e) { e.Enable(!m_buildInProgress &&
 
 void NewBuildTab::ScrollToBottom() { m_view->ScrollToEnd(); }
 
-void NewBuildTab::AppendLine(const wxString& text)
-{
-    m_output << text;
-    DoProcessOutput(false, false);
-}
+void NewBuildTab::AppendLine(const wxString& text) { m_parser.Add(text); }
 
 void NewBuildTab::OnStyleNeeded(wxStyledTextEvent& event)
 {
-    int startPos = m_view->GetEndStyled();
-    int endPos = event.GetPosition();
-    wxString text = m_view->GetTextRange(startPos, endPos);
+    // style only the lines scintilla asks for (i.e. the visible ones), the severity was computed by the parser
+    int startLine = m_view->LineFromPosition(m_view->GetEndStyled());
+    int endLine = m_view->LineFromPosition(event.GetPosition());
+    int startPos = m_view->PositionFromLine(startLine);
 #if wxCHECK_VERSION(3, 1, 1) && !defined(__WXOSX__)
     // The scintilla syntax in e.g. wx3.1.1 changed
     m_view->StartStyling(startPos);
@@ -816,39 +737,28 @@ void NewBuildTab::OnStyleNeeded(wxStyledTextEvent& event)
     m_view->StartStyling(startPos, 0x1f);
 #endif
 
-    int curline = m_view->GetLineCount();
-    curline -= 1; // The view always ends with a "\n", we don't count it as a line
-    wxArrayString lines = ::wxStringTokenize(text, wxT("\n"), wxTOKEN_RET_DELIMS);
-
-    // the last line that we coloured
-    curline -= lines.size();
-
-    for(size_t i = 0; i < lines.size(); ++i) {
-        const wxString& strLine = lines.Item(i);
-        if(m_viewData.count(curline)) {
-            BuildLineInfo* b = m_viewData.find(curline)->second;
-            switch(b->GetSeverity()) {
+    for(int curline = startLine; curline <= endLine; ++curline) {
+        int length = m_view->PositionFromLine(curline + 1) - m_view->PositionFromLine(curline);
+        int style = LEX_GCC_DEFAULT;
+        std::map<int, BuildLineInfo*>::const_iterator iter = m_viewData.find(curline);
+        if(iter != m_viewData.end()) {
+            switch(iter->second->GetSeverity()) {
             case SV_WARNING:
-                m_view->SetStyling(strLine.length(), LEX_GCC_WARNING);
+                style = LEX_GCC_WARNING;
                 break;
             case SV_ERROR:
-                m_view->SetStyling(strLine.length(), LEX_GCC_ERROR);
-                break;
-            case SV_SUCCESS:
-                m_view->SetStyling(strLine.length(), LEX_GCC_DEFAULT);
+                style = LEX_GCC_ERROR;
                 break;
             case SV_DIR_CHANGE:
-                m_view->SetStyling(strLine.length(), LEX_GCC_INFO);
+                style = LEX_GCC_INFO;
                 break;
+            case SV_SUCCESS:
             case SV_NONE:
             default:
-                m_view->SetStyling(strLine.length(), LEX_GCC_DEFAULT);
                 break;
             }
-        } else {
-            m_view->SetStyling(strLine.length(), LEX_GCC_DEFAULT);
         }
-        ++curline;
+        m_view->SetStyling(length, style);
     }
 }
 
@@ -942,146 +852,6 @@ void NewBuildTab::DoCentreErrorLine(BuildLineInfo* bli, clEditor* editor, bool c
     SetActive(editor);
 }
 
-void NewBuildTab::ColourOutput()
-{
-    // Loop over the lines and colour them
-    int fromLine = (m_lastLineColoured == wxNOT_FOUND) ? 0 : m_lastLineColoured;
-    int untilLine = (m_view->GetLineCount() - 1);
-
-    if(fromLine == untilLine) { return; }
-
-    for(int i = fromLine; (i < untilLine) && (untilLine >= fromLine); ++i) {
-        int startPos = m_view->PositionFromLine(i);
-        int lineEndPos = m_view->GetLineEndPosition(i);
-
-#if wxCHECK_VERSION(3, 1, 1) && !defined(__WXOSX__)
-        // The scintilla syntax in e.g. wx3.1.1 changed
-        m_view->StartStyling(startPos);
-#else
-        m_view->StartStyling(startPos, 0x1f);
-#endif
-
-        // Run the regexes
-        wxString lineText = m_view->GetLine(i);
-        LINE_SEVERITY severity;
-        GetMatchingRegex(lineText, severity);
-        switch(severity) {
-        case SV_WARNING:
-            m_view->SetStyling((lineEndPos - startPos), LEX_GCC_WARNING);
-            break;
-        case SV_ERROR:
-            m_view->SetStyling((lineEndPos - startPos), LEX_GCC_ERROR);
-            break;
-        case SV_SUCCESS:
-            m_view->SetStyling((lineEndPos - startPos), LEX_GCC_DEFAULT);
-            break;
-        case SV_DIR_CHANGE:
-            m_view->SetStyling((lineEndPos - startPos), LEX_GCC_INFO);
-            break;
-        case SV_NONE:
-        default:
-            m_view->SetStyling((lineEndPos - startPos), LEX_GCC_DEFAULT);
-            break;
-        }
-    }
-    m_lastLineColoured = untilLine;
-}
-
-CmpPatternPtr NewBuildTab::GetMatchingRegex(const wxString& lineText, LINE_SEVERITY& severity)
-{
-    if(lineText.Lower().Contains("entering directory") || lineText.Lower().Contains("leaving directory")) {
-        severity = SV_DIR_CHANGE;
-        return NULL;
-
-    } else if(lineText.StartsWith("====")) {
-        severity = SV_NONE;
-        return NULL;
-
-    } else {
-
-        // Find *warnings* first
-        bool isWarning = false;
-
-        if(!m_cmp) {
-            severity = SV_NONE;
-            return NULL;
-        }
-
-        CmpPatterns cmpPatterns;
-        if(!DoGetCompilerPatterns(m_cmp->GetName(), cmpPatterns)) {
-            severity = SV_NONE;
-            return NULL;
-        }
-
-        // If it is not an error, maybe it's a warning
-        for(size_t i = 0; i < cmpPatterns.warningPatterns.size(); i++) {
-            CmpPatternPtr cmpPatterPtr = cmpPatterns.warningPatterns.at(i);
-            BuildLineInfo bli;
-            if(cmpPatterPtr->Matches(lineText, bli)) {
-                severity = SV_WARNING;
-                return cmpPatterPtr;
-            }
-        }
-        if(!isWarning) {
-            for(size_t i = 0; i < cmpPatterns.errorsPatterns.size(); i++) {
-                BuildLineInfo bli;
-                CmpPatternPtr cmpPatterPtr = cmpPatterns.errorsPatterns.at(i);
-                if(cmpPatterPtr->Matches(lineText, bli)) {
-                    severity = SV_ERROR;
-                    return cmpPatterPtr;
-                }
-            }
-        }
-    }
-
-    // Default
-    severity = SV_NONE;
-    return NULL;
-}
-
-void NewBuildTab::OnIdle(wxIdleEvent& event)
-{
-    if(m_view->IsEmpty()) { return; }
-    ColourOutput();
-}
-
-////////////////////////////////////////////
-// CmpPatter
-
-bool CmpPattern::Matches(const wxString& line, BuildLineInfo& lineInfo)
-{
-    long fidx, lidx;
-    if(!m_fileIndex.ToLong(&fidx) || !m_lineIndex.ToLong(&lidx)) return false;
-
-    if(!m_regex || !m_regex->IsValid()) return false;
-    if(!m_regex->Matches(line)) return false;
-
-    long colIndex;
-    if(!m_colIndex.ToLong(&colIndex)) return false;
-
-    lineInfo.SetSeverity(m_severity);
-    if(m_regex->GetMatchCount() > (size_t)fidx) { lineInfo.SetFilename(m_regex->GetMatch(line, fidx)); }
-
-    // keep the match length
-    lineInfo.SetRegexLineMatch(m_regex->GetMatch(line, 0).length());
-
-    if(m_regex->GetMatchCount() > (size_t)lidx) {
-        long lineNumber;
-        wxString strLine = m_regex->GetMatch(line, lidx);
-        strLine.ToLong(&lineNumber);
-        lineInfo.SetLineNumber(--lineNumber);
-    }
-
-    if(m_regex->GetMatchCount() > (size_t)colIndex) {
-        long column;
-        wxString strCol = m_regex->GetMatch(line, colIndex);
-        if(strCol.StartsWith(":")) { strCol.Remove(0, 1); }
-
-        if(!strCol.IsEmpty() && strCol.ToLong(&column)) { lineInfo.SetColumn(column); }
-    }
-    return true;
-}
-
 void BuildLineInfo::NormalizeFilename(const wxArrayString& directories, const wxString& cygwinPath)
 {
     wxFileName fn(this->GetFilename());
@@ -1154,3 +924,177 @@ void BuildLineInfo::SetFilename(const wxString& filename)
     this->m_filename = filename;
 #endif
 }
+
+////////////////////////////////////////////
+// BuildOutputParser
+
+BuildOutputParser::BuildOutputParser(const std::function<void()>& notify)
+    : m_notify(notify)
+{
+}
+
+BuildOutputParser::~BuildOutputParser()
+{
+    if(m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+        }
+        m_cv.notify_one();
+        m_thread.join();
+    }
+    for(Line& line : m_lines) {
+        delete line.info;
+    }
+}
+
+void BuildOutputParser::WaitIdle(std::unique_lock<std::mutex>& lock)
+{
+    m_idleCv.wait(lock, [this]() { return !m_busy && !m_flush && m_input.empty(); });
+}
+
+void BuildOutputParser::Start(std::shared_ptr<clBuildOutputMatcher> matcher, const wxString& cygwinRoot)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    WaitIdle(lock);
+    m_matcher = matcher;
+    m_cygwinRoot = cygwinRoot;
+}
+
+void BuildOutputParser::Clear()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    WaitIdle(lock);
+    m_partialLine.Clear();
+    m_directories.Clear();
+    for(Line& line : m_lines) {
+        delete line.info;
+    }
+    m_lines.clear();
+}
+
+void BuildOutputParser::Add(const wxString& output)
+{
+    if(output.IsEmpty()) { return; }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!m_thread.joinable()) { m_thread = std::thread([this]() { WorkerMain(); }); }
+        m_input << output;
+    }
+    m_cv.notify_one();
+}
+
+void BuildOutputParser::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(!m_thread.joinable()) { m_thread = std::thread([this]() { WorkerMain(); }); }
+    m_flush = true;
+    m_cv.notify_one();
+    WaitIdle(lock);
+}
+
+void BuildOutputParser::TakeLines(Lines_t& lines)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    lines.swap(m_lines);
+    m_lines.clear();
+}
+
+void BuildOutputParser::WorkerMain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true) {
+        m_cv.wait(lock, [this]() { return m_shutdown || m_flush || !m_input.empty(); });
+        if(m_shutdown) { break; }
+
+        // take everything received so far and parse it without holding the lock
+        wxString input;
+        input.swap(m_input);
+        bool flush = m_flush;
+        std::shared_ptr<clBuildOutputMatcher> matcher = m_matcher;
+        wxString cygwinRoot = m_cygwinRoot;
+        m_busy = true;
+        lock.unlock();
+
+        Lines_t lines;
+        DoParse(input, flush, matcher.get(), cygwinRoot, lines);
+
+        lock.lock();
+        m_busy = false;
+        if(flush) { m_flush = false; }
+        // a single notification until the lines are taken
+        bool notify = m_lines.empty() && !lines.empty();
+        m_lines.insert(m_lines.end(), lines.begin(), lines.end());
+        if(notify && !flush && m_notify) { m_notify(); }
+        m_idleCv.notify_all();
+    }
+}
+
+void BuildOutputParser::DoParse(const wxString& input, bool flush, clBuildOutputMatcher* matcher,
+                                const wxString& cygwinRoot, Lines_t& lines)
+{
+    m_partialLine << input;
+
+    // process only completed lines (i.e. a line that ends with '\n')
+    size_t start = 0;
+    size_t eol = m_partialLine.find('\n', start);
+    while(eol != wxString::npos) {
+        DoParseLine(m_partialLine.Mid(start, eol - start + 1), matcher, cygwinRoot, lines);
+        start = eol + 1;
+        eol = m_partialLine.find('\n', start);
+    }
+    m_partialLine.Remove(0, start);
+
+    if(flush && !m_partialLine.IsEmpty()) {
+        DoParseLine(m_partialLine, matcher, cygwinRoot, lines);
+        m_partialLine.Clear();
+    }
+}
+
+void BuildOutputParser::DoParseLine(const wxString& rawLine, clBuildOutputMatcher* matcher,
+                                    const wxString& cygwinRoot, Lines_t& lines)
+{
+    wxString text;
+    ::clStripTerminalColouring(rawLine, text);
+
+    // If this is a line similar to 'Entering directory `'
+    // add the path in the directories array
+    DoSearchForDirectory(text);
+
+    BuildLineInfo* buildLineInfo = new BuildLineInfo();
+    wxString lowerText = text.Lower();
+    clBuildOutputMatcher::Match match;
+    if(lowerText.Contains("entering directory") || lowerText.Contains("leaving directory")) {
+        buildLineInfo->SetSeverity(SV_DIR_CHANGE);
+
+    } else if(!text.StartsWith("====") && matcher && matcher->Matches(text, match)) {
+        buildLineInfo->SetSeverity(match.severity == clBuildOutputMatcher::kSeverityWarning ? SV_WARNING : SV_ERROR);
+        buildLineInfo->SetFilename(match.filename);
+        buildLineInfo->SetLineNumber(match.lineNumber);
+        buildLineInfo->NormalizeFilename(m_directories, cygwinRoot);
+        buildLineInfo->SetRegexLineMatch(match.length);
+        buildLineInfo->SetColumn(match.column);
+    }
+
+    text.Trim();
+    lines.push_back({ text, buildLineInfo });
+}
+
+void BuildOutputParser::DoSearchForDirectory(const wxString& line)
+{
+    // Check for makefile directory changes lines
+    if(line.Contains(wxT("Entering directory `"))) {
+        wxString currentDir = line.AfterFirst(wxT('`'));
+        currentDir = currentDir.BeforeLast(wxT('\''));
+
+        // Collect the m_baseDir
+        m_directories.Add(currentDir);
+
+    } else if(line.Contains(wxT("Entering directory '"))) {
+        wxString currentDir = line.AfterFirst(wxT('\''));
+        currentDir = currentDir.BeforeLast(wxT('\''));
+
+        // Collect the m_baseDir
+        m_directories.Add(currentDir);
+    }
+}
@@ -36,8 +36,14 @@
 #include "buildtabsettingsdata.h"
 #include "compiler.h"
 #include <map>
-#include <wx/regex.h>
 #include "cl_command_event.h"
+#include "clBuildOutputMatcher.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <wx/stc/stc.h>
 
 class wxDataViewListCtrl;
@@ -95,51 +101,78 @@ public:
 
 /////////////////////////////////////////////////////////////////
 
-class CmpPattern
+/**
+ * @class BuildOutputParser
+ * @brief splits the build output into lines and matches them against the compiler patterns. The work is done by a
+ * worker thread: the build tab only appends and styles the lines it gets back
+ */
+class BuildOutputParser
 {
+public:
+    struct Line {
+        wxString text; // the text to display
+        BuildLineInfo* info;
+    };
+    typedef std::vector<Line> Lines_t;
+
 protected:
-    wxRegEx* m_regex;
-    wxString m_fileIndex;
-    wxString m_lineIndex;
-    wxString m_colIndex;
-    LINE_SEVERITY m_severity;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;     // wakes up the worker
+    std::condition_variable m_idleCv; // the worker is done with its input
+    wxString m_input;                 // received, not parsed yet
+    Lines_t m_lines;                  // parsed, not taken yet
+    bool m_busy = false;
+    bool m_flush = false;
+    bool m_shutdown = false;
+    std::shared_ptr<clBuildOutputMatcher> m_matcher;
+    wxString m_cygwinRoot;
+    std::function<void()> m_notify;
+
+    // owned by the worker
+    wxString m_partialLine;
+    wxArrayString m_directories;
+
+protected:
+    void WorkerMain();
+    void WaitIdle(std::unique_lock<std::mutex>& lock);
+    void DoParse(const wxString& input, bool flush, clBuildOutputMatcher* matcher, const wxString& cygwinRoot,
+                 Lines_t& lines);
+    void DoParseLine(const wxString& rawLine, clBuildOutputMatcher* matcher, const wxString& cygwinRoot,
+                     Lines_t& lines);
+    void DoSearchForDirectory(const wxString& line);
 
 public:
-    CmpPattern(wxRegEx* re, const wxString& file, const wxString& line, const wxString& column, LINE_SEVERITY severity)
-        : m_regex(re)
-        , m_fileIndex(file)
-        , m_lineIndex(line)
-        , m_colIndex(column)
-        , m_severity(severity)
-    {
-    }
+    /**
+     * @param notify called from the worker thread when parsed lines become available
+     */
+    BuildOutputParser(const std::function<void()>& notify);
+    virtual ~BuildOutputParser();
 
-    ~CmpPattern() { wxDELETE(m_regex); }
+    /**
+     * @brief use 'matcher' for the output of a new build
+     */
+    void Start(std::shared_ptr<clBuildOutputMatcher> matcher, const wxString& cygwinRoot);
 
     /**
-     * @brief return true if "line" matches this pattern
-     * @param lineInfo [output]
+     * @brief discard the pending output and the directories collected so far
      */
-    bool Matches(const wxString& line, BuildLineInfo& lineInfo);
+    void Clear();
 
-    void SetFileIndex(const wxString& fileIndex) { this->m_fileIndex = fileIndex; }
-    void SetLineIndex(const wxString& lineIndex) { this->m_lineIndex = lineIndex; }
-    void SetRegex(wxRegEx* regex) { this->m_regex = regex; }
-    void SetSeverity(LINE_SEVERITY severity) { this->m_severity = severity; }
-    const wxString& GetFileIndex() const { return m_fileIndex; }
-    const wxString& GetLineIndex() const { return m_lineIndex; }
-    void SetColIndex(const wxString& colIndex) { this->m_colIndex = colIndex; }
-    const wxString& GetColIndex() const { return m_colIndex; }
-    wxRegEx* GetRegex() { return m_regex; }
-    LINE_SEVERITY GetSeverity() const { return m_severity; }
-};
-typedef SmartPtr<CmpPattern> CmpPatternPtr;
+    /**
+     * @brief queue build output (not necessarily complete lines)
+     */
+    void Add(const wxString& output);
 
-//////////////////////////////////////////////////////////////////
+    /**
+     * @brief wait for the queued output to be parsed, including the last line (even if it is incomplete)
+     */
+    void Flush();
 
-struct CmpPatterns {
-    std::vector<CmpPatternPtr> errorsPatterns;
-    std::vector<CmpPatternPtr> warningPatterns;
+    /**
+     * @brief move the parsed lines into 'lines'. The caller owns their BuildLineInfo
+     */
+    void TakeLines(Lines_t& lines);
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -148,14 +181,12 @@ class NewBuildTab : public wxPanel
 {
     enum BuildpaneScrollTo { ScrollToFirstError, ScrollToFirstItem, ScrollToEnd };
 
-    typedef std::map<wxString, CmpPatterns> MapCmpPatterns_t;
     typedef std::multimap<wxString, BuildLineInfo*> MultimapBuildInfo_t;
     typedef std::list<BuildLineInfo*> BuildInfoList_t;
 
-    wxString m_output;
     wxStyledTextCtrl* m_view;
     CompilerPtr m_cmp;
-    MapCmpPatterns_t m_cmpPatterns;
+    BuildOutputParser m_parser;
     int m_warnCount;
     int m_errorCount;
     BuildTabSettingsData m_buildTabSettings;
@@ -164,7 +195,6 @@ class NewBuildTab : public wxPanel
     BuildTabSettingsData::ShowBuildPane m_showMe;
     wxStopWatch m_sw;
     MultimapBuildInfo_t m_buildInfoPerFile;
-    wxArrayString m_directories;
     bool m_skipWarnings;
     BuildpaneScrollTo m_buildpaneScrollTo;
     BuildInfoList_t m_errorsAndWarningsList;
@@ -174,24 +204,20 @@ class NewBuildTab : public wxPanel
     wxString m_cygwinRoot;
     std::map<int, BuildLineInfo*> m_viewData;
     int m_maxlineWidth;
-    int m_lastLineColoured;
 
 protected:
     void InitView(const wxString& theme = "");
     void CenterLineInView(int line);
-    void DoCacheRegexes();
-    BuildLineInfo* DoProcessLine(const wxString& line);
-    void DoProcessOutput(bool compilationEnded, bool isSummaryLine);
-    void DoSearchForDirectory(const wxString& line);
-    bool DoGetCompilerPatterns(const wxString& compilerName, CmpPatterns& patterns);
+    std::shared_ptr<clBuildOutputMatcher> DoCreateMatcher() const;
+    void DoProcessParsedLines();
+    void DoAppendLines(BuildOutputParser::Lines_t& lines);
+    void DoAppendPlainLine(const wxString& text);
     void DoClear();
     void MarkEditor(clEditor* editor);
     void DoToggleWindow();
     bool DoSelectAndOpen(int buildViewLine, bool centerLine);
     wxFont DoGetFont() const;
     void DoCentreErrorLine(BuildLineInfo* bli, clEditor* editor, bool centerLine);
-    void ColourOutput();
-    CmpPatternPtr GetMatchingRegex(const wxString& lineText, LINE_SEVERITY& severity);
 
 public:
     NewBuildTab(wxWindow* parent);
@@ -226,7 +252,6 @@ protected:
     void OnClearUI(wxUpdateUIEvent& e);
     void OnStyleNeeded(wxStyledTextEvent& event);
     void OnHotspotClicked(wxStyledTextEvent& event);
-    void OnIdle(wxIdleEvent& event);
 };
 
 #endif // NEWBUILDTAB_H
@@ -1,24 +1,25 @@
 #include "CompileCommandsJSON.h"
-#include "JSON.h"
+#include "CompileCommandsReader.h"
 #include "compiler_command_line_parser.h"
     
 CompileCommandsJSON::CompileCommandsJSON(const wxString& filename)
     : m_filename(filename)
 {
     if(m_filename.FileExists()) {
-        JSON json(m_filename);
-        JSONItem arr = json.toElement();
-        const int count = arr.arraySize();
-        for(int i = 0; i < count; ++i) {
-            wxString command = arr.arrayItem(i).namedObject("command").toString();
-            wxString workingDirectory = arr.arrayItem(i).namedObject("directory").toString();
-            
-            // Use the workingDirectory to convert all paths to full path
-            CompilerCommandLineParser cclp(command, workingDirectory);
-            m_includes = cclp.GetIncludes();
-            m_macros = cclp.GetMacros();
-            m_others = cclp.GetOtherOptions();
-        }
+        // Only the flags of the last entry are kept: remember its command and parse it once
+        std::string command;
+        std::string workingDirectory;
+        CompileCommandsReader::Read(m_filename, [&](const CompileCommandsReader::Entry& entry) {
+            command = entry.command;
+            workingDirectory = entry.directory;
+        });
+
+        // Use the workingDirectory to convert all paths to full path
+        CompilerCommandLineParser cclp(wxString::FromUTF8(command.c_str(), command.length()),
+                                       wxString::FromUTF8(workingDirectory.c_str(), workingDirectory.length()));
+        m_includes = cclp.GetIncludes();
+        m_macros = cclp.GetMacros();
+        m_others = cclp.GetOtherOptions();
     }
 }
 
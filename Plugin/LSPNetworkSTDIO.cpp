@@ -6,6 +6,7 @@
 #include "ChildProcess.h"
 #include "processreaderthread.h"
 #include "dirsaver.h"
+#include "fileutils.h"
 
 LSPNetworkSTDIO::LSPNetworkSTDIO() {}
 
@@ -36,7 +37,8 @@ void LSPNetworkSTDIO::Open(const LSPStartupInfo& siInfo)
 void LSPNetworkSTDIO::Send(const std::string& data)
 {
     if(m_server) {
-        clDEBUG() << "LSPNetworkSTDIO:\n" << data;
+        clDEBUG() << "LSPNetworkSTDIO: sending" << data.length() << "bytes";
+        clDEBUG1() << "LSPNetworkSTDIO:\n" << data;
         m_server->Write(data);
     } else {
         clDEBUG() << "LSPNetworkSTDIO: no process !?";
@@ -55,9 +57,13 @@ void LSPNetworkSTDIO::OnProcessTerminated(clProcessEvent& event)
 
 void LSPNetworkSTDIO::OnProcessOutput(clProcessEvent& event)
 {
-    const wxString& dataRead = event.GetOutput();
     clCommandEvent evt(wxEVT_LSP_NET_DATA_READY);
-    evt.SetString(dataRead);
+    if(!event.GetOutputRaw().empty()) {
+        evt.SetStringRaw(event.GetOutputRaw());
+    } else {
+        // the process output was already converted to a string
+        evt.SetStringRaw(FileUtils::ToStdString(event.GetOutput()));
+    }
     AddPendingEvent(evt);
 }
 
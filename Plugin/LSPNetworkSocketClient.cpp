@@ -58,7 +58,7 @@ void LSPNetworkSocketClient::Open(const LSPStartupInfo& info)
     }
     
     // Now that the process is up, connect to the server
-    m_socket.reset(new clAsyncSocket(m_startupInfo.GetConnectioString(), kAsyncSocketBuffer | kAsyncSocketClient));
+    m_socket.reset(new clAsyncSocket(m_startupInfo.GetConnectioString(), kAsyncSocketBuffer | kAsyncSocketRawBuffer | kAsyncSocketClient));
     m_socket->Bind(wxEVT_ASYNC_SOCKET_CONNECTED, &LSPNetworkSocketClient::OnSocketConnected, this);
     m_socket->Bind(wxEVT_ASYNC_SOCKET_CONNECTION_LOST, &LSPNetworkSocketClient::OnSocketConnectionLost, this);
     m_socket->Bind(wxEVT_ASYNC_SOCKET_CONNECT_ERROR, &LSPNetworkSocketClient::OnSocketConnectionError, this);
@@ -70,7 +70,8 @@ void LSPNetworkSocketClient::Open(const LSPStartupInfo& info)
 void LSPNetworkSocketClient::Send(const std::string& data)
 {
     if(m_socket) {
-        clDEBUG() << "LSP socket:\n" << data;
+        clDEBUG() << "LSP socket: sending" << data.length() << "bytes";
+        clDEBUG1() << "LSP socket:\n" << data;
         m_socket->Send(data);
     } else {
         clDEBUG() << "LSP socket: no socket !?";
@@ -107,8 +108,7 @@ void LSPNetworkSocketClient::OnSocketError(clCommandEvent& event)
 
 void LSPNetworkSocketClient::OnSocketData(clCommandEvent& event)
 {
-    const wxString& dataRead = event.GetString();
     clCommandEvent evt(wxEVT_LSP_NET_DATA_READY);
-    evt.SetString(dataRead);
+    evt.SetStringRaw(event.GetStringRaw());
     AddPendingEvent(evt);
 }
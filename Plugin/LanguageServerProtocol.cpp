@@ -1,3 +1,4 @@
+#include "LSP/CancelRequestNotification.hpp"
 #include "LSP/CompletionRequest.h"
 #include "LSP/DidChangeTextDocumentRequest.h"
 #include "LSP/DidCloseTextDocumentRequest.h"
@@ -29,11 +30,55 @@
 #include "imanager.h"
 #include "processreaderthread.h"
 #include "wxmd5.h"
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <wx/app.h>
 #include <wx/filesys.h>
 #include <wx/stc/stc.h>
 
+// Incremental sync: once a document has this many pending changes (or more changed bytes than its size), its whole
+// content is sent instead
+#define MAX_PENDING_CHANGES 1000
+// Requests sent to the server without waiting for the previous replies
+#define MAX_REQUESTS_IN_FLIGHT 8
+// A request that did not get its reply after this many milliseconds is no longer waited for
+#define REQUEST_TIMEOUT_MS 30000
+// The replies latency is written to the log every LOG_STATS_INTERVAL replies
+#define LOG_STATS_INTERVAL 100
+
+namespace
+{
+/**
+ * @brief the length of UTF-8 text in UTF-16 code units (the LSP character offsets unit)
+ */
+int UTF16Length(const char* text, size_t len)
+{
+    int count = 0;
+    for(size_t i = 0; i < len; ++i) {
+        unsigned char ch = (unsigned char)text[i];
+        if((ch & 0xC0) != 0x80) {
+            // a character outside the BMP takes 2 code units
+            count += (ch >= 0xF0) ? 2 : 1;
+        }
+    }
+    return count;
+}
+
+LSP::Position GetLSPPosition(wxStyledTextCtrl* ctrl, int pos)
+{
+    int line = ctrl->LineFromPosition(pos);
+    int lineStart = ctrl->PositionFromLine(line);
+    if(pos == lineStart) {
+        return LSP::Position(line, 0);
+    }
+    wxCharBuffer text = ctrl->GetTextRangeRaw(lineStart, pos);
+    return LSP::Position(line, UTF16Length(text.data(), text.length()));
+}
+
+bool IsSingleLine(const LSP::Range& range) { return range.GetStart().GetLine() == range.GetEnd().GetLine(); }
+} // namespace
+
 LanguageServerProtocol::LanguageServerProtocol(const wxString& name, eNetworkType netType, wxEvtHandler* owner,
                                                IPathConverter::Ptr_t pathConverter)
     : ServiceProvider(wxString() << "LSP: " << name, eServiceType::kCodeCompletion)
@@ -52,6 +97,7 @@ LanguageServerProtocol::LanguageServerProtocol(const wxString& name, eNetworkTyp
     Bind(wxEVT_CC_CODE_COMPLETE, &LanguageServerProtocol::OnCodeComplete, this);
     Bind(wxEVT_CC_CODE_COMPLETE_FUNCTION_CALLTIP, &LanguageServerProtocol::OnFunctionCallTip, this);
     EventNotifier::Get()->Bind(wxEVT_CC_SHOW_QUICK_OUTLINE, &LanguageServerProtocol::OnQuickOutline, this);
+    wxTheApp->Bind(wxEVT_STC_MODIFIED, &LanguageServerProtocol::OnStcModified, this);
 
     // Use sockets here
     switch(netType) {
@@ -79,6 +125,7 @@ LanguageServerProtocol::~LanguageServerProtocol()
     Unbind(wxEVT_CC_CODE_COMPLETE, &LanguageServerProtocol::OnCodeComplete, this);
     Unbind(wxEVT_CC_CODE_COMPLETE_FUNCTION_CALLTIP, &LanguageServerProtocol::OnFunctionCallTip, this);
     EventNotifier::Get()->Unbind(wxEVT_CC_SHOW_QUICK_OUTLINE, &LanguageServerProtocol::OnQuickOutline, this);
+    wxTheApp->Unbind(wxEVT_STC_MODIFIED, &LanguageServerProtocol::OnStcModified, this);
     DoClear();
 }
 
@@ -138,8 +185,9 @@ void LanguageServerProtocol::QueueMessage(LSP::MessageWithParams::Ptr_t request)
     if(!IsInitialized()) {
         return;
     }
-    if(request->As<LSP::CompletionRequest>()) {
-        m_lastCompletionRequestId = request->As<LSP::CompletionRequest>()->GetId();
+    // a newer completion (or signature help) request makes the previous ones useless
+    if(request->As<LSP::CompletionRequest>() || request->As<LSP::SignatureHelpRequest>()) {
+        DoCancelRequests(request->GetMethod());
     }
     m_Queue.Push(request);
     ProcessQueue();
@@ -204,11 +252,12 @@ bool LanguageServerProtocol::Start()
 void LanguageServerProtocol::DoClear()
 {
     m_filesSent.clear();
-    m_outputBuffer.clear();
+    m_reader.Clear();
     m_state = kUnInitialized;
     m_initializeRequestID = wxNOT_FOUND;
     m_Queue.Clear();
-    m_lastCompletionRequestId = wxNOT_FOUND;
+    m_textDocumentSync = kTextDocumentSyncFull;
+    m_documents.clear();
     // Destory the current connection
     m_network->Close();
 }
@@ -310,17 +359,7 @@ void LanguageServerProtocol::FindDefinition(IEditor* editor)
     CHECK_COND_RET(ShouldHandleFile(editor));
 
     // If the editor is modified, we need to tell the LSP to reparse the source file
-    const wxFileName& filename = editor->GetFileName();
-    if(m_filesSent.count(filename.GetFullPath()) && editor->IsModified()) {
-        // we already sent this file over, ask for change parse
-        std::string fileContent;
-        editor->GetEditorTextRaw(fileContent);
-        SendChangeRequest(filename, fileContent);
-    } else if(m_filesSent.count(filename.GetFullPath()) == 0) {
-        std::string fileContent;
-        editor->GetEditorTextRaw(fileContent);
-        SendOpenRequest(filename, fileContent, GetLanguageId(filename));
-    }
+    DoSyncEditor(editor);
 
     LSP::GotoDefinitionRequest::Ptr_t req = LSP::MessageWithParams::MakeRequest(new LSP::GotoDefinitionRequest(
         editor->GetFileName(), editor->GetCurrentLine(), editor->GetCtrl()->GetColumn(editor->GetCurrentPosition())));
@@ -354,6 +393,7 @@ void LanguageServerProtocol::SendCloseRequest(const wxFileName& filename)
         LSP::MessageWithParams::MakeRequest(new LSP::DidCloseTextDocumentRequest(filename));
     QueueMessage(req);
     m_filesSent.erase(filename.GetFullPath());
+    m_documents.erase(filename.GetFullPath());
 }
 
 void LanguageServerProtocol::SendChangeRequest(const wxFileName& filename, const std::string& fileContent)
@@ -415,9 +455,8 @@ void LanguageServerProtocol::OnFileSaved(clCommandEvent& event)
     IEditor* editor = clGetManager()->GetActiveEditor();
     CHECK_PTR_RET(editor);
     if(ShouldHandleFile(editor)) {
-        std::string fileContent;
-        editor->GetEditorTextRaw(fileContent);
-        SendSaveRequest(editor->GetFileName(), fileContent);
+        // For now: report a change event (see SendSaveRequest)
+        SendChangeRequest(editor);
     }
 }
 
@@ -430,16 +469,13 @@ void LanguageServerProtocol::OpenEditor(IEditor* editor)
         return;
     }
     if(editor && ShouldHandleFile(editor)) {
-        std::string fileContent;
-        editor->GetEditorTextRaw(fileContent);
-
         if(m_filesSent.count(editor->GetFileName().GetFullPath())) {
             clDEBUG() << "OpenEditor->SendChangeRequest called for:" << editor->GetFileName().GetFullName();
-            SendChangeRequest(editor->GetFileName(), fileContent);
+            SendChangeRequest(editor);
         } else {
 
             clDEBUG() << "OpenEditor->SendOpenRequest called for:" << editor->GetFileName().GetFullName();
-            SendOpenRequest(editor->GetFileName(), fileContent, GetLanguageId(editor->GetFileName()));
+            SendOpenRequest(editor);
         }
     }
 }
@@ -451,16 +487,7 @@ void LanguageServerProtocol::FunctionHelp(IEditor* editor)
     CHECK_COND_RET(ShouldHandleFile(editor));
     // If the editor is modified, we need to tell the LSP to reparse the source file
     const wxFileName& filename = editor->GetFileName();
-    if(m_filesSent.count(filename.GetFullPath()) && editor->IsModified()) {
-        // we already sent this file over, ask for change parse
-        std::string fileContent;
-        editor->GetEditorTextRaw(fileContent);
-        SendChangeRequest(filename, fileContent);
-    } else if(m_filesSent.count(filename.GetFullPath()) == 0) {
-        std::string fileContent;
-        editor->GetEditorTextRaw(fileContent);
-        SendOpenRequest(filename, fileContent, GetLanguageId(filename));
-    }
+    DoSyncEditor(editor);
 
     if(ShouldHandleFile(filename)) {
         LSP::SignatureHelpRequest::Ptr_t req = LSP::MessageWithParams::MakeRequest(new LSP::SignatureHelpRequest(
@@ -475,18 +502,7 @@ void LanguageServerProtocol::CodeComplete(IEditor* editor)
     CHECK_PTR_RET(editor);
     CHECK_COND_RET(ShouldHandleFile(editor));
     // If the editor is modified, we need to tell the LSP to reparse the source file
-    const wxFileName& filename = editor->GetFileName();
-
-    if(m_filesSent.count(filename.GetFullPath()) && editor->IsModified()) {
-        std::string text;
-        editor->GetEditorTextRaw(text);
-        SendChangeRequest(filename, text);
-
-    } else if(m_filesSent.count(filename.GetFullPath()) == 0) {
-        std::string text;
-        editor->GetEditorTextRaw(text);
-        SendOpenRequest(filename, text, GetLanguageId(filename));
-    }
+    DoSyncEditor(editor);
 
     // Now request the for code completion
     SendCodeCompleteRequest(editor->GetFileName(), editor->GetCurrentLine(),
@@ -498,22 +514,75 @@ void LanguageServerProtocol::ProcessQueue()
     if(m_Queue.IsEmpty()) {
         return;
     }
-    if(m_Queue.IsWaitingReponse()) {
-        clDEBUG() << "LSP is busy, will not send message";
+    if(!IsRunning()) {
+        clDEBUG() << GetLogPrefix() << "is down.";
         return;
     }
-    LSP::MessageWithParams::Ptr_t req = m_Queue.Get();
+
+    size_t expired = m_Queue.ExpireRequests(REQUEST_TIMEOUT_MS);
+    if(expired) {
+        clWARNING() << GetLogPrefix() << expired << "requests did not get a reply after" << REQUEST_TIMEOUT_MS
+                    << "ms. Not waiting for them anymore" << clEndl;
+    }
+
+    // Send the requests without waiting for the previous replies, up to MAX_REQUESTS_IN_FLIGHT
+    while(!m_Queue.IsEmpty()) {
+        if(!m_Queue.CanSend(MAX_REQUESTS_IN_FLIGHT)) {
+            clDEBUG() << GetLogPrefix() << m_Queue.GetInFlightCount()
+                      << "requests are waiting for a reply, will not send message";
+            break;
+        }
+        LSP::MessageWithParams::Ptr_t req = m_Queue.Get();
+        m_network->Send(req->ToString(m_pathConverter));
+        m_Queue.SetSent(req);
+        m_Queue.Pop();
+        if(!req->GetStatusMessage().IsEmpty()) {
+            clGetManager()->SetStatusMessage(req->GetStatusMessage(), 1);
+        }
+    }
+}
+
+void LanguageServerProtocol::DoCancelRequests(const wxString& method)
+{
+    std::vector<int> ids = m_Queue.CancelRequests(method);
     if(!IsRunning()) {
-        clDEBUG() << GetLogPrefix() << "is down.";
         return;
     }
+    for(int id : ids) {
+        clDEBUG() << GetLogPrefix() << "Cancelling" << method << "request ID#" << id;
+        LSP::CancelRequestNotification::Ptr_t cancelNotification =
+            LSP::MessageWithParams::MakeRequest(new LSP::CancelRequestNotification(id));
+        m_network->Send(cancelNotification->ToString(m_pathConverter));
+    }
+}
+
+bool LanguageServerProtocol::IsStaleReply(LSP::MessageWithParams::Ptr_t message) const
+{
+    LSP::Request* req = message ? message->As<LSP::Request>() : nullptr;
+    if(!req || !req->IsPositionDependantRequest()) {
+        return false;
+    }
+    IEditor* editor = clGetManager()->GetActiveEditor();
+    if(!editor) {
+        return true;
+    }
+    const wxFileName& filename = editor->GetFileName();
+    size_t line = editor->GetCurrentLine();
+    size_t column = editor->GetCtrl()->GetColumn(editor->GetCurrentPosition());
+    return !req->IsValidAt(filename, line, column);
+}
 
-    // Write the message length as string of 10 bytes
-    m_network->Send(req->ToString(m_pathConverter));
-    m_Queue.SetWaitingReponse(true);
-    m_Queue.Pop();
-    if(!req->GetStatusMessage().IsEmpty()) {
-        clGetManager()->SetStatusMessage(req->GetStatusMessage(), 1);
+void LanguageServerProtocol::LogLatencyStats() const
+{
+    typedef std::map<wxString, LSPRequestMessageQueue::LatencyStats> StatsMap_t;
+    for(const StatsMap_t::value_type& vt : m_Queue.GetStats()) {
+        const LSPRequestMessageQueue::LatencyStats& stats = vt.second;
+        if(stats.count == 0) {
+            continue;
+        }
+        clDEBUG() << GetLogPrefix() << vt.first << ":" << stats.count << "replies (" << stats.dropped
+                  << "dropped), average:" << (stats.totalMs / (long)stats.count).ToLong()
+                  << "ms, max:" << stats.maxMs.ToLong() << "ms";
     }
 }
 
@@ -538,17 +607,7 @@ void LanguageServerProtocol::FindDeclaration(IEditor* editor)
         CHECK_COND_RET(ShouldHandleFile(editor));
 
         // If the editor is modified, we need to tell the LSP to reparse the source file
-        const wxFileName& filename = editor->GetFileName();
-        if(m_filesSent.count(filename.GetFullPath()) && editor->IsModified()) {
-            // we already sent this file over, ask for change parse
-            std::string content;
-            editor->GetEditorTextRaw(content);
-            SendChangeRequest(filename, content);
-        } else if(m_filesSent.count(filename.GetFullPath()) == 0) {
-            std::string content;
-            editor->GetEditorTextRaw(content);
-            SendOpenRequest(filename, content, GetLanguageId(filename));
-        }
+        DoSyncEditor(editor);
 
         LSP::GotoDeclarationRequest::Ptr_t req = LSP::MessageWithParams::MakeRequest(
             new LSP::GotoDeclarationRequest(editor->GetFileName(), editor->GetCurrentLine(),
@@ -584,21 +643,56 @@ void LanguageServerProtocol::OnNetError(clCommandEvent& event)
 
 void LanguageServerProtocol::OnNetDataReady(clCommandEvent& event)
 {
-    clDEBUG() << GetLogPrefix() << event.GetString();
-    wxString buffer = std::move(event.GetString());
-    m_outputBuffer << buffer;
-    m_Queue.SetWaitingReponse(false);
-
-    while(true) {
-        // Did we get a complete message?
-        LSP::ResponseMessage res(m_outputBuffer, m_pathConverter);
+    const std::string& data = event.GetStringRaw();
+    clDEBUG() << GetLogPrefix() << "received" << data.length() << "bytes";
+    m_reader.Append(data.c_str(), data.length());
+
+    // Handle the complete messages, they are parsed directly from the reader buffer
+    const char* content = nullptr;
+    size_t contentLength = 0;
+    while(m_reader.Next(content, contentLength)) {
+        if(FileLogger::CanLog(FileLogger::Developer)) {
+            clDEBUG1() << GetLogPrefix() << wxString(content, wxConvUTF8, contentLength);
+        }
+        LSP::ResponseMessage res(content, contentLength, m_pathConverter);
         if(res.IsOk()) {
             if(IsInitialized()) {
-                LSP::MessageWithParams::Ptr_t msg_ptr = m_Queue.TakePendingReplyMessage(res.GetId());
-                // Is this an error message?
-                if(res.Has("error")) {
+                // Requests coming from the server have their own ids, don't match them with ours
+                LSPRequestMessageQueue::PendingRequest pending;
+                bool isReply = !res.Has("method") && m_Queue.TakePendingReply(res.GetId(), pending);
+                LSP::MessageWithParams::Ptr_t msg_ptr = pending.message;
+                bool discard = false;
+                if(isReply) {
+                    if(pending.cancelled) {
+                        clDEBUG() << GetLogPrefix() << "Received a reply for the cancelled" << msg_ptr->GetMethod()
+                                  << "request ID#" << res.GetId() << ". Dropping it";
+                        discard = true;
+                    } else if(!res.Has("error") && IsStaleReply(msg_ptr)) {
+                        clDEBUG() << GetLogPrefix() << "Reply for" << msg_ptr->GetMethod() << "request ID#"
+                                  << res.GetId() << "is no longer valid. Discarding its result";
+                        discard = true;
+                    }
+
+                    wxLongLong elapsedMs = ::wxGetLocalTimeMillis() - pending.sentTime;
+                    m_Queue.AddReply(msg_ptr->GetMethod(), elapsedMs, discard);
+                    clDEBUG() << GetLogPrefix() << msg_ptr->GetMethod() << "reply ID#" << res.GetId()
+                              << "received after" << elapsedMs.ToLong() << "ms";
+                    if((++m_repliesCount % LOG_STATS_INTERVAL) == 0) {
+                        LogLatencyStats();
+                    }
+                }
+
+                if(discard) {
+                    // nothing to do here
+                } else if(res.Has("error")) {
+                    // Is this an error message?
                     clDEBUG() << GetLogPrefix() << "received an error message";
-                    LSP::ResponseError errMsg(res.GetMessageString(), m_pathConverter);
+                    if(!isReply && !res.Has("method")) {
+                        // an error we can't match with a request (e.g. the server could not parse the request):
+                        // don't wait for the replies of the requests sent so far
+                        m_Queue.ClearPendingReplies();
+                    }
+                    LSP::ResponseError errMsg(res.GetJSON(), m_pathConverter);
                     switch(errMsg.GetErrorCode()) {
                     case LSP::ResponseError::kErrorCodeInternalError:
                     case LSP::ResponseError::kErrorCodeInvalidRequest: {
@@ -609,6 +703,9 @@ void LanguageServerProtocol::OnNetDataReady(clCommandEvent& event)
                         break;
                     }
                     case LSP::ResponseError::kErrorCodeMethodNotFound: {
+                        if(!msg_ptr) {
+                            break;
+                        }
                         // User requested a mesasge which is not supported by this server
                         clGetManager()->SetStatusMessage(wxString() << GetLogPrefix() << _("method: ")
                                                                     << msg_ptr->GetMethod() << _(" is not supported"));
@@ -634,26 +731,9 @@ void LanguageServerProtocol::OnNetDataReady(clCommandEvent& event)
                 } else {
                     if(msg_ptr && msg_ptr->As<LSP::Request>()) {
                         clDEBUG() << GetLogPrefix() << "received a response";
-                        // Check if the reply is still valid
-                        IEditor* editor = clGetManager()->GetActiveEditor();
-                        if(editor) {
-                            LSP::Request* preq = msg_ptr->As<LSP::Request>();
-                            if(preq->As<LSP::CompletionRequest>() && (preq->GetId() < m_lastCompletionRequestId)) {
-                                clDEBUG() << "Received a response for completion message ID#" << preq->GetId()
-                                          << ". However, a newer completion request with ID#"
-                                          << m_lastCompletionRequestId << "was already sent. Dropping response";
-                                return;
-                            }
+                        if(clGetManager()->GetActiveEditor()) {
                             // let the originating request to handle it
-                            const wxFileName& filename = editor->GetFileName();
-                            size_t line = editor->GetCurrentLine();
-                            size_t column = editor->GetCtrl()->GetColumn(editor->GetCurrentPosition());
-                            if(false && preq->IsPositionDependantRequest() &&
-                               !preq->IsValidAt(filename, line, column)) {
-                                clDEBUG() << "Response is no longer valid. Discarding its result";
-                            } else {
-                                preq->OnResponse(res, m_owner, m_pathConverter);
-                            }
+                            msg_ptr->As<LSP::Request>()->OnResponse(res, m_owner, m_pathConverter);
                         }
 
                     } else if(res.IsPushDiagnostics()) {
@@ -700,6 +780,20 @@ void LanguageServerProtocol::OnNetDataReady(clCommandEvent& event)
                 // we only accept initialization responses here
                 if(res.GetId() == m_initializeRequestID) {
                     m_state = kInitialized;
+                    LSPRequestMessageQueue::PendingRequest pending;
+                    if(m_Queue.TakePendingReply(res.GetId(), pending)) {
+                        m_Queue.AddReply(pending.message->GetMethod(), ::wxGetLocalTimeMillis() - pending.sentTime,
+                                         false);
+                    }
+
+                    // textDocumentSync is either a TextDocumentSyncKind or a TextDocumentSyncOptions
+                    JSONItem textDocumentSync = res.Get("result")["capabilities"]["textDocumentSync"];
+                    if(textDocumentSync.isNumber()) {
+                        m_textDocumentSync = textDocumentSync.toInt(kTextDocumentSyncFull);
+                    } else if(textDocumentSync.hasNamedObject("change")) {
+                        m_textDocumentSync = textDocumentSync["change"].toInt(kTextDocumentSyncFull);
+                    }
+                    clDEBUG() << GetLogPrefix() << "Text document sync kind:" << m_textDocumentSync << clEndl;
 
                     clDEBUG() << GetLogPrefix() << "Sending InitializedNotification" << clEndl;
                     LSP::InitializedNotification::Ptr_t initNotification =
@@ -717,12 +811,9 @@ void LanguageServerProtocol::OnNetDataReady(clCommandEvent& event)
                     clDEBUG() << GetLogPrefix() << "Server not initialized. This message is ignored";
                 }
             }
-            // A message was consumed from the buffer, see if we got more messages
-            if(!m_outputBuffer.empty()) {
-                continue;
-            }
+        } else {
+            clWARNING() << GetLogPrefix() << "received an invalid message of" << contentLength << "bytes" << clEndl;
         }
-        break;
     }
     ProcessQueue();
 }
@@ -730,6 +821,7 @@ void LanguageServerProtocol::OnNetDataReady(clCommandEvent& event)
 void LanguageServerProtocol::Stop()
 {
     clDEBUG() << GetLogPrefix() << "Going down";
+    LogLatencyStats();
     m_network->Close();
 }
 
@@ -753,17 +845,7 @@ void LanguageServerProtocol::FindImplementation(IEditor* editor)
         CHECK_COND_RET(ShouldHandleFile(editor));
 
         // If the editor is modified, we need to tell the LSP to reparse the source file
-        const wxFileName& filename = editor->GetFileName();
-        if(m_filesSent.count(filename.GetFullPath()) && editor->IsModified()) {
-            // we already sent this file over, ask for change parse
-            std::string content;
-            editor->GetEditorTextRaw(content);
-            SendChangeRequest(filename, content);
-        } else if(m_filesSent.count(filename.GetFullPath()) == 0) {
-            std::string content;
-            editor->GetEditorTextRaw(content);
-            SendOpenRequest(filename, content, GetLanguageId(filename));
-        }
+        DoSyncEditor(editor);
 
         LSP::GotoImplementationRequest::Ptr_t req = LSP::MessageWithParams::MakeRequest(
             new LSP::GotoImplementationRequest(editor->GetFileName(), editor->GetCurrentLine(),
@@ -804,7 +886,8 @@ void LanguageServerProtocol::DocumentSymbols(IEditor* editor)
 
 void LanguageServerProtocol::UpdateFileSent(const wxFileName& filename, const std::string& fileContent)
 {
-    wxString checksum = wxMD5::GetDigest(fileContent);
+    // with incremental sync the editor changes are tracked instead, an empty checksum means "unknown"
+    wxString checksum = IsIncrementalSync() ? wxString() : wxMD5::GetDigest(fileContent);
     m_filesSent.erase(filename.GetFullPath());
     clDEBUG() << "Caching file:" << filename << "with checksum:" << checksum << clEndl;
     m_filesSent.insert({ filename.GetFullPath(), checksum });
@@ -813,34 +896,193 @@ void LanguageServerProtocol::UpdateFileSent(const wxFileName& filename, const st
 bool LanguageServerProtocol::IsFileChangedSinceLastParse(const wxFileName& filename,
                                                          const std::string& fileContent) const
 {
-    if(m_filesSent.count(filename.GetFullPath()) == 0) {
+    wxStringMap_t::const_iterator iter = m_filesSent.find(filename.GetFullPath());
+    if(iter == m_filesSent.end() || iter->second.IsEmpty()) {
         return true;
     }
     wxString checksum = wxMD5::GetDigest(fileContent);
-    return m_filesSent.find(filename.GetFullPath())->second != checksum;
+    return iter->second != checksum;
 }
 
-//===------------------------------------------------------------------
-// LSPRequestMessageQueue
-//===------------------------------------------------------------------
+void LanguageServerProtocol::DoSyncEditor(IEditor* editor)
+{
+    const wxFileName& filename = editor->GetFileName();
+    if(m_filesSent.count(filename.GetFullPath()) == 0) {
+        SendOpenRequest(editor);
+    } else if(editor->IsModified() || m_documents.count(filename.GetFullPath())) {
+        // we already sent this file over, ask for change parse
+        SendChangeRequest(editor);
+    }
+}
+
+void LanguageServerProtocol::SendOpenRequest(IEditor* editor)
+{
+    std::string fileContent;
+    editor->GetEditorTextRaw(fileContent);
+    SendOpenRequest(editor->GetFileName(), fileContent, GetLanguageId(editor->GetFileName()));
+    DoTrackEditor(editor);
+}
 
-void LSPRequestMessageQueue::Push(LSP::MessageWithParams::Ptr_t message)
+void LanguageServerProtocol::SendChangeRequest(IEditor* editor)
 {
-    m_Queue.push(message);
+    const wxFileName& filename = editor->GetFileName();
+    Document* doc = DoGetIncrementalDocument(editor);
+    if(doc) {
+        if(doc->changes.empty()) {
+            clDEBUG() << GetLogPrefix() << "No changes detected in file:" << filename << clEndl;
+            return;
+        }
+        if(!IsInitialized()) {
+            return;
+        }
+        clDEBUG() << GetLogPrefix() << "Sending" << doc->changes.size() << "changes of file:" << filename << clEndl;
+        LSP::DidChangeTextDocumentRequest::Ptr_t req =
+            LSP::MessageWithParams::MakeRequest(new LSP::DidChangeTextDocumentRequest(filename, doc->changes));
+#ifndef __WXOSX__
+        req->SetStatusMessage(wxString() << GetLogPrefix() << " re-parsing file: " << filename.GetFullName());
+#endif
+        doc->changes.clear();
+        doc->changesBytes = 0;
+        QueueMessage(req);
+        return;
+    }
 
-    // Messages of type 'Request' require responses from the server
-    LSP::Request* req = message->As<LSP::Request>();
-    if(req) {
-        m_pendingReplyMessages.insert({ req->GetId(), message });
+    // send the whole content, and track the changes from now on
+    std::string fileContent;
+    editor->GetEditorTextRaw(fileContent);
+    SendChangeRequest(filename, fileContent);
+    DoTrackEditor(editor);
+}
+
+void LanguageServerProtocol::DoTrackEditor(IEditor* editor)
+{
+    if(!IsIncrementalSync() || !editor->GetCtrl()) {
+        return;
+    }
+    Document& doc = m_documents[editor->GetFileName().GetFullPath()];
+    doc = Document();
+    doc.ctrl = editor->GetCtrl();
+}
+
+LanguageServerProtocol::Document* LanguageServerProtocol::DoGetIncrementalDocument(IEditor* editor)
+{
+    if(!IsIncrementalSync()) {
+        return nullptr;
+    }
+    std::unordered_map<wxString, Document>::iterator iter = m_documents.find(editor->GetFileName().GetFullPath());
+    if(iter == m_documents.end() || iter->second.ctrl != editor->GetCtrl() || iter->second.fullSyncNeeded) {
+        return nullptr;
+    }
+    return &iter->second;
+}
+
+void LanguageServerProtocol::DoAddDocumentChange(Document& doc, const LSP::TextDocumentContentChangeEvent& change)
+{
+    doc.changesBytes += change.GetText().length();
+    if(!doc.changes.empty()) {
+        // coalesce typing, backspace and delete on the same line into a single change
+        LSP::TextDocumentContentChangeEvent& last = doc.changes.back();
+        const LSP::Range& lastRange = last.GetRange();
+        const LSP::Range& range = change.GetRange();
+        bool sameLine = IsSingleLine(lastRange) && IsSingleLine(range) &&
+                        lastRange.GetStart().GetLine() == range.GetStart().GetLine();
+        bool lastIsInsert = !last.GetText().empty() && last.GetText().find('\n') == std::string::npos &&
+                            lastRange.GetStart().GetCharacter() == lastRange.GetEnd().GetCharacter();
+        bool lastIsDelete = last.GetText().empty();
+        bool isInsert = range.GetStart().GetCharacter() == range.GetEnd().GetCharacter();
+        bool isDelete = change.GetText().empty();
+
+        if(sameLine && lastIsInsert && isInsert &&
+           range.GetStart().GetCharacter() ==
+               lastRange.GetStart().GetCharacter() + UTF16Length(last.GetText().c_str(), last.GetText().length())) {
+            // typing after the previous insertion
+            last.SetText(last.GetText() + change.GetText());
+            return;
+        }
+        if(sameLine && lastIsDelete && isDelete) {
+            if(range.GetEnd().GetCharacter() == lastRange.GetStart().GetCharacter()) {
+                // backspace: deleting right before the previous deletion
+                last.SetRange(LSP::Range(range.GetStart(), lastRange.GetEnd()));
+                return;
+            }
+            if(range.GetStart().GetCharacter() == lastRange.GetStart().GetCharacter()) {
+                // delete: deleting what follows the previous deletion
+                int deleted = range.GetEnd().GetCharacter() - range.GetStart().GetCharacter();
+                LSP::Position end(lastRange.GetEnd().GetLine(), lastRange.GetEnd().GetCharacter() + deleted);
+                last.SetRange(LSP::Range(lastRange.GetStart(), end));
+                return;
+            }
+        }
+    }
+
+    doc.changes.push_back(change);
+    if(doc.changes.size() > MAX_PENDING_CHANGES || (int)doc.changesBytes > doc.ctrl->GetLength()) {
+        // cheaper to send the whole content
+        doc.fullSyncNeeded = true;
+        doc.changes.clear();
+        doc.changesBytes = 0;
+    }
+}
+
+void LanguageServerProtocol::OnStcModified(wxStyledTextEvent& event)
+{
+    event.Skip();
+    if(m_documents.empty()) {
+        return;
+    }
+
+    wxStyledTextCtrl* ctrl = dynamic_cast<wxStyledTextCtrl*>(event.GetEventObject());
+    CHECK_PTR_RET(ctrl);
+    Document* doc = nullptr;
+    for(auto& p : m_documents) {
+        if(p.second.ctrl == ctrl) {
+            doc = &p.second;
+            break;
+        }
+    }
+    if(!doc || doc->fullSyncNeeded) {
+        return;
+    }
+
+    int type = event.GetModificationType();
+    int pos = event.GetPosition();
+    if(type & wxSTC_MOD_INSERTTEXT) {
+        // the text is already in the document
+        LSP::Position start = GetLSPPosition(ctrl, pos);
+        wxCharBuffer text = ctrl->GetTextRangeRaw(pos, pos + event.GetLength());
+        LSP::TextDocumentContentChangeEvent change;
+        change.SetRange(LSP::Range(start, start)).SetText(std::string(text.data(), text.length()));
+        DoAddDocumentChange(*doc, change);
+
+    } else if(type & wxSTC_MOD_BEFOREDELETE) {
+        // the range must be computed while the text is still there
+        LSP::TextDocumentContentChangeEvent change;
+        change.SetRange(LSP::Range(GetLSPPosition(ctrl, pos), GetLSPPosition(ctrl, pos + event.GetLength())));
+        DoAddDocumentChange(*doc, change);
+        doc->deletePending = true;
+
+    } else if(type & wxSTC_MOD_DELETETEXT) {
+        if(!doc->deletePending) {
+            // this editor does not report "before delete" events, we can't tell what was deleted
+            doc->fullSyncNeeded = true;
+            doc->changes.clear();
+            doc->changesBytes = 0;
+        }
+        doc->deletePending = false;
     }
 }
 
+//===------------------------------------------------------------------
+// LSPRequestMessageQueue
+//===------------------------------------------------------------------
+
+void LSPRequestMessageQueue::Push(LSP::MessageWithParams::Ptr_t message) { m_Queue.push_back(message); }
+
 void LSPRequestMessageQueue::Pop()
 {
     if(!m_Queue.empty()) {
-        m_Queue.pop();
+        m_Queue.pop_front();
     }
-    SetWaitingReponse(false);
 }
 
 LSP::MessageWithParams::Ptr_t LSPRequestMessageQueue::Get()
@@ -853,22 +1095,92 @@ LSP::MessageWithParams::Ptr_t LSPRequestMessageQueue::Get()
 
 void LSPRequestMessageQueue::Clear()
 {
-    while(!m_Queue.empty()) {
-        m_Queue.pop();
-    }
-    SetWaitingReponse(false);
+    m_Queue.clear();
     m_pendingReplyMessages.clear();
 }
 
-LSP::MessageWithParams::Ptr_t LSPRequestMessageQueue::TakePendingReplyMessage(int msgid)
+bool LSPRequestMessageQueue::CanSend(size_t maxInFlight) const
 {
-    if(m_pendingReplyMessages.empty()) {
-        return LSP::MessageWithParams::Ptr_t(nullptr);
+    if(m_Queue.empty()) {
+        return false;
     }
-    if(m_pendingReplyMessages.count(msgid) == 0) {
-        return LSP::MessageWithParams::Ptr_t(nullptr);
+    // Notifications don't have replies
+    return !m_Queue.front()->As<LSP::Request>() || (m_pendingReplyMessages.size() < maxInFlight);
+}
+
+void LSPRequestMessageQueue::SetSent(LSP::MessageWithParams::Ptr_t message)
+{
+    // Messages of type 'Request' require responses from the server
+    LSP::Request* req = message->As<LSP::Request>();
+    if(req) {
+        PendingRequest pending;
+        pending.message = message;
+        pending.sentTime = ::wxGetLocalTimeMillis();
+        m_pendingReplyMessages[req->GetId()] = pending;
+    }
+}
+
+std::vector<int> LSPRequestMessageQueue::CancelRequests(const wxString& method)
+{
+    // Not sent yet: simply remove them from the queue
+    m_Queue.erase(std::remove_if(m_Queue.begin(), m_Queue.end(),
+                                 [&](LSP::MessageWithParams::Ptr_t message) {
+                                     return message->As<LSP::Request>() && (message->GetMethod() == method);
+                                 }),
+                  m_Queue.end());
+
+    // Already sent: keep them until their reply arrives, but drop the reply
+    std::vector<int> ids;
+    for(std::unordered_map<int, PendingRequest>::value_type& vt : m_pendingReplyMessages) {
+        PendingRequest& pending = vt.second;
+        if(!pending.cancelled && (pending.message->GetMethod() == method)) {
+            pending.cancelled = true;
+            ids.push_back(vt.first);
+        }
+    }
+    return ids;
+}
+
+size_t LSPRequestMessageQueue::ExpireRequests(wxLongLong timeoutMs)
+{
+    wxLongLong now = ::wxGetLocalTimeMillis();
+    size_t count = 0;
+    std::unordered_map<int, PendingRequest>::iterator iter = m_pendingReplyMessages.begin();
+    while(iter != m_pendingReplyMessages.end()) {
+        wxLongLong elapsedMs = now - iter->second.sentTime;
+        if(elapsedMs >= timeoutMs) {
+            AddReply(iter->second.message->GetMethod(), elapsedMs, true);
+            iter = m_pendingReplyMessages.erase(iter);
+            ++count;
+        } else {
+            ++iter;
+        }
+    }
+    return count;
+}
+
+void LSPRequestMessageQueue::ClearPendingReplies() { m_pendingReplyMessages.clear(); }
+
+bool LSPRequestMessageQueue::TakePendingReply(int msgid, PendingRequest& pending)
+{
+    std::unordered_map<int, PendingRequest>::iterator iter = m_pendingReplyMessages.find(msgid);
+    if(iter == m_pendingReplyMessages.end()) {
+        return false;
+    }
+    pending = iter->second;
+    m_pendingReplyMessages.erase(iter);
+    return true;
+}
+
+void LSPRequestMessageQueue::AddReply(const wxString& method, wxLongLong elapsedMs, bool dropped)
+{
+    LatencyStats& stats = m_stats[method];
+    ++stats.count;
+    if(dropped) {
+        ++stats.dropped;
+    }
+    stats.totalMs += elapsedMs;
+    if(elapsedMs > stats.maxMs) {
+        stats.maxMs = elapsedMs;
     }
-    LSP::MessageWithParams::Ptr_t msgptr = m_pendingReplyMessages[msgid];
-    m_pendingReplyMessages.erase(msgid);
-    return msgptr;
 }
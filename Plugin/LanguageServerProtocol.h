@@ -2,7 +2,9 @@
 #define LANGUAG_ESERVER_PROTOCOL_H
 
 #include "LSP/IPathConverter.hpp"
+#include "LSP/MessageReader.h"
 #include "LSP/MessageWithParams.h"
+#include "LSP/basic_types.h"
 #include "LSPNetwork.h"
 #include "ServiceProvider.h"
 #include "SocketAPI/clSocketClientAsync.h"
@@ -10,33 +12,93 @@
 #include "cl_command_event.h"
 #include "codelite_exports.h"
 #include "macros.h"
+#include <deque>
 #include <map>
-#include <queue>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <wx/filename.h>
+#include <wx/longlong.h>
 #include <wx/sharedptr.h>
 #include <wxStringHash.h>
 
 class IEditor;
+class wxStyledTextCtrl;
+class wxStyledTextEvent;
 class WXDLLIMPEXP_SDK LSPRequestMessageQueue
 {
-    std::queue<LSP::MessageWithParams::Ptr_t> m_Queue;
-    std::unordered_map<int, LSP::MessageWithParams::Ptr_t> m_pendingReplyMessages;
-    bool m_waitingReponse = false;
+public:
+    // A request sent to the server, waiting for its reply
+    struct PendingRequest {
+        LSP::MessageWithParams::Ptr_t message;
+        wxLongLong sentTime;
+        bool cancelled = false;
+    };
+
+    // Per method reply statistics
+    struct LatencyStats {
+        size_t count = 0;
+        size_t dropped = 0; // cancelled or stale replies
+        wxLongLong totalMs = 0;
+        wxLongLong maxMs = 0;
+    };
+
+protected:
+    std::deque<LSP::MessageWithParams::Ptr_t> m_Queue;
+    std::unordered_map<int, PendingRequest> m_pendingReplyMessages;
+    std::map<wxString, LatencyStats> m_stats;
 
 public:
     LSPRequestMessageQueue() {}
     virtual ~LSPRequestMessageQueue() {}
 
-    LSP::MessageWithParams::Ptr_t TakePendingReplyMessage(int msgid);
+    /**
+     * @brief remove the request 'msgid' from the requests waiting for a reply
+     * @return false if no such request was sent
+     */
+    bool TakePendingReply(int msgid, PendingRequest& pending);
     void Push(LSP::MessageWithParams::Ptr_t message);
     void Pop();
     LSP::MessageWithParams::Ptr_t Get();
     void Clear();
     bool IsEmpty() const { return m_Queue.empty(); }
-    void SetWaitingReponse(bool waitingReponse) { this->m_waitingReponse = waitingReponse; }
-    bool IsWaitingReponse() const { return m_waitingReponse; }
+
+    /**
+     * @brief can the next message be sent? Notifications are always sent, requests are sent as long as there are
+     * less than 'maxInFlight' requests waiting for their reply
+     */
+    bool CanSend(size_t maxInFlight) const;
+
+    /**
+     * @brief mark 'message' as sent. Requests are kept until their reply arrives
+     */
+    void SetSent(LSP::MessageWithParams::Ptr_t message);
+
+    /**
+     * @brief drop the queued requests for 'method' and mark the ones already sent as cancelled (their replies are
+     * discarded)
+     * @return the ids of the sent requests that should be cancelled on the server side
+     */
+    std::vector<int> CancelRequests(const wxString& method);
+
+    /**
+     * @brief stop waiting for the replies of the requests sent more than 'timeoutMs' milliseconds ago, so a server
+     * that never answers some requests does not block the queue. A late reply is ignored
+     * @return the number of requests dropped
+     */
+    size_t ExpireRequests(wxLongLong timeoutMs);
+
+    /**
+     * @brief stop waiting for the replies of all the sent requests
+     */
+    void ClearPendingReplies();
+
+    /**
+     * @brief record the reply of a request for 'method' that took 'elapsedMs' milliseconds
+     */
+    void AddReply(const wxString& method, wxLongLong elapsedMs, bool dropped);
+    const std::map<wxString, LatencyStats>& GetStats() const { return m_stats; }
+    size_t GetInFlightCount() const { return m_pendingReplyMessages.size(); }
 };
 
 class WXDLLIMPEXP_SDK LanguageServerProtocol : public ServiceProvider
@@ -46,6 +108,22 @@ class WXDLLIMPEXP_SDK LanguageServerProtocol : public ServiceProvider
         kInitialized,
     };
 
+    // TextDocumentSyncKind
+    enum eTextDocumentSync {
+        kTextDocumentSyncNone = 0,
+        kTextDocumentSyncFull = 1,
+        kTextDocumentSyncIncremental = 2,
+    };
+
+    // A document synced incrementally: the changes made in its editor since the last textDocument/didChange
+    struct Document {
+        wxStyledTextCtrl* ctrl = nullptr;
+        std::vector<LSP::TextDocumentContentChangeEvent> changes;
+        size_t changesBytes = 0;
+        bool deletePending = false; // a "before delete" was seen, waiting for the delete itself
+        bool fullSyncNeeded = false;
+    };
+
     wxString m_name;
     wxEvtHandler* m_owner = nullptr;
     LSPNetwork::Ptr_t m_network;
@@ -54,7 +132,7 @@ class WXDLLIMPEXP_SDK LanguageServerProtocol : public ServiceProvider
     wxString m_workingDirectory;
     wxStringMap_t m_filesSent;
     wxStringSet_t m_languages;
-    wxString m_outputBuffer;
+    LSP::MessageReader m_reader;
     wxString m_rootFolder;
     wxString m_connectionString;
     IPathConverter::Ptr_t m_pathConverter;
@@ -69,7 +147,9 @@ class WXDLLIMPEXP_SDK LanguageServerProtocol : public ServiceProvider
     size_t m_createFlags = 0;
     wxStringSet_t m_unimplementedMethods;
     bool m_disaplayDiagnostics = true;
-    int m_lastCompletionRequestId = wxNOT_FOUND;
+    int m_textDocumentSync = kTextDocumentSyncFull;
+    std::unordered_map<wxString, Document> m_documents;
+    size_t m_repliesCount = 0;
 
 public:
     typedef wxSharedPtr<LanguageServerProtocol> Ptr_t;
@@ -89,6 +169,7 @@ protected:
     void OnFindSymbol(clCodeCompletionEvent& event);
     void OnFunctionCallTip(clCodeCompletionEvent& event);
     void OnQuickOutline(clCodeCompletionEvent& event);
+    void OnStcModified(wxStyledTextEvent& event);
 
 protected:
     void DoClear();
@@ -96,16 +177,37 @@ protected:
     bool ShouldHandleFile(IEditor* editor) const;
     wxString GetLogPrefix() const;
     void ProcessQueue();
+    /**
+     * @brief cancel the pending requests for 'method' (a newer request replaces them)
+     */
+    void DoCancelRequests(const wxString& method);
+    /**
+     * @brief is 'message' a position dependant request whose reply no longer matches the editor state?
+     */
+    bool IsStaleReply(LSP::MessageWithParams::Ptr_t message) const;
     static wxString GetLanguageId(const wxFileName& fn);
     static wxString GetLanguageId(const wxString& fn);
     void UpdateFileSent(const wxFileName& filename, const std::string& fileContent);
     bool IsFileChangedSinceLastParse(const wxFileName& filename, const std::string& fileContent) const;
+    bool IsIncrementalSync() const { return m_textDocumentSync == kTextDocumentSyncIncremental; }
+
+    /**
+     * @brief make sure the server has the latest content of the editor (open it or send its changes)
+     */
+    void DoSyncEditor(IEditor* editor);
+    /**
+     * @brief start tracking the changes of the editor (incremental sync only)
+     */
+    void DoTrackEditor(IEditor* editor);
+    void DoAddDocumentChange(Document& doc, const LSP::TextDocumentContentChangeEvent& change);
+    Document* DoGetIncrementalDocument(IEditor* editor);
 
 protected:
     /**
      * @brief notify about file open
      */
     void SendOpenRequest(const wxFileName& filename, const std::string& fileContent, const wxString& languageId);
+    void SendOpenRequest(IEditor* editor);
 
     /**
      * @brief report a file-close notification
@@ -117,6 +219,12 @@ protected:
      */
     void SendChangeRequest(const wxFileName& filename, const std::string& fileContent);
 
+    /**
+     * @brief report the editor changes. When the server supports it, only the changes made since the last
+     * notification are sent (otherwise, the whole content)
+     */
+    void SendChangeRequest(IEditor* editor);
+
     /**
      * @brief report a file-save notification
      */
@@ -233,6 +341,11 @@ public:
      * @brief get list of symbols for the current editor
      */
     void DocumentSymbols(IEditor* editor);
+
+    /**
+     * @brief write the replies latency (per method) to the log
+     */
+    void LogLatencyStats() const;
 };
 
 #endif // CLLANGUAGESERVER_H
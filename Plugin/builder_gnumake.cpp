@@ -31,6 +31,7 @@
 #include "build_settings_config.h"
 #include "builder_gnumake.h"
 #include "buildmanager.h"
+#include "clXXHash.h"
 #include "cl_command_event.h"
 #include "configuration_mapping.h"
 #include "dirsaver.h"
@@ -44,10 +45,25 @@
 #include "wx/sstream.h"
 #include "wx/tokenzr.h"
 #include <algorithm>
+#include <wx/ffile.h>
 #include <wx/stopwatch.h>
+#include <wx/xml/xml.h>
 
 static bool OS_WINDOWS = wxGetOsVersion() & wxOS_WINDOWS ? true : false;
 
+// the line of the makefile header that holds the fingerprint of the inputs it was generated from
+#define MAKEFILE_FINGERPRINT_PREFIX "## Fingerprint: "
+
+static wxString XmlToString(wxXmlNode* node)
+{
+    wxXmlDocument doc;
+    doc.SetRoot(node); // the document takes the ownership
+    wxString content;
+    wxStringOutputStream sos(&content);
+    doc.Save(sos);
+    return content;
+}
+
 static wxString GetMakeDirCmd(BuildConfigPtr bldConf, const wxString& relPath = wxEmptyString)
 {
     wxString intermediateDirectory(bldConf->GetIntermediateDirectory());
@@ -123,6 +139,7 @@ bool BuilderGNUMakeClassic::Export(const wxString& project, const wxString& conf
     wxArrayString depsArr = proj->GetDependencies(bld_conf_name);
 
     CL_DEBUG("Generating Makefile...");
+    wxStopWatch sw;
     // Filter all disabled projects from the dependencies array
     wxArrayString updatedDepsArr;
     for(size_t i = 0; i < depsArr.GetCount(); ++i) {
@@ -427,7 +444,7 @@ bool BuilderGNUMakeClassic::Export(const wxString& project, const wxString& conf
     wxStringInputStream content(text);
     output << content;
 
-    CL_DEBUG("Generating Makefile...is completed");
+    CL_DEBUG("Generating Makefile...is completed (%ld ms)", sw.Time());
     return true;
 }
 
@@ -476,6 +493,19 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
         }
     }
 
+    EvnVarList vars;
+    EnvironmentConfig::Instance()->ReadObject(wxT("Variables"), &vars);
+    EnvMap varMap = vars.GetVariables(wxT(""), true, proj->GetName(), bldConf->GetName());
+
+    // the makefile content depends only on the inputs hashed into the fingerprint: when they did not change there is
+    // nothing to generate, even if 'force' is set or the project is flagged as modified
+    wxString fingerprint = DoGetMakefileFingerprint(proj, bldConf, varMap, depsProj);
+    if(DoIsMakefileUpToDate(fn, fingerprint)) {
+        CL_DEBUG("Makefile %s is up to date", fn);
+        proj->SetModified(false);
+        return;
+    }
+
     // Load the current project files
     m_projectFilesMetadata = &(proj->GetFiles());
 
@@ -486,6 +516,7 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
     text << wxT("##") << wxT("\n");
     text << wxT("## Auto Generated makefile by CodeLite IDE") << wxT("\n");
     text << wxT("## any manual changes will be erased      ") << wxT("\n");
+    text << MAKEFILE_FINGERPRINT_PREFIX << fingerprint << wxT("\n");
     text << wxT("##") << wxT("\n");
 
     // Create the makefile variables
@@ -497,10 +528,6 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
     // so user will be able to override any of the default
     // variables by defining its own
     //----------------------------------------------------------
-    EvnVarList vars;
-    EnvironmentConfig::Instance()->ReadObject(wxT("Variables"), &vars);
-    EnvMap varMap = vars.GetVariables(wxT(""), true, proj->GetName(), bldConf->GetName());
-
     text << wxT("##") << wxT("\n");
     text << wxT("## User defined environment variables") << wxT("\n");
     text << wxT("##") << wxT("\n");
@@ -552,6 +579,69 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
     proj->SetModified(false);
 }
 
+wxString BuilderGNUMakeClassic::DoGetMakefileFingerprint(ProjectPtr proj, BuildConfigPtr bldConf,
+                                                         EnvMap& varMap, const wxArrayString& depsProj)
+{
+    // everything the generated makefile is built from (except for the 'Date' variable)
+    wxString content;
+    content << GetName() << "\n";
+    content << proj->GetXmlString() << "\n";
+    content << XmlToString(bldConf->ToXml()) << "\n";
+
+    CompilerPtr cmp = BuildSettingsConfigST::Get()->GetCompiler(bldConf->GetCompilerType());
+    if(cmp) { content << XmlToString(cmp->ToXml()) << "\n"; }
+
+    content << clCxxWorkspaceST::Get()->GetWorkspaceFileName().GetFullPath() << "\n";
+    content << clCxxWorkspaceST::Get()->GetBuildMatrix()->GetSelectedConfigurationName() << "\n";
+    content << clCxxWorkspaceST::Get()->GetStartupDir() << "\n";
+    content << wxGetUserName() << "\n";
+
+    for(size_t i = 0; i < varMap.GetCount(); ++i) {
+        wxString name, value;
+        varMap.Get(i, name, value);
+        content << name << "=" << value << "\n";
+    }
+
+    for(size_t i = 0; i < depsProj.GetCount(); ++i) {
+        content << depsProj.Item(i) << "\n";
+    }
+
+    // the build commands may use macros (e.g. the current file)
+    BuildCommandList cmds;
+    bldConf->GetPreBuildCommands(cmds);
+    BuildCommandList postBuildCmds;
+    bldConf->GetPostBuildCommands(postBuildCmds);
+    cmds.insert(cmds.end(), postBuildCmds.begin(), postBuildCmds.end());
+    for(const BuildCommand& cmd : cmds) {
+        content << MacroManager::Instance()->Expand(cmd.GetCommand(), clGetManager(), proj->GetName(),
+                                                    bldConf->GetName())
+                << "\n";
+    }
+
+    // and the flags added by the plugins
+    clBuildEvent e(wxEVT_GET_ADDITIONAL_COMPILEFLAGS);
+    e.SetProjectName(proj->GetName());
+    e.SetConfigurationName(bldConf->GetName());
+    EventNotifier::Get()->ProcessEvent(e);
+    content << e.GetCommand() << "\n";
+
+    const wxCharBuffer buffer = content.ToUTF8();
+    wxUint64 hash = clXXHash::Hash64(buffer.data(), buffer.length());
+    return wxString::Format("%016llx", (unsigned long long)hash);
+}
+
+bool BuilderGNUMakeClassic::DoIsMakefileUpToDate(const wxString& makefile, const wxString& fingerprint) const
+{
+    wxFFile fp(makefile, "rb");
+    if(!fp.IsOpened()) { return false; }
+
+    // the fingerprint is in the header
+    char buffer[512];
+    size_t bytes = fp.Read(buffer, sizeof(buffer));
+    wxString header = wxString::From8BitData(buffer, bytes);
+    return header.Contains(MAKEFILE_FINGERPRINT_PREFIX + fingerprint);
+}
+
 void BuilderGNUMakeClassic::CreateMakeDirsTarget(ProjectPtr proj, BuildConfigPtr bldConf, const wxString& targetName,
                                                  wxString& text)
 {
@@ -27,6 +27,7 @@
 
 #include "builder.h"
 #include "codelite_exports.h"
+#include "evnvarlist.h"
 #include "project.h"
 #include "workspace.h"
 #include <wx/txtstrm.h>
@@ -83,6 +84,9 @@ protected:
 
 private:
     void GenerateMakefile(ProjectPtr proj, const wxString& confToBuild, bool force, const wxArrayString& depsProj);
+    wxString DoGetMakefileFingerprint(ProjectPtr proj, BuildConfigPtr bldConf, EnvMap& varMap,
+                                      const wxArrayString& depsProj);
+    bool DoIsMakefileUpToDate(const wxString& makefile, const wxString& fingerprint) const;
     void CreateConfigsVariables(ProjectPtr proj, BuildConfigPtr bldConf, wxString& text);
     void CreateMakeDirsTarget(ProjectPtr proj, BuildConfigPtr bldConf, const wxString& targetName, wxString& text);
     void CreateTargets(const wxString& type, BuildConfigPtr bldConf, wxString& text, const wxString& projName);
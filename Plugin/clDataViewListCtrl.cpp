@@ -80,6 +80,7 @@ clDataViewListCtrl::~clDataViewListCtrl()
 void clDataViewListCtrl::AppendItem(const wxVector<wxVariant>& values, wxUIntPtr data)
 {
     wxTreeItemId item = clTreeCtrl::AppendItem(GetRootItem(), "", -1, -1, nullptr);
+    if(!item.IsOk()) { return; }
     clRowEntry* child = m_model.ToPtr(item);
     // mark this row as a "list-view" row (i.e. it can't have children)
     child->SetListItem(true);
@@ -197,6 +198,7 @@ void clDataViewListCtrl::DeleteAllItems(const std::function<void(wxUIntPtr)>& de
 wxDataViewItem clDataViewListCtrl::AppendItem(const wxString& text, int image, int selImage, wxUIntPtr data)
 {
     wxTreeItemId child = clTreeCtrl::AppendItem(GetRootItem(), text, image, selImage, nullptr);
+    if(!child.IsOk()) { return wxDataViewItem(); }
     // mark this row as a "list-view" row (i.e. it can't have children)
     m_model.ToPtr(child)->SetListItem(true);
     wxDataViewItem dvItem = DV_ITEM(child);
@@ -210,6 +212,7 @@ wxDataViewItem clDataViewListCtrl::InsertItem(const wxDataViewItem& previous, co
 {
     wxTreeItemId child =
         clTreeCtrl::InsertItem(GetRootItem(), wxTreeItemId(previous.GetID()), text, image, selImage, nullptr);
+    if(!child.IsOk()) { return wxDataViewItem(); }
     // mark this row as a "list-view" row (i.e. it can't have children)
     m_model.ToPtr(child)->SetListItem(true);
     wxDataViewItem dvItem = DV_ITEM(child);
@@ -290,6 +293,7 @@ size_t clDataViewListCtrl::GetItemCount() const
 {
     clRowEntry* root = m_model.GetRoot();
     if(!root) { return 0; }
+    if(m_model.IsVirtual()) { return m_model.GetExpandedLines(); }
     return root->GetChildrenCount(false);
 }
 
@@ -299,6 +303,7 @@ wxDataViewItem clDataViewListCtrl::RowToItem(size_t row) const
     // A row is simply a child at a given index
     clRowEntry* root = m_model.GetRoot();
     if(!root) { return wxDataViewItem(); }
+    if(m_model.IsVirtual()) { return wxDataViewItem(m_model.GetItemFromIndex(row)); }
     if(row >= root->GetChildren().size()) { return wxDataViewItem(); }
     return wxDataViewItem(root->GetChildren()[row]);
 }
@@ -361,6 +366,10 @@ void clDataViewListCtrl::SetSortFunction(const clSortFunc_t& CompareFunc)
 {
     clRowEntry* root = m_model.GetRoot();
     if(!root) { return; }
+    if(m_model.IsVirtual()) {
+        clTreeCtrl::SetSortFunction(CompareFunc);
+        return;
+    }
 
     // Disconnect the current function, if any
     m_model.SetSortFunction(nullptr);
@@ -383,6 +392,7 @@ void clDataViewListCtrl::SetSortFunction(const clSortFunc_t& CompareFunc)
 
     // Step 3: sort the children
     std::sort(children.begin(), children.end(), CompareFunc);
+    root->ChildrenReordered();
 
     // Now, reconnect the children, starting with the root
     clRowEntry* prev = root;
@@ -399,6 +409,13 @@ void clDataViewListCtrl::SetSortFunction(const clSortFunc_t& CompareFunc)
     Refresh();
 }
 
+void clDataViewListCtrl::SetDataProvider(clTreeCtrlDataProvider* provider)
+{
+    clTreeCtrl::SetDataProvider(provider);
+    // DVC must always have the hidden root
+    if(!provider) { AddRoot("Hidden Root", -1, -1, nullptr); }
+}
+
 int clDataViewListCtrl::ItemToRow(const wxDataViewItem& item) const
 {
     clRowEntry* pItem = m_model.ToPtr(TREE_ITEM(item));
@@ -406,6 +423,7 @@ int clDataViewListCtrl::ItemToRow(const wxDataViewItem& item) const
 
     clRowEntry* root = m_model.GetRoot();
     if(!root) { return wxNOT_FOUND; }
+    if(m_model.IsVirtual()) { return (pItem == root) ? wxNOT_FOUND : m_model.GetItemIndex(pItem); }
 
     const clRowEntry::Vec_t& children = root->GetChildren();
     for(size_t i = 0; i < children.size(); ++i) {
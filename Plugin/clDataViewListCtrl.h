@@ -163,6 +163,12 @@ public:
      */
     void SetSortFunction(const clSortFunc_t& CompareFunc);
 
+    /**
+     * @brief display the rows of 'provider' instead of the list items (see clTreeCtrl::SetDataProvider). The rows are
+     * addressed by their index, so RowToItem() and ItemToRow() are executed in O(1)
+     */
+    virtual void SetDataProvider(clTreeCtrlDataProvider* provider);
+
     /**
      * @brief remove all columns from the control
      */
@@ -16,6 +16,9 @@
 #define wxCONTROL_NONE 0
 #endif
 
+// the lowest bit set in 'i', used by the children rows index (a Fenwick tree)
+static size_t LowBit(size_t i) { return i & (~i + 1); }
+
 #ifdef __WXMSW__
 #define PEN_STYLE wxPENSTYLE_SHORT_DASH
 #define IS_MSW 1
@@ -106,7 +109,7 @@ clRowEntry::clRowEntry(clTreeCtrl* tree, const wxString& label, int bitmapIndex,
 {
     // Fill the verctor with items constructed using the _non_ default constructor
     // to makes sure that IsOk() returns TRUE
-    m_cells.resize(m_tree->GetHeader()->empty() ? 1 : m_tree->GetHeader()->size(),
+    m_cells.resize((!m_tree || m_tree->GetHeader()->empty()) ? 1 : m_tree->GetHeader()->size(),
                    clCellValue("", -1, -1)); // at least one column
     clCellValue cv(label, bitmapIndex, bitmapSelectedIndex);
     m_cells[0] = cv;
@@ -118,7 +121,7 @@ clRowEntry::clRowEntry(clTreeCtrl* tree, bool checked, const wxString& label, in
 {
     // Fill the verctor with items constructed using the _non_ default constructor
     // to makes sure that IsOk() returns TRUE
-    m_cells.resize(m_tree->GetHeader()->empty() ? 1 : m_tree->GetHeader()->size(),
+    m_cells.resize((!m_tree || m_tree->GetHeader()->empty()) ? 1 : m_tree->GetHeader()->size(),
                    clCellValue("", -1, -1)); // at least one column
     clCellValue cv(checked, label, bitmapIndex, bitmapSelectedIndex);
     m_cells[0] = cv;
@@ -154,32 +157,41 @@ void clRowEntry::InsertChild(clRowEntry* child, clRowEntry* prev)
     child->SetIndentsCount(GetIndentsCount() + 1);
 
     // We need the last item of this subtree (prev 'this' is the root)
-    if(prev == nullptr) {
-        // make it the first item
-        m_children.insert(m_children.begin(), child);
-    } else {
-        // Insert the item in the parent children list
-        clRowEntry::Vec_t::iterator iter = m_children.end();
-        iter = std::find_if(m_children.begin(), m_children.end(), [&](clRowEntry* c) { return c == prev; });
-        if(iter != m_children.end()) {
-            ++iter;
+    size_t where = 0; // make it the first item
+    if(prev) {
+        // if 'prev' is not found, than the is actually appending the item
+        where = DoGetChildPos(prev);
+        where = (where == wxString::npos) ? m_children.size() : (where + 1);
+    }
+    // Insert the item in the parent children list
+    m_children.insert(m_children.begin() + where, child);
+    child->m_childPos = where;
+
+    // Update the rows count. Appending keeps the index, inserting moves the items after 'where': re-build it on demand
+    if(!m_childrenLinesIndexDirty && (where + 1 == m_children.size())) {
+        size_t index = m_children.size(); // 1 based
+        size_t lines = child->m_lines;
+        for(size_t i = index - 1; i > 0; i -= LowBit(i)) {
+            lines += m_childrenLinesIndex[i - 1];
         }
-        // if iter is end(), than the is actually appending the item
-        m_children.insert(iter, child);
+        for(size_t i = index - LowBit(index); i > 0; i -= LowBit(i)) {
+            lines -= m_childrenLinesIndex[i - 1];
+        }
+        m_childrenLinesIndex.push_back(lines);
+    } else {
+        m_childrenLinesIndexDirty = true;
     }
+    m_childrenLines += child->m_lines;
+    DoUpdateLines();
 
     // Connect the linked list for sequential iteration
-    clRowEntry::Vec_t::iterator iterCur =
-        std::find_if(m_children.begin(), m_children.end(), [&](clRowEntry* c) { return c == child; });
-
     clRowEntry* nodeBefore = nullptr;
     // Find the item before and after
-    if(iterCur == m_children.begin()) {
+    if(where == 0) {
         nodeBefore = child->GetParent(); // "this"
     } else {
-        --iterCur;
-        clRowEntry* prevSibling = (*iterCur);
-        while(prevSibling && prevSibling->HasChildren()) {
+        clRowEntry* prevSibling = m_children[where - 1];
+        while(!prevSibling->m_children.empty()) {
             prevSibling = prevSibling->GetLastChild();
         }
         nodeBefore = prevSibling;
@@ -206,7 +218,7 @@ void clRowEntry::DeleteChild(clRowEntry* child)
     // do this in a while loop since 'child->RemoveChild(c);' will alter
     // the array and will invalidate all iterators
     while(!child->m_children.empty()) {
-        clRowEntry* c = child->m_children[0];
+        clRowEntry* c = child->m_children.back();
         child->DeleteChild(c);
     }
     // Connect the list
@@ -219,25 +231,181 @@ void clRowEntry::DeleteChild(clRowEntry* child)
         next->m_prev = prev;
     }
     // Now disconnect this child from this node
-    clRowEntry::Vec_t::iterator iter =
-        std::find_if(m_children.begin(), m_children.end(), [&](clRowEntry* c) { return c == child; });
-    if(iter != m_children.end()) {
-        m_children.erase(iter);
+    size_t where = DoGetChildPos(child);
+    if(where != wxString::npos) {
+        m_children.erase(m_children.begin() + where);
+        // Removing the last child keeps the index
+        if(!m_childrenLinesIndexDirty && (where == m_children.size())) {
+            m_childrenLinesIndex.pop_back();
+        } else {
+            m_childrenLinesIndexDirty = true;
+        }
+        m_childrenLines -= child->m_lines;
+        DoUpdateLines();
     }
     wxDELETE(child);
 }
 
-int clRowEntry::GetExpandedLines() const
+void clRowEntry::DoUpdateLines()
+{
+    size_t lines = (IsHidden() ? 0 : 1) + (IsExpanded() ? m_childrenLines : 0);
+    if(lines == m_lines) {
+        return;
+    }
+    long delta = (long)lines - (long)m_lines;
+    m_lines = lines;
+    if(m_parent) {
+        m_parent->DoChildLinesChanged(this, delta);
+    }
+}
+
+void clRowEntry::DoChildLinesChanged(clRowEntry* child, long delta)
+{
+    size_t where = DoGetChildPos(child);
+    if(where == wxString::npos) {
+        // not one of our children (e.g. a virtual row)
+        return;
+    }
+    m_childrenLines += delta;
+    if(!m_childrenLinesIndexDirty) {
+        for(size_t i = where + 1; i <= m_childrenLinesIndex.size(); i += LowBit(i)) {
+            m_childrenLinesIndex[i - 1] += delta;
+        }
+    }
+    DoUpdateLines();
+}
+
+size_t clRowEntry::DoGetChildPos(const clRowEntry* child) const
+{
+    // The position is kept by the item, but inserting or deleting a child moves the ones after it
+    if((child->m_childPos < m_children.size()) && (m_children[child->m_childPos] == child)) {
+        return child->m_childPos;
+    }
+    clRowEntry::Vec_t::const_iterator iter = std::find(m_children.begin(), m_children.end(), child);
+    if(iter == m_children.end()) {
+        return wxString::npos;
+    }
+    const_cast<clRowEntry*>(child)->m_childPos = (iter - m_children.begin());
+    return child->m_childPos;
+}
+
+void clRowEntry::DoBuildChildrenLinesIndex()
+{
+    size_t count = m_children.size();
+    m_childrenLinesIndex.resize(count);
+    for(size_t i = 0; i < count; ++i) {
+        m_children[i]->m_childPos = i;
+        m_childrenLinesIndex[i] = m_children[i]->m_lines;
+    }
+    for(size_t i = 1; i <= count; ++i) {
+        size_t parent = i + LowBit(i);
+        if(parent <= count) {
+            m_childrenLinesIndex[parent - 1] += m_childrenLinesIndex[i - 1];
+        }
+    }
+    m_childrenLinesIndexDirty = false;
+}
+
+void clRowEntry::ChildrenReordered() { m_childrenLinesIndexDirty = true; }
+
+size_t clRowEntry::GetChildrenLinesBefore(const clRowEntry* child)
+{
+    size_t where = DoGetChildPos(child);
+    if(where == wxString::npos) {
+        return 0;
+    }
+    if(m_childrenLinesIndexDirty) {
+        DoBuildChildrenLinesIndex();
+    }
+    size_t lines = 0;
+    for(size_t i = where; i > 0; i -= LowBit(i)) {
+        lines += m_childrenLinesIndex[i - 1];
+    }
+    return lines;
+}
+
+clRowEntry* clRowEntry::GetChildByLine(size_t& line)
 {
-    clRowEntry* node = const_cast<clRowEntry*>(this);
-    int counter = 0;
-    while(node) {
-        if(node->IsVisible()) {
-            ++counter;
+    if(line >= m_childrenLines) {
+        return nullptr;
+    }
+    if(m_childrenLinesIndexDirty) {
+        DoBuildChildrenLinesIndex();
+    }
+    // Find the last child whose preceding rows are <= line
+    size_t count = m_childrenLinesIndex.size();
+    size_t mask = 1;
+    while((mask << 1) <= count) {
+        mask <<= 1;
+    }
+    size_t where = 0;
+    for(; mask; mask >>= 1) {
+        size_t next = where + mask;
+        if((next <= count) && (m_childrenLinesIndex[next - 1] <= line)) {
+            where = next;
+            line -= m_childrenLinesIndex[next - 1];
         }
-        node = node->m_next;
     }
-    return counter;
+    return (where < count) ? m_children[where] : nullptr;
+}
+
+clRowEntry* clRowEntry::GetNextVisible()
+{
+    // An item inside a collapsed subtree: continue after the top most collapsed ancestor
+    clRowEntry* node = this;
+    for(clRowEntry* parent = m_parent; parent; parent = parent->m_parent) {
+        if(!parent->IsExpanded()) {
+            node = parent;
+        }
+    }
+    if((node == this) && IsExpanded() && !m_children.empty()) {
+        return m_children[0];
+    }
+
+    // The next sibling of the item or of the closest ancestor that has one
+    while(node->m_parent) {
+        clRowEntry* parent = node->m_parent;
+        size_t where = parent->DoGetChildPos(node);
+        if(where == wxString::npos) {
+            return nullptr;
+        }
+        if((where + 1) < parent->m_children.size()) {
+            return parent->m_children[where + 1];
+        }
+        node = parent;
+    }
+    return nullptr;
+}
+
+clRowEntry* clRowEntry::GetPrevVisible()
+{
+    // An item inside a collapsed subtree: the top most collapsed ancestor is the previous visible item
+    clRowEntry* node = this;
+    for(clRowEntry* parent = m_parent; parent; parent = parent->m_parent) {
+        if(!parent->IsExpanded()) {
+            node = parent;
+        }
+    }
+    if(node != this) {
+        return node;
+    }
+
+    if(!m_parent) {
+        return nullptr;
+    }
+    size_t where = m_parent->DoGetChildPos(this);
+    if(where == wxString::npos) {
+        return nullptr;
+    }
+    if(where == 0) {
+        return m_parent->IsHidden() ? nullptr : m_parent;
+    }
+    // The last visible item of the previous sibling subtree
+    clRowEntry* prev = m_parent->m_children[where - 1];
+    while(prev->IsExpanded() && !prev->m_children.empty()) {
+        prev = prev->m_children.back();
+    }
+    return prev;
 }
 
 void clRowEntry::GetNextItems(int count, clRowEntry::Vec_t& items, bool selfIncluded)
@@ -246,18 +414,14 @@ void clRowEntry::GetNextItems(int count, clRowEntry::Vec_t& items, bool selfIncl
         return;
     }
     items.reserve(count);
+    size_t first = items.size();
     if(!this->IsHidden() && selfIncluded) {
         items.push_back(this);
     }
-    clRowEntry* next = GetNext();
-    while(next) {
-        if(next->IsVisible() && !next->IsHidden()) {
-            items.push_back(next);
-        }
-        if((int)items.size() == count) {
-            return;
-        }
-        next = next->GetNext();
+    clRowEntry* next = GetNextVisible();
+    while(next && ((int)(items.size() - first) < count)) {
+        items.push_back(next);
+        next = next->GetNextVisible();
     }
 }
 
@@ -267,19 +431,17 @@ void clRowEntry::GetPrevItems(int count, clRowEntry::Vec_t& items, bool selfIncl
         return;
     }
     items.reserve(count);
+    // Collect the items backward, then put them in order
+    size_t first = items.size();
     if(!this->IsHidden() && selfIncluded) {
-        items.insert(items.begin(), this);
+        items.push_back(this);
     }
-    clRowEntry* prev = GetPrev();
-    while(prev) {
-        if(prev->IsVisible() && !prev->IsHidden()) {
-            items.insert(items.begin(), prev);
-        }
-        if((int)items.size() == count) {
-            return;
-        }
-        prev = prev->GetPrev();
+    clRowEntry* prev = GetPrevVisible();
+    while(prev && ((int)(items.size() - first) < count)) {
+        items.push_back(prev);
+        prev = prev->GetPrevVisible();
     }
+    std::reverse(items.begin() + first, items.end());
 }
 
 clRowEntry* clRowEntry::GetVisibleItem(int index)
@@ -331,6 +493,7 @@ bool clRowEntry::SetExpanded(bool b)
     }
 
     SetFlag(kNF_Expanded, b);
+    DoUpdateLines();
     m_model->NodeExpanded(this, b);
     return true;
 }
@@ -642,7 +805,8 @@ bool clRowEntry::IsVisible() const
 void clRowEntry::DeleteAllChildren()
 {
     while(!m_children.empty()) {
-        clRowEntry* c = m_children[0];
+        // Start from the last one, so the array does not move
+        clRowEntry* c = m_children.back();
         // DeleteChild will remove it from the array
         DeleteChild(c);
     }
@@ -670,6 +834,7 @@ void clRowEntry::SetHidden(bool b)
         return;
     }
     SetFlag(kNF_Hidden, b);
+    DoUpdateLines();
     if(b) {
         m_indentsCount = -1;
     } else {
@@ -26,6 +26,7 @@ enum clTreeCtrlNodeFlags {
     kNF_Hidden = (1 << 6),
     kNF_LisItem = (1 << 7),
     kNF_HighlightText = (1 << 8),
+    kNF_HasChildren = (1 << 9), // a virtual row with children (see clTreeCtrlDataProvider)
 };
 
 typedef std::array<wxString, 3> Str3Arr_t;
@@ -69,6 +70,16 @@ protected:
     wxRect m_rowRect;
     wxRect m_buttonRect;
     clMatchResult m_higlightInfo;
+    size_t m_rowIndex = 0; // the index of a virtual row in the data provider
+    size_t m_childPos = 0; // the position of this item in its parent's children (checked before use)
+    // The number of visible rows of this subtree, assuming this item is visible: the item itself (unless hidden) and,
+    // when expanded, the rows of its children
+    size_t m_lines = 1;
+    size_t m_childrenLines = 0;
+    // Fenwick tree over the 'm_lines' of the children: the number of rows before a child in O(log n)
+    std::vector<size_t> m_childrenLinesIndex;
+    bool m_childrenLinesIndexDirty = false;
+    friend class clTreeCtrlModel;
 
 protected:
     void SetFlag(clTreeCtrlNodeFlags flag, bool b)
@@ -82,6 +93,17 @@ protected:
 
     bool HasFlag(clTreeCtrlNodeFlags flag) const { return m_flags & flag; }
 
+    /**
+     * @brief re-compute 'm_lines' after a change and update the parent
+     */
+    void DoUpdateLines();
+    void DoChildLinesChanged(clRowEntry* child, long delta);
+    /**
+     * @brief the position of 'child' in m_children, or wxString::npos
+     */
+    size_t DoGetChildPos(const clRowEntry* child) const;
+    void DoBuildChildrenLinesIndex();
+
     /**
      * @brief return the nth visible item
      */
@@ -204,14 +226,37 @@ public:
     wxTreeItemData* GetClientObject() const { return m_clientObject; }
     void SetParent(clRowEntry* parent);
     clRowEntry* GetParent() const { return m_parent; }
-    bool HasChildren() const { return !m_children.empty(); }
+    bool HasChildren() const { return !m_children.empty() || HasFlag(kNF_HasChildren); }
     void SetClientData(wxTreeItemData* clientData)
     {
         wxDELETE(m_clientObject);
         this->m_clientObject = clientData;
     }
     size_t GetChildrenCount(bool recurse) const;
-    int GetExpandedLines() const;
+    /**
+     * @brief the number of visible rows of this subtree (assuming this item is visible). This function is executed
+     * in O(1)
+     */
+    int GetExpandedLines() const { return m_lines; }
+    /**
+     * @brief the number of visible rows of the children that come before 'child'. This function is executed in
+     * O(log n)
+     */
+    size_t GetChildrenLinesBefore(const clRowEntry* child);
+    /**
+     * @brief return the child whose subtree holds the visible row 'line' (counted from the first child). On return,
+     * 'line' is relative to that child
+     */
+    clRowEntry* GetChildByLine(size_t& line);
+    /**
+     * @brief call this after re-ordering the array returned by GetChildren()
+     */
+    void ChildrenReordered();
+    /**
+     * @brief the next (previous) visible item. The subtrees of collapsed items are skipped
+     */
+    clRowEntry* GetNextVisible();
+    clRowEntry* GetPrevVisible();
     void GetNextItems(int count, clRowEntry::Vec_t& items, bool selfIncluded = true);
     void GetPrevItems(int count, clRowEntry::Vec_t& items, bool selfIncluded = true);
     void SetIndentsCount(int count) { this->m_indentsCount = count; }
@@ -0,0 +1,106 @@
+#include "clRowIndexRanges.h"
+#include <algorithm>
+
+void clRowIndexRanges::DoAppend(Vec_t& ranges, size_t first, size_t last) const
+{
+    // merge with the previous range when they touch
+    if(!ranges.empty() && (ranges.back().second + 1 >= first)) {
+        ranges.back().second = std::max(ranges.back().second, last);
+    } else {
+        ranges.push_back({ first, last });
+    }
+}
+
+void clRowIndexRanges::Add(size_t first, size_t last)
+{
+    if(first > last) { std::swap(first, last); }
+
+    Vec_t ranges;
+    ranges.reserve(m_ranges.size() + 1);
+    Vec_t::const_iterator iter = m_ranges.begin();
+    for(; (iter != m_ranges.end()) && (iter->first < first); ++iter) {
+        DoAppend(ranges, iter->first, iter->second);
+    }
+    DoAppend(ranges, first, last);
+    for(; iter != m_ranges.end(); ++iter) {
+        DoAppend(ranges, iter->first, iter->second);
+    }
+    m_ranges.swap(ranges);
+}
+
+void clRowIndexRanges::Remove(size_t index)
+{
+    // the first range that starts after 'index', the one before it is the only one that can hold it
+    Vec_t::iterator iter = std::upper_bound(m_ranges.begin(), m_ranges.end(), index,
+                                            [](size_t i, const Range_t& range) { return i < range.first; });
+    if(iter == m_ranges.begin()) { return; }
+    --iter;
+    if(index > iter->second) { return; }
+
+    if(iter->first == iter->second) {
+        m_ranges.erase(iter);
+    } else if(index == iter->first) {
+        ++iter->first;
+    } else if(index == iter->second) {
+        --iter->second;
+    } else {
+        Range_t after(index + 1, iter->second);
+        iter->second = index - 1;
+        m_ranges.insert(iter + 1, after);
+    }
+}
+
+bool clRowIndexRanges::Contains(size_t index) const
+{
+    Vec_t::const_iterator iter = std::upper_bound(m_ranges.begin(), m_ranges.end(), index,
+                                                  [](size_t i, const Range_t& range) { return i < range.first; });
+    if(iter == m_ranges.begin()) { return false; }
+    --iter;
+    return index <= iter->second;
+}
+
+size_t clRowIndexRanges::GetCount() const
+{
+    size_t count = 0;
+    for(const Range_t& range : m_ranges) {
+        count += range.second - range.first + 1;
+    }
+    return count;
+}
+
+void clRowIndexRanges::RowExpanded(size_t index, long delta)
+{
+    if(delta == 0) { return; }
+
+    // When collapsing, the rows (index, lastHidden] are gone
+    size_t lastHidden = (delta < 0) ? (index - delta) : index;
+    Vec_t ranges;
+    ranges.reserve(m_ranges.size());
+    for(const Range_t& range : m_ranges) {
+        if(range.first <= index) { DoAppend(ranges, range.first, std::min(range.second, index)); }
+        if(range.second > lastHidden) {
+            size_t first = std::max(range.first, lastHidden + 1);
+            DoAppend(ranges, first + delta, range.second + delta);
+        }
+    }
+    m_ranges.swap(ranges);
+}
+
+void clRowIndexRanges::Truncate(size_t count)
+{
+    while(!m_ranges.empty() && (m_ranges.back().first >= count)) {
+        m_ranges.pop_back();
+    }
+    if(!m_ranges.empty() && (m_ranges.back().second >= count)) { m_ranges.back().second = count - 1; }
+}
+
+bool clRowIndexRanges::MoveIndex(size_t rowIndex, size_t index, long delta, size_t& newIndex)
+{
+    if(rowIndex <= index) {
+        newIndex = rowIndex;
+        return true;
+    }
+    if((delta < 0) && (rowIndex <= (index - delta))) { return false; }
+    newIndex = rowIndex + delta;
+    return true;
+}
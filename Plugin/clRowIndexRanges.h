@@ -0,0 +1,70 @@
+#ifndef CLROWINDEXRANGES_H
+#define CLROWINDEXRANGES_H
+
+#include "codelite_exports.h"
+#include <utility>
+#include <vector>
+#include <wx/defs.h>
+
+/**
+ * @class clRowIndexRanges
+ * @brief a set of row indexes, kept as sorted and disjoint [first, last] ranges. In virtual mode, clTreeCtrlModel
+ * keeps the rows selected by a range selection in one, so they don't need a clRowEntry each
+ */
+class WXDLLIMPEXP_SDK clRowIndexRanges
+{
+public:
+    typedef std::pair<size_t, size_t> Range_t;
+    typedef std::vector<Range_t> Vec_t;
+
+protected:
+    Vec_t m_ranges;
+
+protected:
+    void DoAppend(Vec_t& ranges, size_t first, size_t last) const;
+
+public:
+    clRowIndexRanges() {}
+    ~clRowIndexRanges() {}
+
+    /**
+     * @brief add the indexes between 'first' and 'last' (included, in any order)
+     */
+    void Add(size_t first, size_t last);
+
+    /**
+     * @brief remove a single index
+     */
+    void Remove(size_t index);
+
+    bool Contains(size_t index) const;
+
+    /**
+     * @brief the number of indexes
+     */
+    size_t GetCount() const;
+
+    bool IsEmpty() const { return m_ranges.empty(); }
+    void Clear() { m_ranges.clear(); }
+    const Vec_t& GetRanges() const { return m_ranges; }
+
+    /**
+     * @brief row 'index' was expanded or collapsed and the row count changed by 'delta'. The indexes after it move,
+     * the indexes of a collapsed subtree are removed
+     */
+    void RowExpanded(size_t index, long delta);
+
+    /**
+     * @brief remove the indexes that are not below 'count'
+     */
+    void Truncate(size_t count);
+
+    /**
+     * @brief the new index of row 'rowIndex' after row 'index' was expanded or collapsed and the row count changed by
+     * 'delta'
+     * @return false if the row is in the collapsed subtree
+     */
+    static bool MoveIndex(size_t rowIndex, size_t index, long delta, size_t& newIndex);
+};
+
+#endif // CLROWINDEXRANGES_H
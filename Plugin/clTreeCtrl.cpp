@@ -212,6 +212,16 @@ void clTreeCtrl::OnPaint(wxPaintEvent& event)
         }
     }
 
+    if(m_model.IsVirtual()) {
+        // Virtual rows are created when they are displayed: fit the header to the new ones
+        const clRowEntry::Vec_t& onScreen = m_model.GetOnScreenItems();
+        for(size_t i = 0; i < items.size(); ++i) {
+            if(std::find(onScreen.begin(), onScreen.end(), items[i]) == onScreen.end()) {
+                DoUpdateHeader(wxTreeItemId(items[i]));
+            }
+        }
+    }
+
     // Update the first item on screen
     SetFirstItemOnScreen(firstItem);
 
@@ -239,6 +249,9 @@ wxTreeItemId clTreeCtrl::InsertItem(const wxTreeItemId& parent, const wxTreeItem
                                     int image, int selImage, wxTreeItemData* data)
 {
     wxTreeItemId item = m_model.InsertItem(parent, previous, text, image, selImage, data);
+    if(!item.IsOk()) {
+        return item;
+    }
     DoUpdateHeader(item);
     if(IsExpanded(parent)) {
         UpdateScrollBar();
@@ -250,6 +263,9 @@ wxTreeItemId clTreeCtrl::AppendItem(const wxTreeItemId& parent, const wxString&
                                     wxTreeItemData* data)
 {
     wxTreeItemId item = m_model.AppendItem(parent, text, image, selImage, data);
+    if(!item.IsOk()) {
+        return item;
+    }
     DoUpdateHeader(item);
     if(IsExpanded(parent)) {
         UpdateScrollBar();
@@ -333,10 +349,15 @@ void clTreeCtrl::OnMouseLeftDown(wxMouseEvent& event)
                     m_model.SelectItem(where, !pNode->IsSelected(), true);
                 } else if(event.ShiftDown()) {
                     // Range selection
-                    clRowEntry::Vec_t range;
-                    m_model.GetRange(pNode, m_model.ToPtr(m_model.GetSingleSelection()), range);
-                    std::for_each(range.begin(), range.end(),
-                                  [&](clRowEntry* p) { m_model.AddSelection(wxTreeItemId(p)); });
+                    if(m_model.IsVirtual()) {
+                        // Don't create a row for every index in the range
+                        m_model.SelectVirtualRange(pNode, m_model.ToPtr(m_model.GetSingleSelection()));
+                    } else {
+                        clRowEntry::Vec_t range;
+                        m_model.GetRange(pNode, m_model.ToPtr(m_model.GetSingleSelection()), range);
+                        std::for_each(range.begin(), range.end(),
+                                      [&](clRowEntry* p) { m_model.AddSelection(wxTreeItemId(p)); });
+                    }
                 } else {
                     // The default, single selection
                     if(!has_multiple_selection && pNode->IsSelected()) {
@@ -1057,7 +1078,34 @@ clRowEntry* clTreeCtrl::GetFirstItemOnScreen() { return m_model.GetFirstItemOnSc
 
 void clTreeCtrl::SetFirstItemOnScreen(clRowEntry* item) { m_model.SetFirstItemOnScreen(item); }
 
-void clTreeCtrl::SetSortFunction(const clSortFunc_t& CompareFunc) { m_model.SetSortFunction(CompareFunc); }
+void clTreeCtrl::SetSortFunction(const clSortFunc_t& CompareFunc)
+{
+    m_model.SetSortFunction(CompareFunc);
+    if(m_model.IsVirtual()) {
+        // Virtual rows are not inserted one by one, sort them now
+        m_model.SortVirtualRows(CompareFunc);
+        Refresh();
+    }
+}
+
+void clTreeCtrl::SetDataProvider(clTreeCtrlDataProvider* provider)
+{
+    m_model.EnableEvents(false);
+    m_model.SetDataProvider(provider);
+    m_model.EnableEvents(true);
+    m_scrollLines = 0;
+    SetFirstColumn(0);
+    UpdateScrollBar();
+    Refresh();
+}
+
+void clTreeCtrl::RefreshRows()
+{
+    m_model.RefreshVirtualRows();
+    UpdateScrollBar();
+    Refresh();
+}
+
 void clTreeCtrl::ScrollToRow(int firstLine)
 {
     clRowEntry* newTopLine = nullptr;
@@ -1101,7 +1149,13 @@ void clTreeCtrl::ScrollRows(int steps, wxDirection direction)
     bool fromTop = false;
     if(steps == 0) {
         // Top or Bottom
-        if(direction == wxUP) {
+        if(m_model.IsVirtual()) {
+            nextSelection = wxTreeItemId(m_model.GetItemFromIndex((direction == wxUP) ? 0 : (GetRange() - 1)));
+            if(!nextSelection.IsOk()) {
+                return;
+            }
+            fromTop = (direction == wxUP);
+        } else if(direction == wxUP) {
             if(IsRootHidden()) {
                 nextSelection = wxTreeItemId(m_model.ToPtr(GetRootItem())->GetFirstChild());
             } else {
@@ -1316,6 +1370,9 @@ void clTreeCtrl::ClearHighlight(const wxTreeItemId& item)
 
 clRowEntry* clTreeCtrl::DoFind(clRowEntry* from, const wxString& what, size_t col, size_t searchFlags, bool next)
 {
+    if(m_model.IsVirtual()) {
+        return DoFindVirtual(from, what, col, searchFlags, next);
+    }
     clRowEntry* curp = nullptr;
     if(!from) {
         curp = m_model.GetRoot();
@@ -1341,6 +1398,35 @@ clRowEntry* clTreeCtrl::DoFind(clRowEntry* from, const wxString& what, size_t co
     return nullptr;
 }
 
+clRowEntry* clTreeCtrl::DoFindVirtual(clRowEntry* from, const wxString& what, size_t col, size_t searchFlags,
+                                      bool next)
+{
+    int count = GetRange();
+    int index = 0;
+    if(!from || (from == m_model.GetRoot())) {
+        index = next ? 0 : (count - 1);
+    } else {
+        index = m_model.GetItemIndex(from);
+        if(!(searchFlags & wxTR_SEARCH_INCLUDE_CURRENT_ITEM)) {
+            index += next ? 1 : -1;
+        }
+    }
+
+    // Match the content of the rows through a scratch row: only the matching row is created
+    clRowEntry scratch(this, wxEmptyString);
+    for(; (index >= 0) && (index < count); index += next ? 1 : -1) {
+        m_model.FillVirtualRow(index, &scratch);
+        clMatchResult res;
+        if(clSearchText::Matches(what, col, scratch.GetLabel(col), searchFlags, &res)) {
+            clRowEntry* row = m_model.GetItemFromIndex(index);
+            row->SetHighlightInfo(res);
+            row->SetHighlight(true);
+            return row;
+        }
+    }
+    return nullptr;
+}
+
 void clTreeCtrl::ClearAllHighlights()
 {
     clTreeNodeVisitor V;
@@ -1351,6 +1437,13 @@ void clTreeCtrl::ClearAllHighlights()
         return true;
     };
     V.Visit(m_model.GetRoot(), false, Foo);
+
+    // Virtual rows are not children of the root
+    clRowEntry::Vec_t rows;
+    m_model.GetVirtualRows(rows);
+    for(size_t i = 0; i < rows.size(); ++i) {
+        Foo(rows[i], true);
+    }
     Refresh();
 }
 
@@ -51,6 +51,7 @@ private:
 
     void DoInitialize();
     clRowEntry* DoFind(clRowEntry* from, const wxString& what, size_t col, size_t searchFlags, bool next);
+    clRowEntry* DoFindVirtual(clRowEntry* from, const wxString& what, size_t col, size_t searchFlags, bool next);
 
 protected:
     void UpdateScrollBar();
@@ -112,6 +113,24 @@ public:
     const clTreeCtrlModel& GetModel() const { return m_model; }
     clTreeCtrlModel& GetModel() { return m_model; }
 
+    //===--------------------
+    // Virtual mode
+    //===--------------------
+
+    /**
+     * @brief display the rows of 'provider' instead of the tree items. Only the rows that are displayed (or selected)
+     * are created, so the control can show millions of rows. The current items are deleted, and the items returned
+     * by this control (GetSelection(), HitTest() ...) are valid until the rows of the provider change.
+     * Pass nullptr to go back to a regular tree. The provider must exist as long as it is set
+     */
+    virtual void SetDataProvider(clTreeCtrlDataProvider* provider);
+    clTreeCtrlDataProvider* GetDataProvider() const { return m_model.GetDataProvider(); }
+
+    /**
+     * @brief the rows of the provider changed (added, removed or modified): update the displayed rows
+     */
+    void RefreshRows();
+
     /**
      * @brief set a sorting function for this tree. The function returns true if the first element should be placed
      * before the second element
@@ -171,6 +190,7 @@ public:
 
     /**
      * @brief ppends an item to the end of the branch identified by parent, return a new item id.
+     * In virtual mode (see SetDataProvider()) the rows come from the provider: this asserts and returns an invalid id
      */
     wxTreeItemId AppendItem(const wxTreeItemId& parent, const wxString& text, int image = -1, int selImage = -1,
                             wxTreeItemData* data = NULL);
@@ -181,6 +201,7 @@ public:
 
     /**
      * @brief insert item after 'previous'
+     * In virtual mode (see SetDataProvider()) the rows come from the provider: this asserts and returns an invalid id
      */
     wxTreeItemId InsertItem(const wxTreeItemId& parent, const wxTreeItemId& previous, const wxString& text,
                             int image = -1, int selImage = -1, wxTreeItemData* data = NULL);
@@ -377,7 +398,7 @@ public:
     wxTreeItemId GetPrevSibling(const wxTreeItemId& item) const;
 
     /**
-     * @brief delete all items in tree
+     * @brief delete all items in tree. In virtual mode, this also detaches the data provider
      */
     virtual void DeleteAllItems();
 
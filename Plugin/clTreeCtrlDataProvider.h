@@ -0,0 +1,76 @@
+#ifndef CLTREECTRLDATAPROVIDER_H
+#define CLTREECTRLDATAPROVIDER_H
+
+#include "codelite_exports.h"
+#include <functional>
+#include <wx/defs.h>
+
+class clRowEntry;
+typedef std::function<bool(size_t, size_t)> clRowCompareFunc_t;
+
+/**
+ * @class clTreeCtrlDataProvider
+ * @brief the rows of a clTreeCtrl (or clDataViewListCtrl) in virtual mode. The control does not hold the rows: it asks
+ * the provider for the number of rows and for the content of the rows it displays.
+ *
+ * Rows are addressed by their index among the rows that can be displayed, i.e. the children of a collapsed row are
+ * not counted. A flat provider (a list) only needs to implement GetRowCount() and FillRow()
+ */
+class WXDLLIMPEXP_SDK clTreeCtrlDataProvider
+{
+public:
+    clTreeCtrlDataProvider() {}
+    virtual ~clTreeCtrlDataProvider() {}
+
+    /**
+     * @brief the number of rows
+     */
+    virtual size_t GetRowCount() const = 0;
+
+    /**
+     * @brief set the content of row 'index' into 'row' with the clRowEntry setters (SetLabel, SetBitmapIndex,
+     * SetTextColour, SetData ...). Tree providers also set the indentation of the row with SetIndentsCount().
+     * This is called only for the rows that are displayed
+     */
+    virtual void FillRow(size_t index, clRowEntry* row) const = 0;
+
+    /**
+     * @brief a flat provider has no hierarchy: its rows are drawn as list items (no expand button and no indentation)
+     */
+    virtual bool IsFlat() const { return true; }
+
+    /**
+     * @brief does row 'index' have children?
+     */
+    virtual bool HasChildren(size_t index) const
+    {
+        wxUnusedVar(index);
+        return false;
+    }
+
+    /**
+     * @brief are the children of row 'index' displayed?
+     */
+    virtual bool IsExpanded(size_t index) const
+    {
+        wxUnusedVar(index);
+        return false;
+    }
+
+    /**
+     * @brief show or hide the children of row 'index'. The rows after it move up or down accordingly
+     */
+    virtual void SetExpanded(size_t index, bool expanded)
+    {
+        wxUnusedVar(index);
+        wxUnusedVar(expanded);
+    }
+
+    /**
+     * @brief re-order the rows. 'less' compares two rows given their index before the sort, so the provider should sort
+     * a permutation of the indices and apply it once sorted. Tree providers sort the children of each row
+     */
+    virtual void SortRows(const clRowCompareFunc_t& less) { wxUnusedVar(less); }
+};
+
+#endif // CLTREECTRLDATAPROVIDER_H
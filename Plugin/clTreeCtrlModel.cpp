@@ -1,6 +1,7 @@
 #include "clTreeCtrl.h"
 #include "clTreeCtrlModel.h"
 #include <algorithm>
+#include <unordered_set>
 #include <wx/dc.h>
 #include <wx/settings.h>
 #include <wx/treebase.h>
@@ -24,6 +25,7 @@ clTreeCtrlModel::clTreeCtrlModel(clTreeCtrl* tree)
 clTreeCtrlModel::~clTreeCtrlModel()
 {
     m_shutdown = true; // Disable events
+    DoDeleteVirtualRows(false);
     wxDELETE(m_root);
 }
 
@@ -31,26 +33,35 @@ void clTreeCtrlModel::GetNextItems(clRowEntry* from, int count, clRowEntry::Vec_
 {
     if(count < 0) { count = 0; }
     items.reserve(count);
+    if(m_provider) { return DoGetVirtualRows(from, count, items, selfIncluded, true); }
     return from->GetNextItems(count, items, selfIncluded);
 }
 
 void clTreeCtrlModel::GetPrevItems(clRowEntry* from, int count, clRowEntry::Vec_t& items, bool selfIncluded) const
 {
+    if(m_provider) { return DoGetVirtualRows(from, count, items, selfIncluded, false); }
     return from->GetPrevItems(count, items, selfIncluded);
 }
 
 wxTreeItemId clTreeCtrlModel::AddRoot(const wxString& text, int image, int selImage, wxTreeItemData* data)
 {
     if(m_root) { return wxTreeItemId(m_root); }
-    m_root = new clRowEntry(m_tree, text, image, selImage);
+    m_root = DoCreateRow(text, image, selImage);
     m_root->SetClientData(data);
-    if(m_tree->GetTreeStyle() & wxTR_HIDE_ROOT) {
+    if(m_tree && (m_tree->GetTreeStyle() & wxTR_HIDE_ROOT)) {
         m_root->SetHidden(true);
         m_root->SetExpanded(true);
     }
     return wxTreeItemId(m_root);
 }
 
+clRowEntry* clTreeCtrlModel::DoCreateRow(const wxString& text, int image, int selImage)
+{
+    clRowEntry* row = new clRowEntry(m_tree, text, image, selImage);
+    row->m_model = this;
+    return row;
+}
+
 wxTreeItemId clTreeCtrlModel::GetRootItem() const
 {
     if(!m_root) { return wxTreeItemId(); }
@@ -63,6 +74,12 @@ void clTreeCtrlModel::UnselectAll()
         m_selectedItems[i]->SetSelected(false);
     }
     m_selectedItems.clear();
+    if(!m_virtualSelection.IsEmpty()) {
+        for(VirtualRowsMap_t::iterator iter = m_virtualRows.begin(); iter != m_virtualRows.end(); ++iter) {
+            if(m_virtualSelection.Contains(iter->first)) { iter->second->SetSelected(false); }
+        }
+        m_virtualSelection.Clear();
+    }
 }
 
 void clTreeCtrlModel::SelectItem(const wxTreeItemId& item, bool select_it, bool addSelection, bool clear_old_selection)
@@ -89,6 +106,7 @@ void clTreeCtrlModel::SelectItem(const wxTreeItemId& item, bool select_it, bool
         clRowEntry::Vec_t::iterator iter =
             std::find_if(m_selectedItems.begin(), m_selectedItems.end(), [&](clRowEntry* p) { return (p == child); });
         if(iter != m_selectedItems.end() && !select_it) { m_selectedItems.erase(iter); }
+        if(m_provider && !select_it && (child != m_root)) { m_virtualSelection.Remove(child->m_rowIndex); }
     } else {
         if(!ClearSelections(item != GetSingleSelection())) { return; }
     }
@@ -121,6 +139,7 @@ void clTreeCtrlModel::SetOnScreenItems(const clRowEntry::Vec_t& items)
         if(iter == items.end()) { m_onScreenItems[i]->ClearRects(); }
     }
     m_onScreenItems = items;
+    if(m_provider) { DoDeleteUnusedVirtualRows(); }
 }
 
 bool clTreeCtrlModel::ExpandToItem(const wxTreeItemId& item)
@@ -141,13 +160,15 @@ wxTreeItemId clTreeCtrlModel::AppendItem(const wxTreeItemId& parent, const wxStr
 {
     clRowEntry* parentNode = nullptr;
     if(!parent.IsOk()) { return wxTreeItemId(); }
+    // In virtual mode the rows come from the provider
+    wxCHECK_MSG(!m_provider, wxTreeItemId(), "can not append items in virtual mode, the rows come from the provider");
     parentNode = ToPtr(parent);
 
-    clRowEntry* child = new clRowEntry(m_tree, text, image, selImage);
+    clRowEntry* child = DoCreateRow(text, image, selImage);
     child->SetClientData(data);
     // Find the best insertion point
     clRowEntry* prevItem = nullptr;
-    if(!parentNode->IsRoot() && (m_tree->GetTreeStyle() & wxTR_SORT_TOP_LEVEL)) {
+    if(!parentNode->IsRoot() && m_tree && (m_tree->GetTreeStyle() & wxTR_SORT_TOP_LEVEL)) {
         // We have been requested to sort top level items only
         parentNode->AddChild(child);
     } else if(m_shouldInsertBeforeFunc != nullptr) {
@@ -172,12 +193,13 @@ wxTreeItemId clTreeCtrlModel::InsertItem(const wxTreeItemId& parent, const wxTre
 {
     if(!parent.IsOk()) { return wxTreeItemId(); }
     if(!previous.IsOk()) { return wxTreeItemId(); }
+    wxCHECK_MSG(!m_provider, wxTreeItemId(), "can not insert items in virtual mode, the rows come from the provider");
 
     clRowEntry* pPrev = ToPtr(previous);
     clRowEntry* parentNode = ToPtr(parent);
     if(pPrev->GetParent() != parentNode) { return wxTreeItemId(); }
 
-    clRowEntry* child = new clRowEntry(m_tree, text, image, selImage);
+    clRowEntry* child = DoCreateRow(text, image, selImage);
     child->SetClientData(data);
     parentNode->InsertChild(child, pPrev);
     return wxTreeItemId(child);
@@ -191,6 +213,14 @@ void clTreeCtrlModel::DoExpandAllChildren(const wxTreeItemId& item, bool expand)
 {
     clRowEntry* p = ToPtr(item);
     if(!p) { return; }
+    if(m_provider) {
+        if(p == m_root) {
+            DoExpandAllVirtualRows(expand);
+        } else {
+            p->SetExpanded(expand);
+        }
+        return;
+    }
     while(p) {
         if(p->HasChildren()) {
             if(expand && !p->IsExpanded()) {
@@ -217,6 +247,12 @@ void clTreeCtrlModel::DeleteItem(const wxTreeItemId& item)
 {
     clRowEntry* node = ToPtr(item);
     if(!node) { return; }
+    if(m_provider) {
+        // The rows belong to the provider: only the root can be deleted, which leaves the virtual mode
+        if(node != m_root) { return; }
+        DoDeleteVirtualRows(false);
+        m_provider = nullptr;
+    }
     node->DeleteAllChildren();
 
     // Send the delete event
@@ -273,6 +309,7 @@ bool clTreeCtrlModel::NodeExpanding(clRowEntry* node, bool expanding)
 
 void clTreeCtrlModel::NodeExpanded(clRowEntry* node, bool expanded)
 {
+    if(m_provider && (node != m_root)) { DoVirtualRowExpanded(node); }
     wxTreeEvent after(expanded ? wxEVT_TREE_ITEM_EXPANDED : wxEVT_TREE_ITEM_COLLAPSED);
     after.SetItem(wxTreeItemId(node));
     after.SetEventObject(m_tree);
@@ -285,10 +322,29 @@ bool clTreeCtrlModel::IsMultiSelection() const { return m_tree && (m_tree->GetTr
 
 bool clTreeCtrlModel::SendEvent(wxEvent& event)
 {
-    if(m_shutdown) { return false; }
+    if(m_shutdown || !m_tree) { return false; }
     return m_tree->GetEventHandler()->ProcessEvent(event);
 }
 
+const clRowEntry::Vec_t& clTreeCtrlModel::GetSelections() const
+{
+    DoCreateVirtualSelection();
+    return m_selectedItems;
+}
+
+size_t clTreeCtrlModel::GetSelectionsCount() const
+{
+    if(m_virtualSelection.IsEmpty()) { return m_selectedItems.size(); }
+
+    // A row can be both in the selected items and in the range selection
+    size_t count = m_selectedItems.size() + m_virtualSelection.GetCount();
+    for(size_t i = 0; i < m_selectedItems.size(); ++i) {
+        clRowEntry* row = m_selectedItems[i];
+        if((row != m_root) && m_virtualSelection.Contains(row->m_rowIndex)) { --count; }
+    }
+    return count;
+}
+
 wxTreeItemId clTreeCtrlModel::GetSingleSelection() const
 {
     if(m_selectedItems.empty()) { return wxTreeItemId(); }
@@ -299,14 +355,23 @@ int clTreeCtrlModel::GetItemIndex(clRowEntry* item) const
 {
     if(item == NULL) { return wxNOT_FOUND; }
     if(!m_root) { return wxNOT_FOUND; }
+    if(m_provider) { return (item == m_root) ? 0 : (int)item->m_rowIndex; }
+
+    // Count the visible rows before 'item', level by level up to the root
     int counter = 0;
-    clRowEntry* current = m_root;
-    while(current) {
-        if(current == item) { return counter; }
-        if(current->IsVisible()) { ++counter; }
-        current = current->GetNext();
+    clRowEntry* current = item;
+    while(current->GetParent()) {
+        clRowEntry* parent = current->GetParent();
+        if(parent->IsExpanded()) {
+            counter += parent->GetChildrenLinesBefore(current);
+        } else {
+            // 'item' is in a collapsed subtree: the parent is the last visible row before it
+            counter = 0;
+        }
+        if(!parent->IsHidden()) { ++counter; }
+        current = parent;
     }
-    return wxNOT_FOUND;
+    return (current == m_root) ? counter : wxNOT_FOUND;
 }
 
 bool clTreeCtrlModel::GetRange(clRowEntry* from, clRowEntry* to, clRowEntry::Vec_t& items) const
@@ -328,6 +393,13 @@ bool clTreeCtrlModel::GetRange(clRowEntry* from, clRowEntry* to, clRowEntry::Vec
 
     int index1 = GetItemIndex(from);
     int index2 = GetItemIndex(to);
+    if(m_provider) {
+        for(int i = wxMin(index1, index2); i <= wxMax(index1, index2); ++i) {
+            clRowEntry* row = GetVirtualRow(i);
+            if(row) { items.push_back(row); }
+        }
+        return true;
+    }
 
     clRowEntry* start_item = index1 > index2 ? to : from;
     clRowEntry* end_item = index1 > index2 ? from : to;
@@ -346,6 +418,7 @@ bool clTreeCtrlModel::GetRange(clRowEntry* from, clRowEntry* to, clRowEntry::Vec
 size_t clTreeCtrlModel::GetExpandedLines() const
 {
     if(!GetRoot()) { return 0; }
+    if(m_provider) { return m_provider->GetRowCount(); }
     return m_root->GetExpandedLines();
 }
 
@@ -353,12 +426,18 @@ clRowEntry* clTreeCtrlModel::GetItemFromIndex(int index) const
 {
     if(index < 0) { return nullptr; }
     if(!m_root) { return nullptr; }
-    int curIndex = -1;
+    if(m_provider) { return GetVirtualRow(index); }
+
+    // Go down the tree, skipping the subtrees that end before the requested row
+    size_t line = index;
     clRowEntry* current = m_root;
     while(current) {
-        if(current->IsVisible()) { ++curIndex; }
-        if(curIndex == index) { return current; }
-        current = current->GetNext();
+        if(!current->IsHidden()) {
+            if(line == 0) { return current; }
+            --line;
+        }
+        if(!current->IsExpanded()) { return nullptr; }
+        current = current->GetChildByLine(line);
     }
     return nullptr;
 }
@@ -447,7 +526,7 @@ void clTreeCtrlModel::AddSelection(const wxTreeItemId& item)
 
 bool clTreeCtrlModel::ClearSelections(bool notify)
 {
-    if(m_selectedItems.empty()) { return true; }
+    if(m_selectedItems.empty() && m_virtualSelection.IsEmpty()) { return true; }
 
     if(notify) {
         // Check if we can proceed with this operation
@@ -464,6 +543,7 @@ bool clTreeCtrlModel::ClearSelections(bool notify)
 bool clTreeCtrlModel::IsItemSelected(const clRowEntry* item) const
 {
     if(item == nullptr) { return false; }
+    if(m_provider && (item != m_root) && m_virtualSelection.Contains(item->m_rowIndex)) { return true; }
     if(m_selectedItems.empty()) { return false; }
     clRowEntry::Vec_t::const_iterator iter =
         std::find_if(m_selectedItems.begin(), m_selectedItems.end(), [&](clRowEntry* p) { return (p == item); });
@@ -483,6 +563,12 @@ clRowEntry* clTreeCtrlModel::GetRowBefore(clRowEntry* item, bool visibleItem) co
 {
     clRowEntry* curp = item;
     if(!curp) { return nullptr; }
+    if(m_provider) {
+        // The hidden root comes before the first row
+        if((curp == m_root) || (curp->m_rowIndex == 0)) { return nullptr; }
+        return GetVirtualRow(curp->m_rowIndex - 1);
+    }
+    if(visibleItem) { return curp->GetPrevVisible(); }
     curp = curp->GetPrev();
     while(curp) {
         if(visibleItem && !curp->IsVisible()) {
@@ -498,6 +584,8 @@ clRowEntry* clTreeCtrlModel::GetRowAfter(clRowEntry* item, bool visibleItem) con
 {
     clRowEntry* curp = item;
     if(!curp) { return nullptr; }
+    if(m_provider) { return GetVirtualRow((curp == m_root) ? 0 : (curp->m_rowIndex + 1)); }
+    if(visibleItem) { return curp->GetNextVisible(); }
     curp = curp->GetNext();
     while(curp) {
         if(visibleItem && !curp->IsVisible()) {
@@ -508,3 +596,232 @@ clRowEntry* clTreeCtrlModel::GetRowAfter(clRowEntry* item, bool visibleItem) con
     }
     return curp;
 }
+
+void clTreeCtrlModel::SetDataProvider(clTreeCtrlDataProvider* provider)
+{
+    // Delete the tree items (or the rows of the previous provider)
+    if(m_root) { DeleteItem(GetRootItem()); }
+    m_provider = provider;
+    if(!m_provider) { return; }
+
+    // The rows are the children of a hidden root
+    m_root = new clRowEntry(m_tree, "Hidden Root");
+    m_root->SetHidden(true);
+    m_root->SetExpanded(true);
+}
+
+clRowEntry* clTreeCtrlModel::GetVirtualRow(size_t index) const
+{
+    if(!m_provider || !m_root || (index >= m_provider->GetRowCount())) { return nullptr; }
+    VirtualRowsMap_t::iterator iter = m_virtualRows.find(index);
+    if(iter != m_virtualRows.end()) { return iter->second; }
+
+    clRowEntry* row = new clRowEntry(m_tree, wxEmptyString);
+    row->SetParent(m_root);
+    row->m_rowIndex = index;
+    row->SetSelected(m_virtualSelection.Contains(index));
+    FillVirtualRow(index, row);
+    m_virtualRows.insert({ index, row });
+    return row;
+}
+
+void clTreeCtrlModel::FillVirtualRow(size_t index, clRowEntry* row) const
+{
+    // Start from empty cells, the provider sets the values it has
+    size_t columns = m_tree->GetHeader()->empty() ? 1 : m_tree->GetHeader()->size();
+    row->m_cells.assign(columns, clCellValue("", -1, -1));
+    row->SetListItem(m_provider->IsFlat());
+    row->SetFlag(kNF_HasChildren, m_provider->HasChildren(index));
+    row->SetFlag(kNF_Expanded, m_provider->IsExpanded(index));
+    m_provider->FillRow(index, row);
+}
+
+void clTreeCtrlModel::DoGetVirtualRows(clRowEntry* from, int count, clRowEntry::Vec_t& items, bool selfIncluded,
+                                       bool next) const
+{
+    if(!from || (count <= 0)) { return; }
+    long index = 0;
+    if(from == m_root) {
+        // The hidden root comes before the first row
+        if(!next) { return; }
+    } else {
+        index = from->m_rowIndex;
+        if(!selfIncluded) { index += next ? 1 : -1; }
+    }
+
+    size_t first = items.size();
+    for(; (index >= 0) && ((int)(items.size() - first) < count); index += next ? 1 : -1) {
+        clRowEntry* row = GetVirtualRow(index);
+        if(!row) { break; }
+        items.push_back(row);
+    }
+    if(!next) { std::reverse(items.begin() + first, items.end()); }
+}
+
+void clTreeCtrlModel::DoVirtualRowExpanded(clRowEntry* node)
+{
+    long index = node->m_rowIndex;
+    long countBefore = m_provider->GetRowCount();
+    m_provider->SetExpanded(index, node->IsExpanded());
+    long delta = (long)m_provider->GetRowCount() - countBefore;
+    if(delta == 0) { return; }
+
+    // Move the rows that are below 'node'. When collapsing, the rows of its subtree are gone
+    VirtualRowsMap_t rows;
+    clRowEntry::Vec_t hiddenRows;
+    for(VirtualRowsMap_t::iterator iter = m_virtualRows.begin(); iter != m_virtualRows.end(); ++iter) {
+        clRowEntry* row = iter->second;
+        if(clRowIndexRanges::MoveIndex(iter->first, index, delta, row->m_rowIndex)) {
+            rows.insert({ row->m_rowIndex, row });
+        } else {
+            hiddenRows.push_back(row);
+        }
+    }
+    m_virtualRows.swap(rows);
+    m_virtualSelection.RowExpanded(index, delta);
+
+    bool firstItemHidden = false;
+    for(size_t i = 0; i < hiddenRows.size(); ++i) {
+        firstItemHidden = firstItemHidden || (hiddenRows[i] == m_firstItemOnScreen);
+        delete hiddenRows[i];
+    }
+    if(firstItemHidden) { m_firstItemOnScreen = node; }
+}
+
+void clTreeCtrlModel::DoExpandAllVirtualRows(bool expand)
+{
+    // The rows after the current one move as we go, so the row count is read every time
+    for(size_t i = 0; i < m_provider->GetRowCount(); ++i) {
+        if(m_provider->HasChildren(i) && (m_provider->IsExpanded(i) != expand)) { m_provider->SetExpanded(i, expand); }
+    }
+    DoDeleteVirtualRows(true);
+}
+
+void clTreeCtrlModel::DoDeleteVirtualRows(bool keepFirstItemOnScreen)
+{
+    long firstIndex = wxNOT_FOUND;
+    if(keepFirstItemOnScreen && m_firstItemOnScreen && (m_firstItemOnScreen != m_root)) {
+        firstIndex = m_firstItemOnScreen->m_rowIndex;
+    }
+
+    // Drop the references first: deleting the rows one by one would search these lists for every row
+    m_selectedItems.clear();
+    m_virtualSelection.Clear();
+    m_onScreenItems.clear();
+    if(m_firstItemOnScreen != m_root) { m_firstItemOnScreen = nullptr; }
+
+    VirtualRowsMap_t rows;
+    rows.swap(m_virtualRows);
+    for(VirtualRowsMap_t::iterator iter = rows.begin(); iter != rows.end(); ++iter) {
+        delete iter->second;
+    }
+
+    if((firstIndex != wxNOT_FOUND) && m_provider && (m_provider->GetRowCount() > 0)) {
+        m_firstItemOnScreen = GetVirtualRow(wxMin((size_t)firstIndex, m_provider->GetRowCount() - 1));
+    }
+}
+
+void clTreeCtrlModel::DoDeleteUnusedVirtualRows()
+{
+    // Keep the rows on screen, the selected rows and the first row on screen. The rows of the range selection are
+    // kept by index, they are created again when needed
+    std::unordered_set<clRowEntry*> onScreen(m_onScreenItems.begin(), m_onScreenItems.end());
+    std::unordered_set<clRowEntry*> selected(m_selectedItems.begin(), m_selectedItems.end());
+    clRowEntry::Vec_t unused;
+    for(VirtualRowsMap_t::iterator iter = m_virtualRows.begin(); iter != m_virtualRows.end();) {
+        clRowEntry* row = iter->second;
+        if(selected.count(row) || (row == m_firstItemOnScreen) || onScreen.count(row)) {
+            ++iter;
+        } else {
+            unused.push_back(row);
+            iter = m_virtualRows.erase(iter);
+        }
+    }
+    for(size_t i = 0; i < unused.size(); ++i) {
+        delete unused[i];
+    }
+}
+
+void clTreeCtrlModel::RefreshVirtualRows()
+{
+    if(!m_provider) { return; }
+    size_t count = m_provider->GetRowCount();
+    m_virtualSelection.Truncate(count);
+    clRowEntry::Vec_t outOfRange;
+    for(VirtualRowsMap_t::iterator iter = m_virtualRows.begin(); iter != m_virtualRows.end();) {
+        if(iter->first >= count) {
+            outOfRange.push_back(iter->second);
+            iter = m_virtualRows.erase(iter);
+        } else {
+            FillVirtualRow(iter->first, iter->second);
+            ++iter;
+        }
+    }
+
+    bool firstItemDeleted = false;
+    for(size_t i = 0; i < outOfRange.size(); ++i) {
+        firstItemDeleted = firstItemDeleted || (outOfRange[i] == m_firstItemOnScreen);
+        delete outOfRange[i];
+    }
+    if(firstItemDeleted && (count > 0)) { m_firstItemOnScreen = GetVirtualRow(count - 1); }
+}
+
+void clTreeCtrlModel::SortVirtualRows(const clSortFunc_t& CompareFunc)
+{
+    if(!m_provider || !CompareFunc) { return; }
+
+    // The compare function works on rows: fill two rows with the content of the rows being compared
+    clRowEntry first(m_tree, wxEmptyString);
+    clRowEntry second(m_tree, wxEmptyString);
+    m_provider->SortRows([&](size_t a, size_t b) {
+        FillVirtualRow(a, &first);
+        FillVirtualRow(b, &second);
+        return CompareFunc(&first, &second);
+    });
+
+    // The rows moved: the existing rows (and the selection) no longer match the provider
+    DoDeleteVirtualRows(true);
+}
+
+void clTreeCtrlModel::SelectVirtualRange(clRowEntry* from, clRowEntry* to)
+{
+    if(!m_provider || !from || !to || (from == m_root) || (to == m_root)) { return; }
+    size_t first = wxMin(from->m_rowIndex, to->m_rowIndex);
+    size_t last = wxMax(from->m_rowIndex, to->m_rowIndex);
+
+    // Like GetRange(), the rows are added from the lowest index
+    AddSelection(wxTreeItemId(GetVirtualRow(first)));
+    if((last - first) > 1) {
+        m_virtualSelection.Add(first + 1, last - 1);
+        for(VirtualRowsMap_t::iterator iter = m_virtualRows.begin(); iter != m_virtualRows.end(); ++iter) {
+            if(m_virtualSelection.Contains(iter->first)) { iter->second->SetSelected(true); }
+        }
+    }
+    if(last != first) { AddSelection(wxTreeItemId(GetVirtualRow(last))); }
+}
+
+void clTreeCtrlModel::DoCreateVirtualSelection() const
+{
+    if(m_virtualSelection.IsEmpty()) { return; }
+    std::unordered_set<clRowEntry*> selected(m_selectedItems.begin(), m_selectedItems.end());
+    clRowEntry::Vec_t rows;
+    const clRowIndexRanges::Vec_t& ranges = m_virtualSelection.GetRanges();
+    for(size_t i = 0; i < ranges.size(); ++i) {
+        for(size_t index = ranges[i].first; index <= ranges[i].second; ++index) {
+            clRowEntry* row = GetVirtualRow(index);
+            if(row && !selected.count(row)) { rows.push_back(row); }
+        }
+    }
+    m_virtualSelection.Clear();
+
+    // Keep the last selected item last, it is the single selection
+    m_selectedItems.insert(m_selectedItems.begin(), rows.begin(), rows.end());
+}
+
+void clTreeCtrlModel::GetVirtualRows(clRowEntry::Vec_t& rows) const
+{
+    rows.reserve(rows.size() + m_virtualRows.size());
+    for(VirtualRowsMap_t::const_iterator iter = m_virtualRows.begin(); iter != m_virtualRows.end(); ++iter) {
+        rows.push_back(iter->second);
+    }
+}
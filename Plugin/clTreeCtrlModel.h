@@ -2,8 +2,11 @@
 #define CLTREECTRLMODEL_H
 
 #include "clRowEntry.h"
+#include "clRowIndexRanges.h"
+#include "clTreeCtrlDataProvider.h"
 #include "codelite_exports.h"
 #include <functional>
+#include <unordered_map>
 #include <vector>
 #include <wx/colour.h>
 #include <wx/sharedptr.h>
@@ -16,20 +19,44 @@ class WXDLLIMPEXP_SDK clTreeCtrlModel
 {
     clTreeCtrl* m_tree = nullptr;
     clRowEntry* m_root = nullptr;
-    clRowEntry::Vec_t m_selectedItems;
+    mutable clRowEntry::Vec_t m_selectedItems;
     clRowEntry::Vec_t m_onScreenItems;
     clRowEntry* m_firstItemOnScreen = nullptr;
     int m_indentSize = 16;
     bool m_shutdown = false;
     clSortFunc_t m_shouldInsertBeforeFunc = nullptr;
+    clTreeCtrlDataProvider* m_provider = nullptr;
+    // Virtual mode: the rows that were created from the provider, by index. These are the rows on screen, the selected
+    // rows and the rows visited since the last paint
+    typedef std::unordered_map<size_t, clRowEntry*> VirtualRowsMap_t;
+    mutable VirtualRowsMap_t m_virtualRows;
+    // Virtual mode: the rows selected by a range selection, by index. Their rows are created only when they are needed
+    mutable clRowIndexRanges m_virtualSelection;
 
 protected:
     void DoExpandAllChildren(const wxTreeItemId& item, bool expand);
+    void DoExpandAllVirtualRows(bool expand);
+    void DoGetVirtualRows(clRowEntry* from, int count, clRowEntry::Vec_t& items, bool selfIncluded, bool next) const;
+    void DoVirtualRowExpanded(clRowEntry* node);
+    /**
+     * @brief delete the virtual rows. Keep the first row on screen (by its index) if 'keepFirstItemOnScreen' is set
+     */
+    void DoDeleteVirtualRows(bool keepFirstItemOnScreen);
+    void DoDeleteUnusedVirtualRows();
+    /**
+     * @brief create the rows of the range selection and add them to the selected items
+     */
+    void DoCreateVirtualSelection() const;
+    clRowEntry* DoCreateRow(const wxString& text, int image, int selImage);
     bool IsSingleSelection() const;
     bool IsMultiSelection() const;
     bool SendEvent(wxEvent& event);
 
 public:
+    /**
+     * @brief the model of 'tree'. Without a tree (nullptr), the model can be used on its own: no events are sent and
+     * the root is visible
+     */
     clTreeCtrlModel(clTreeCtrl* tree);
     ~clTreeCtrlModel();
 
@@ -104,10 +131,13 @@ public:
 
     const clRowEntry::Vec_t& GetOnScreenItems() const { return m_onScreenItems; }
     clRowEntry::Vec_t& GetOnScreenItems() { return m_onScreenItems; }
-    const clRowEntry::Vec_t& GetSelections() const { return m_selectedItems; }
+    /**
+     * @brief the selected rows. In virtual mode, this creates the rows of a range selection
+     */
+    const clRowEntry::Vec_t& GetSelections() const;
     bool ExpandToItem(const wxTreeItemId& item);
     wxTreeItemId GetSingleSelection() const;
-    size_t GetSelectionsCount() const { return m_selectedItems.size(); }
+    size_t GetSelectionsCount() const;
 
     /**
      * @brief do we have items in this tree? (root included)
@@ -128,6 +158,7 @@ public:
     /**
      * @brief get range of items from -> to
      * Or from: to->from (incase 'to' has a lower index)
+     * In virtual mode this creates a row for every index in the range, use SelectVirtualRange() to select it
      */
     bool GetRange(clRowEntry* from, clRowEntry* to, clRowEntry::Vec_t& items) const;
 
@@ -137,6 +168,49 @@ public:
     clRowEntry* GetPrevSibling(clRowEntry* item) const;
     
     void EnableEvents(bool enable) { m_shutdown = !enable; }
+
+    //===--------------------
+    // Virtual mode
+    //===--------------------
+    /**
+     * @brief take the rows from 'provider' instead of the items of the tree. All the items are deleted. Pass nullptr
+     * to leave the virtual mode. The model does not own the provider
+     */
+    void SetDataProvider(clTreeCtrlDataProvider* provider);
+    clTreeCtrlDataProvider* GetDataProvider() const { return m_provider; }
+    bool IsVirtual() const { return m_provider != nullptr; }
+
+    /**
+     * @brief return the row at 'index', create it if needed. The row (and its item id) stays valid while it is on
+     * screen or selected
+     */
+    clRowEntry* GetVirtualRow(size_t index) const;
+
+    /**
+     * @brief fill 'row' with the content of the row at 'index'
+     */
+    void FillVirtualRow(size_t index, clRowEntry* row) const;
+
+    /**
+     * @brief the provider rows changed: fill the existing rows again and drop those that are out of range
+     */
+    void RefreshVirtualRows();
+
+    /**
+     * @brief sort the provider rows with 'CompareFunc'. This clears the selection
+     */
+    void SortVirtualRows(const clSortFunc_t& CompareFunc);
+
+    /**
+     * @brief the rows that currently exist
+     */
+    void GetVirtualRows(clRowEntry::Vec_t& rows) const;
+
+    /**
+     * @brief add the rows from 'from' to 'to' to the selection. Only the two ends get a row, the rows between them
+     * are kept by index
+     */
+    void SelectVirtualRange(clRowEntry* from, clRowEntry* to);
 };
 
 #endif // CLTREECTRLMODEL_H
@@ -24,6 +24,8 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "compilation_database.h"
+#include "CompileCommandsIndex.h"
+#include "CompileCommandsReader.h"
 #include "file_logger.h"
 #include "fileextmanager.h"
 #include "fileutils.h"
@@ -314,9 +316,6 @@ FileNameVector_t CompilationDatabase::GetCompileCommandsFiles() const
 
 void CompilationDatabase::ProcessCMakeCompilationDatabase(const wxFileName& compile_commands)
 {
-    JSON root(compile_commands);
-    JSONItem arr = root.toElement();
-
     try {
 
         wxString sql;
@@ -324,32 +323,51 @@ void CompilationDatabase::ProcessCMakeCompilationDatabase(const wxFileName& comp
         wxSQLite3Statement st = m_db->PrepareStatement(sql);
         m_db->ExecuteUpdate("BEGIN");
 
-        for(int i = 0; i < arr.arraySize(); ++i) {
+        // Stream the entries into the database, the file is not loaded into memory
+        bool ok = CompileCommandsReader::Read(compile_commands, [&](const CompileCommandsReader::Entry& entry) {
             // Each object has 3 properties:
-            // directory, command, file
-            JSONItem element = arr.arrayItem(i);
-            if(element.hasNamedObject("file") && element.hasNamedObject("directory") &&
-               element.hasNamedObject("command")) {
-                wxString cmd = element.namedObject("command").toString();
-                wxString file = element.namedObject("file").toString();
-                wxString path = wxFileName(file).GetPath();
-                wxString cwd = element.namedObject("directory").toString();
-
-                cwd = wxFileName(cwd, "").GetPath();
-                file = wxFileName(file).GetFullPath();
-
-                st.Bind(1, file);
-                st.Bind(2, path);
-                st.Bind(3, cwd);
-                st.Bind(4, cmd);
-                st.ExecuteUpdate();
+            // directory, command (or arguments), file
+            if(entry.file.empty() || entry.directory.empty() ||
+               (entry.command.empty() && entry.arguments.empty())) {
+                return;
+            }
+            wxString cmd;
+            if(!entry.command.empty()) {
+                cmd = wxString::FromUTF8(entry.command.c_str(), entry.command.length());
+            } else {
+                CompileCommandsIndex::Flags flags;
+                for(const std::string& arg : entry.arguments) {
+                    flags.arguments.Add(wxString::FromUTF8(arg.c_str(), arg.length()));
+                }
+                cmd = flags.GetCommandLine();
             }
+            wxFileName file(wxString::FromUTF8(entry.file.c_str(), entry.file.length()));
+            wxString cwd = wxString::FromUTF8(entry.directory.c_str(), entry.directory.length());
+            cwd = wxFileName(cwd, "").GetPath();
+
+            st.Bind(1, file.GetFullPath());
+            st.Bind(2, file.GetPath());
+            st.Bind(3, cwd);
+            st.Bind(4, cmd);
+            st.ExecuteUpdate();
+        });
+
+        if(ok) {
+            m_db->ExecuteUpdate("COMMIT");
+        } else {
+            // don't keep the entries read before the error
+            clWARNING() << "Invalid compilation database:" << compile_commands << clEndl;
+            m_db->ExecuteUpdate("ROLLBACK");
         }
 
-        m_db->ExecuteUpdate("COMMIT");
-
     } catch(wxSQLite3Exception& e) {
-        wxUnusedVar(e);
+        clWARNING() << "Failed to store" << compile_commands << ":" << e.GetMessage() << clEndl;
+        try {
+            m_db->ExecuteUpdate("ROLLBACK");
+        } catch(wxSQLite3Exception& e2) {
+            // no transaction in progress
+            wxUnusedVar(e2);
+        }
     }
 }
 
@@ -410,22 +428,16 @@ wxArrayString CompilationDatabase::FindIncludePaths(const wxString& rootFolder,
     lastCompileCommands = compile_commands;
     lastCompileCommandsModified = compile_commands.GetModificationTime().GetTicks();
 
+    // The translation units share a handful of distinct flags: parse each of them once
+    CompileCommandsIndex index;
+    index.Load(compile_commands);
+
     wxStringSet_t paths;
-    JSON root(compile_commands);
-    JSONItem arr = root.toElement();
-    const int file_size = arr.arraySize();
-    for(int i = 0; i < file_size; ++i) {
-        // Each object has 3 properties:
-        // directory, command, file
-        JSONItem element = arr.arrayItem(i);
-        if(element.hasNamedObject("file") && element.hasNamedObject("directory") && element.hasNamedObject("command")) {
-            wxString cmd = element.namedObject("command").toString();
-            wxString cwd = element.namedObject("directory").toString();
-            CompilerCommandLineParser cclp(cmd, cwd);
-            const wxArrayString& includes = cclp.GetIncludes();
-            std::for_each(includes.begin(), includes.end(),
-                          [&](const wxString& includePath) { paths.insert(includePath); });
-        }
+    for(const CompileCommandsIndex::FlagsPtr_t& flags : index.GetFlags()) {
+        CompilerCommandLineParser cclp(flags->GetCommandLine(), flags->directory);
+        const wxArrayString& includes = cclp.GetIncludes();
+        std::for_each(includes.begin(), includes.end(),
+                      [&](const wxString& includePath) { paths.insert(includePath); });
     }
     // Convert the set back to array
     wxArrayString includePaths;
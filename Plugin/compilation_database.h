@@ -46,7 +46,8 @@ protected:
     void CreateDatabase();
     wxString GetDbVersion();
     /**
-     * @brief create our compilation database out of CMake's compile_commands.json file
+     * @brief create our compilation database out of CMake's compile_commands.json file. Nothing is stored if the file
+     * is not a valid compilation database
      */
     void ProcessCMakeCompilationDatabase(const wxFileName& compile_commands);
 
@@ -114,7 +114,9 @@ bool Project::Create(const wxString& name, const wxString& description, const wx
     return true;
 }
 
-bool Project::Load(const wxString& path)
+bool Project::Load(const wxString& path) { return LoadXml(path) && FinishLoad(); }
+
+bool Project::LoadXml(const wxString& path)
 {
     if(!m_doc.Load(path)) {
         return false;
@@ -133,7 +135,11 @@ bool Project::Load(const wxString& path)
     DoBuildCacheFromXml();
     SetModified(true);
     SetProjectLastModifiedTime(GetFileLastModifiedTime());
+    return true;
+}
 
+bool Project::FinishLoad()
+{
     DoUpdateProjectSettings();
     bool saveNeeded = false;
     if(GetVersionNumber() < CURRENT_WORKSPACE_VERSION) {
@@ -458,6 +464,14 @@ void Project::SetModified(bool mod) { m_isModified = mod; }
 
 bool Project::IsModified() { return m_isModified; }
 
+wxString Project::GetXmlString() const
+{
+    wxString projectXml;
+    wxStringOutputStream sos(&projectXml);
+    m_doc.Save(sos);
+    return projectXml;
+}
+
 wxString Project::GetDescription() const
 {
     wxXmlNode* root = m_doc.GetRoot();
@@ -467,6 +467,21 @@ public:
      * \return
      */
     bool Load(const wxString& path);
+
+    /**
+     * \brief the first part of Load(): read the project file and build the files table.
+     * Unlike Load(), it can be called from a worker thread
+     * \param path
+     * \return
+     */
+    bool LoadXml(const wxString& path);
+
+    /**
+     * \brief the second part of Load(): load the project settings (they use the global build settings, so call it
+     * from the main thread)
+     * \return
+     */
+    bool FinishLoad();
     /**
      * \brief Create new project
      * \param name project name
@@ -651,6 +666,11 @@ public:
      */
     void SetModified(bool mod);
 
+    /**
+     * @brief the project XML (as it would be saved)
+     */
+    wxString GetXmlString() const;
+
     // Transaction support to reduce overhead of disk writing
     void BeginTranscation() { m_tranActive = true; }
     void CommitTranscation() { Save(); }
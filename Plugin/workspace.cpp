@@ -49,6 +49,10 @@
 #include "compiler_command_line_parser.h"
 #include "fileutils.h"
 #include <wx/sstream.h>
+#include <wx/stopwatch.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 clCxxWorkspace::clCxxWorkspace()
     : m_saveOnExit(true)
@@ -1245,20 +1249,75 @@ void clCxxWorkspace::DoUnselectActiveProject()
 
 void clCxxWorkspace::DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString& folder,
                                            std::vector<wxXmlNode*>& removedChildren)
+{
+    // A new Project reads the global build settings: create them here, on the main thread
+    wxStopWatch sw;
+    std::vector<ProjectToLoad> projects;
+    DoCollectProjectsFromXml(parentNode, folder, projects);
+    long collectTime = sw.Time();
+
+    // Parse the project files and build their files tables in parallel. The workers only touch their own
+    // projects
+    sw.Start();
+    std::atomic<size_t> next(0);
+    auto loadProjects = [&]() {
+        for(size_t i = next++; i < projects.size(); i = next++) {
+            ProjectToLoad& p = projects[i];
+            p.loaded = p.project->LoadXml(p.path);
+        }
+    };
+    size_t threadsCount = std::min<size_t>(projects.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for(size_t i = 1; i < threadsCount; ++i) {
+        threads.push_back(std::thread(loadProjects));
+    }
+    loadProjects();
+    for(std::thread& thr : threads) {
+        thr.join();
+    }
+    long parseTime = sw.Time();
+
+    // Add them to the workspace, in the order of the XML file
+    sw.Start();
+    for(ProjectToLoad& p : projects) {
+        if(!p.loaded || !p.project->FinishLoad()) {
+            clWARNING() << "Corrupted project file" << p.path << clEndl;
+            removedChildren.push_back(p.node);
+            continue;
+        }
+        m_projects.insert(std::make_pair(p.project->GetName(), p.project));
+        p.project->AssociateToWorkspace(this);
+        p.project->SetWorkspaceFolder(p.folder);
+    }
+    clDEBUG() << "Workspace: loaded" << projects.size() << "projects. Collect:" << collectTime
+              << "ms, parse:" << parseTime << "ms (" << threadsCount << "threads), attach:" << sw.Time() << "ms"
+              << clEndl;
+}
+
+void clCxxWorkspace::DoCollectProjectsFromXml(wxXmlNode* parentNode, const wxString& folder,
+                                              std::vector<ProjectToLoad>& projects)
 {
     wxXmlNode* child = parentNode->GetChildren();
     while(child) {
         if(child->GetName() == wxT("Project")) {
-            wxString projectPath = child->GetPropVal(wxT("Path"), wxEmptyString);
-            wxString errmsg;
-            if(!DoAddProject(projectPath, folder, errmsg)) { removedChildren.push_back(child); }
+            // Convert the path to absolute path
+            wxFileName projectFile(child->GetPropVal(wxT("Path"), wxEmptyString));
+            if(projectFile.IsRelative()) { projectFile.MakeAbsolute(m_fileName.GetPath()); }
+
+            ProjectToLoad p;
+            p.node = child;
+            p.path = projectFile.GetFullPath();
+            p.folder = folder;
+            p.project.Reset(new Project());
+            p.loaded = false;
+            projects.push_back(p);
         } else if(child->GetName() == wxT("VirtualDirectory")) {
             // Virtual directory
             wxString currentFolder = folder;
             wxString vdName = child->GetAttribute("Name", wxEmptyString);
             if(!currentFolder.IsEmpty()) { currentFolder << "/"; }
             currentFolder << vdName;
-            DoLoadProjectsFromXml(child, currentFolder, removedChildren);
+            DoCollectProjectsFromXml(child, currentFolder, projects);
         } else if((child->GetName() == wxT("WorkspaceParserPaths")) ||
                   (child->GetName() == wxT("WorkspaceParserMacros"))) {
             wxString swtlw = XmlUtils::ReadString(m_doc.GetRoot(), "SWTLW");
@@ -1359,12 +1418,14 @@ bool clCxxWorkspace::DoLoadWorkspace(const wxString& fileName, wxString& errMsg)
         return false;
     }
 
+    wxStopWatch sw;
     m_fileName = workSpaceFile;
     m_doc.Load(m_fileName.GetFullPath());
     if(!m_doc.IsOk()) {
         errMsg = wxT("Corrupted workspace file");
         return false;
     }
+    clDEBUG() << "Workspace: loaded" << m_fileName << "in" << sw.Time() << "ms" << clEndl;
 
     // Make sure we have the WORKSPACE/.codelite folder exists
     {
@@ -1389,12 +1450,16 @@ bool clCxxWorkspace::DoLoadWorkspace(const wxString& fileName, wxString& errMsg)
     }
 
     errMsg.Clear();
+    sw.Start();
     TagsManager* mgr = TagsManagerST::Get();
     mgr->CloseDatabase();
     mgr->OpenDatabase(GetTagsFileName().GetFullPath());
+    clDEBUG() << "Workspace: opened the tags database in" << sw.Time() << "ms" << clEndl;
 
     // Update the build matrix
+    sw.Start();
     DoUpdateBuildMatrix();
+    clDEBUG() << "Workspace: loaded the build matrix in" << sw.Time() << "ms" << clEndl;
     return true;
 }
 
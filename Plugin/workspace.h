@@ -108,11 +108,25 @@ private:
      */
     void DoUnselectActiveProject();
 
+    struct ProjectToLoad {
+        wxXmlNode* node;
+        wxString path;   // the project file, absolute path
+        wxString folder; // the workspace folder
+        ProjectPtr project;
+        bool loaded;
+    };
+
     /**
-     * @brief load projects from the XML file
+     * @brief load projects from the XML file. The project files are parsed in parallel, the projects are then added
+     * to the workspace in the order of the XML file
      */
     void DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString& folder, std::vector<wxXmlNode*>& removedChildren);
 
+    /**
+     * @brief list the projects of the XML file (recursing into the workspace folders)
+     */
+    void DoCollectProjectsFromXml(wxXmlNode* parentNode, const wxString& folder, std::vector<ProjectToLoad>& projects);
+
     // return the wxXmlNode instance for the give path
     // the path is separated by "/"
     // return NULL if no such virtual directory exists
@@ -2,6 +2,7 @@
 #include "CxxTemplateFunction.h"
 #include "bitmap_loader.h"
 #include "cc_box_tip_window.h"
+#include "clRowEntry.h"
 #include "cl_command_event.h"
 #include "codelite_events.h"
 #include "drawingutils.h"
@@ -132,7 +133,11 @@ wxCodeCompletionBox::wxCodeCompletionBox(wxWindow* parent, wxEvtHandler* eventOb
     m_bmpUpEnabled = m_bmpUp.ConvertToDisabled();
 }
 
-wxCodeCompletionBox::~wxCodeCompletionBox() { DoDestroyTipWindow(); }
+wxCodeCompletionBox::~wxCodeCompletionBox()
+{
+    m_list->SetDataProvider(nullptr);
+    DoDestroyTipWindow();
+}
 
 void wxCodeCompletionBox::ShowCompletionBox(wxStyledTextCtrl* ctrl, const wxCodeCompletionBoxEntry::Vec_t& entries)
 {
@@ -156,15 +161,22 @@ void wxCodeCompletionBox::ShowCompletionBox(wxStyledTextCtrl* ctrl, const wxCode
     // Filter all duplicate entries from the list (based on simple string match)
     RemoveDuplicateEntries();
 
+    // The keys to filter: the entries text without the signature. They are normalized once for the whole list
+    m_filter.Clear();
+    for(size_t i = 0; i < m_allEntries.size(); ++i) {
+        wxString entryText = m_allEntries.at(i)->GetText().BeforeFirst('(');
+        m_filter.AddKey(entryText.Trim().Trim(false));
+    }
+
     // Filter results based on user input
     size_t startsWithCount = 0;
     size_t containsCount = 0;
-    FilterResults(true, startsWithCount, containsCount);
+    FilterResults(startsWithCount, containsCount);
     wxUnusedVar(containsCount);
 
     // If we got a single match - insert it
-    if(m_entries.size() == 1 && (m_flags & kInsertSingleMatch)) {
-        wxString entryText = m_entries[0]->GetText().BeforeFirst('(');
+    if(m_filter.GetMatchesCount() == 1 && (m_flags & kInsertSingleMatch)) {
+        wxString entryText = GetEntry(0)->GetText().BeforeFirst('(');
         if(startsWithCount == 1 && entryText.CmpNoCase(GetFilter()) == 0) {
             DoDestroy();
             return;
@@ -176,12 +188,15 @@ void wxCodeCompletionBox::ShowCompletionBox(wxStyledTextCtrl* ctrl, const wxCode
     int end = m_stc->GetCurrentPos();
 
     wxString word = m_stc->GetTextRange(start, end); // the current word
-    if(m_entries.empty()) {
+    if(m_filter.GetMatchesCount() == 0) {
         // no entries to display
         DoDestroy();
         return;
     }
 
+    // The list displays the matches of the filter: only the visible rows are created. The filter changes only refresh
+    // the rows
+    m_list->SetDataProvider(this);
     DoShowCompletionBox();
 
     if(m_stc) {
@@ -204,11 +219,12 @@ void wxCodeCompletionBox::DoDisplayTipWindow()
 
         size_t index = static_cast<size_t>(m_list->GetItemData(item));
 
-        wxString docComment = m_entries.at(index)->GetComment();
+        wxCodeCompletionBoxEntry::Ptr_t entry = m_allEntries.at(index);
+        wxString docComment = entry->GetComment();
         docComment.Trim().Trim(false);
-        if(docComment.IsEmpty() && m_entries.at(index)->m_tag) {
+        if(docComment.IsEmpty() && entry->m_tag) {
             // Format the comment on demand if the origin was a tag entry
-            docComment = m_entries.at(index)->m_tag->FormatComment();
+            docComment = entry->m_tag->FormatComment();
         }
 
         if(docComment.IsEmpty()) {
@@ -254,66 +270,23 @@ void wxCodeCompletionBox::StcModified(wxStyledTextEvent& event)
     DoUpdateList();
 }
 
-bool wxCodeCompletionBox::FilterResults(bool updateEntries, size_t& startsWithCount, size_t& containsCount)
+bool wxCodeCompletionBox::FilterResults(size_t& startsWithCount, size_t& containsCount)
 {
-    containsCount = 0;
-    startsWithCount = 0;
-    wxString word = GetFilter();
-    if(word.IsEmpty()) {
-        if(updateEntries) {
-            m_entries = m_allEntries;
-        }
-        return false;
-    }
-
-    if(updateEntries) {
-        m_entries.clear();
-    }
-    wxString lcFilter = word.Lower();
     // Smart sorting:
-    // We preare the list of matches in the following order:
+    // We prepare the list of matches in the following order:
     // Exact matches
     // Starts with
     // Contains
-    wxCodeCompletionBoxEntry::Vec_t exactMatches, exactMatchesI, startsWith, startsWithI, contains, containsI;
-    for(size_t i = 0; i < m_allEntries.size(); ++i) {
-        wxString entryText = m_allEntries.at(i)->GetText().BeforeFirst('(');
-        entryText.Trim().Trim(false);
-        wxString lcEntryText = entryText.Lower();
-
-        // Exact match:
-        if(word == entryText) {
-            exactMatches.push_back(m_allEntries.at(i));
-
-        } else if(lcEntryText == lcFilter) {
-            exactMatchesI.push_back(m_allEntries.at(i));
-
-        } else if(entryText.StartsWith(word)) {
-            startsWith.push_back(m_allEntries.at(i));
-
-        } else if(lcEntryText.StartsWith(lcFilter)) {
-            startsWithI.push_back(m_allEntries.at(i));
-
-        } else if(entryText.Contains(word)) {
-            contains.push_back(m_allEntries.at(i));
-
-        } else if(lcEntryText.Contains(lcFilter)) {
-            containsI.push_back(m_allEntries.at(i));
-        }
-    }
-    startsWithCount = startsWith.size() + startsWithI.size() + exactMatches.size() + exactMatchesI.size();
-    containsCount = startsWithCount + contains.size() + containsI.size();
-
-    // Merge the results
-    if(updateEntries) {
-        m_entries.insert(m_entries.end(), exactMatches.begin(), exactMatches.end());
-        m_entries.insert(m_entries.end(), exactMatchesI.begin(), exactMatchesI.end());
-        m_entries.insert(m_entries.end(), startsWith.begin(), startsWith.end());
-        m_entries.insert(m_entries.end(), startsWithI.begin(), startsWithI.end());
-        m_entries.insert(m_entries.end(), contains.begin(), contains.end());
-        m_entries.insert(m_entries.end(), containsI.begin(), containsI.end());
+    // The filter characters in order ("gfn" for "GetFileName"), best scores first
+    wxString word = GetFilter();
+    m_filter.Filter(word);
+    startsWithCount = m_filter.GetStartsWithCount();
+    containsCount = m_filter.GetContainsCount();
+    if(word.IsEmpty()) {
+        return false;
     }
-    return exactMatches.empty() && exactMatchesI.empty() && startsWith.empty() && startsWithI.empty();
+    // A fuzzy match is enough to keep the list, ask for new entries only when nothing matches
+    return m_filter.GetMatchesCount() == 0;
 }
 
 void wxCodeCompletionBox::InsertSelection(wxCodeCompletionBoxEntry::Ptr_t entry)
@@ -326,7 +299,7 @@ void wxCodeCompletionBox::InsertSelection(wxCodeCompletionBoxEntry::Ptr_t entry)
             CHECK_PTR_RET(item);
             size_t index = static_cast<size_t>(m_list->GetItemData(item));
 
-            match = m_entries[index];
+            match = m_allEntries.at(index);
         }
 
         // Let the owner override the default behavior
@@ -412,12 +385,12 @@ void wxCodeCompletionBox::DoUpdateList()
 {
     size_t startsWithCount = 0;
     size_t containsCount = 0;
-    bool refreshList = FilterResults(true, startsWithCount, containsCount);
+    bool refreshList = FilterResults(startsWithCount, containsCount);
     wxUnusedVar(containsCount);
 
     // If there a single exact match hide the cc box
-    // if(!m_entries.empty()) {
-    //     wxString entryText = m_entries[0]->GetText().BeforeFirst('(');
+    // if(m_filter.GetMatchesCount()) {
+    //     wxString entryText = GetEntry(0)->GetText().BeforeFirst('(');
     //     if(startsWithCount == 1 && entryText.CmpNoCase(GetFilter()) == 0) {
     //         DoDestroy();
     //         return;
@@ -425,8 +398,9 @@ void wxCodeCompletionBox::DoUpdateList()
     // }
 
     int curpos = m_stc->GetCurrentPos();
-    if(m_entries.empty() || curpos < m_startPos || refreshList) {
-        if((m_entries.empty() || refreshList) && (m_flags & kRefreshOnKeyType)) {
+    bool noMatches = (m_filter.GetMatchesCount() == 0);
+    if(noMatches || curpos < m_startPos || refreshList) {
+        if((noMatches || refreshList) && (m_flags & kRefreshOnKeyType)) {
             // Trigger a new CC box
             wxCommandEvent event(wxEVT_MENU, XRCID("complete_word"));
             wxTheApp->GetTopWindow()->GetEventHandler()->AddPendingEvent(event);
@@ -704,22 +678,27 @@ int wxCodeCompletionBox::GetImageId(LSP::CompletionItem::Ptr_t entry) const
 
 void wxCodeCompletionBox::DoPopulateList()
 {
-    // Fill the control with the entries
-    m_list->DeleteAllItems();
-
-    wxVector<wxVariant> cols;
-    for(size_t i = 0; i < m_entries.size(); ++i) {
-        wxCodeCompletionBoxEntry::Ptr_t cc_item = m_entries[i];
-        cols.clear();
-        cols.push_back(::MakeBitmapIndexText(cc_item->GetText(), cc_item->GetImgIndex()));
-        m_list->AppendItem(cols, (wxUIntPtr)i);
-    }
+    // The matches changed, the provider rows are refreshed in place
+    m_list->RefreshRows();
+
     // Select the first item
     if(m_list->GetItemCount()) {
-        m_list->Select(m_list->RowToItem(0));
+        wxDataViewItem first = m_list->RowToItem(0);
+        m_list->Select(first);
+        m_list->EnsureVisible(first);
     }
 }
 
+void wxCodeCompletionBox::FillRow(size_t index, clRowEntry* row) const
+{
+    // The row data is the index of the entry in m_allEntries
+    size_t entryIndex = m_filter.GetMatch(index);
+    wxCodeCompletionBoxEntry::Ptr_t cc_item = m_allEntries[entryIndex];
+    row->SetLabel(cc_item->GetText());
+    row->SetBitmapIndex(cc_item->GetImgIndex());
+    row->SetData((wxUIntPtr)entryIndex);
+}
+
 void wxCodeCompletionBox::OnSelectionActivated(wxDataViewEvent& event)
 {
     event.Skip();
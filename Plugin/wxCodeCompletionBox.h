@@ -27,6 +27,8 @@
 #define WXCODECOMPLETIONBOX_H
 
 #include "LSP/CompletionItem.h"
+#include "clCodeCompletionFilter.h"
+#include "clTreeCtrlDataProvider.h"
 #include "entry.h"
 #include "wxCodeCompletionBoxBase.h"
 #include "wxCodeCompletionBoxEntry.hpp"
@@ -44,7 +46,7 @@ class CCBoxTipWindow;
 class wxCodeCompletionBox;
 class wxCodeCompletionBoxManager;
 
-class WXDLLIMPEXP_SDK wxCodeCompletionBox : public wxCodeCompletionBoxBase
+class WXDLLIMPEXP_SDK wxCodeCompletionBox : public wxCodeCompletionBoxBase, public clTreeCtrlDataProvider
 {
 public:
     typedef std::vector<wxBitmap> BmpVec_t;
@@ -62,7 +64,7 @@ protected:
     virtual void OnSelectionActivated(wxDataViewEvent& event);
     virtual void OnSelectionChanged(wxDataViewEvent& event);
     wxCodeCompletionBoxEntry::Vec_t m_allEntries;
-    wxCodeCompletionBoxEntry::Vec_t m_entries;
+    clCodeCompletionFilter m_filter; // the keys of m_allEntries, the list displays its matches
     wxCodeCompletionBox::BmpVec_t m_bitmaps;
     static wxCodeCompletionBox::BmpVec_t m_defaultBitmaps;
     std::unordered_map<int, int> m_lspCompletionItemImageIndexMap;
@@ -95,6 +97,7 @@ protected:
     void StcKeyDown(wxKeyEvent& event);
     static void InitializeDefaultBitmaps();
     void DoPopulateList();
+    wxCodeCompletionBoxEntry::Ptr_t GetEntry(size_t row) const { return m_allEntries[m_filter.GetMatch(row)]; }
 
 public:
     /**
@@ -141,14 +144,18 @@ public:
     void SetStartPos(int startPos) { this->m_startPos = startPos; }
     int GetStartPos() const { return m_startPos; }
 
+    // clTreeCtrlDataProvider
+    size_t GetRowCount() const { return m_filter.GetMatchesCount(); }
+    void FillRow(size_t index, clRowEntry* row) const;
+
 protected:
     /**
      * @brief filter the results based on what the user typed in the editor
      * @param [output] startsWithCount number of entries that 'starts with' the filter (case-I)
-     * @param [output] containsCount number of entries that 'starts with' the filter
-     * @return Should we refresh the content of the CC box (based on number of "Exact matches" / "Starts with" found)
+     * @param [output] containsCount number of entries that 'starts with' or contain the filter (case-I)
+     * @return Should we refresh the content of the CC box (nothing matches the filter)
      */
-    bool FilterResults(bool updateEntries, size_t& startsWithCount, size_t& containsCount);
+    bool FilterResults(size_t& startsWithCount, size_t& containsCount);
     void RemoveDuplicateEntries();
     void InsertSelection(wxCodeCompletionBoxEntry::Ptr_t entry = wxCodeCompletionBoxEntry::Ptr_t(nullptr));
     wxString GetFilter();
@@ -83,6 +83,7 @@ PHPCodeCompletion::PHPCodeCompletion()
     EventNotifier::Get()->Connect(wxEVT_CC_JUMP_HYPER_LINK,
                                   clCodeCompletionEventHandler(PHPCodeCompletion::OnQuickJump), NULL, this);
     EventNotifier::Get()->Bind(wxPHP_PARSE_ENDED, &PHPCodeCompletion::OnParseEnded, this);
+    EventNotifier::Get()->Bind(wxPHP_FILE_PARSED, &PHPCodeCompletion::OnFileParsed, this);
     EventNotifier::Get()->Bind(wxEVT_CC_UPDATE_NAVBAR, &PHPCodeCompletion::OnUpdateNavigationBar, this);
     EventNotifier::Get()->Bind(wxEVT_NAVBAR_SCOPE_MENU_SHOWING, &PHPCodeCompletion::OnNavigationBarMenuShowing, this);
     EventNotifier::Get()->Bind(wxEVT_NAVBAR_SCOPE_MENU_SELECTION_MADE,
@@ -115,6 +116,7 @@ PHPCodeCompletion::~PHPCodeCompletion()
     EventNotifier::Get()->Disconnect(wxEVT_CC_JUMP_HYPER_LINK,
                                      clCodeCompletionEventHandler(PHPCodeCompletion::OnQuickJump), NULL, this);
     EventNotifier::Get()->Unbind(wxPHP_PARSE_ENDED, &PHPCodeCompletion::OnParseEnded, this);
+    EventNotifier::Get()->Unbind(wxPHP_FILE_PARSED, &PHPCodeCompletion::OnFileParsed, this);
     EventNotifier::Get()->Unbind(wxEVT_NAVBAR_SCOPE_MENU_SHOWING, &PHPCodeCompletion::OnNavigationBarMenuShowing, this);
     EventNotifier::Get()->Unbind(wxEVT_NAVBAR_SCOPE_MENU_SELECTION_MADE,
                                  &PHPCodeCompletion::OnNavigationBarMenuSelectionMade, this);
@@ -870,9 +872,16 @@ void PHPCodeCompletion::DoOpenEditorForEntry(PHPEntityBase::Ptr_t entry)
 void PHPCodeCompletion::OnParseEnded(clParseEvent& event)
 {
     event.Skip();
+    m_lookupTable.ResetSymbolsCache();
     m_lookupTable.RebuildClassCache();
 }
 
+void PHPCodeCompletion::OnFileParsed(clParseEvent& event)
+{
+    event.Skip();
+    m_lookupTable.UpdateSymbolsCache(event.GetFileName());
+}
+
 void PHPCodeCompletion::OnUpdateNavigationBar(clCodeCompletionEvent& e)
 {
     e.Skip();
@@ -100,6 +100,7 @@ private:
     void OnInsertDoxyBlock(clCodeCompletionEvent& e);
     void OnRetagWorkspace(wxCommandEvent& event);
     void OnParseEnded(clParseEvent& event);
+    void OnFileParsed(clParseEvent& event);
     void OnUpdateNavigationBar(clCodeCompletionEvent& e);
     void OnNavigationBarMenuSelectionMade(clCommandEvent& e);
     void OnNavigationBarMenuShowing(clContextMenuEvent& e);
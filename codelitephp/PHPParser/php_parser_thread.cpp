@@ -2,6 +2,8 @@
 #include "PHPLookupTable.h"
 #include "PHPSourceFile.h"
 #include "macros.h"
+#include <algorithm>
+#include <thread>
 #include <wx/dir.h>
 
 PHPParserThread* PHPParserThread::ms_instance = 0;
@@ -76,13 +78,12 @@ void PHPParserThread::ParseFiles(PHPParserThreadRequest* request)
         allFiles.Add(*iter);
     }
 
-    // Get list of PHP files under
-    lookuptable.RecreateSymbolsDatabase(allFiles,
-                                        request->requestType == PHPParserThreadRequest::kParseWorkspaceFilesFull ?
-                                            PHPLookupTable::kUpdateMode_Full :
-                                            PHPLookupTable::kUpdateMode_Fast,
-                                        [&]() { return PHPParserThread::ms_goingDown; },
-                                        false);
+    // Get list of PHP files under. The files are parsed by a thread per CPU, this thread stores their symbols
+    lookuptable.RecreateSymbolsDatabaseInParallel(
+        allFiles,
+        request->requestType == PHPParserThreadRequest::kParseWorkspaceFilesFull ? PHPLookupTable::kUpdateMode_Full :
+                                                                                   PHPLookupTable::kUpdateMode_Fast,
+        [&]() { return PHPParserThread::ms_goingDown; }, false, std::max(1u, std::thread::hardware_concurrency()));
     // reset the shutdown flag
     ms_goingDown = false;
 }
@@ -100,6 +101,11 @@ void PHPParserThread::ParseFile(PHPParserThreadRequest* request)
 
     // Save its symbols
     lookuptable.UpdateSourceFile(sourceFile);
+
+    // Let the code completion refresh the symbols of this file
+    clParseEvent event(wxPHP_FILE_PARSED);
+    event.SetFileName(request->file);
+    EventNotifier::Get()->AddPendingEvent(event);
 }
 
 void PHPParserThread::Clear()
@@ -856,6 +856,33 @@ TEST_FUNC(test_func_arg_in_lambda_in_assignment)
     return true;
 }
 
+TEST_FUNC(test_reparse_base_class)
+{
+    // the lookups keep the symbols in memory: re-parsing a file must update them
+    PHPSourceFile baseV1("<?php class test_reparse_base { public function foo() {} }", &lookup);
+    baseV1.SetFilename(wxFileName("/tmp/test_reparse_base.php"));
+    baseV1.Parse();
+    lookup.UpdateSourceFile(baseV1);
+
+    PHPSourceFile derived("<?php class test_reparse_derived extends test_reparse_base {}", &lookup);
+    derived.SetFilename(wxFileName("/tmp/test_reparse_derived.php"));
+    derived.Parse();
+    lookup.UpdateSourceFile(derived);
+
+    PHPEntityBase::Ptr_t cls = lookup.FindClass("\\test_reparse_derived");
+    CHECK_BOOL(cls);
+    CHECK_BOOL(lookup.FindMemberOf(cls->GetDbId(), "foo"));
+
+    PHPSourceFile baseV2("<?php class test_reparse_base { public function bar() {} }", &lookup);
+    baseV2.SetFilename(wxFileName("/tmp/test_reparse_base.php"));
+    baseV2.Parse();
+    lookup.UpdateSourceFile(baseV2);
+
+    CHECK_BOOL(!lookup.FindMemberOf(cls->GetDbId(), "foo"));
+    CHECK_BOOL(lookup.FindMemberOf(cls->GetDbId(), "bar"));
+    return true;
+}
+
 
 //======================-------------------------------------------------
 // Main
@@ -1099,7 +1099,7 @@ void PHPWorkspaceView::ReloadWorkspace(bool saveBeforeReload)
     LoadWorkspaceView();
 }
 
-void PHPWorkspaceView::ReportParseThreadProgress(size_t curIndex, size_t total)
+void PHPWorkspaceView::ReportParseThreadProgress(size_t curIndex, size_t total, size_t filesPerSecond)
 {
     if(!m_gaugeParseProgress->IsShown()) {
         m_gaugeParseProgress->SetValue(0);
@@ -1111,11 +1111,16 @@ void PHPWorkspaceView::ReportParseThreadProgress(size_t curIndex, size_t total)
         int precent = (curIndex * 100) / total;
         m_gaugeParseProgress->SetValue(precent);
     }
+    if(filesPerSecond) {
+        m_gaugeParseProgress->SetToolTip(wxString::Format(_("Parsing: %u/%u files (%u files/sec)"), (unsigned)curIndex,
+                                                          (unsigned)total, (unsigned)filesPerSecond));
+    }
 }
 
 void PHPWorkspaceView::ReportParseThreadDone()
 {
     m_gaugeParseProgress->SetValue(0);
+    m_gaugeParseProgress->UnsetToolTip();
     if(m_gaugeParseProgress->IsShown()) {
         m_gaugeParseProgress->Hide();
         GetSizer()->Layout();
@@ -1144,7 +1149,7 @@ void PHPWorkspaceView::OnPhpParserDone(clParseEvent& event)
 void PHPWorkspaceView::OnPhpParserProgress(clParseEvent& event)
 {
     event.Skip();
-    ReportParseThreadProgress(event.GetCurfileIndex(), event.GetTotalFiles());
+    ReportParseThreadProgress(event.GetCurfileIndex(), event.GetTotalFiles(), event.GetFilesPerSecond());
 }
 
 void PHPWorkspaceView::OnPhpParserStarted(clParseEvent& event) { event.Skip(); }
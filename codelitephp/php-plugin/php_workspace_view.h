@@ -190,7 +190,7 @@ public:
     void LoadWorkspaceView();
     void UnLoadWorkspaceView();
 
-    void ReportParseThreadProgress(size_t curIndex, size_t total);
+    void ReportParseThreadProgress(size_t curIndex, size_t total, size_t filesPerSecond = 0);
     void ReportParseThreadDone();
     void ReloadWorkspace(bool saveBeforeReload);
 };
@@ -6,6 +6,15 @@
 #include "workerthread.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifndef __WXMSW__
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #ifdef __WXMSW__
 #define PIPE_NAME "\\\\.\\pipe\\codelite_indexer_%s"
@@ -29,13 +38,15 @@ int main(int argc, char** argv)
     int max_requests(5000);
     int requests(0);
     long parent_pid(0);
+    int workers(1);
     if(argc < 2) {
-        printf("Usage: %s <string> [--pid]\n", argv[0]);
+        printf("Usage: %s <string> [--pid] [--workers <count>]\n", argv[0]);
         printf("Usage: %s --batch <file_list> <output file>\n", argv[0]);
-        printf("   <string> - a unique string that identifies this indexer from other instances               \n");
-        printf("   --pid    - when set, <string> is handled as process number and the indexer will            \n");
-        printf("              check if this process alive. If it is down, the indexer will go down as well\n");
-        printf("   --batch  - when set, batch parsing is done using list of files set in file_list argument   \n");
+        printf("   <string>  - a unique string that identifies this indexer from other instances               \n");
+        printf("   --pid     - when set, <string> is handled as process number and the indexer will            \n");
+        printf("               check if this process alive. If it is down, the indexer will go down as well\n");
+        printf("   --workers - number of worker processes serving the channel (default: 1)                    \n");
+        printf("   --batch   - when set, batch parsing is done using list of files set in file_list argument   \n");
         return 1;
     }
 
@@ -45,9 +56,17 @@ int main(int argc, char** argv)
         return 0;
     }
 
-    if(argc == 3 && strcmp(argv[2], "--pid") == 0) {
-        parent_pid = atol(argv[1]);
-        printf("INFO: parent PID is set on %s\n", argv[1]);
+    for(int i = 2; i < argc; ++i) {
+        if(strcmp(argv[i], "--pid") == 0) {
+            parent_pid = atol(argv[1]);
+            printf("INFO: parent PID is set on %s\n", argv[1]);
+
+        } else if(strcmp(argv[i], "--workers") == 0 && (i + 1) < argc) {
+            workers = atoi(argv[++i]);
+            if(workers < 1) {
+                workers = 1;
+            }
+        }
     }
 
     // create the connection factory
@@ -56,11 +75,59 @@ int main(int argc, char** argv)
 
     clNamedPipeConnectionsServer server(channel_name);
 
+#ifndef __WXMSW__
+    // A client that disconnects in the middle of a reply should not kill us
+    signal(SIGPIPE, SIG_IGN);
+
+    // libctags keeps its parser state in globals, so the worker pool is made of processes and not threads.
+    // All the workers accept connections from the same listening socket, so it must be created before we fork
+    std::vector<pid_t> children;
+    long master_pid = getpid();
+    bool is_worker = false;
+    if(workers > 1) {
+        if(!server.listen()) {
+            fprintf(stderr, "ERROR: failed to listen on %s\n", channel_name);
+            return 1;
+        }
+        for(int i = 1; i < workers; ++i) {
+            pid_t pid = fork();
+            if(pid == 0) {
+                is_worker = true;
+                children.clear();
+                break;
+            } else if(pid > 0) {
+                children.push_back(pid);
+            } else {
+                perror("ERROR: fork");
+                break;
+            }
+        }
+    }
+#else
+    // Each indexer process creates its own instance of the named pipe, so a single process is used
+    workers = 1;
+#endif
+
+    // A worker process holds at most one pending connection besides the one being served, so the others are
+    // accepted by idle workers instead of piling up here
+    if(workers > 1) {
+        g_connectionQueue.setMaxSize(1);
+    }
+
     // start the worker thread
     WorkerThread worker(&g_connectionQueue);
 
     // start the 'is alive thread'
+#ifndef __WXMSW__
+    // forked workers follow the main indexer process, which is the one restarted by codelite
+    IsAliveThread isAliveThread(is_worker ? master_pid : parent_pid, channel_name, !is_worker);
+    if(is_worker) {
+        parent_pid = master_pid;
+        max_requests = -1;
+    }
+#else
     IsAliveThread isAliveThread(parent_pid, channel_name);
+#endif
     worker.run();
     if(parent_pid) {
         isAliveThread.run();
@@ -68,6 +135,9 @@ int main(int argc, char** argv)
 
     printf("INFO: codelite_indexer started\n");
     printf("INFO: listening on %s\n", channel_name);
+    if(workers > 1) {
+        printf("INFO: using %d worker processes\n", workers);
+    }
 
     while(true) {
         clNamedPipe* conn = server.waitForNewConnection(-1);
@@ -85,6 +155,13 @@ int main(int argc, char** argv)
         if(requests == max_requests) {
             // stop the worker thread and exit
             printf("INFO: Max requests reached, going down\n");
+#ifndef __WXMSW__
+            // the worker processes are recycled together with us
+            for(size_t i = 0; i < children.size(); ++i) {
+                kill(children[i], SIGTERM);
+                waitpid(children[i], NULL, 0);
+            }
+#endif
             worker.requestStop();
             worker.wait(-1);
 
@@ -19,6 +19,11 @@ public:
 
 	bool put(const T& item);
 	bool get(T& item, long timeout);
+
+	/**
+	 * @brief bound the queue: put() blocks while it holds 'maxSize' items. 0 (the default) means unbounded
+	 */
+	void setMaxSize(size_t maxSize);
 };
 
 //----------------------------
@@ -48,4 +53,10 @@ bool eQueue<T>::put(const T& item)
 	return m_impl->put(item);
 }
 
+template<class T>
+void eQueue<T>::setMaxSize(size_t maxSize)
+{
+	m_impl->setMaxSize(maxSize);
+}
+
 #endif // __equeue__
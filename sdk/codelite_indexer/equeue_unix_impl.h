@@ -14,7 +14,9 @@ class eQueueImpl
 protected:
 	pthread_mutex_t m_mutex;
 	pthread_cond_t m_cond;
+	pthread_cond_t m_notFull;
 	std::list<T> m_queue;
+	size_t m_maxSize;
 
 public:
 	eQueueImpl();
@@ -22,6 +24,7 @@ public:
 
 	bool put ( const T& item );
 	bool get ( T& item, long timeout );
+	void setMaxSize ( size_t maxSize );
 };
 
 //----------------------------
@@ -38,6 +41,8 @@ eQueueImpl<T>::eQueueImpl()
 	pthread_condattr_t cattr;
 	pthread_condattr_init ( &cattr );
 	pthread_cond_init ( &m_cond, &cattr );
+	pthread_cond_init ( &m_notFull, &cattr );
+	m_maxSize = 0;
 }
 
 template<class T>
@@ -80,6 +85,7 @@ bool eQueueImpl<T>::get ( T& item, long timeout )
 	// get copy of the data
 	item = m_queue.front();
 	m_queue.pop_front();
+	pthread_cond_signal ( &m_notFull );
 
 	pthread_mutex_unlock ( &m_mutex );
 
@@ -90,6 +96,9 @@ template<class T>
 bool eQueueImpl<T>::put ( const T& item )
 {
 	pthread_mutex_lock ( &m_mutex );
+	while ( m_maxSize && m_queue.size() >= m_maxSize ) {
+		pthread_cond_wait ( &m_notFull, &m_mutex );
+	}
 	bool was_empty = m_queue.empty();
 	m_queue.push_back ( item );
 	if ( was_empty ) {
@@ -99,6 +108,15 @@ bool eQueueImpl<T>::put ( const T& item )
 	return true;
 }
 
+template<class T>
+void eQueueImpl<T>::setMaxSize ( size_t maxSize )
+{
+	pthread_mutex_lock ( &m_mutex );
+	m_maxSize = maxSize;
+	pthread_cond_broadcast ( &m_notFull );
+	pthread_mutex_unlock ( &m_mutex );
+}
+
 #endif // __equeue_unix_impl_h__
 
 #endif // !defined(__WXMSW__)
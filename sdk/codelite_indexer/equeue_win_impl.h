@@ -12,7 +12,9 @@ class eQueueImpl
 protected:
 	CRITICAL_SECTION m_cs;
 	HANDLE m_event;
+	HANDLE m_notFullEvent;
 	std::list<T> m_queue;
+	size_t m_maxSize;
 
 public:
 	eQueueImpl();
@@ -20,6 +22,7 @@ public:
 
 	bool put(const T& item);
 	bool get(T& item, long timeout);
+	void setMaxSize(size_t maxSize);
 };
 
 //----------------------------
@@ -33,6 +36,9 @@ eQueueImpl<T>::eQueueImpl()
 	// it shall be reset as long as queue is empty
 	InitializeCriticalSection(&m_cs);
 	m_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+	// signalled as long as there is room in the queue
+	m_notFullEvent = CreateEvent(NULL, TRUE, TRUE, NULL);
+	m_maxSize = 0;
 }
 
 template<class T>
@@ -40,6 +46,7 @@ eQueueImpl<T>::~eQueueImpl()
 {
 	DeleteCriticalSection(&m_cs);
 	CloseHandle(m_event);
+	CloseHandle(m_notFullEvent);
 	m_queue.clear();
 }
 
@@ -73,6 +80,7 @@ bool eQueueImpl<T>::get(T& item, long timeout)
 				if (m_queue.empty()) {
 					ResetEvent(m_event);
 				}
+				SetEvent(m_notFullEvent);
 				LeaveCriticalSection( &m_cs );
 				return true;
 			}
@@ -87,13 +95,38 @@ bool eQueueImpl<T>::get(T& item, long timeout)
 template<class T>
 bool eQueueImpl<T>::put(const T& item)
 {
-	EnterCriticalSection( &m_cs );
+	while (true) {
+		WaitForSingleObject(m_notFullEvent, INFINITE);
+		EnterCriticalSection( &m_cs );
+		if (m_maxSize == 0 || m_queue.size() < m_maxSize) {
+			break;
+		}
+		// another thread filled the queue first
+		ResetEvent(m_notFullEvent);
+		LeaveCriticalSection( &m_cs );
+	}
 	m_queue.push_back(item);
 	SetEvent(m_event);
+	if (m_maxSize && m_queue.size() >= m_maxSize) {
+		ResetEvent(m_notFullEvent);
+	}
 	LeaveCriticalSection( &m_cs );
 	return true;
 }
 
+template<class T>
+void eQueueImpl<T>::setMaxSize(size_t maxSize)
+{
+	EnterCriticalSection( &m_cs );
+	m_maxSize = maxSize;
+	if (m_maxSize == 0 || m_queue.size() < m_maxSize) {
+		SetEvent(m_notFullEvent);
+	} else {
+		ResetEvent(m_notFullEvent);
+	}
+	LeaveCriticalSection( &m_cs );
+}
+
 #endif // __equeue_win_h__
 
 #endif
@@ -33,6 +33,13 @@ class clIndexerReply
 	std::string m_fileName;
 	std::string m_tags;
 
+public:
+	enum {
+		CLI_REPLY_FAILED = 0,
+		CLI_REPLY_SUCCESS = 1,
+		CLI_REPLY_END_OF_BATCH = 2
+	};
+
 public:
 	clIndexerReply();
 	~clIndexerReply();
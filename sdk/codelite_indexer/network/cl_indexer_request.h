@@ -38,7 +38,10 @@ class clIndexerRequest
 public:
 	enum {
 		CLI_PARSE,
-		CLI_PARSE_AND_SAVE
+		CLI_PARSE_AND_SAVE,
+		// parse every file in the request and stream back one reply per file,
+		// followed by a reply with the completion code CLI_REPLY_END_OF_BATCH
+		CLI_PARSE_BATCH
 	};
 
 public:
@@ -108,7 +108,7 @@ PIPE_HANDLE clNamedPipeConnectionsServer::initNewInstance()
 			return INVALID_PIPE_HANDLE;
 		}
 	}
-	listen(_listenHandle, 10);
+	::listen(_listenHandle, 10);
 	return _listenHandle;
 #endif
 }
@@ -124,6 +124,15 @@ bool clNamedPipeConnectionsServer::shutdown()
 	return true;
 }
 
+bool clNamedPipeConnectionsServer::listen()
+{
+#ifdef __WXMSW__
+	return true;
+#else
+	return this->initNewInstance() != INVALID_PIPE_HANDLE;
+#endif
+}
+
 clNamedPipe *clNamedPipeConnectionsServer::waitForNewConnection( int timeout )
 {
 	PIPE_HANDLE hConn = this->initNewInstance();
@@ -41,6 +41,13 @@ public:
 	virtual ~clNamedPipeConnectionsServer();
 	bool shutdown();
 	clNamedPipe *waitForNewConnection(int timeout);
+
+	/**
+	 * @brief create the listening end point now rather than on the first call to waitForNewConnection().
+	 * This is required when the listening socket should be shared with forked worker processes.
+	 * Under Windows, this is a no-op: every process creates its own pipe instance
+	 */
+	bool listen();
 	NP_SERVER_ERRORS getLastError() { return this->_lastError ; }
 
 protected:
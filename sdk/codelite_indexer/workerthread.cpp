@@ -37,6 +37,13 @@ void WorkerThread::start()
 				continue;
 			}
 
+			if (req.getCmd() == clIndexerRequest::CLI_PARSE_BATCH) {
+				// a client that went away in the middle of a batch (e.g. a cancelled retag)
+				// only drops its own connection
+				ProcessBatchRequest(conn, req);
+				continue;
+			}
+
 			char *tags(NULL);
 			// create fies for the requested files
 			for (size_t i=0; i<req.getFiles().size(); i++) {
@@ -101,6 +108,40 @@ void WorkerThread::start()
 	exit(-1);
 }
 
+bool WorkerThread::ProcessBatchRequest(clNamedPipe* conn, const clIndexerRequest& req)
+{
+	for (size_t i=0; i<req.getFiles().size(); i++) {
+		const std::string& file_name = req.getFiles().at(i);
+		char *tags = ctags_make_tags(req.getCtagOptions().c_str(), file_name.c_str());
+
+		// send a reply per file, even when no tags were found, so the client
+		// can keep track of its progress
+		clIndexerReply reply;
+		reply.setFileName(file_name);
+		if (tags) {
+			reply.setCompletionCode(clIndexerReply::CLI_REPLY_SUCCESS);
+			reply.setTags(tags);
+			ctags_free(tags);
+		} else {
+			reply.setCompletionCode(clIndexerReply::CLI_REPLY_FAILED);
+		}
+
+		if ( !clIndexerProtocol::SendReply(conn, reply) ) {
+			fprintf(stderr, "ERROR: Protocol error: failed to send reply for file %s\n", file_name.c_str());
+			return false;
+		}
+	}
+
+	// let the client know that this batch is completed
+	clIndexerReply eob;
+	eob.setCompletionCode(clIndexerReply::CLI_REPLY_END_OF_BATCH);
+	if ( !clIndexerProtocol::SendReply(conn, eob) ) {
+		fprintf(stderr, "ERROR: Protocol error: failed to send end of batch reply\n");
+		return false;
+	}
+	return true;
+}
+
 // ---------------------------------------------
 // is alive thread
 // ---------------------------------------------
@@ -117,8 +158,10 @@ void IsAliveThread::start()
 			fprintf(stderr, "INFO: parent process died, going down\n");
 #ifndef __WXMSW__
 			// Delete the local socket
-			::unlink(m_socket.c_str());
-			::remove(m_socket.c_str());
+			if ( m_ownsSocket ) {
+				::unlink(m_socket.c_str());
+				::remove(m_socket.c_str());
+			}
 #endif
 			exit(0);
 		}
@@ -126,7 +169,9 @@ void IsAliveThread::start()
 	
 #ifndef __WXMSW__
 	// Delete the local socket
-	::unlink(m_socket.c_str());
-	::remove(m_socket.c_str());
+	if ( m_ownsSocket ) {
+		::unlink(m_socket.c_str());
+		::remove(m_socket.c_str());
+	}
 #endif
 }
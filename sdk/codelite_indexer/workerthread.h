@@ -9,10 +9,18 @@
 // parsing thread
 // ---------------------------------------------
 
+class clIndexerRequest;
 class WorkerThread : public eThread
 {
     eQueue<clNamedPipe*>* m_queue;
 
+protected:
+    /**
+     * @brief parse the files of a CLI_PARSE_BATCH request and send back one reply per file
+     * @return false if the connection was lost
+     */
+    bool ProcessBatchRequest(clNamedPipe* conn, const clIndexerRequest& req);
+
 public:
     WorkerThread(eQueue<clNamedPipe*>* queue);
     ~WorkerThread();
@@ -28,11 +36,19 @@ class IsAliveThread : public eThread
 {
     int m_pid;
     std::string m_socket;
+    bool m_ownsSocket;
 
 public:
-    IsAliveThread(int pid, const std::string& socketName)
+    /**
+     * @param pid the process to watch
+     * @param socketName the channel name
+     * @param ownsSocket when true, the socket file is removed when going down. Forked workers
+     * share the socket with the main indexer process and should leave it alone
+     */
+    IsAliveThread(int pid, const std::string& socketName, bool ownsSocket = true)
         : m_pid(pid)
         , m_socket(socketName)
+        , m_ownsSocket(ownsSocket)
     {
     }
     ~IsAliveThread() {}